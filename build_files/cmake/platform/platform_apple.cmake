@@ -53,6 +53,12 @@ find_package(ZLIB REQUIRED)
 find_package(BZip2 REQUIRED)
 list(APPEND ZLIB_LIBRARIES ${BZIP2_LIBRARIES})
 
+# Required for compressed .blend files, which must be readable by every build.
+if(NOT DEFINED ZSTD_ROOT_DIR)
+  set(ZSTD_ROOT_DIR ${LIBDIR}/zstd)
+endif()
+find_package(Zstd REQUIRED)
+
 if(WITH_OPENAL)
   find_package(OpenAL)
   if(NOT OPENAL_FOUND)
@@ -280,6 +280,13 @@ set(ZLIB_LIBRARY ${LIBDIR}/zlib/lib/libz_st.lib)
 set(ZLIB_DIR ${LIBDIR}/zlib)
 
 windows_find_package(zlib) # we want to find before finding things that depend on it like png
+
+# Required for compressed .blend files, which must be readable by every build.
+if(NOT EXISTS ${LIBDIR}/zstd)
+  message(FATAL_ERROR "Zstd was not found in ${LIBDIR}/zstd, it is required")
+endif()
+set(ZSTD_INCLUDE_DIRS ${LIBDIR}/zstd/include)
+set(ZSTD_LIBRARIES ${LIBDIR}/zstd/lib/zstd_static.lib)
 windows_find_package(png)
 
 if(NOT PNG_FOUND)
@@ -86,12 +86,15 @@ ATOMIC_INLINE int32_t atomic_cas_int32(int32_t *v, int32_t old, int32_t _new);
 ATOMIC_INLINE int32_t atomic_fetch_and_add_int32(int32_t *p, int32_t x);
 ATOMIC_INLINE int32_t atomic_fetch_and_or_int32(int32_t *p, int32_t x);
 ATOMIC_INLINE int32_t atomic_fetch_and_and_int32(int32_t *p, int32_t x);
+ATOMIC_INLINE int32_t atomic_load_int32(const int32_t *p);
+ATOMIC_INLINE void atomic_store_int32(int32_t *p, int32_t v);
 
 ATOMIC_INLINE int16_t atomic_fetch_and_or_int16(int16_t *p, int16_t b);
 ATOMIC_INLINE int16_t atomic_fetch_and_and_int16(int16_t *p, int16_t b);
 
 ATOMIC_INLINE uint8_t atomic_fetch_and_or_uint8(uint8_t *p, uint8_t b);
 ATOMIC_INLINE uint8_t atomic_fetch_and_and_uint8(uint8_t *p, uint8_t b);
+ATOMIC_INLINE uint8_t atomic_load_uint8(const uint8_t *p);
 
 ATOMIC_INLINE int8_t atomic_fetch_and_or_int8(int8_t *p, int8_t b);
 ATOMIC_INLINE int8_t atomic_fetch_and_and_int8(int8_t *p, int8_t b);
@@ -162,6 +162,18 @@ ATOMIC_INLINE int32_t atomic_fetch_and_and_int32(int32_t *p, int32_t x)
   return InterlockedAnd((long *)p, x);
 }
 
+ATOMIC_INLINE int32_t atomic_load_int32(const int32_t *p)
+{
+  /* Volatile reads have acquire semantics with the default `/volatile:ms`. */
+  return *(const volatile int32_t *)p;
+}
+
+ATOMIC_INLINE void atomic_store_int32(int32_t *p, int32_t v)
+{
+  /* Volatile writes have release semantics with the default `/volatile:ms`. */
+  *(volatile int32_t *)p = v;
+}
+
 /******************************************************************************/
 /* 16-bit operations. */
 
@@ -200,6 +212,12 @@ ATOMIC_INLINE uint8_t atomic_fetch_and_or_uint8(uint8_t *p, uint8_t b)
 #endif
 }
 
+ATOMIC_INLINE uint8_t atomic_load_uint8(const uint8_t *p)
+{
+  /* Volatile reads have acquire semantics with the default `/volatile:ms`. */
+  return *(const volatile uint8_t *)p;
+}
+
 /* Signed */
 #pragma intrinsic(_InterlockedAnd8)
 ATOMIC_INLINE int8_t atomic_fetch_and_and_int8(int8_t *p, int8_t b)
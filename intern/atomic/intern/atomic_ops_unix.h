@@ -322,6 +322,16 @@ ATOMIC_INLINE int32_t atomic_fetch_and_and_int32(int32_t *p, int32_t x)
   return __sync_fetch_and_and(p, x);
 }
 
+ATOMIC_INLINE int32_t atomic_load_int32(const int32_t *p)
+{
+  return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+ATOMIC_INLINE void atomic_store_int32(int32_t *p, int32_t v)
+{
+  __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
 #else
 #  error "Missing implementation for 32-bit atomic operations"
 #endif
@@ -356,6 +366,12 @@ ATOMIC_INLINE uint8_t atomic_fetch_and_or_uint8(uint8_t *p, uint8_t b)
 {
   return __sync_fetch_and_or(p, b);
 }
+/* Load with acquire semantics, memory written before a barrier that published the value is
+ * visible after the load. */
+ATOMIC_INLINE uint8_t atomic_load_uint8(const uint8_t *p)
+{
+  return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
 
 /* Signed */
 ATOMIC_INLINE int8_t atomic_fetch_and_and_int8(int8_t *p, int8_t b)
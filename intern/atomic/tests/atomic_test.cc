@@ -557,6 +557,24 @@ TEST(atomic, atomic_fetch_and_and_int32)
   }
 }
 
+TEST(atomic, atomic_load_int32)
+{
+  {
+    int32_t value = -12;
+    EXPECT_EQ(atomic_load_int32(&value), -12);
+    EXPECT_EQ(value, -12);
+  }
+}
+
+TEST(atomic, atomic_store_int32)
+{
+  {
+    int32_t value = 12;
+    atomic_store_int32(&value, -0x12345678);
+    EXPECT_EQ(value, -0x12345678);
+  }
+}
+
 /** \} */
 
 /** \name 16 bit signed int atomics
@@ -613,6 +631,15 @@ TEST(atomic, atomic_fetch_and_and_uint8)
   }
 }
 
+TEST(atomic, atomic_load_uint8)
+{
+  {
+    uint8_t value = 12;
+    EXPECT_EQ(atomic_load_uint8(&value), 12);
+    EXPECT_EQ(value, 12);
+  }
+}
+
 /** \} */
 
 /** \name 8 bit signed int atomics
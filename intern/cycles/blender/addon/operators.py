@@ -195,12 +195,42 @@ class CYCLES_OT_merge_images(Operator):
         return {'FINISHED'}
 
 
+class CYCLES_OT_convert_textures(Operator):
+    "Convert image textures to tiled and mipmapped .tx files next to the " \
+    "images, for use by the texture cache"
+    bl_idname = "cycles.convert_textures"
+    bl_label = "Convert Textures"
+
+    def execute(self, context):
+        cscene = context.scene.cycles
+
+        import _cycles
+        num_converted = 0
+        for image in bpy.data.images:
+            if image.source != 'FILE' or image.packed_file:
+                continue
+
+            filepath = bpy.path.abspath(image.filepath, library=image.library)
+            if filepath.endswith(".tx"):
+                continue
+
+            try:
+                _cycles.convert_texture(input=filepath, tile_size=cscene.texture_tile_size)
+                num_converted += 1
+            except Exception as e:
+                self.report({'WARNING'}, str(e))
+
+        self.report({'INFO'}, tip_("Converted %d textures") % num_converted)
+        return {'FINISHED'}
+
+
 classes = (
     CYCLES_OT_use_shading_nodes,
     CYCLES_OT_add_aov,
     CYCLES_OT_remove_aov,
     CYCLES_OT_denoise_animation,
-    CYCLES_OT_merge_images
+    CYCLES_OT_merge_images,
+    CYCLES_OT_convert_textures
 )
 
 
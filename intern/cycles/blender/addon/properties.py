@@ -397,6 +397,30 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         min=0.0, max=1.0,
         default=0.01,
     )
+    use_light_tree: BoolProperty(
+        name="Light Tree",
+        description="Pick lights based on their estimated contribution to the shading point, "
+        "which reduces noise in scenes with many lights (not supported with Branched Path Tracing)",
+        default=False,
+    )
+    use_path_guiding: BoolProperty(
+        name="Path Guiding",
+        description="Learn where indirect light comes from while rendering, and sample bounces towards it, "
+        "which reduces noise from indirect light that is hard to find (CPU only, not supported with Branched Path Tracing)",
+        default=False,
+    )
+    path_guiding_fraction: FloatProperty(
+        name="Guiding Fraction",
+        description="Fraction of bounces sampled from the learned distribution instead of the BSDF",
+        min=0.0, max=0.9,
+        default=0.5,
+    )
+    path_guiding_training_samples: IntProperty(
+        name="Training Samples",
+        description="Number of samples for which paths are used to learn the distribution of indirect light",
+        min=1, max=(1 << 24),
+        default=128,
+    )
 
     use_adaptive_sampling: BoolProperty(
         name="Use Adaptive Sampling",
@@ -800,6 +824,48 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         items=enum_texture_limit
     )
 
+    use_texture_cache: BoolProperty(
+        name="Use Texture Cache",
+        default=False,
+        description="Load image textures on demand in tiles and mipmap levels, instead of fully loading them "
+        "into memory (CPU only)",
+    )
+    texture_cache_size: IntProperty(
+        name="Cache Size",
+        default=1024,
+        min=0, soft_max=65536,
+        subtype='UNSIGNED',
+        description="Memory used for texture tiles in MB, least recently used tiles are freed when it is full",
+    )
+    texture_tile_size: IntProperty(
+        name="Tile Size",
+        default=64,
+        min=8, max=1024,
+        description="Size of tiles when converting images to tiled textures",
+    )
+    texture_auto_convert: BoolProperty(
+        name="Auto Convert",
+        default=False,
+        description="Convert image textures to tiled and mipmapped .tx files next to the image before rendering, "
+        "files are only converted again when the image changes",
+    )
+    texture_blur_diffuse: FloatProperty(
+        name="Diffuse Blur",
+        default=1.0 / 64.0,
+        min=0.0, max=1.0,
+        subtype='FACTOR',
+        description="Blur of image textures after diffuse bounces, as a fraction of the image size. "
+        "Higher values read lower resolution mipmap levels",
+    )
+    texture_blur_glossy: FloatProperty(
+        name="Glossy Blur",
+        default=0.0,
+        min=0.0, max=1.0,
+        subtype='FACTOR',
+        description="Blur of image textures after glossy bounces, as a fraction of the image size. "
+        "Higher values read lower resolution mipmap levels",
+    )
+
     ao_bounces: IntProperty(
         name="AO Bounces",
         default=0,
@@ -316,6 +316,15 @@ class CYCLES_RENDER_PT_sampling_advanced(CyclesButtonsPanel, Panel):
         col.prop(cscene, "min_transparent_bounces")
         col.prop(cscene, "light_sampling_threshold", text="Light Threshold")
 
+        col = layout.column(align=True)
+        col.active = cscene.progressive == 'PATH' or not use_branched_path(context)
+        col.prop(cscene, "use_light_tree")
+        col.prop(cscene, "use_path_guiding")
+        sub = col.column(align=True)
+        sub.active = cscene.use_path_guiding
+        sub.prop(cscene, "path_guiding_fraction", text="Fraction")
+        sub.prop(cscene, "path_guiding_training_samples", text="Training Samples")
+
         if cscene.progressive != 'PATH' and use_branched_path(context):
             col = layout.column(align=True)
             col.prop(cscene, "sample_all_lights_direct")
@@ -743,6 +752,35 @@ class CYCLES_RENDER_PT_performance_final_render(CyclesButtonsPanel, Panel):
         col.prop(rd, "use_persistent_data", text="Persistent Images")
 
 
+class CYCLES_RENDER_PT_performance_texture_cache(CyclesButtonsPanel, Panel):
+    bl_label = "Texture Cache"
+    bl_parent_id = "CYCLES_RENDER_PT_performance"
+
+    def draw_header(self, context):
+        cscene = context.scene.cycles
+
+        self.layout.prop(cscene, "use_texture_cache", text="")
+
+    def draw(self, context):
+        layout = self.layout
+        layout.use_property_split = True
+        layout.use_property_decorate = False
+
+        cscene = context.scene.cycles
+
+        layout.active = cscene.use_texture_cache
+
+        col = layout.column()
+        col.prop(cscene, "texture_cache_size")
+        col.prop(cscene, "texture_blur_diffuse")
+        col.prop(cscene, "texture_blur_glossy")
+
+        col = layout.column()
+        col.prop(cscene, "texture_auto_convert")
+        col.prop(cscene, "texture_tile_size")
+        col.operator("cycles.convert_textures")
+
+
 class CYCLES_RENDER_PT_performance_viewport(CyclesButtonsPanel, Panel):
     bl_label = "Viewport"
     bl_parent_id = "CYCLES_RENDER_PT_performance"
@@ -2294,6 +2332,7 @@ classes = (
     CYCLES_RENDER_PT_performance_tiles,
     CYCLES_RENDER_PT_performance_acceleration_structure,
     CYCLES_RENDER_PT_performance_final_render,
+    CYCLES_RENDER_PT_performance_texture_cache,
     CYCLES_RENDER_PT_performance_viewport,
     CYCLES_RENDER_PT_passes,
     CYCLES_RENDER_PT_passes_data,
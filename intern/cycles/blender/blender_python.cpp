@@ -24,6 +24,7 @@
 #include "blender/blender_util.h"
 
 #include "render/denoising.h"
+#include "render/image_cache.h"
 #include "render/merge.h"
 
 #include "util/util_debug.h"
@@ -835,6 +836,29 @@ static PyObject *merge_func(PyObject * /*self*/, PyObject *args, PyObject *keywo
   Py_RETURN_NONE;
 }
 
+static PyObject *convert_texture_func(PyObject * /*self*/, PyObject *args, PyObject *keywords)
+{
+  static const char *keyword_list[] = {"input", "output", "tile_size", NULL};
+  const char *input, *output = NULL;
+  int tile_size = 64;
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args, keywords, "s|zi", (char **)keyword_list, &input, &output, &tile_size)) {
+    return NULL;
+  }
+
+  /* Write next to the input by default, where the texture cache finds it. */
+  const string tx_filepath = (output) ? string(output) : TextureCache::tx_filepath(input);
+
+  string error;
+  if (!TextureCache::convert(input, tx_filepath, tile_size, error)) {
+    PyErr_SetString(PyExc_ValueError, error.c_str());
+    return NULL;
+  }
+
+  return pyunicode_from_string(tx_filepath.c_str());
+}
+
 static PyObject *debug_flags_update_func(PyObject * /*self*/, PyObject *args)
 {
   PyObject *pyscene;
@@ -1034,6 +1058,9 @@ static PyMethodDef methods[] = {
     {"denoise", (PyCFunction)denoise_func, METH_VARARGS | METH_KEYWORDS, ""},
     {"merge", (PyCFunction)merge_func, METH_VARARGS | METH_KEYWORDS, ""},
 
+    /* Texture cache */
+    {"convert_texture", (PyCFunction)convert_texture_func, METH_VARARGS | METH_KEYWORDS, ""},
+
     /* Debugging routines */
     {"debug_flags_update", debug_flags_update_func, METH_VARARGS, ""},
     {"debug_flags_reset", debug_flags_reset_func, METH_NOARGS, ""},
@@ -311,6 +311,11 @@ void BlenderSync::sync_integrator()
   integrator->set_sample_all_lights_direct(get_boolean(cscene, "sample_all_lights_direct"));
   integrator->set_sample_all_lights_indirect(get_boolean(cscene, "sample_all_lights_indirect"));
   integrator->set_light_sampling_threshold(get_float(cscene, "light_sampling_threshold"));
+  integrator->set_use_light_tree(get_boolean(cscene, "use_light_tree"));
+  integrator->set_use_path_guiding(get_boolean(cscene, "use_path_guiding"));
+  integrator->set_path_guiding_fraction(get_float(cscene, "path_guiding_fraction"));
+  integrator->set_path_guiding_training_samples(
+      get_int(cscene, "path_guiding_training_samples"));
 
   SamplingPattern sampling_pattern = (SamplingPattern)get_enum(
       cscene, "sampling_pattern", SAMPLING_NUM_PATTERNS, SAMPLING_PATTERN_SOBOL);
@@ -795,6 +800,13 @@ SceneParams BlenderSync::get_scene_params(BL::Scene &b_scene, bool background)
     params.texture_limit = 0;
   }
 
+  params.texture_cache.use_cache = get_boolean(cscene, "use_texture_cache");
+  params.texture_cache.cache_size = get_int(cscene, "texture_cache_size");
+  params.texture_cache.tile_size = get_int(cscene, "texture_tile_size");
+  params.texture_cache.use_auto_convert = get_boolean(cscene, "texture_auto_convert");
+  params.texture_cache.diffuse_blur = get_float(cscene, "texture_blur_diffuse");
+  params.texture_cache.glossy_blur = get_float(cscene, "texture_blur_glossy");
+
   params.bvh_layout = DebugFlags().cpu.bvh_layout;
 
   params.background = background;
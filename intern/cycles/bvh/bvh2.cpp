@@ -42,10 +42,30 @@ int BVHStackEntry::encodeIdx() const
 BVH2::BVH2(const BVHParams &params_,
            const vector<Geometry *> &geometry_,
            const vector<Object *> &objects_)
-    : BVH(params_, geometry_, objects_)
+    : BVH(params_, geometry_, objects_),
+      num_top_level_prims(0),
+      num_top_level_tri_verts(0),
+      num_top_level_nodes(0),
+      num_top_level_leaf_nodes(0),
+      build_node_area(0.0f),
+      refit_node_area(0.0f)
 {
 }
 
+/* Refit the top level BVH until its nodes got this much larger than after building. */
+static const float BVH_REFIT_MAX_NODE_AREA = 1.5f;
+
+/* Sum of the areas of all nodes below the root. */
+static float bvh_subtree_area(const BVHNode *node)
+{
+  float area = 0.0f;
+  for (int i = 0; i < node->num_children(); i++) {
+    const BVHNode *child = node->get_child(i);
+    area += child->bounds.safe_area() + bvh_subtree_area(child);
+  }
+  return area;
+}
+
 void BVH2::build(Progress &progress, Stats *)
 {
   progress.set_substatus("Building BVH");
@@ -94,12 +114,61 @@ void BVH2::build(Progress &progress, Stats *)
   progress.set_substatus("Packing BVH nodes");
   pack_nodes(root);
 
+  const float root_area = root->bounds.safe_area();
+  build_node_area = (root_area > 0.0f) ? bvh_subtree_area(root) / root_area : 0.0f;
+  refit_node_area = build_node_area;
+
   /* free build nodes */
   root->deleteSubtree();
 }
 
 void BVH2::refit(Progress &progress)
 {
+  if (params.top_level) {
+    /* Instance BVHs may have been refit themselves, so they are merged again afterwards. */
+    pack.prim_index.resize(num_top_level_prims);
+    pack.prim_type.resize(num_top_level_prims);
+    pack.prim_object.resize(num_top_level_prims);
+    pack.prim_visibility.resize(num_top_level_prims);
+    pack.prim_tri_index.resize(num_top_level_prims);
+    pack.prim_tri_verts.resize(num_top_level_tri_verts);
+    if (pack.prim_time.size()) {
+      pack.prim_time.resize(num_top_level_prims);
+    }
+    pack.nodes.resize(num_top_level_nodes);
+    pack.leaf_nodes.resize(num_top_level_leaf_nodes);
+
+    /* Primitive indices of the top level were already offset to the global arrays, so the
+     * triangles are packed here instead of with pack_primitives(). */
+    progress.set_substatus("Packing BVH primitives");
+    for (size_t i = 0; i < num_top_level_prims; i++) {
+      if (pack.prim_index[i] == -1) {
+        continue;
+      }
+
+      const Object *ob = objects[pack.prim_object[i]];
+      if (pack.prim_type[i] & PRIMITIVE_ALL_TRIANGLE) {
+        const Mesh *mesh = static_cast<const Mesh *>(ob->get_geometry());
+        const Mesh::Triangle t = mesh->get_triangle(pack.prim_index[i] - mesh->prim_offset);
+        float4 *tri_verts = &pack.prim_tri_verts[pack.prim_tri_index[i]];
+        tri_verts[0] = float3_to_float4(mesh->verts[t.v[0]]);
+        tri_verts[1] = float3_to_float4(mesh->verts[t.v[1]]);
+        tri_verts[2] = float3_to_float4(mesh->verts[t.v[2]]);
+      }
+      pack.prim_visibility[i] = ob->visibility_for_tracing();
+    }
+
+    if (progress.get_cancel())
+      return;
+
+    progress.set_substatus("Refitting BVH nodes");
+    refit_nodes();
+
+    progress.set_substatus("Packing BVH instances");
+    pack_instances(num_top_level_nodes, num_top_level_leaf_nodes);
+    return;
+  }
+
   progress.set_substatus("Packing BVH primitives");
   pack_primitives();
 
@@ -110,6 +179,11 @@ void BVH2::refit(Progress &progress)
   refit_nodes();
 }
 
+bool BVH2::can_refit() const
+{
+  return refit_node_area <= build_node_area * BVH_REFIT_MAX_NODE_AREA;
+}
+
 BVHNode *BVH2::widen_children_nodes(const BVHNode *root)
 {
   return const_cast<BVHNode *>(root);
@@ -260,7 +334,21 @@ void BVH2::pack_nodes(const BVHNode *root)
   pack.leaf_nodes.clear();
   /* For top level BVH, first merge existing BVH's so we know the offsets. */
   if (params.top_level) {
-    pack_instances(node_size, num_leaf_nodes * BVH_NODE_LEAF_SIZE);
+    /* Adjust primitive index to point to the triangle in the global array, for
+     * geometry with transform applied and already in the top level BVH.
+     */
+    for (size_t i = 0; i < pack.prim_index.size(); i++) {
+      if (pack.prim_index[i] != -1) {
+        pack.prim_index[i] += objects[pack.prim_object[i]]->get_geometry()->prim_offset;
+      }
+    }
+
+    num_top_level_prims = pack.prim_index.size();
+    num_top_level_tri_verts = pack.prim_tri_verts.size();
+    num_top_level_nodes = node_size;
+    num_top_level_leaf_nodes = num_leaf_nodes * BVH_NODE_LEAF_SIZE;
+
+    pack_instances(num_top_level_nodes, num_top_level_leaf_nodes);
   }
   else {
     pack.nodes.resize(node_size);
@@ -315,11 +403,13 @@ void BVH2::pack_nodes(const BVHNode *root)
 
 void BVH2::refit_nodes()
 {
-  assert(!params.top_level);
-
   BoundBox bbox = BoundBox::empty;
   uint visibility = 0;
+  refit_node_area = 0.0f;
   refit_node(0, (pack.root_index == -1) ? true : false, bbox, visibility);
+
+  const float root_area = bbox.safe_area();
+  refit_node_area = (root_area > 0.0f) ? refit_node_area / root_area : 0.0f;
 }
 
 void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
@@ -331,7 +421,13 @@ void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
     const int c0 = data[0].x;
     const int c1 = data[0].y;
 
-    refit_primitives(c0, c1, bbox, visibility);
+    if (c0 < 0) {
+      /* Object instance in the top level BVH. */
+      refit_primitives(~c0, ~c0 + 1, bbox, visibility);
+    }
+    else {
+      refit_primitives(c0, c1, bbox, visibility);
+    }
 
     /* TODO(sergey): De-duplicate with pack_leaf(). */
     float4 leaf_data[BVH_NODE_LEAF_SIZE];
@@ -355,6 +451,8 @@ void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
     refit_node((c0 < 0) ? -c0 - 1 : c0, (c0 < 0), bbox0, visibility0);
     refit_node((c1 < 0) ? -c1 - 1 : c1, (c1 < 0), bbox1, visibility1);
 
+    refit_node_area += bbox0.safe_area() + bbox1.safe_area();
+
     if (is_unaligned) {
       Transform aligned_space = transform_identity();
       pack_unaligned_node(
@@ -503,15 +601,6 @@ void BVH2::pack_primitives()
 
 void BVH2::pack_instances(size_t nodes_size, size_t leaf_nodes_size)
 {
-  /* Adjust primitive index to point to the triangle in the global array, for
-   * geometry with transform applied and already in the top level BVH.
-   */
-  for (size_t i = 0; i < pack.prim_index.size(); i++) {
-    if (pack.prim_index[i] != -1) {
-      pack.prim_index[i] += objects[pack.prim_object[i]]->get_geometry()->prim_offset;
-    }
-  }
-
   /* track offsets of instanced BVH data in global array */
   size_t prim_offset = pack.prim_index.size();
   size_t nodes_offset = nodes_size;
@@ -48,6 +48,10 @@ class BVH2 : public BVH {
   void build(Progress &progress, Stats *stats);
   void refit(Progress &progress);
 
+  /* Refitting degrades the tree as primitives move away from where it was built, false when
+   * the tree should be built again instead. */
+  bool can_refit() const;
+
   PackedBVH pack;
 
  protected:
@@ -103,6 +107,16 @@ class BVH2 : public BVH {
 
   /* merge instance BVH's */
   void pack_instances(size_t nodes_size, size_t leaf_nodes_size);
+
+  /* Size of the top level part of the packed arrays, instance BVHs are merged after it. */
+  size_t num_top_level_prims;
+  size_t num_top_level_tri_verts;
+  size_t num_top_level_nodes;
+  size_t num_top_level_leaf_nodes;
+
+  /* Sum of the inner node areas relative to the root area, after building and refitting. */
+  float build_node_area;
+  float refit_node_area;
 };
 
 CCL_NAMESPACE_END
@@ -343,8 +343,12 @@ void BVHEmbree::build(Progress &progress, Stats *stats, RTCDevice rtc_device_)
                                                         RTC_BUILD_QUALITY_MEDIUM);
   rtcSetSceneBuildQuality(scene, build_quality);
 
+  object_visibility.clear();
+
   int i = 0;
   foreach (Object *ob, objects) {
+    object_visibility.push_back(ob->visibility_for_tracing());
+
     if (params.top_level) {
       if (!ob->is_traceable()) {
         ++i;
@@ -396,12 +400,24 @@ void BVHEmbree::add_instance(Object *ob, int i)
   BVHEmbree *instance_bvh = (BVHEmbree *)(ob->get_geometry()->bvh);
   assert(instance_bvh != NULL);
 
+  RTCGeometry geom_id = rtcNewGeometry(rtc_device, RTC_GEOMETRY_TYPE_INSTANCE);
+  rtcSetGeometryInstancedScene(geom_id, instance_bvh->scene);
+  set_instance_transform(geom_id, ob);
+
+  rtcSetGeometryUserData(geom_id, (void *)instance_bvh->scene);
+  rtcSetGeometryMask(geom_id, ob->visibility_for_tracing());
+
+  rtcCommitGeometry(geom_id);
+  rtcAttachGeometryByID(scene, geom_id, i * 2);
+  rtcReleaseGeometry(geom_id);
+}
+
+void BVHEmbree::set_instance_transform(RTCGeometry geom_id, const Object *ob)
+{
   const size_t num_object_motion_steps = ob->use_motion() ? ob->get_motion().size() : 1;
   const size_t num_motion_steps = min(num_object_motion_steps, RTC_MAX_TIME_STEP_COUNT);
   assert(num_object_motion_steps <= RTC_MAX_TIME_STEP_COUNT);
 
-  RTCGeometry geom_id = rtcNewGeometry(rtc_device, RTC_GEOMETRY_TYPE_INSTANCE);
-  rtcSetGeometryInstancedScene(geom_id, instance_bvh->scene);
   rtcSetGeometryTimeStepCount(geom_id, num_motion_steps);
 
   if (ob->use_motion()) {
@@ -425,13 +441,6 @@ void BVHEmbree::add_instance(Object *ob, int i)
     rtcSetGeometryTransform(
         geom_id, 0, RTC_FORMAT_FLOAT3X4_ROW_MAJOR, (const float *)&ob->get_tfm());
   }
-
-  rtcSetGeometryUserData(geom_id, (void *)instance_bvh->scene);
-  rtcSetGeometryMask(geom_id, ob->visibility_for_tracing());
-
-  rtcCommitGeometry(geom_id);
-  rtcAttachGeometryByID(scene, geom_id, i * 2);
-  rtcReleaseGeometry(geom_id);
 }
 
 void BVHEmbree::add_triangles(const Object *ob, const Mesh *mesh, int i)
@@ -677,12 +686,27 @@ void BVHEmbree::refit(Progress &progress)
     if (!params.top_level || (ob->is_traceable() && !ob->get_geometry()->is_instanced())) {
       Geometry *geom = ob->get_geometry();
 
+      /* Geometry that didn't change keeps its BVH, only the mask is updated when the
+       * visibility of the object changed. */
+      const uint visibility = ob->visibility_for_tracing();
+      const bool update_geom = !params.top_level || geom->is_modified();
+      if (!update_geom && visibility == object_visibility[geom_id / 2]) {
+        geom_id += 2;
+        continue;
+      }
+      object_visibility[geom_id / 2] = visibility;
+
       if (geom->geometry_type == Geometry::MESH || geom->geometry_type == Geometry::VOLUME) {
         Mesh *mesh = static_cast<Mesh *>(geom);
         if (mesh->num_triangles() > 0) {
           RTCGeometry geom = rtcGetGeometry(scene, geom_id);
-          set_tri_vertex_buffer(geom, mesh, true);
-          rtcSetGeometryUserData(geom, (void *)mesh->optix_prim_offset);
+          if (update_geom) {
+            set_tri_vertex_buffer(geom, mesh, true);
+            rtcSetGeometryUserData(geom, (void *)mesh->optix_prim_offset);
+            /* Topology is unchanged, so refit instead of building the BVH again. */
+            rtcSetGeometryBuildQuality(geom, RTC_BUILD_QUALITY_REFIT);
+          }
+          rtcSetGeometryMask(geom, visibility);
           rtcCommitGeometry(geom);
         }
       }
@@ -690,12 +714,23 @@ void BVHEmbree::refit(Progress &progress)
         Hair *hair = static_cast<Hair *>(geom);
         if (hair->num_curves() > 0) {
           RTCGeometry geom = rtcGetGeometry(scene, geom_id + 1);
-          set_curve_vertex_buffer(geom, hair, true);
-          rtcSetGeometryUserData(geom, (void *)hair->optix_prim_offset);
+          if (update_geom) {
+            set_curve_vertex_buffer(geom, hair, true);
+            rtcSetGeometryUserData(geom, (void *)hair->optix_prim_offset);
+          }
+          rtcSetGeometryMask(geom, visibility);
           rtcCommitGeometry(geom);
         }
       }
     }
+    else if (ob->is_traceable()) {
+      /* Instances are committed again for the bounds of refit instanced scenes, and for
+       * changed transforms. */
+      RTCGeometry geom = rtcGetGeometry(scene, geom_id);
+      set_instance_transform(geom, ob);
+      rtcSetGeometryMask(geom, ob->visibility_for_tracing());
+      rtcCommitGeometry(geom);
+    }
     geom_id += 2;
   }
 
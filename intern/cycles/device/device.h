@@ -375,6 +375,12 @@ class Device {
     return NULL;
   }
 
+  /* learned path guiding field, only for CPU device */
+  virtual void *path_guiding_memory()
+  {
+    return NULL;
+  }
+
   /* load/compile kernels, must be called before adding tasks */
   virtual bool load_kernels(const DeviceRequestedFeatures & /*requested_features*/)
   {
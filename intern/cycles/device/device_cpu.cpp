@@ -51,6 +51,7 @@
 
 #include "render/buffers.h"
 #include "render/coverage.h"
+#include "render/path_guiding.h"
 
 #include "util/util_debug.h"
 #include "util/util_foreach.h"
@@ -64,6 +65,7 @@
 #include "util/util_system.h"
 #include "util/util_task.h"
 #include "util/util_thread.h"
+#include "util/util_time.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -184,6 +186,9 @@ class CPUDevice : public Device {
 #ifdef WITH_OSL
   OSLGlobals osl_globals;
 #endif
+#ifdef __PATH_GUIDING__
+  PathGuidingField path_guiding_field;
+#endif
 #ifdef WITH_OPENIMAGEDENOISE
   oidn::DeviceRef oidn_device;
   oidn::FilterRef oidn_filter;
@@ -196,6 +201,15 @@ class CPUDevice : public Device {
 
   bool use_split_kernel;
 
+  /* Time render threads spent on tiles, to report how long they were idle. */
+  struct ThreadRenderTime {
+    double start;
+    double end;
+    double busy;
+  };
+  thread_mutex thread_render_times_mutex;
+  vector<ThreadRenderTime> thread_render_times;
+
   DeviceRequestedFeatures requested_features;
 
   KernelFunctions<void (*)(KernelGlobals *, float *, int, int, int, int, int)> path_trace_kernel;
@@ -312,6 +326,11 @@ class CPUDevice : public Device {
 #ifdef WITH_OSL
     kernel_globals.osl = &osl_globals;
 #endif
+#ifdef __PATH_GUIDING__
+    path_guiding_field_init(&path_guiding_field);
+    kernel_globals.path_guiding = &path_guiding_field;
+    kernel_globals.path_guiding_distribution = NULL;
+#endif
 #ifdef WITH_EMBREE
     embree_device = rtcNewDevice("verbose=0");
 #endif
@@ -357,6 +376,9 @@ class CPUDevice : public Device {
 #endif
     task_pool.cancel();
     texture_info.free();
+#ifdef __PATH_GUIDING__
+    path_guiding_field_free(&path_guiding_field);
+#endif
   }
 
   virtual bool show_samples() const override
@@ -549,6 +571,15 @@ class CPUDevice : public Device {
 #endif
   }
 
+  virtual void *path_guiding_memory() override
+  {
+#ifdef __PATH_GUIDING__
+    return &path_guiding_field;
+#else
+    return NULL;
+#endif
+  }
+
   void build_bvh(BVH *bvh, Progress &progress, bool refit) override
   {
 #ifdef WITH_EMBREE
@@ -961,6 +992,12 @@ class CPUDevice : public Device {
         break;
       }
 
+      /* Give part of the tile to a thread that ran out of tiles. Coverage is accumulated for
+       * the whole tile and can't be split. */
+      if (tile.can_split && !use_coverage) {
+        task.split_tile(tile);
+      }
+
       if (tile.task == RenderTile::PATH_TRACE) {
         for (int y = tile.y; y < tile.y + tile.h; y++) {
           for (int x = tile.x; x < tile.x + tile.w; x++) {
@@ -1289,8 +1326,14 @@ class CPUDevice : public Device {
       }
     }
 
+    ThreadRenderTime render_time;
+    render_time.start = time_dt();
+    render_time.busy = 0.0;
+
     RenderTile tile;
     while (task.acquire_tile(this, tile, tile_types)) {
+      const double tile_time_start = time_dt();
+
       if (tile.task == RenderTile::PATH_TRACE) {
         if (use_split_kernel) {
           device_only_memory<uchar> void_buffer(this, "void_buffer");
@@ -1317,6 +1360,8 @@ class CPUDevice : public Device {
         task.update_progress(&tile, tile.w * tile.h);
       }
 
+      render_time.busy += time_dt() - tile_time_start;
+
       task.release_tile(tile);
 
       if (TaskPool::canceled()) {
@@ -1329,6 +1374,12 @@ class CPUDevice : public Device {
       oidn_task_lock.unlock();
     }
 
+    render_time.end = time_dt();
+    {
+      thread_scoped_lock lock(thread_render_times_mutex);
+      thread_render_times.push_back(render_time);
+    }
+
     profiler.remove_state(&kg->profiler);
 
     thread_kernel_globals_free((KernelGlobals *)kgbuffer.device_pointer);
@@ -1465,6 +1516,44 @@ class CPUDevice : public Device {
   virtual void task_wait() override
   {
     task_pool.wait_work();
+
+    report_thread_render_times();
+  }
+
+  void report_thread_render_times()
+  {
+    thread_scoped_lock lock(thread_render_times_mutex);
+
+    if (thread_render_times.empty()) {
+      return;
+    }
+
+    /* Threads are idle while waiting for tiles, and once they are out of tiles until the last
+     * thread finished. */
+    double start = DBL_MAX;
+    double end = 0.0;
+    foreach (const ThreadRenderTime &render_time, thread_render_times) {
+      start = min(start, render_time.start);
+      end = max(end, render_time.end);
+    }
+
+    double total_time = 0.0;
+    double total_idle = 0.0;
+    for (size_t i = 0; i < thread_render_times.size(); i++) {
+      const ThreadRenderTime &render_time = thread_render_times[i];
+      const double idle = (end - render_time.start) - render_time.busy;
+      total_time += end - render_time.start;
+      total_idle += idle;
+      VLOG(2) << "Render thread " << i << " busy " << render_time.busy << " seconds, idle "
+              << idle << " seconds.";
+    }
+
+    if (total_time > 0.0) {
+      VLOG(1) << "Render threads were idle " << 100.0 * total_idle / total_time << "% of "
+              << end - start << " seconds.";
+    }
+
+    thread_render_times.clear();
   }
 
   virtual void task_cancel() override
@@ -1484,6 +1573,9 @@ class CPUDevice : public Device {
     }
     kg.decoupled_volume_steps_index = 0;
     kg.coverage_asset = kg.coverage_object = kg.coverage_material = NULL;
+#ifdef __PATH_GUIDING__
+    kg.path_guiding_distribution = NULL;
+#endif
 #ifdef WITH_OSL
     OSLShader::thread_init(&kg, &kernel_globals, &osl_globals);
 #endif
@@ -310,6 +310,14 @@ class MultiDevice : public Device {
     return devices.front().device->osl_memory();
   }
 
+  virtual void *path_guiding_memory() override
+  {
+    if (devices.size() > 1) {
+      return NULL;
+    }
+    return devices.front().device->path_guiding_memory();
+  }
+
   bool is_resident(device_ptr key, Device *sub_device) override
   {
     foreach (SubDevice &sub, devices) {
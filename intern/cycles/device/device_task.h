@@ -161,6 +161,7 @@ class DeviceTask {
   function<void(RenderTile &)> release_tile;
   function<bool()> get_cancel;
   function<bool()> get_tile_stolen;
+  function<bool(RenderTile &)> split_tile;
   function<void(RenderTileNeighbors &, Device *)> map_neighbor_tiles;
   function<void(RenderTileNeighbors &, Device *)> unmap_neighbor_tiles;
 
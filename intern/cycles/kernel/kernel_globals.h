@@ -78,6 +78,13 @@ typedef struct KernelGlobals {
   CoverageMap *coverage_material;
   CoverageMap *coverage_asset;
 
+#  ifdef __PATH_GUIDING__
+  /* Learned distributions for path guiding, shared by all threads. */
+  PathGuidingField *path_guiding;
+  /* Distribution guiding the bounce at the current path vertex, NULL if not guided. */
+  const PathGuidingDistribution *path_guiding_distribution;
+#  endif
+
   /* split kernel */
   SplitData split_data;
   SplitParams split_param_data;
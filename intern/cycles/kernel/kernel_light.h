@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include "kernel_light_tree.h"
+
 #include "kernel_light_background.h"
 
 CCL_NAMESPACE_BEGIN
@@ -153,7 +155,7 @@ ccl_device_inline bool lamp_light_sample(
     }
   }
 
-  ls->pdf *= kernel_data.integrator.pdf_lights;
+  ls->pdf *= light_select_pdf_lamp(kg, lamp, P);
 
   return (ls->pdf > 0.0f);
 }
@@ -291,7 +293,7 @@ ccl_device bool lamp_light_eval(
     return false;
   }
 
-  ls->pdf *= kernel_data.integrator.pdf_lights;
+  ls->pdf *= light_select_pdf_lamp(kg, lamp, P);
 
   return true;
 }
@@ -328,12 +330,36 @@ ccl_device_inline bool triangle_world_space_vertices(
   return has_motion;
 }
 
-ccl_device_inline float triangle_light_pdf_area(KernelGlobals *kg,
+/* Probability of selecting the triangle per unit area, with motion blur relative to the area at
+ * the center of the shutter. Without light tree this is the same for all triangles. */
+ccl_device_inline float triangle_light_pdf_select(KernelGlobals *kg,
+                                                  int object,
+                                                  int prim,
+                                                  const float3 P,
+                                                  bool has_motion,
+                                                  float area)
+{
+  if (!kernel_data.integrator.use_light_tree) {
+    return kernel_data.integrator.pdf_triangles;
+  }
+
+  if (has_motion) {
+    float3 V[3];
+    triangle_world_space_vertices(kg, object, prim, -1.0f, V);
+    area = triangle_area(V[0], V[1], V[2]);
+  }
+  if (UNLIKELY(area == 0.0f)) {
+    return 0.0f;
+  }
+  return light_select_pdf_triangle(kg, object, prim, P) / area;
+}
+
+ccl_device_inline float triangle_light_pdf_area(const float pdf_triangles,
                                                 const float3 Ng,
                                                 const float3 I,
                                                 float t)
 {
-  float pdf = kernel_data.integrator.pdf_triangles;
+  float pdf = pdf_triangles;
   float cos_pi = fabsf(dot(Ng, I));
 
   if (cos_pi == 0.0f)
@@ -358,10 +384,13 @@ ccl_device_forceinline float triangle_light_pdf(KernelGlobals *kg, ShaderData *s
   const float3 N = cross(e0, e1);
   const float distance_to_plane = fabsf(dot(N, sd->I * t)) / dot(N, N);
 
+  /* sd contains the point on the light source
+   * calculate Px, the point that we're shading */
+  const float3 Px = sd->P + sd->I * t;
+  const float pdf_triangles = triangle_light_pdf_select(
+      kg, sd->object, sd->prim, Px, has_motion, 0.5f * len(N));
+
   if (longest_edge_squared > distance_to_plane * distance_to_plane) {
-    /* sd contains the point on the light source
-     * calculate Px, the point that we're shading */
-    const float3 Px = sd->P + sd->I * t;
     const float3 v0_p = V[0] - Px;
     const float3 v1_p = V[1] - Px;
     const float3 v2_p = V[2] - Px;
@@ -389,12 +418,12 @@ ccl_device_forceinline float triangle_light_pdf(KernelGlobals *kg, ShaderData *s
       else {
         area = 0.5f * len(N);
       }
-      const float pdf = area * kernel_data.integrator.pdf_triangles;
+      const float pdf = area * pdf_triangles;
       return pdf / solid_angle;
     }
   }
   else {
-    float pdf = triangle_light_pdf_area(kg, sd->Ng, sd->I, t);
+    float pdf = triangle_light_pdf_area(pdf_triangles, sd->Ng, sd->I, t);
     if (has_motion) {
       const float area = 0.5f * len(N);
       if (UNLIKELY(area == 0.0f)) {
@@ -435,6 +464,7 @@ ccl_device_forceinline void triangle_light_sample(KernelGlobals *kg,
   float Nl = 0.0f;
   ls->Ng = safe_normalize_len(N0, &Nl);
   float area = 0.5f * Nl;
+  const float pdf_triangles = triangle_light_pdf_select(kg, object, prim, P, has_motion, area);
 
   /* flip normal if necessary */
   const int object_flag = kernel_tex_fetch(__object_flag, object);
@@ -542,7 +572,7 @@ ccl_device_forceinline void triangle_light_sample(KernelGlobals *kg,
         triangle_world_space_vertices(kg, object, prim, -1.0f, V);
         area = triangle_area(V[0], V[1], V[2]);
       }
-      const float pdf = area * kernel_data.integrator.pdf_triangles;
+      const float pdf = area * pdf_triangles;
       ls->pdf = pdf / solid_angle;
     }
   }
@@ -564,7 +594,7 @@ ccl_device_forceinline void triangle_light_sample(KernelGlobals *kg,
     ls->P = u * V[0] + v * V[1] + t * V[2];
     /* compute incoming direction, distance and pdf */
     ls->D = normalize_len(ls->P - P, &ls->t);
-    ls->pdf = triangle_light_pdf_area(kg, ls->Ng, -ls->D, ls->t);
+    ls->pdf = triangle_light_pdf_area(pdf_triangles, ls->Ng, -ls->D, ls->t);
     if (has_motion && area != 0.0f) {
       /* scale the PDF.
        * area = the area the sample was taken from
@@ -634,7 +664,16 @@ ccl_device_noinline bool light_sample(KernelGlobals *kg,
 {
   if (lamp < 0) {
     /* sample index */
-    int index = light_distribution_sample(kg, &randu);
+    int index;
+    if (kernel_data.integrator.use_light_tree) {
+      index = light_tree_sample(kg, P, &randu);
+      if (index < 0) {
+        return false;
+      }
+    }
+    else {
+      index = light_distribution_sample(kg, &randu);
+    }
 
     /* fetch light data */
     const ccl_global KernelLightDistribution *kdistribution = &kernel_tex_fetch(
@@ -424,7 +424,7 @@ ccl_device float background_light_pdf(KernelGlobals *kg, float3 P, float3 direct
   float pdf_fac = (portal_method_pdf + sun_method_pdf + map_method_pdf);
   if (pdf_fac == 0.0f) {
     /* Use uniform as a fallback if we can't use any strategy. */
-    return kernel_data.integrator.pdf_lights / M_4PI_F;
+    return light_select_pdf_distant(kg) / M_4PI_F;
   }
 
   pdf_fac = 1.0f / pdf_fac;
@@ -440,7 +440,7 @@ ccl_device float background_light_pdf(KernelGlobals *kg, float3 P, float3 direct
     pdf += background_map_pdf(kg, direction) * map_method_pdf;
   }
 
-  return pdf * kernel_data.integrator.pdf_lights;
+  return pdf * light_select_pdf_distant(kg);
 }
 
 #endif
@@ -0,0 +1,190 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+CCL_NAMESPACE_BEGIN
+
+/* Light Tree
+ *
+ * Selects emitters proportional to an estimate of their contribution at the shading point,
+ * based on "Importance Sampling of Many Lights with Adaptive Tree Splitting" by Conty and
+ * Kulla. The tree contains triangles and lamps with a position, distant and background lights
+ * are stored at the end of the light distribution and selected uniformly.
+ *
+ * The selection probability depends on the shading point, so everything computing the PDF of
+ * a light sample for MIS must go through the `light_select_pdf_*` functions below. */
+
+/* Probability of selecting a distant or background light. */
+ccl_device_inline float light_tree_distant_probability(KernelGlobals *kg)
+{
+  const int num_distant = kernel_data.integrator.num_distant_lights;
+  if (num_distant == 0) {
+    return 0.0f;
+  }
+  return (kernel_data.integrator.num_distribution > num_distant) ? 0.5f : 1.0f;
+}
+
+/* Conservative estimate of the contribution of all emitters in the node at P. */
+ccl_device float light_tree_node_importance(KernelGlobals *kg, int node_index, float3 P)
+{
+  const ccl_global KernelLightTreeNode *knode = &kernel_tex_fetch(__light_tree_nodes,
+                                                                  node_index);
+  const float3 bounds_min = make_float3(
+      knode->bounds_min[0], knode->bounds_min[1], knode->bounds_min[2]);
+  const float3 bounds_max = make_float3(
+      knode->bounds_max[0], knode->bounds_max[1], knode->bounds_max[2]);
+  const float3 centroid = 0.5f * (bounds_min + bounds_max);
+  const float radius_sq = 0.25f * len_squared(bounds_max - bounds_min);
+
+  const float3 V = P - centroid;
+  const float distance_sq = len_squared(V);
+
+  if (distance_sq <= radius_sq) {
+    /* Inside the bounding sphere, any orientation is possible. */
+    return (radius_sq > 0.0f) ? knode->energy / radius_sq : knode->energy;
+  }
+
+  /* Angle between the axis and the direction to P, reduced by the spread of the normals and
+   * the angle the bounding sphere subtends from P. */
+  const float3 axis = make_float3(knode->axis[0], knode->axis[1], knode->axis[2]);
+  const float cos_theta = clamp(dot(axis, V) / sqrtf(distance_sq), -1.0f, 1.0f);
+  const float sin_theta_u = sqrtf(radius_sq / distance_sq);
+  const float theta = fast_acosf(cos_theta);
+  const float theta_u = fast_asinf(sin_theta_u);
+  const float theta_prime = max(theta - knode->theta_o - theta_u, 0.0f);
+
+  if (theta_prime > knode->theta_e) {
+    return 0.0f;
+  }
+
+  return knode->energy * fast_cosf(theta_prime) / distance_sq;
+}
+
+/* Pick a light distribution index, returns -1 when no emitter contributes to P.
+ * Rescales `randu` so it can be reused for sampling the emitter. */
+ccl_device int light_tree_sample(KernelGlobals *kg, float3 P, float *randu)
+{
+  const int num_distribution = kernel_data.integrator.num_distribution;
+  const int num_distant = kernel_data.integrator.num_distant_lights;
+  const float distant_probability = light_tree_distant_probability(kg);
+  float r = *randu;
+
+  if (r < distant_probability) {
+    /* Distant lights are at the end of the distribution, pick one uniformly. */
+    r = r / distant_probability * num_distant;
+    const int distant = min((int)r, num_distant - 1);
+    *randu = r - distant;
+    return num_distribution - num_distant + distant;
+  }
+  r = (r - distant_probability) / (1.0f - distant_probability);
+
+  int node_index = 0;
+  int child_index = kernel_tex_fetch(__light_tree_nodes, 0).child_index;
+
+  while (child_index >= 0) {
+    const float importance_left = light_tree_node_importance(kg, node_index + 1, P);
+    const float importance_right = light_tree_node_importance(kg, child_index, P);
+    const float importance_total = importance_left + importance_right;
+
+    if (importance_total == 0.0f) {
+      return -1;
+    }
+
+    const float probability_left = importance_left / importance_total;
+    if (r < probability_left) {
+      node_index = node_index + 1;
+      r = r / probability_left;
+    }
+    else {
+      node_index = child_index;
+      r = (r - probability_left) / (1.0f - probability_left);
+    }
+    /* Avoid reaching 1.0 through float precision loss after many levels. */
+    r = min(r, 1.0f - 1e-7f);
+
+    child_index = kernel_tex_fetch(__light_tree_nodes, node_index).child_index;
+  }
+
+  *randu = r;
+  return ~child_index;
+}
+
+/* Probability of #light_tree_sample selecting the emitter in the given leaf. */
+ccl_device float light_tree_pdf(KernelGlobals *kg, float3 P, int node_index)
+{
+  float pdf = 1.0f - light_tree_distant_probability(kg);
+  int parent_index = kernel_tex_fetch(__light_tree_nodes, node_index).parent_index;
+
+  while (parent_index >= 0) {
+    const int sibling_index = (node_index == parent_index + 1) ?
+                                  kernel_tex_fetch(__light_tree_nodes, parent_index).child_index :
+                                  parent_index + 1;
+    const float importance = light_tree_node_importance(kg, node_index, P);
+    const float importance_sibling = light_tree_node_importance(kg, sibling_index, P);
+    const float importance_total = importance + importance_sibling;
+
+    if (importance == 0.0f) {
+      return 0.0f;
+    }
+    pdf *= importance / importance_total;
+
+    node_index = parent_index;
+    parent_index = kernel_tex_fetch(__light_tree_nodes, node_index).parent_index;
+  }
+
+  return pdf;
+}
+
+/* Light Selection PDF */
+
+/* Probability of selecting a distant or background light. */
+ccl_device_inline float light_select_pdf_distant(KernelGlobals *kg)
+{
+  if (kernel_data.integrator.use_light_tree) {
+    return light_tree_distant_probability(kg) / kernel_data.integrator.num_distant_lights;
+  }
+  return kernel_data.integrator.pdf_lights;
+}
+
+/* Probability of selecting the lamp for shading point P. */
+ccl_device_inline float light_select_pdf_lamp(KernelGlobals *kg, int lamp, float3 P)
+{
+  if (kernel_data.integrator.use_light_tree) {
+    const int leaf_index = kernel_tex_fetch(__light_tree_leaf, lamp);
+    return (leaf_index >= 0) ? light_tree_pdf(kg, P, leaf_index) : light_select_pdf_distant(kg);
+  }
+  return kernel_data.integrator.pdf_lights;
+}
+
+/* Probability of selecting the triangle for shading point P, only valid with a light tree.
+ *
+ * Per object, the leaf table stores the offset of its triangle leaves and the primitive offset
+ * of its geometry, see #LightManager::device_update_tree. */
+ccl_device_inline float light_select_pdf_triangle(KernelGlobals *kg,
+                                                  int object,
+                                                  int prim,
+                                                  float3 P)
+{
+  const int object_offset = kernel_data.integrator.num_all_lights + object * 2;
+  const int table_offset = kernel_tex_fetch(__light_tree_leaf, object_offset);
+  if (table_offset < 0) {
+    return 0.0f;
+  }
+  const int prim_offset = kernel_tex_fetch(__light_tree_leaf, object_offset + 1);
+  const int leaf_index = kernel_tex_fetch(__light_tree_leaf, table_offset + prim - prim_offset);
+  return (leaf_index >= 0) ? light_tree_pdf(kg, P, leaf_index) : 0.0f;
+}
+
+CCL_NAMESPACE_END
@@ -519,6 +519,11 @@ ccl_device_forceinline void kernel_path_integrate(KernelGlobals *kg,
   /* Shader data memory used for both volumes and surfaces, saves stack space. */
   ShaderData sd;
 
+#  ifdef __PATH_GUIDING__
+  PathGuidingPath guiding_path;
+  path_guiding_path_init(kg, &guiding_path, state);
+#  endif
+
 #  ifdef __SUBSURFACE__
   SubsurfaceIndirectRays ss_indirect;
   kernel_path_subsurface_init_indirect(&ss_indirect);
@@ -612,6 +617,11 @@ ccl_device_forceinline void kernel_path_integrate(KernelGlobals *kg,
         }
 #  endif /* __SUBSURFACE__ */
 
+#  ifdef __PATH_GUIDING__
+        /* Distribution for the bounce, which direct lighting needs for MIS as well. */
+        kg->path_guiding_distribution = path_guiding_distribution(kg, &sd);
+#  endif
+
 #  ifdef __EMISSION__
         /* direct lighting */
         kernel_path_surface_connect_light(kg, &sd, emission_sd, throughput, state, L);
@@ -624,6 +634,10 @@ ccl_device_forceinline void kernel_path_integrate(KernelGlobals *kg,
       /* compute direct lighting and next bounce */
       if (!kernel_path_surface_bounce(kg, &sd, &throughput, state, &L->state, ray))
         break;
+
+#  ifdef __PATH_GUIDING__
+      path_guiding_path_add_vertex(kg, &guiding_path, &sd, state, ray, throughput, L);
+#  endif
     }
 
 #  ifdef __SUBSURFACE__
@@ -631,6 +645,10 @@ ccl_device_forceinline void kernel_path_integrate(KernelGlobals *kg,
      * stack memory than invoking kernel_path_indirect.
      */
     if (ss_indirect.num_rays) {
+#    ifdef __PATH_GUIDING__
+      /* Radiance of the remaining rays would be attributed to vertices of the next ray. */
+      path_guiding_path_stop(kg, &guiding_path);
+#    endif
       kernel_path_subsurface_setup_indirect(kg, &ss_indirect, state, ray, L, &throughput);
     }
     else {
@@ -638,6 +656,10 @@ ccl_device_forceinline void kernel_path_integrate(KernelGlobals *kg,
     }
   }
 #  endif /* __SUBSURFACE__ */
+
+#  ifdef __PATH_GUIDING__
+  path_guiding_path_train(kg, &guiding_path, L);
+#  endif
 }
 
 ccl_device void kernel_path_trace(
@@ -0,0 +1,312 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "util/util_atomic.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Path Guiding
+ *
+ * Learns the distribution of incident radiance while rendering, and samples bounces
+ * proportional to it to find indirect light that BSDF sampling rarely hits. Space is divided
+ * into a uniform grid over the scene bounds, and every cell has a histogram of the incident
+ * radiance over the sphere of directions.
+ *
+ * Paths traced for the first samples record the radiance they find at each vertex in the
+ * histograms. Once a cell has enough samples its histogram is turned into a sampling
+ * distribution, which is rebuilt as more samples come in. Bounces then sample a mixture of
+ * the BSDF and the learned distribution, and the mixture PDF is used for MIS, so the result
+ * stays unbiased however well the field is learned. */
+
+/* Radiance found along a path after each of its vertices, to train the field at the end of
+ * the path. */
+#define PATH_GUIDING_MAX_VERTICES 8
+
+typedef struct PathGuidingVertex {
+  float3 P;
+  float3 D;
+  float3 throughput;
+  float3 L_sum;
+  float pdf;
+} PathGuidingVertex;
+
+typedef struct PathGuidingPath {
+  bool record;
+  int num_vertices;
+  PathGuidingVertex vertices[PATH_GUIDING_MAX_VERTICES];
+} PathGuidingPath;
+
+/* Field lookups */
+
+ccl_device_inline int path_guiding_cell_index(const PathGuidingField *field, float3 P)
+{
+  const float3 p = (P - field->bounds_min) * field->inv_cell_size;
+  /* Clamp as float first, positions outside of the bounds map to the closest cell. */
+  const int x = (int)clamp(p.x, 0.0f, (float)(field->resolution[0] - 1));
+  const int y = (int)clamp(p.y, 0.0f, (float)(field->resolution[1] - 1));
+  const int z = (int)clamp(p.z, 0.0f, (float)(field->resolution[2] - 1));
+  return x + field->resolution[0] * (y + field->resolution[1] * z);
+}
+
+ccl_device_inline int path_guiding_direction_to_bin(float3 D)
+{
+  const float u = 0.5f * (D.z + 1.0f);
+  const float v = (atan2f(D.y, D.x) + M_PI_F) * M_1_2PI_F;
+  const int i = clamp((int)(u * PATH_GUIDING_THETA_BINS), 0, PATH_GUIDING_THETA_BINS - 1);
+  const int j = clamp((int)(v * PATH_GUIDING_PHI_BINS), 0, PATH_GUIDING_PHI_BINS - 1);
+  return i * PATH_GUIDING_PHI_BINS + j;
+}
+
+ccl_device_inline float3 path_guiding_bin_to_direction(int bin, float u, float v)
+{
+  const float cos_theta = 2.0f * ((bin / PATH_GUIDING_PHI_BINS) + u) / PATH_GUIDING_THETA_BINS -
+                          1.0f;
+  const float phi = M_2PI_F * ((bin % PATH_GUIDING_PHI_BINS) + v) / PATH_GUIDING_PHI_BINS -
+                    M_PI_F;
+  const float sin_theta = safe_sqrtf(1.0f - cos_theta * cos_theta);
+  return make_float3(sin_theta * cosf(phi), sin_theta * sinf(phi), cos_theta);
+}
+
+/* Distribution guiding the bounce at the shading point, NULL if it should not be guided. */
+ccl_device_inline const PathGuidingDistribution *path_guiding_distribution(KernelGlobals *kg,
+                                                                           const ShaderData *sd)
+{
+  const PathGuidingField *field = kg->path_guiding;
+  if (!kernel_data.integrator.use_path_guiding || field == NULL || field->cells == NULL) {
+    return NULL;
+  }
+  /* Guided directions are only useful if some BSDF can be evaluated for them. */
+  if (!(sd->flag & SD_BSDF_HAS_EVAL)) {
+    return NULL;
+  }
+
+  const PathGuidingCell *cell = field->cells[path_guiding_cell_index(field, sd->P)];
+  return (cell != NULL) ? cell->distribution : NULL;
+}
+
+/* Sampling */
+
+ccl_device_inline float path_guiding_pdf(const PathGuidingDistribution *distribution, float3 D)
+{
+  const int bin = path_guiding_direction_to_bin(D);
+  /* All bins cover the same solid angle. */
+  return (distribution->cdf[bin + 1] - distribution->cdf[bin]) *
+         (PATH_GUIDING_NUM_BINS * 0.25f * M_1_PI_F);
+}
+
+ccl_device_inline float3 path_guiding_sample(const PathGuidingDistribution *distribution,
+                                             float randu,
+                                             float randv,
+                                             float *pdf)
+{
+  /* Find the bin with cdf[bin] <= randu < cdf[bin + 1], which is never empty. */
+  int lo = 0;
+  int hi = PATH_GUIDING_NUM_BINS;
+  while (hi - lo > 1) {
+    const int mid = (lo + hi) >> 1;
+    if (distribution->cdf[mid] <= randu) {
+      lo = mid;
+    }
+    else {
+      hi = mid;
+    }
+  }
+
+  const float bin_probability = distribution->cdf[lo + 1] - distribution->cdf[lo];
+  *pdf = bin_probability * (PATH_GUIDING_NUM_BINS * 0.25f * M_1_PI_F);
+
+  /* Rescale to reuse for the position inside the bin. */
+  const float u = clamp((randu - distribution->cdf[lo]) / bin_probability, 0.0f, 1.0f - 1e-6f);
+  return path_guiding_bin_to_direction(lo, u, randv);
+}
+
+/* Label of a guided direction, for bounce counts and ray visibility. The closure is the one
+ * that contributes most in the direction, like the closure a BSDF sample would come from. */
+ccl_device_inline int path_guiding_label(const ShaderData *sd,
+                                         const ShaderClosure *sc,
+                                         float3 omega_in)
+{
+  const int label = (dot(sd->Ng, omega_in) < 0.0f) ? LABEL_TRANSMIT : LABEL_REFLECT;
+  return label | (CLOSURE_IS_BSDF_DIFFUSE(sc->type) ? LABEL_DIFFUSE : LABEL_GLOSSY);
+}
+
+/* Training */
+
+ccl_device void path_guiding_build_distribution(PathGuidingCell *cell, int index)
+{
+  float sum = 0.0f;
+  for (int i = 0; i < PATH_GUIDING_NUM_BINS; i++) {
+    sum += cell->radiance[i];
+  }
+  if (!(sum > 0.0f) || !isfinite_safe(sum)) {
+    return;
+  }
+
+  PathGuidingDistribution *distribution = (PathGuidingDistribution *)malloc(
+      sizeof(PathGuidingDistribution));
+  if (distribution == NULL) {
+    return;
+  }
+
+  /* Mix in a uniform distribution, so directions that received no radiance so far are still
+   * sampled and learned. */
+  const float uniform = 0.1f * sum / PATH_GUIDING_NUM_BINS;
+  distribution->cdf[0] = 0.0f;
+  for (int i = 0; i < PATH_GUIDING_NUM_BINS; i++) {
+    distribution->cdf[i + 1] = distribution->cdf[i] + cell->radiance[i] + uniform;
+  }
+  const float inv_total = 1.0f / distribution->cdf[PATH_GUIDING_NUM_BINS];
+  for (int i = 1; i < PATH_GUIDING_NUM_BINS; i++) {
+    distribution->cdf[i] *= inv_total;
+  }
+  distribution->cdf[PATH_GUIDING_NUM_BINS] = 1.0f;
+
+  cell->distributions[index] = distribution;
+  /* Publish with a compare and swap, so other threads see the complete distribution. */
+  PathGuidingDistribution *old_distribution = cell->distribution;
+  atomic_cas_ptr((void **)&cell->distribution, old_distribution, distribution);
+}
+
+ccl_device void path_guiding_record(PathGuidingField *field, float3 P, float3 D, float value)
+{
+  const int index = path_guiding_cell_index(field, P);
+  PathGuidingCell *cell = field->cells[index];
+
+  if (cell == NULL) {
+    cell = (PathGuidingCell *)calloc(1, sizeof(PathGuidingCell));
+    if (cell == NULL) {
+      return;
+    }
+    PathGuidingCell *other_cell = (PathGuidingCell *)atomic_cas_ptr(
+        (void **)&field->cells[index], NULL, cell);
+    if (other_cell != NULL) {
+      /* Another thread allocated the cell first. */
+      free(cell);
+      cell = other_cell;
+    }
+  }
+
+  if (value > 0.0f) {
+    atomic_add_and_fetch_float(&cell->radiance[path_guiding_direction_to_bin(D)], value);
+  }
+
+  /* Exactly one thread sees each sample count, so it alone builds the distribution. */
+  const uint num_samples = atomic_fetch_and_add_uint32(&cell->num_samples, 1) + 1;
+  if (num_samples % PATH_GUIDING_MIN_SAMPLES != 0) {
+    return;
+  }
+
+  uint n = num_samples / PATH_GUIDING_MIN_SAMPLES;
+  int index_distribution = 0;
+  while ((n & 3) == 0) {
+    n >>= 2;
+    index_distribution++;
+  }
+  if (n == 1 && index_distribution < PATH_GUIDING_MAX_DISTRIBUTIONS) {
+    path_guiding_build_distribution(cell, index_distribution);
+  }
+}
+
+/* Total radiance of the path so far, without modifying it like path_radiance_clamp_and_sum.
+ * Only differences between totals along the path are used, so splitting light passes does
+ * not matter here. */
+ccl_device_inline float3 path_guiding_radiance_sum(const PathRadiance *L)
+{
+  float3 L_sum = L->emission;
+#ifdef __PASSES__
+  if (L->use_light_pass) {
+    L_sum += L->direct_diffuse + L->direct_glossy + L->direct_transmission + L->direct_volume +
+             L->direct_emission + L->indirect;
+  }
+#endif
+  return L_sum;
+}
+
+ccl_device_inline void path_guiding_path_init(KernelGlobals *kg,
+                                              PathGuidingPath *path,
+                                              const PathState *state)
+{
+  path->record = kernel_data.integrator.use_path_guiding && kg->path_guiding != NULL &&
+                 kg->path_guiding->cells != NULL &&
+                 state->sample < kernel_data.integrator.path_guiding_training_samples;
+  path->num_vertices = 0;
+  kg->path_guiding_distribution = NULL;
+}
+
+/* Remember the vertex after its bounce, to later record the radiance found along the new
+ * direction. */
+ccl_device_inline void path_guiding_path_add_vertex(KernelGlobals *kg,
+                                                    PathGuidingPath *path,
+                                                    const ShaderData *sd,
+                                                    const PathState *state,
+                                                    const Ray *ray,
+                                                    float3 throughput,
+                                                    const PathRadiance *L)
+{
+  kg->path_guiding_distribution = NULL;
+
+  if (!path->record || path->num_vertices == PATH_GUIDING_MAX_VERTICES) {
+    return;
+  }
+  /* Singular and transparent bounces don't tell anything about the distribution. */
+  if (!(sd->flag & SD_BSDF) || (state->flag & (PATH_RAY_SINGULAR | PATH_RAY_TRANSPARENT))) {
+    return;
+  }
+
+  PathGuidingVertex *vertex = &path->vertices[path->num_vertices++];
+  vertex->P = sd->P;
+  vertex->D = ray->D;
+  vertex->throughput = throughput;
+  vertex->L_sum = path_guiding_radiance_sum(L);
+  vertex->pdf = state->ray_pdf;
+}
+
+/* Stop recording vertices, for when radiance found later along the path is not incident
+ * through the directions of new vertices. */
+ccl_device_inline void path_guiding_path_stop(KernelGlobals *kg, PathGuidingPath *path)
+{
+  path->record = false;
+  kg->path_guiding_distribution = NULL;
+}
+
+/* Record the incident radiance found for every vertex of the finished path. */
+ccl_device void path_guiding_path_train(KernelGlobals *kg,
+                                        PathGuidingPath *path,
+                                        const PathRadiance *L)
+{
+  kg->path_guiding_distribution = NULL;
+
+  if (path->num_vertices == 0) {
+    return;
+  }
+
+  const float3 L_end = path_guiding_radiance_sum(L);
+
+  for (int i = 0; i < path->num_vertices; i++) {
+    const PathGuidingVertex *vertex = &path->vertices[i];
+    const float3 L_incident = safe_divide_color(L_end - vertex->L_sum, vertex->throughput);
+    /* Divide by the PDF to estimate the radiance integrated over the bin. */
+    float value = average(L_incident) / vertex->pdf;
+    if (!isfinite_safe(value)) {
+      value = 0.0f;
+    }
+    path_guiding_record(kg->path_guiding, vertex->P, vertex->D, value);
+  }
+
+  path->num_vertices = 0;
+}
+
+CCL_NAMESPACE_END
@@ -32,6 +32,10 @@
 
 #include "kernel/svm/svm.h"
 
+#ifdef __PATH_GUIDING__
+#  include "kernel/kernel_path_guiding.h"
+#endif
+
 CCL_NAMESPACE_BEGIN
 
 /* ShaderData setup from incoming ray */
@@ -629,6 +633,14 @@ ccl_device_inline
     float pdf;
     _shader_bsdf_multi_eval(kg, sd, omega_in, &pdf, NULL, eval, 0.0f, 0.0f);
     if (use_mis) {
+#ifdef __PATH_GUIDING__
+      /* The bounce samples a mixture of the BSDF and the guiding distribution. */
+      if (kg->path_guiding_distribution) {
+        const float fraction = kernel_data.integrator.path_guiding_fraction;
+        pdf = (1.0f - fraction) * pdf +
+              fraction * path_guiding_pdf(kg->path_guiding_distribution, omega_in);
+      }
+#endif
       float weight = power_heuristic(light_pdf, pdf);
       bsdf_eval_mis(eval, weight);
     }
@@ -774,6 +786,104 @@ ccl_device_inline int shader_bsdf_sample(KernelGlobals *kg,
   return label;
 }
 
+#ifdef __PATH_GUIDING__
+/* Same as _shader_bsdf_multi_eval without skipping a closure, also returning the closure that
+ * contributes most in the direction, or NULL if none does. */
+ccl_device_inline const ShaderClosure *_shader_bsdf_multi_eval_guided(KernelGlobals *kg,
+                                                                      ShaderData *sd,
+                                                                      const float3 omega_in,
+                                                                      float *pdf,
+                                                                      BsdfEval *result_eval)
+{
+  const ShaderClosure *max_sc = NULL;
+  float max_contribution = 0.0f;
+  float sum_pdf = 0.0f;
+  float sum_sample_weight = 0.0f;
+
+  for (int i = 0; i < sd->num_closure; i++) {
+    const ShaderClosure *sc = &sd->closure[i];
+
+    if (CLOSURE_IS_BSDF(sc->type)) {
+      float bsdf_pdf = 0.0f;
+      const float3 eval = bsdf_eval(kg, sd, sc, omega_in, &bsdf_pdf) * sc->weight;
+
+      if (bsdf_pdf != 0.0f) {
+        bsdf_eval_accum(result_eval, sc->type, eval, 1.0f);
+        sum_pdf += bsdf_pdf * sc->sample_weight;
+
+        const float contribution = average(eval);
+        if (max_sc == NULL || contribution > max_contribution) {
+          max_sc = sc;
+          max_contribution = contribution;
+        }
+      }
+
+      sum_sample_weight += sc->sample_weight;
+    }
+  }
+
+  *pdf = (sum_sample_weight > 0.0f) ? sum_pdf / sum_sample_weight : 0.0f;
+  return max_sc;
+}
+
+/* Sample the mixture of the BSDF and the guiding distribution of the shading point, returning
+ * the PDF of the mixture. */
+ccl_device int shader_bsdf_sample_guided(KernelGlobals *kg,
+                                         ShaderData *sd,
+                                         float randu,
+                                         float randv,
+                                         BsdfEval *bsdf_eval,
+                                         float3 *omega_in,
+                                         differential3 *domega_in,
+                                         float *pdf)
+{
+  const PathGuidingDistribution *distribution = kg->path_guiding_distribution;
+  const float fraction = kernel_data.integrator.path_guiding_fraction;
+
+  if (randu < fraction) {
+    /* Sample the guiding distribution and evaluate all BSDFs for the direction. */
+    float guide_pdf;
+    *omega_in = path_guiding_sample(distribution, randu / fraction, randv, &guide_pdf);
+    *domega_in = differential3_zero();
+
+    PROFILING_INIT(kg, PROFILING_CLOSURE_EVAL);
+
+    bsdf_eval_init(bsdf_eval,
+                   NBUILTIN_CLOSURES,
+                   make_float3(0.0f, 0.0f, 0.0f),
+                   kernel_data.film.use_light_pass);
+
+    float bsdf_pdf;
+    const ShaderClosure *label_sc = _shader_bsdf_multi_eval_guided(
+        kg, sd, *omega_in, &bsdf_pdf, bsdf_eval);
+
+    if (label_sc == NULL) {
+      /* No closure reflects light in the direction. */
+      *pdf = 0.0f;
+      return LABEL_NONE;
+    }
+
+    *pdf = fraction * guide_pdf + (1.0f - fraction) * bsdf_pdf;
+    return path_guiding_label(sd, label_sc, *omega_in);
+  }
+
+  const int label = shader_bsdf_sample(
+      kg, sd, (randu - fraction) / (1.0f - fraction), randv, bsdf_eval, omega_in, domega_in, pdf);
+
+  if (*pdf != 0.0f) {
+    if (label & LABEL_SINGULAR) {
+      /* Singular directions can only be found by sampling the BSDF. */
+      *pdf *= 1.0f - fraction;
+    }
+    else {
+      *pdf = (1.0f - fraction) * (*pdf) + fraction * path_guiding_pdf(distribution, *omega_in);
+    }
+  }
+
+  return label;
+}
+#endif /* __PATH_GUIDING__ */
+
 ccl_device int shader_bsdf_sample_closure(KernelGlobals *kg,
                                           ShaderData *sd,
                                           const ShaderClosure *sc,
@@ -128,6 +128,7 @@ CCL_NAMESPACE_BEGIN
 #  endif
 #  define __VOLUME_DECOUPLED__
 #  define __VOLUME_RECORD_ALL__
+#  define __PATH_GUIDING__
 #endif /* __KERNEL_CPU__ */
 
 #ifdef __KERNEL_CUDA__
@@ -1387,7 +1388,15 @@ typedef struct KernelIntegrator {
 
   int max_closures;
 
-  int pad1, pad2;
+  /* light tree */
+  int use_light_tree;
+  int num_distant_lights;
+
+  /* path guiding */
+  int use_path_guiding;
+  int path_guiding_training_samples;
+  float path_guiding_fraction;
+  int pad1;
 } KernelIntegrator;
 static_assert_align(KernelIntegrator, 16);
 
@@ -1548,6 +1557,69 @@ typedef struct KernelLightDistribution {
 } KernelLightDistribution;
 static_assert_align(KernelLightDistribution, 16);
 
+/* Light tree node, nodes are stored depth first so the first child of a node directly follows
+ * it. Leaves reference a single emitter of the light distribution. */
+typedef struct KernelLightTreeNode {
+  /* Bounding box of the emitters. */
+  float bounds_min[3];
+  /* Estimated emitted power. */
+  float energy;
+  float bounds_max[3];
+  /* Angle containing all emitter normals around the axis. */
+  float theta_o;
+  float axis[3];
+  /* Angle around the emitter normals in which light is emitted. */
+  float theta_e;
+  /* Index of the second child for inner nodes, for leaves the bitwise inverse of the light
+   * distribution index. */
+  int child_index;
+  int parent_index;
+  int pad1, pad2;
+} KernelLightTreeNode;
+static_assert_align(KernelLightTreeNode, 16);
+
+#ifdef __PATH_GUIDING__
+/* Path guiding field, see kernel_path_guiding.h. Only on the CPU, where all threads share the
+ * field and learn it while rendering. */
+
+/* Number of cells along the longest axis of the scene bounds. */
+#  define PATH_GUIDING_RESOLUTION 32
+/* Directional bins, with cos(theta) and phi mapped to equal area bins. */
+#  define PATH_GUIDING_THETA_BINS 8
+#  define PATH_GUIDING_PHI_BINS 16
+#  define PATH_GUIDING_NUM_BINS (PATH_GUIDING_THETA_BINS * PATH_GUIDING_PHI_BINS)
+/* Samples in a cell before the first sampling distribution is built, the distribution is then
+ * rebuilt every time the number of samples quadruples. */
+#  define PATH_GUIDING_MIN_SAMPLES 128
+#  define PATH_GUIDING_MAX_DISTRIBUTIONS 8
+
+typedef struct PathGuidingDistribution {
+  /* Cumulative distribution over the bins, normalized to one. */
+  float cdf[PATH_GUIDING_NUM_BINS + 1];
+} PathGuidingDistribution;
+
+typedef struct PathGuidingCell {
+  /* Estimate of the incident radiance integrated over each bin. */
+  float radiance[PATH_GUIDING_NUM_BINS];
+  uint num_samples;
+  /* Most recent sampling distribution, NULL until enough samples are recorded. */
+  PathGuidingDistribution *distribution;
+  /* All distributions built for the cell. Other threads may still sample older ones, so they
+   * are only freed when the field is reset. */
+  PathGuidingDistribution *distributions[PATH_GUIDING_MAX_DISTRIBUTIONS];
+} PathGuidingCell;
+
+typedef struct PathGuidingField {
+  /* Uniform grid over the scene bounds. */
+  float3 bounds_min;
+  float3 inv_cell_size;
+  int resolution[3];
+  int num_cells;
+  /* Cells are allocated by the kernel when the first path records radiance in them. */
+  PathGuidingCell **cells;
+} PathGuidingField;
+#endif /* __PATH_GUIDING__ */
+
 typedef struct KernelParticle {
   int index;
   float age;
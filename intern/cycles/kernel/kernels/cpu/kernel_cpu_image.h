@@ -23,6 +23,8 @@
 #  include <nanovdb/util/SampleFromVoxels.h>
 #endif
 
+#include "util/util_texture_cache.h"
+
 CCL_NAMESPACE_BEGIN
 
 /* Make template functions private so symbols don't conflict between kernels with different
@@ -584,10 +586,30 @@ template<typename T> struct NanoVDBInterpolator {
 
 #undef SET_CUBIC_SPLINE_WEIGHTS
 
-ccl_device float4 kernel_tex_image_interp(KernelGlobals *kg, int id, float x, float y)
+/* The derivatives of the texture coordinates and the path flag are only used for images in the
+ * texture cache, to select the mipmap level and the blur after bounces. */
+ccl_device float4 kernel_tex_image_interp(KernelGlobals *kg,
+                                          int id,
+                                          float x,
+                                          float y,
+                                          float2 dx = make_float2(0.0f, 0.0f),
+                                          float2 dy = make_float2(0.0f, 0.0f),
+                                          int path_flag = 0)
 {
   const TextureInfo &info = kernel_tex_fetch(__texture_info, id);
 
+  if (info.cache_handle) {
+    const TextureCacheHandle *handle = (const TextureCacheHandle *)info.cache_handle;
+    float blur = 0.0f;
+    if (path_flag & PATH_RAY_DIFFUSE_ANCESTOR) {
+      blur = handle->diffuse_blur;
+    }
+    else if (path_flag & PATH_RAY_GLOSSY) {
+      blur = handle->glossy_blur;
+    }
+    return texture_cache_lookup(handle, x, y, dx, dy, blur);
+  }
+
   switch (info.data_type) {
     case IMAGE_DATA_TYPE_HALF:
       return TextureInterpolator<half>::interp(info, x, y);
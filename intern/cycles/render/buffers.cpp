@@ -126,6 +126,7 @@ RenderTile::RenderTile()
 
   buffers = NULL;
   stealing_state = NO_STEALING;
+  can_split = false;
 }
 
 /* Render Buffers */
@@ -149,6 +149,10 @@ class RenderTile {
   typedef enum { NO_STEALING = 0, CAN_BE_STOLEN = 1, WAS_STOLEN = 2 } StealingState;
   StealingState stealing_state;
 
+  /* Part of the tile can be handed to an idle thread of the same device, see
+   * #Session::split_tile. */
+  bool can_split;
+
   RenderBuffers *buffers;
 
   RenderTile();
@@ -1229,14 +1229,37 @@ void GeometryManager::device_update_bvh(Device *device,
 
   VLOG(1) << "Using " << bvh_layout_name(bparams.bvh_layout) << " layout.";
 
-  const bool can_refit = scene->bvh != nullptr &&
-                         (bparams.bvh_layout == BVHLayout::BVH_LAYOUT_OPTIX);
+  const bool can_refit = scene_bvh_can_refit(scene, bparams);
   const bool pack_all = scene->bvh == nullptr;
+  const bool has_bvh2_layout = (bparams.bvh_layout == BVH_LAYOUT_BVH2);
 
   BVH *bvh = scene->bvh;
   if (!scene->bvh) {
     bvh = scene->bvh = BVH::create(bparams, scene->geometry, scene->objects, device);
   }
+  else if (has_bvh2_layout || bparams.bvh_layout == BVH_LAYOUT_EMBREE) {
+    bvh->geometry = scene->geometry;
+    bvh->objects = scene->objects;
+  }
+
+  if (can_refit && has_bvh2_layout) {
+    /* The packed BVH was stolen by the device arrays, take it back to refit it in place. */
+    PackedBVH &pack = static_cast<BVH2 *>(bvh)->pack;
+    dscene->bvh_nodes.give_data(pack.nodes);
+    dscene->bvh_leaf_nodes.give_data(pack.leaf_nodes);
+    dscene->object_node.give_data(pack.object_node);
+    dscene->prim_tri_index.give_data(pack.prim_tri_index);
+    dscene->prim_tri_verts.give_data(pack.prim_tri_verts);
+    dscene->prim_type.give_data(pack.prim_type);
+    dscene->prim_visibility.give_data(pack.prim_visibility);
+    dscene->prim_index.give_data(pack.prim_index);
+    dscene->prim_object.give_data(pack.prim_object);
+    dscene->prim_time.give_data(pack.prim_time);
+  }
+
+  if (can_refit) {
+    progress.set_status("Updating Scene BVH", "Refitting");
+  }
 
   device->build_bvh(bvh, progress, can_refit);
 
@@ -1244,11 +1267,30 @@ void GeometryManager::device_update_bvh(Device *device,
     return;
   }
 
-  const bool has_bvh2_layout = (bparams.bvh_layout == BVH_LAYOUT_BVH2);
+  if (!can_refit) {
+    scene_bvh_object_flags.clear();
+    foreach (Object *ob, scene->objects) {
+      scene_bvh_object_flags.push_back((ob->is_traceable() ? 1 : 0) |
+                                       (ob->get_geometry()->is_instanced() ? 2 : 0));
+    }
+  }
 
   PackedBVH pack;
   if (has_bvh2_layout) {
-    pack = std::move(static_cast<BVH2 *>(bvh)->pack);
+    /* Steal the arrays rather than assigning the packed BVH, array has no move assignment and
+     * the BVH would keep a copy of all the data. */
+    PackedBVH &bvh_pack = static_cast<BVH2 *>(bvh)->pack;
+    pack.nodes.steal_data(bvh_pack.nodes);
+    pack.leaf_nodes.steal_data(bvh_pack.leaf_nodes);
+    pack.object_node.steal_data(bvh_pack.object_node);
+    pack.prim_tri_index.steal_data(bvh_pack.prim_tri_index);
+    pack.prim_tri_verts.steal_data(bvh_pack.prim_tri_verts);
+    pack.prim_type.steal_data(bvh_pack.prim_type);
+    pack.prim_visibility.steal_data(bvh_pack.prim_visibility);
+    pack.prim_index.steal_data(bvh_pack.prim_index);
+    pack.prim_object.steal_data(bvh_pack.prim_object);
+    pack.prim_time.steal_data(bvh_pack.prim_time);
+    pack.root_index = bvh_pack.root_index;
   }
   else {
     progress.set_status("Updating Scene BVH", "Packing BVH primitives");
@@ -1367,6 +1409,48 @@ void GeometryManager::device_update_bvh(Device *device,
   dscene->data.bvh.scene = NULL;
 }
 
+bool GeometryManager::scene_bvh_can_refit(Scene *scene, const BVHParams &bparams)
+{
+  if (scene->bvh == nullptr) {
+    return false;
+  }
+
+  if (bparams.bvh_layout == BVH_LAYOUT_OPTIX) {
+    return true;
+  }
+
+  /* With persistent data, keep the BVH of the previous frame when only objects moved or meshes
+   * deformed. */
+  if (!scene->params.persistent_data) {
+    return false;
+  }
+
+  if (bparams.bvh_layout == BVH_LAYOUT_BVH2) {
+    if (!static_cast<BVH2 *>(scene->bvh)->can_refit()) {
+      VLOG(1) << "Rebuilding scene BVH, refitting degraded it too much.";
+      return false;
+    }
+  }
+  else if (bparams.bvh_layout != BVH_LAYOUT_EMBREE) {
+    return false;
+  }
+
+  if (scene->bvh->geometry != scene->geometry || scene->bvh->objects != scene->objects ||
+      scene_bvh_object_flags.size() != scene->objects.size()) {
+    return false;
+  }
+
+  for (size_t i = 0; i < scene->objects.size(); i++) {
+    const Object *ob = scene->objects[i];
+    const uint flags = (ob->is_traceable() ? 1 : 0) | (ob->get_geometry()->is_instanced() ? 2 : 0);
+    if (flags != scene_bvh_object_flags[i]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 /* Set of flags used to help determining what data has been modified or needs reallocation, so we
  * can decide which device data to free or update. */
 enum {
@@ -246,6 +246,11 @@ class GeometryManager {
                                 Progress &progress);
 
   void device_update_bvh(Device *device, DeviceScene *dscene, Scene *scene, Progress &progress);
+  bool scene_bvh_can_refit(Scene *scene, const BVHParams &bparams);
+
+  /* Whether objects were traceable and instanced when the scene BVH was built, it can only be
+   * refit while they stay the same. */
+  vector<uint> scene_bvh_object_flags;
 
   void device_update_displacement_images(Device *device, Scene *scene, Progress &progress);
 
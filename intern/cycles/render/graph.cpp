@@ -383,6 +383,8 @@ void ShaderGraph::finalize(Scene *scene, bool do_bump, bool do_simplify, bool bu
     if (do_bump)
       bump_from_displacement(bump_in_object_space);
 
+    refine_texture_derivatives(scene);
+
     ShaderInput *surface_in = output()->input("Surface");
     ShaderInput *volume_in = output()->input("Volume");
 
@@ -954,6 +956,63 @@ void ShaderGraph::refine_bump_nodes()
   }
 }
 
+void ShaderGraph::refine_texture_derivatives(Scene *scene)
+{
+  /* image textures in the texture cache select the mipmap level from the derivatives of the
+   * texture coordinates. like for bump nodes, we copy the sub-graph defined from the "Vector"
+   * input twice, with texture coordinates shifted by dx/dy, and connect the copies to the
+   * "VectorDX" and "VectorDY" inputs. */
+
+  if (!scene->image_manager->use_texture_cache(scene) || scene->shader_manager->use_osl()) {
+    return;
+  }
+
+  /* image textures that are part of a bump sub-graph are skipped, so the center and shifted
+   * height samples all read the same mipmap level. */
+  vector<ShaderNode *> image_nodes;
+  foreach (ShaderNode *node, nodes) {
+    if (node->type == ImageTextureNode::node_type && node->bump == SHADER_BUMP_NONE &&
+        node->input("Vector")->link) {
+      image_nodes.push_back(node);
+    }
+  }
+
+  /* textures sharing the same coordinates share the copies too */
+  map<ShaderOutput *, pair<ShaderOutput *, ShaderOutput *>> copied_outputs;
+
+  foreach (ShaderNode *node, image_nodes) {
+    ShaderOutput *out = node->input("Vector")->link;
+
+    if (copied_outputs.find(out) == copied_outputs.end()) {
+      ShaderNodeSet nodes_vector;
+      ShaderNodeMap nodes_dx;
+      ShaderNodeMap nodes_dy;
+
+      find_dependencies(nodes_vector, node->input("Vector"));
+
+      copy_nodes(nodes_vector, nodes_dx);
+      copy_nodes(nodes_vector, nodes_dy);
+
+      foreach (NodePair &pair, nodes_dx)
+        pair.second->bump = SHADER_BUMP_DX;
+      foreach (NodePair &pair, nodes_dy)
+        pair.second->bump = SHADER_BUMP_DY;
+
+      /* add generated nodes */
+      foreach (NodePair &pair, nodes_dx)
+        add(pair.second);
+      foreach (NodePair &pair, nodes_dy)
+        add(pair.second);
+
+      copied_outputs[out] = make_pair(nodes_dx[out->parent]->output(out->name()),
+                                      nodes_dy[out->parent]->output(out->name()));
+    }
+
+    connect(copied_outputs[out].first, node->input("VectorDX"));
+    connect(copied_outputs[out].second, node->input("VectorDY"));
+  }
+}
+
 void ShaderGraph::bump_from_displacement(bool use_object_space)
 {
   /* generate bump mapping automatically from displacement. bump mapping is
@@ -17,6 +17,7 @@
 #include "render/image.h"
 #include "device/device.h"
 #include "render/colorspace.h"
+#include "render/image_cache.h"
 #include "render/image_oiio.h"
 #include "render/image_vdb.h"
 #include "render/scene.h"
@@ -304,6 +305,8 @@ ImageManager::ImageManager(const DeviceInfo &info)
 
   /* Set image limits */
   has_half_images = info.has_half_images;
+  /* The kernel can only read from the texture cache on the CPU. */
+  has_texture_cache = (info.type == DEVICE_CPU);
 }
 
 ImageManager::~ImageManager()
@@ -646,6 +649,42 @@ bool ImageManager::file_load_image(Image *img, int texture_limit)
   return true;
 }
 
+bool ImageManager::use_texture_cache(const Scene *scene) const
+{
+  return scene->params.texture_cache.use_cache && has_texture_cache;
+}
+
+TextureCacheHandle *ImageManager::texture_cache_handle(Scene *scene, Image *img)
+{
+  if (!use_texture_cache(scene)) {
+    return NULL;
+  }
+
+  /* Only image files, builtin images are only available in memory. */
+  const ustring filepath = img->loader->osl_filepath();
+  if (img->builtin || filepath.empty()) {
+    return NULL;
+  }
+
+  /* The texture cache returns pixels as stored in the file with associated alpha, anything
+   * that needs conversion on load is fully loaded instead. */
+  const ImageMetaData &metadata = img->metadata;
+  if (metadata.depth > 1 || !image_associate_alpha(img) ||
+      !(metadata.colorspace == u_colorspace_raw || metadata.colorspace == u_colorspace_srgb)) {
+    return NULL;
+  }
+
+  {
+    thread_scoped_lock device_lock(device_mutex);
+    if (!texture_cache) {
+      texture_cache.reset(new TextureCache(scene->params.texture_cache));
+    }
+  }
+
+  return texture_cache->get_handle(
+      filepath.string(), img->params.interpolation, img->params.extension);
+}
+
 void ImageManager::device_load_image(Device *device, Scene *scene, int slot, Progress *progress)
 {
   if (progress->get_cancel()) {
@@ -661,6 +700,13 @@ void ImageManager::device_load_image(Device *device, Scene *scene, int slot, Pro
   load_image_metadata(img);
   ImageDataType type = img->metadata.type;
 
+  /* Pixels of images in the texture cache are loaded on demand by the kernel. Only a single
+   * pixel is allocated, so the texture info is still available. */
+  TextureCacheHandle *cache_handle = texture_cache_handle(scene, img);
+  if (cache_handle) {
+    type = IMAGE_DATA_TYPE_BYTE4;
+  }
+
   /* Name for debugging. */
   img->mem_name = string_printf("__tex_image_%s_%03d", name_from_type(type), slot);
 
@@ -675,9 +721,19 @@ void ImageManager::device_load_image(Device *device, Scene *scene, int slot, Pro
       device, img->mem_name.c_str(), slot, type, img->params.interpolation, img->params.extension);
   img->mem->info.use_transform_3d = img->metadata.use_transform_3d;
   img->mem->info.transform_3d = img->metadata.transform_3d;
+  img->mem->info.cache_handle = (uint64_t)cache_handle;
 
   /* Create new texture. */
-  if (type == IMAGE_DATA_TYPE_FLOAT4) {
+  if (cache_handle) {
+    thread_scoped_lock device_lock(device_mutex);
+    uchar *pixels = (uchar *)img->mem->alloc(1, 1);
+
+    pixels[0] = (TEX_IMAGE_MISSING_R * 255);
+    pixels[1] = (TEX_IMAGE_MISSING_G * 255);
+    pixels[2] = (TEX_IMAGE_MISSING_B * 255);
+    pixels[3] = (TEX_IMAGE_MISSING_A * 255);
+  }
+  else if (type == IMAGE_DATA_TYPE_FLOAT4) {
     if (!file_load_image<TypeDesc::FLOAT, float>(img, texture_limit)) {
       /* on failure to load, we set a 1x1 pixels pink image */
       thread_scoped_lock device_lock(device_mutex);
@@ -799,6 +855,11 @@ void ImageManager::device_free_image(Device *, int slot)
   }
 
   if (img->mem) {
+    if (img->mem->info.cache_handle) {
+      texture_cache->invalidate(img->loader->osl_filepath().string());
+      texture_cache->release_handle((TextureCacheHandle *)img->mem->info.cache_handle);
+    }
+
     thread_scoped_lock device_lock(device_mutex);
     delete img->mem;
   }
@@ -894,6 +955,11 @@ void ImageManager::collect_statistics(RenderStats *stats)
     stats->image.textures.add_entry(
         NamedSizeEntry(image->loader->name(), image->mem->memory_size()));
   }
+
+  if (texture_cache) {
+    stats->image.textures.add_entry(
+        NamedSizeEntry("Texture Cache", texture_cache->memory_used()));
+  }
 }
 
 void ImageManager::tag_update()
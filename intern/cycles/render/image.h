@@ -39,7 +39,9 @@ class Progress;
 class RenderStats;
 class Scene;
 class ColorSpaceProcessor;
+class TextureCache;
 class VDBImageLoader;
+struct TextureCacheHandle;
 
 /* Image Parameters */
 class ImageParams {
@@ -187,6 +189,9 @@ class ImageManager {
   void set_osl_texture_system(void *texture_system);
   bool set_animation_frame_update(int frame);
 
+  /* Image files may be read on demand through the texture cache. */
+  bool use_texture_cache(const Scene *scene) const;
+
   void collect_statistics(RenderStats *stats);
 
   void tag_update();
@@ -213,6 +218,7 @@ class ImageManager {
  private:
   bool need_update_;
   bool has_half_images;
+  bool has_texture_cache;
 
   thread_mutex device_mutex;
   thread_mutex images_mutex;
@@ -221,11 +227,15 @@ class ImageManager {
   vector<Image *> images;
   void *osl_texture_system;
 
+  /* Created on first use, when the scene enables it. */
+  unique_ptr<TextureCache> texture_cache;
+
   int add_image_slot(ImageLoader *loader, const ImageParams &params, const bool builtin);
   void add_image_user(int slot);
   void remove_image_user(int slot);
 
   void load_image_metadata(Image *img);
+  TextureCacheHandle *texture_cache_handle(Scene *scene, Image *img);
 
   template<TypeDesc::BASETYPE FileFormat, typename StorageType>
   bool file_load_image(Image *img, int texture_limit);
@@ -0,0 +1,202 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "render/image_cache.h"
+
+#include "util/util_logging.h"
+#include "util/util_path.h"
+#include "util/util_time.h"
+
+#include <OpenImageIO/imagebufalgo.h>
+
+CCL_NAMESPACE_BEGIN
+
+static TextureOpt::InterpMode texture_cache_interpolation(InterpolationType interpolation)
+{
+  switch (interpolation) {
+    case INTERPOLATION_CLOSEST:
+      return TextureOpt::InterpClosest;
+    case INTERPOLATION_CUBIC:
+      return TextureOpt::InterpBicubic;
+    case INTERPOLATION_SMART:
+      return TextureOpt::InterpSmartBicubic;
+    default:
+      return TextureOpt::InterpBilinear;
+  }
+}
+
+static TextureOpt::Wrap texture_cache_wrap(ExtensionType extension)
+{
+  switch (extension) {
+    case EXTENSION_REPEAT:
+      return TextureOpt::WrapPeriodic;
+    case EXTENSION_EXTEND:
+      return TextureOpt::WrapClamp;
+    default:
+      return TextureOpt::WrapBlack;
+  }
+}
+
+TextureCache::TextureCache(const TextureCacheParams &params) : params(params)
+{
+  /* Private texture system, so the memory budget is not shared with OSL. */
+  texture_system = TextureSystem::create(false);
+  texture_system->attribute("max_memory_MB", (float)params.cache_size);
+  /* Read images that are not tiled or mipmapped in tiles too, generating the mipmap levels
+   * as they are needed. */
+  texture_system->attribute("autotile", params.tile_size);
+  texture_system->attribute("automip", 1);
+  /* Match the channel layout the kernel expects for full images. */
+  texture_system->attribute("gray_to_rgb", 1);
+}
+
+TextureCache::~TextureCache()
+{
+  VLOG(1) << "Texture cache statistics:\n" << texture_system->getstats();
+
+  handles.clear();
+  TextureSystem::destroy(texture_system, true);
+}
+
+TextureCacheHandle *TextureCache::get_handle(const string &filepath,
+                                             InterpolationType interpolation,
+                                             ExtensionType extension)
+{
+  string texture_filepath = filepath;
+
+  if (params.use_auto_convert && !string_endswith(filepath, ".tx")) {
+    const string converted_filepath = tx_filepath(filepath);
+    string error;
+    if (convert_serialized(filepath, converted_filepath, error)) {
+      texture_filepath = converted_filepath;
+    }
+    else {
+      VLOG(1) << "Failed to convert " << filepath << " to a tiled texture: " << error;
+    }
+  }
+
+  const ustring texture_ufilepath(texture_filepath);
+  int exists = 0;
+  if (!texture_system->get_texture_info(
+          texture_ufilepath, 0, ustring("exists"), TypeDesc::INT, &exists) ||
+      !exists) {
+    return NULL;
+  }
+
+  unique_ptr<TextureCacheHandle> handle(new TextureCacheHandle());
+  handle->texture_system = texture_system;
+  handle->handle = texture_system->get_texture_handle(texture_ufilepath);
+  handle->options.interpmode = texture_cache_interpolation(interpolation);
+  handle->options.swrap = texture_cache_wrap(extension);
+  handle->options.twrap = texture_cache_wrap(extension);
+  /* Alpha for images without an alpha channel. */
+  handle->options.fill = 1.0f;
+  handle->diffuse_blur = params.diffuse_blur;
+  handle->glossy_blur = params.glossy_blur;
+
+  if (handle->handle == NULL) {
+    return NULL;
+  }
+
+  thread_scoped_lock lock(handles_mutex);
+  handles.push_back(std::move(handle));
+  return handles.back().get();
+}
+
+void TextureCache::release_handle(TextureCacheHandle *handle)
+{
+  thread_scoped_lock lock(handles_mutex);
+  for (size_t i = 0; i < handles.size(); i++) {
+    if (handles[i].get() == handle) {
+      handles[i].swap(handles.back());
+      handles.pop_back();
+      return;
+    }
+  }
+}
+
+void TextureCache::invalidate(const string &filepath)
+{
+  texture_system->invalidate(ustring(filepath));
+  if (params.use_auto_convert) {
+    texture_system->invalidate(ustring(tx_filepath(filepath)));
+  }
+}
+
+bool TextureCache::convert_serialized(const string &filepath,
+                                      const string &tx_filepath,
+                                      string &error)
+{
+  /* Images are loaded in parallel, and the same file can be used by several images with
+   * different interpolation or extension. Once another thread is done converting the file, the
+   * conversion here finds the texture up to date and skips it. */
+  {
+    thread_scoped_lock lock(convert_mutex);
+    convert_cond.wait(lock, [&]() { return converting_filepaths.count(tx_filepath) == 0; });
+    converting_filepaths.insert(tx_filepath);
+  }
+
+  const bool success = convert(filepath, tx_filepath, params.tile_size, error);
+
+  {
+    thread_scoped_lock lock(convert_mutex);
+    converting_filepaths.erase(tx_filepath);
+  }
+  convert_cond.notify_all();
+
+  return success;
+}
+
+size_t TextureCache::memory_used() const
+{
+  long long memory_used = 0;
+  texture_system->getattribute("stat:cache_memory_used", TypeDesc::INT64, &memory_used);
+  return memory_used;
+}
+
+bool TextureCache::convert(const string &filepath,
+                           const string &tx_filepath,
+                           int tile_size,
+                           string &error)
+{
+  const double time_start = time_dt();
+
+  ImageSpec config;
+  config.tile_width = tile_size;
+  config.tile_height = tile_size;
+  config.tile_depth = 1;
+  /* Only convert again when the image changed. */
+  config.attribute("maketx:updatemode", 1);
+
+  if (!ImageBufAlgo::make_texture(ImageBufAlgo::MakeTxTexture, filepath, tx_filepath, config)) {
+    error = OIIO::geterror();
+    return false;
+  }
+
+  VLOG(1) << "Converted " << filepath << " to tiled texture in " << time_dt() - time_start
+          << " seconds.";
+
+  return true;
+}
+
+string TextureCache::tx_filepath(const string &filepath)
+{
+  /* Keep the original extension, so images with the same name but different formats don't
+   * share a texture. */
+  return path_join(path_dirname(filepath), path_filename(filepath) + ".tx");
+}
+
+CCL_NAMESPACE_END
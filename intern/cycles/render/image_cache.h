@@ -0,0 +1,108 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __IMAGE_CACHE_H__
+#define __IMAGE_CACHE_H__
+
+#include "util/util_set.h"
+#include "util/util_string.h"
+#include "util/util_texture_cache.h"
+#include "util/util_thread.h"
+#include "util/util_unique_ptr.h"
+#include "util/util_vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Texture Cache Parameters */
+class TextureCacheParams {
+ public:
+  bool use_cache;
+  /* Maximum memory used for tiles in megabytes, least recently used tiles are evicted. */
+  int cache_size;
+  /* Tile size for images converted to tiled textures. */
+  int tile_size;
+  /* Convert images to tiled and mipmapped textures before rendering. */
+  bool use_auto_convert;
+  float diffuse_blur;
+  float glossy_blur;
+
+  TextureCacheParams()
+      : use_cache(false),
+        cache_size(1024),
+        tile_size(64),
+        use_auto_convert(false),
+        diffuse_blur(1.0f / 64.0f),
+        glossy_blur(0.0f)
+  {
+  }
+
+  bool operator==(const TextureCacheParams &other) const
+  {
+    return (use_cache == other.use_cache && cache_size == other.cache_size &&
+            tile_size == other.tile_size && use_auto_convert == other.use_auto_convert &&
+            diffuse_blur == other.diffuse_blur && glossy_blur == other.glossy_blur);
+  }
+};
+
+/* Texture Cache
+ *
+ * Image textures for the CPU that are read on demand, instead of loading the full image into
+ * memory. Files that are tiled and mipmapped (like .tx files) only have the tiles of the mipmap
+ * levels that are actually sampled loaded. */
+class TextureCache {
+ public:
+  explicit TextureCache(const TextureCacheParams &params);
+  ~TextureCache();
+
+  /* Handle for kernel lookups, NULL if the file can't be read. The handle remains valid until
+   * it is released, or for the lifetime of the cache. */
+  TextureCacheHandle *get_handle(const string &filepath,
+                                 InterpolationType interpolation,
+                                 ExtensionType extension);
+  void release_handle(TextureCacheHandle *handle);
+
+  /* Drop cached tiles of the file, so changes on disk are picked up. */
+  void invalidate(const string &filepath);
+
+  size_t memory_used() const;
+
+  /* Convert an image to a tiled and mipmapped texture. Conversion is skipped if the texture
+   * is already up to date with the image. */
+  static bool convert(const string &filepath,
+                      const string &tx_filepath,
+                      int tile_size,
+                      string &error);
+  static string tx_filepath(const string &filepath);
+
+ protected:
+  /* Convert the image, waiting for other threads that convert to the same texture file. */
+  bool convert_serialized(const string &filepath, const string &tx_filepath, string &error);
+
+  TextureCacheParams params;
+  TextureSystem *texture_system;
+
+  /* Texture files that are being written by a conversion. */
+  thread_mutex convert_mutex;
+  thread_condition_variable convert_cond;
+  set<string> converting_filepaths;
+
+  thread_mutex handles_mutex;
+  vector<unique_ptr<TextureCacheHandle>> handles;
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __IMAGE_CACHE_H__ */
@@ -22,6 +22,7 @@
 #include "render/jitter.h"
 #include "render/light.h"
 #include "render/object.h"
+#include "render/path_guiding.h"
 #include "render/scene.h"
 #include "render/shader.h"
 #include "render/sobol.h"
@@ -81,6 +82,11 @@ NODE_DEFINE(Integrator)
   SOCKET_BOOLEAN(sample_all_lights_direct, "Sample All Lights Direct", true);
   SOCKET_BOOLEAN(sample_all_lights_indirect, "Sample All Lights Indirect", true);
   SOCKET_FLOAT(light_sampling_threshold, "Light Sampling Threshold", 0.05f);
+  SOCKET_BOOLEAN(use_light_tree, "Use Light Tree", false);
+
+  SOCKET_BOOLEAN(use_path_guiding, "Use Path Guiding", false);
+  SOCKET_FLOAT(path_guiding_fraction, "Path Guiding Fraction", 0.5f);
+  SOCKET_INT(path_guiding_training_samples, "Path Guiding Training Samples", 128);
 
   static NodeEnum method_enum;
   method_enum.insert("path", PATH);
@@ -235,6 +241,15 @@ void Integrator::device_update(Device *device, DeviceScene *dscene, Scene *scene
     kintegrator->light_inv_rr_threshold = 0.0f;
   }
 
+  /* Path guiding is learned by the CPU kernel, and only guides non-branched paths. Keep some
+   * BSDF sampling, singular directions can't be found otherwise. */
+  kintegrator->path_guiding_fraction = clamp(path_guiding_fraction, 0.0f, 0.9f);
+  kintegrator->path_guiding_training_samples = path_guiding_training_samples;
+  kintegrator->use_path_guiding = use_path_guiding && !kintegrator->branched &&
+                                  kintegrator->path_guiding_fraction > 0.0f &&
+                                  path_guiding_training_samples > 0 &&
+                                  device->path_guiding_memory() != NULL;
+
   /* sobol directions table */
   int max_samples = 1;
 
@@ -284,6 +299,32 @@ void Integrator::device_update(Device *device, DeviceScene *dscene, Scene *scene
   clear_modified();
 }
 
+void Integrator::device_update_path_guiding(Device *device, DeviceScene *dscene, Scene *scene)
+{
+#ifdef __PATH_GUIDING__
+  PathGuidingField *field = (PathGuidingField *)device->path_guiding_memory();
+  if (field == NULL) {
+    return;
+  }
+
+  if (!dscene->data.integrator.use_path_guiding) {
+    path_guiding_field_free(field);
+    return;
+  }
+
+  /* What was learned so far may not match the updated scene, start over. */
+  BoundBox bounds = BoundBox::empty;
+  foreach (Object *object, scene->objects) {
+    bounds.grow(object->bounds);
+  }
+  path_guiding_field_reset(field, bounds);
+#else
+  (void)device;
+  (void)dscene;
+  (void)scene;
+#endif
+}
+
 void Integrator::device_free(Device *, DeviceScene *dscene, bool force_free)
 {
   dscene->sample_pattern_lut.free_if_need_realloc(force_free);
@@ -319,6 +360,11 @@ void Integrator::tag_update(Scene *scene, uint32_t flag)
     scene->object_manager->tag_update(scene, ObjectManager::MOTION_BLUR_MODIFIED);
     scene->camera->tag_modified();
   }
+
+  if (use_light_tree_is_modified() || method_is_modified()) {
+    /* the light distribution is laid out differently for the light tree */
+    scene->light_manager->tag_update(scene, LightManager::INTEGRATOR_MODIFIED);
+  }
 }
 
 CCL_NAMESPACE_END
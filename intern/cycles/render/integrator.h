@@ -74,6 +74,11 @@ class Integrator : public Node {
   NODE_SOCKET_API(bool, sample_all_lights_direct)
   NODE_SOCKET_API(bool, sample_all_lights_indirect)
   NODE_SOCKET_API(float, light_sampling_threshold)
+  NODE_SOCKET_API(bool, use_light_tree)
+
+  NODE_SOCKET_API(bool, use_path_guiding)
+  NODE_SOCKET_API(float, path_guiding_fraction)
+  NODE_SOCKET_API(int, path_guiding_training_samples)
 
   NODE_SOCKET_API(int, adaptive_min_samples)
   NODE_SOCKET_API(float, adaptive_threshold)
@@ -104,6 +109,8 @@ class Integrator : public Node {
   ~Integrator();
 
   void device_update(Device *device, DeviceScene *dscene, Scene *scene);
+  /* Reset the learned path guiding field, after the scene changed. */
+  void device_update_path_guiding(Device *device, DeviceScene *dscene, Scene *scene);
   void device_free(Device *device, DeviceScene *dscene, bool force_free = false);
 
   void tag_update(Scene *scene, uint32_t flag);
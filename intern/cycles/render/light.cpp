@@ -20,6 +20,7 @@
 #include "render/film.h"
 #include "render/graph.h"
 #include "render/integrator.h"
+#include "render/light_tree.h"
 #include "render/mesh.h"
 #include "render/nodes.h"
 #include "render/object.h"
@@ -282,6 +283,81 @@ bool LightManager::object_usable_as_light(Object *object)
   return false;
 }
 
+static bool light_is_distant(const Light *light)
+{
+  return light->get_light_type() == LIGHT_DISTANT || light->get_light_type() == LIGHT_BACKGROUND;
+}
+
+/* Light tree emitter of a lamp with a position. */
+static LightTreeEmitter light_tree_emitter(const Light *light, int distribution_index)
+{
+  const float3 co = light->get_co();
+  const float strength = average(light->get_strength());
+
+  if (light->get_light_type() == LIGHT_AREA) {
+    const float3 axisu = light->get_axisu() * (light->get_sizeu() * light->get_size() * 0.5f);
+    const float3 axisv = light->get_axisv() * (light->get_sizev() * light->get_size() * 0.5f);
+    BoundBox bounds(co - axisu - axisv);
+    bounds.grow(co + axisu - axisv);
+    bounds.grow(co - axisu + axisv);
+    bounds.grow(co + axisu + axisv);
+    /* One sided, intensity along the normal is a quarter of the strength. */
+    const LightTreeCone cone(safe_normalize(light->get_dir()), 0.0f, M_PI_2_F);
+    return LightTreeEmitter(bounds, cone, 0.25f * strength, distribution_index);
+  }
+
+  /* Point and spot lights, the sphere is included in the bounds. */
+  BoundBox bounds(co);
+  bounds.grow(co, light->get_size());
+  const float intensity = strength * 0.25f * M_1_PI_F;
+
+  if (light->get_light_type() == LIGHT_SPOT) {
+    const LightTreeCone cone(
+        safe_normalize(light->get_dir()), 0.5f * light->get_spot_angle(), 0.0f);
+    return LightTreeEmitter(bounds, cone, intensity, distribution_index);
+  }
+
+  const LightTreeCone cone(make_float3(0.0f, 0.0f, 1.0f), M_PI_F, M_PI_2_F);
+  return LightTreeEmitter(bounds, cone, intensity, distribution_index);
+}
+
+void LightManager::device_update_tree(DeviceScene *dscene,
+                                      const vector<LightTreeEmitter> &emitters,
+                                      vector<int> &leaf_table,
+                                      size_t leaf_table_objects_offset,
+                                      size_t leaf_table_triangles_offset)
+{
+  const double time_start = time_dt();
+
+  LightTree light_tree(emitters);
+  const vector<KernelLightTreeNode> &nodes = light_tree.get_nodes();
+  const vector<int> &emitter_leaves = light_tree.get_emitter_leaves();
+
+  /* Replace emitter indices with the index of their leaf. */
+  for (size_t i = 0; i < leaf_table.size(); i++) {
+    if (i >= leaf_table_objects_offset && i < leaf_table_triangles_offset) {
+      /* Object table and primitive offsets. */
+      continue;
+    }
+    if (leaf_table[i] >= 0) {
+      leaf_table[i] = emitter_leaves[leaf_table[i]];
+    }
+  }
+
+  if (!nodes.empty()) {
+    KernelLightTreeNode *knodes = dscene->light_tree_nodes.alloc(nodes.size());
+    std::copy(nodes.begin(), nodes.end(), knodes);
+    dscene->light_tree_nodes.copy_to_device();
+  }
+
+  int *kleaf_table = dscene->light_tree_leaf.alloc(leaf_table.size());
+  std::copy(leaf_table.begin(), leaf_table.end(), kleaf_table);
+  dscene->light_tree_leaf.copy_to_device();
+
+  VLOG(1) << "Light tree with " << emitters.size() << " emitters and " << nodes.size()
+          << " nodes built in " << time_dt() - time_start << " seconds.";
+}
+
 void LightManager::device_update_distribution(Device *,
                                               DeviceScene *dscene,
                                               Scene *scene,
@@ -289,8 +365,14 @@ void LightManager::device_update_distribution(Device *,
 {
   progress.set_status("Updating Lights", "Computing distribution");
 
+  /* The light tree selects lights depending on the shading point, branched path tracing samples
+   * lamps and triangles separately with fixed probabilities so it can't use it. */
+  const bool use_light_tree = scene->integrator->get_use_light_tree() &&
+                              scene->integrator->get_method() != Integrator::BRANCHED_PATH;
+
   /* count */
   size_t num_lights = 0;
+  size_t num_distant_lights = 0;
   size_t num_portals = 0;
   size_t num_background_lights = 0;
   size_t num_triangles = 0;
@@ -300,6 +382,9 @@ void LightManager::device_update_distribution(Device *,
   foreach (Light *light, scene->lights) {
     if (light->is_enabled) {
       num_lights++;
+      if (light_is_distant(light)) {
+        num_distant_lights++;
+      }
     }
     if (light->is_portal) {
       num_portals++;
@@ -336,6 +421,18 @@ void LightManager::device_update_distribution(Device *,
   KernelLightDistribution *distribution = dscene->light_distribution.alloc(num_distribution + 1);
   float totarea = 0.0f;
 
+  /* Light tree emitters and the table to find the leaf of a lamp or triangle in the kernel,
+   * see #light_select_pdf_lamp and #light_select_pdf_triangle. Entries for lamps and triangles
+   * store the emitter index until the tree is built. */
+  vector<LightTreeEmitter> emitters;
+  vector<int> leaf_table;
+  const size_t leaf_table_objects_offset = num_lights;
+  const size_t leaf_table_triangles_offset = num_lights + scene->objects.size() * 2;
+  if (use_light_tree) {
+    emitters.reserve(num_distribution - num_distant_lights);
+    leaf_table.resize(leaf_table_triangles_offset, -1);
+  }
+
   /* triangles */
   size_t offset = 0;
   int j = 0;
@@ -373,6 +470,26 @@ void LightManager::device_update_distribution(Device *,
     }
 
     size_t mesh_num_triangles = mesh->num_triangles();
+
+    size_t leaf_table_offset = 0;
+    vector<float> shader_emission;
+    if (use_light_tree) {
+      leaf_table_offset = leaf_table.size();
+      leaf_table[leaf_table_objects_offset + object_id * 2] = leaf_table_offset;
+      leaf_table[leaf_table_objects_offset + object_id * 2 + 1] = mesh->prim_offset;
+      leaf_table.resize(leaf_table_offset + mesh_num_triangles, -1);
+
+      /* Estimate of the emission per shader, the last entry is for the default surface. */
+      const array<Node *> &used_shaders = mesh->get_used_shaders();
+      shader_emission.resize(used_shaders.size() + 1);
+      for (size_t i = 0; i < shader_emission.size(); i++) {
+        Shader *shader = (i < used_shaders.size()) ? static_cast<Shader *>(used_shaders[i]) :
+                                                     scene->default_surface;
+        float3 emission;
+        shader_emission[i] = shader->is_constant_emission(&emission) ? average(emission) : 1.0f;
+      }
+    }
+
     for (size_t i = 0; i < mesh_num_triangles; i++) {
       int shader_index = mesh->get_shader()[i];
       Shader *shader = (shader_index < mesh->get_used_shaders().size()) ?
@@ -400,7 +517,22 @@ void LightManager::device_update_distribution(Device *,
           p3 = transform_point(&tfm, p3);
         }
 
-        totarea += triangle_area(p1, p2, p3);
+        const float area = triangle_area(p1, p2, p3);
+        totarea += area;
+
+        if (use_light_tree) {
+          BoundBox bounds(p1);
+          bounds.grow(p2);
+          bounds.grow(p3);
+          /* Mesh lights emit on both sides. */
+          const LightTreeCone cone(
+              safe_normalize(cross(p2 - p1, p3 - p1)), M_PI_F, M_PI_2_F);
+          const float emission = shader_emission[min((size_t)shader_index,
+                                                     shader_emission.size() - 1)];
+
+          leaf_table[leaf_table_offset + i] = emitters.size();
+          emitters.push_back(LightTreeEmitter(bounds, cone, area * emission, offset - 1));
+        }
       }
     }
 
@@ -413,33 +545,48 @@ void LightManager::device_update_distribution(Device *,
   float lightarea = (totarea > 0.0f) ? totarea / num_lights : 1.0f;
   bool use_lamp_mis = false;
 
-  int light_index = 0;
-  foreach (Light *light, scene->lights) {
-    if (!light->is_enabled)
-      continue;
+  /* With the light tree, distant lights are stored at the end of the distribution so they can be
+   * selected separately. */
+  const int num_light_passes = use_light_tree ? 2 : 1;
+  for (int light_pass = 0; light_pass < num_light_passes; light_pass++) {
+    int light_index = -1;
+    foreach (Light *light, scene->lights) {
+      if (!light->is_enabled)
+        continue;
 
-    distribution[offset].totarea = totarea;
-    distribution[offset].prim = ~light_index;
-    distribution[offset].lamp.pad = 1.0f;
-    distribution[offset].lamp.size = light->size;
-    totarea += lightarea;
+      light_index++;
 
-    if (light->light_type == LIGHT_DISTANT) {
-      use_lamp_mis |= (light->angle > 0.0f && light->use_mis);
-    }
-    else if (light->light_type == LIGHT_POINT || light->light_type == LIGHT_SPOT) {
-      use_lamp_mis |= (light->size > 0.0f && light->use_mis);
-    }
-    else if (light->light_type == LIGHT_AREA) {
-      use_lamp_mis |= light->use_mis;
-    }
-    else if (light->light_type == LIGHT_BACKGROUND) {
-      num_background_lights++;
-      background_mis |= light->use_mis;
-    }
+      if (use_light_tree && (light_is_distant(light) != (light_pass == 1))) {
+        continue;
+      }
 
-    light_index++;
-    offset++;
+      distribution[offset].totarea = totarea;
+      distribution[offset].prim = ~light_index;
+      distribution[offset].lamp.pad = 1.0f;
+      distribution[offset].lamp.size = light->size;
+      totarea += lightarea;
+
+      if (use_light_tree && !light_is_distant(light)) {
+        leaf_table[light_index] = emitters.size();
+        emitters.push_back(light_tree_emitter(light, offset));
+      }
+
+      if (light->light_type == LIGHT_DISTANT) {
+        use_lamp_mis |= (light->angle > 0.0f && light->use_mis);
+      }
+      else if (light->light_type == LIGHT_POINT || light->light_type == LIGHT_SPOT) {
+        use_lamp_mis |= (light->size > 0.0f && light->use_mis);
+      }
+      else if (light->light_type == LIGHT_AREA) {
+        use_lamp_mis |= light->use_mis;
+      }
+      else if (light->light_type == LIGHT_BACKGROUND) {
+        num_background_lights++;
+        background_mis |= light->use_mis;
+      }
+
+      offset++;
+    }
   }
 
   /* normalize cumulative distribution functions */
@@ -501,9 +648,21 @@ void LightManager::device_update_distribution(Device *,
     /* CDF */
     dscene->light_distribution.copy_to_device();
 
+    /* Light tree */
+    kintegrator->use_light_tree = use_light_tree;
+    kintegrator->num_distant_lights = use_light_tree ? num_distant_lights : 0;
+
+    if (use_light_tree) {
+      device_update_tree(dscene,
+                         emitters,
+                         leaf_table,
+                         leaf_table_objects_offset,
+                         leaf_table_triangles_offset);
+    }
+
     /* Portals */
     if (num_portals > 0) {
-      kbackground->portal_offset = light_index;
+      kbackground->portal_offset = num_lights;
       kbackground->num_portals = num_portals;
       kbackground->portal_weight = 1.0f;
     }
@@ -524,6 +683,8 @@ void LightManager::device_update_distribution(Device *,
     kintegrator->pdf_triangles = 0.0f;
     kintegrator->pdf_lights = 0.0f;
     kintegrator->use_lamp_mis = false;
+    kintegrator->use_light_tree = false;
+    kintegrator->num_distant_lights = 0;
 
     kbackground->num_portals = 0;
     kbackground->portal_offset = 0;
@@ -1014,6 +1175,8 @@ void LightManager::device_free(Device *, DeviceScene *dscene, const bool free_ba
 {
   dscene->light_distribution.free();
   dscene->lights.free();
+  dscene->light_tree_nodes.free();
+  dscene->light_tree_leaf.free();
   if (free_background) {
     dscene->light_background_marginal_cdf.free();
     dscene->light_background_conditional_cdf.free();
@@ -35,6 +35,7 @@ CCL_NAMESPACE_BEGIN
 class Device;
 class DeviceScene;
 class Object;
+struct LightTreeEmitter;
 class Progress;
 class Scene;
 class Shader;
@@ -100,6 +101,7 @@ class LightManager {
     OBJECT_MANAGER = (1 << 5),
     SHADER_COMPILED = (1 << 6),
     SHADER_MODIFIED = (1 << 7),
+    INTEGRATOR_MODIFIED = (1 << 8),
 
     /* tag everything in the manager for an update */
     UPDATE_ALL = ~0u,
@@ -142,6 +144,11 @@ class LightManager {
                                   DeviceScene *dscene,
                                   Scene *scene,
                                   Progress &progress);
+  void device_update_tree(DeviceScene *dscene,
+                          const vector<LightTreeEmitter> &emitters,
+                          vector<int> &leaf_table,
+                          size_t leaf_table_objects_offset,
+                          size_t leaf_table_triangles_offset);
   void device_update_background(Device *device,
                                 DeviceScene *dscene,
                                 Scene *scene,
@@ -0,0 +1,277 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "render/light_tree.h"
+
+#include "util/util_algorithm.h"
+#include "util/util_math.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Number of buckets to evaluate split candidates per axis. */
+static const int LIGHT_TREE_NUM_BUCKETS = 12;
+/* Beyond this depth use median splits, so the tree depth stays bounded. */
+static const int LIGHT_TREE_MAX_SAOH_DEPTH = 48;
+
+/* Light Tree Cone */
+
+LightTreeCone LightTreeCone::merge(const LightTreeCone &a, const LightTreeCone &b)
+{
+  if (b.theta_o > a.theta_o) {
+    return merge(b, a);
+  }
+
+  const float theta_e = max(a.theta_e, b.theta_e);
+  const float theta_d = safe_acosf(dot(a.axis, b.axis));
+
+  if (min(theta_d + b.theta_o, M_PI_F) <= a.theta_o) {
+    /* Cone b is inside cone a. */
+    return LightTreeCone(a.axis, a.theta_o, theta_e);
+  }
+
+  const float theta_o = 0.5f * (a.theta_o + theta_d + b.theta_o);
+  if (theta_o >= M_PI_F) {
+    return LightTreeCone(a.axis, M_PI_F, theta_e);
+  }
+
+  /* Rotate the axis of a towards b. */
+  const float3 rotation_axis = cross(a.axis, b.axis);
+  const float rotation_axis_len = len(rotation_axis);
+  if (rotation_axis_len < 1e-6f) {
+    /* Opposite axes with cones that don't reach each other, no narrower cone than the full
+     * sphere contains both. */
+    return LightTreeCone(a.axis, M_PI_F, theta_e);
+  }
+
+  const float theta_r = theta_o - a.theta_o;
+  const float3 k = rotation_axis / rotation_axis_len;
+  const float3 axis = a.axis * cosf(theta_r) + cross(k, a.axis) * sinf(theta_r);
+  return LightTreeCone(normalize(axis), theta_o, theta_e);
+}
+
+float LightTreeCone::measure() const
+{
+  const float theta_w = min(theta_o + theta_e, M_PI_F);
+  const float sin_theta_o = sinf(theta_o);
+  const float cos_theta_o = cosf(theta_o);
+  return M_2PI_F * (1.0f - cos_theta_o) +
+         M_PI_2_F * (2.0f * theta_w * sin_theta_o - cosf(theta_o - 2.0f * theta_w) -
+                     2.0f * theta_o * sin_theta_o + cos_theta_o);
+}
+
+/* Light Tree */
+
+LightTree::LightTree(const vector<LightTreeEmitter> &emitters) : emitters(emitters)
+{
+  if (emitters.empty()) {
+    return;
+  }
+
+  primitives.resize(emitters.size());
+  for (size_t i = 0; i < emitters.size(); i++) {
+    BuildPrimitive &prim = primitives[i];
+    prim.bounds = emitters[i].bounds;
+    prim.centroid = emitters[i].bounds.center();
+    prim.cone = emitters[i].cone;
+    prim.energy = emitters[i].energy;
+    prim.emitter_index = i;
+  }
+
+  emitter_leaves.resize(emitters.size(), -1);
+  nodes.reserve(emitters.size() * 2 - 1);
+
+  recursive_build(-1, 0, primitives.size(), 0);
+
+  primitives.clear();
+  primitives.shrink_to_fit();
+}
+
+int LightTree::recursive_build(int parent_index, int start, int end, int depth)
+{
+  BoundBox bounds = BoundBox::empty;
+  BoundBox centroid_bounds = BoundBox::empty;
+  LightTreeCone cone = primitives[start].cone;
+  float energy = 0.0f;
+
+  for (int i = start; i < end; i++) {
+    const BuildPrimitive &prim = primitives[i];
+    bounds.grow(prim.bounds);
+    centroid_bounds.grow(prim.centroid);
+    energy += prim.energy;
+    if (i != start) {
+      cone = LightTreeCone::merge(cone, prim.cone);
+    }
+  }
+
+  KernelLightTreeNode knode;
+  knode.bounds_min[0] = bounds.min.x;
+  knode.bounds_min[1] = bounds.min.y;
+  knode.bounds_min[2] = bounds.min.z;
+  knode.energy = energy;
+  knode.bounds_max[0] = bounds.max.x;
+  knode.bounds_max[1] = bounds.max.y;
+  knode.bounds_max[2] = bounds.max.z;
+  knode.theta_o = cone.theta_o;
+  knode.axis[0] = cone.axis.x;
+  knode.axis[1] = cone.axis.y;
+  knode.axis[2] = cone.axis.z;
+  knode.theta_e = cone.theta_e;
+  knode.child_index = -1;
+  knode.parent_index = parent_index;
+  knode.pad1 = 0;
+  knode.pad2 = 0;
+
+  const int node_index = nodes.size();
+
+  if (end - start == 1) {
+    const int emitter_index = primitives[start].emitter_index;
+    knode.child_index = ~emitters[emitter_index].distribution_index;
+    emitter_leaves[emitter_index] = node_index;
+    nodes.push_back(knode);
+    return node_index;
+  }
+
+  nodes.push_back(knode);
+
+  const int middle = split(start, end, centroid_bounds, depth);
+  /* The first child directly follows its parent. */
+  recursive_build(node_index, start, middle, depth + 1);
+  nodes[node_index].child_index = recursive_build(node_index, middle, end, depth + 1);
+
+  return node_index;
+}
+
+namespace {
+
+struct LightTreeBucket {
+  BoundBox bounds = BoundBox::empty;
+  LightTreeCone cone;
+  float energy = 0.0f;
+  int count = 0;
+
+  void add(const BoundBox &other_bounds, const LightTreeCone &other_cone, float other_energy)
+  {
+    bounds.grow(other_bounds);
+    cone = (count == 0) ? other_cone : LightTreeCone::merge(cone, other_cone);
+    energy += other_energy;
+    count++;
+  }
+
+  void add(const LightTreeBucket &other)
+  {
+    if (other.count != 0) {
+      bounds.grow(other.bounds);
+      cone = (count == 0) ? other.cone : LightTreeCone::merge(cone, other.cone);
+      energy += other.energy;
+      count += other.count;
+    }
+  }
+
+  float cost() const
+  {
+    return energy * cone.measure() * bounds.safe_area();
+  }
+};
+
+}  // namespace
+
+/* Split primitives in two, returns the index of the first primitive of the second half. */
+int LightTree::split(int start, int end, const BoundBox &centroid_bounds, int depth)
+{
+  const float3 extent = centroid_bounds.size();
+  const float max_extent = max3(extent);
+
+  float min_cost = FLT_MAX;
+  int min_axis = -1;
+  int min_bucket = 0;
+
+  if (depth < LIGHT_TREE_MAX_SAOH_DEPTH) {
+    for (int axis = 0; axis < 3; axis++) {
+      if (!(extent[axis] > 0.0f)) {
+        continue;
+      }
+
+      LightTreeBucket buckets[LIGHT_TREE_NUM_BUCKETS];
+      const float inv_extent = LIGHT_TREE_NUM_BUCKETS / extent[axis];
+      for (int i = start; i < end; i++) {
+        const BuildPrimitive &prim = primitives[i];
+        const int bucket = clamp(
+            (int)((prim.centroid[axis] - centroid_bounds.min[axis]) * inv_extent),
+            0,
+            LIGHT_TREE_NUM_BUCKETS - 1);
+        buckets[bucket].add(prim.bounds, prim.cone, prim.energy);
+      }
+
+      /* Sweep from the right to get the bounds of all buckets right of each split. */
+      LightTreeBucket right_sums[LIGHT_TREE_NUM_BUCKETS];
+      right_sums[LIGHT_TREE_NUM_BUCKETS - 1] = buckets[LIGHT_TREE_NUM_BUCKETS - 1];
+      for (int i = LIGHT_TREE_NUM_BUCKETS - 2; i >= 0; i--) {
+        right_sums[i] = right_sums[i + 1];
+        right_sums[i].add(buckets[i]);
+      }
+
+      /* Favor splitting along the largest axis, emitters are usually not cube shaped. */
+      const float regularization = max_extent / extent[axis];
+
+      LightTreeBucket left_sum;
+      for (int i = 1; i < LIGHT_TREE_NUM_BUCKETS; i++) {
+        left_sum.add(buckets[i - 1]);
+        const LightTreeBucket &right_sum = right_sums[i];
+        if (left_sum.count == 0 || right_sum.count == 0) {
+          continue;
+        }
+
+        const float cost = (left_sum.cost() + right_sum.cost()) * regularization;
+        if (cost < min_cost) {
+          min_cost = cost;
+          min_axis = axis;
+          min_bucket = i;
+        }
+      }
+    }
+  }
+
+  if (min_axis != -1) {
+    const float inv_extent = LIGHT_TREE_NUM_BUCKETS / extent[min_axis];
+    const float min_centroid = centroid_bounds.min[min_axis];
+    BuildPrimitive *middle = std::partition(
+        primitives.data() + start, primitives.data() + end, [&](const BuildPrimitive &prim) {
+          const int bucket = clamp((int)((prim.centroid[min_axis] - min_centroid) * inv_extent),
+                                   0,
+                                   LIGHT_TREE_NUM_BUCKETS - 1);
+          return bucket < min_bucket;
+        });
+    const int middle_index = middle - primitives.data();
+    if (middle_index != start && middle_index != end) {
+      return middle_index;
+    }
+  }
+
+  /* Fall back to a median split along the largest axis. */
+  const int axis = (extent.x >= extent.y && extent.x >= extent.z) ?
+                       0 :
+                       ((extent.y >= extent.z) ? 1 : 2);
+  const int middle_index = (start + end) / 2;
+  std::nth_element(primitives.data() + start,
+                   primitives.data() + middle_index,
+                   primitives.data() + end,
+                   [axis](const BuildPrimitive &a, const BuildPrimitive &b) {
+                     return a.centroid[axis] < b.centroid[axis];
+                   });
+  return middle_index;
+}
+
+CCL_NAMESPACE_END
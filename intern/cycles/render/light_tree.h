@@ -0,0 +1,108 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LIGHT_TREE_H__
+#define __LIGHT_TREE_H__
+
+#include "kernel/kernel_types.h"
+
+#include "util/util_boundbox.h"
+#include "util/util_types.h"
+#include "util/util_vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Bounds of the emission directions: all normals are within `theta_o` of the axis, and light
+ * is emitted within `theta_e` of the normals. */
+struct LightTreeCone {
+  float3 axis;
+  float theta_o;
+  float theta_e;
+
+  LightTreeCone() : axis(make_float3(0.0f, 0.0f, 1.0f)), theta_o(0.0f), theta_e(0.0f)
+  {
+  }
+
+  LightTreeCone(const float3 &axis, float theta_o, float theta_e)
+      : axis(axis), theta_o(theta_o), theta_e(theta_e)
+  {
+  }
+
+  /* Cone containing both cones. */
+  static LightTreeCone merge(const LightTreeCone &a, const LightTreeCone &b);
+
+  /* Measure of the solid angle of emission, used for the build cost. */
+  float measure() const;
+};
+
+/* Triangle or lamp to be put in the tree. */
+struct LightTreeEmitter {
+  BoundBox bounds;
+  LightTreeCone cone;
+  float energy;
+  /* Index in the light distribution. */
+  int distribution_index;
+
+  LightTreeEmitter(const BoundBox &bounds,
+                   const LightTreeCone &cone,
+                   float energy,
+                   int distribution_index)
+      : bounds(bounds), cone(cone), energy(energy), distribution_index(distribution_index)
+  {
+  }
+};
+
+/* Light Tree
+ *
+ * Binary tree over all emitters with a position, built with the surface area orientation
+ * heuristic. Each leaf contains a single emitter. */
+class LightTree {
+ public:
+  LightTree(const vector<LightTreeEmitter> &emitters);
+
+  /* Nodes in the layout used by the kernel. */
+  const vector<KernelLightTreeNode> &get_nodes() const
+  {
+    return nodes;
+  }
+
+  /* Index of the leaf node for each emitter passed to the constructor. */
+  const vector<int> &get_emitter_leaves() const
+  {
+    return emitter_leaves;
+  }
+
+ protected:
+  struct BuildPrimitive {
+    BoundBox bounds;
+    float3 centroid;
+    LightTreeCone cone;
+    float energy;
+    int emitter_index;
+  };
+
+  int recursive_build(int parent_index, int start, int end, int depth);
+  int split(int start, int end, const BoundBox &centroid_bounds, int depth);
+
+  const vector<LightTreeEmitter> &emitters;
+  vector<BuildPrimitive> primitives;
+  vector<KernelLightTreeNode> nodes;
+  vector<int> emitter_leaves;
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __LIGHT_TREE_H__ */
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "render/path_guiding.h"
+
+#include "util/util_logging.h"
+#include "util/util_math.h"
+
+CCL_NAMESPACE_BEGIN
+
+#ifdef __PATH_GUIDING__
+
+void path_guiding_field_init(PathGuidingField *field)
+{
+  memset(field, 0, sizeof(PathGuidingField));
+}
+
+void path_guiding_field_free(PathGuidingField *field)
+{
+  if (field->cells != NULL) {
+    int num_allocated_cells = 0;
+
+    for (int i = 0; i < field->num_cells; i++) {
+      PathGuidingCell *cell = field->cells[i];
+      if (cell == NULL) {
+        continue;
+      }
+
+      /* Memory is allocated by the kernel with malloc. */
+      for (int j = 0; j < PATH_GUIDING_MAX_DISTRIBUTIONS; j++) {
+        free(cell->distributions[j]);
+      }
+      free(cell);
+      num_allocated_cells++;
+    }
+
+    VLOG(1) << "Path guiding used " << num_allocated_cells << " of " << field->num_cells
+            << " cells.";
+
+    free(field->cells);
+  }
+
+  path_guiding_field_init(field);
+}
+
+void path_guiding_field_reset(PathGuidingField *field, const BoundBox &bounds)
+{
+  path_guiding_field_free(field);
+
+  if (!bounds.valid()) {
+    return;
+  }
+
+  const float3 size = bounds.size();
+  const float cell_size = max3(size) / PATH_GUIDING_RESOLUTION;
+  if (!(cell_size > 0.0f)) {
+    return;
+  }
+
+  field->bounds_min = bounds.min;
+  field->inv_cell_size = make_float3(1.0f / cell_size, 1.0f / cell_size, 1.0f / cell_size);
+  field->num_cells = 1;
+  for (int i = 0; i < 3; i++) {
+    field->resolution[i] = clamp((int)ceilf(size[i] / cell_size), 1, PATH_GUIDING_RESOLUTION);
+    field->num_cells *= field->resolution[i];
+  }
+
+  field->cells = (PathGuidingCell **)calloc(field->num_cells, sizeof(PathGuidingCell *));
+  if (field->cells == NULL) {
+    field->num_cells = 0;
+  }
+}
+
+#endif /* __PATH_GUIDING__ */
+
+CCL_NAMESPACE_END
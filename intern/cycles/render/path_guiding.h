@@ -0,0 +1,43 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __PATH_GUIDING_H__
+#define __PATH_GUIDING_H__
+
+#include "kernel/kernel_types.h"
+
+#include "util/util_boundbox.h"
+
+CCL_NAMESPACE_BEGIN
+
+#ifdef __PATH_GUIDING__
+
+/* Path Guiding Field
+ *
+ * Host side of the distributions the CPU kernel learns for path guiding. The field is owned
+ * by the device, the kernel allocates cells and distributions in it while rendering and they
+ * are freed here between renders. */
+
+void path_guiding_field_init(PathGuidingField *field);
+void path_guiding_field_free(PathGuidingField *field);
+/* Discard everything learned and set up an empty grid over the bounds. */
+void path_guiding_field_reset(PathGuidingField *field, const BoundBox &bounds);
+
+#endif /* __PATH_GUIDING__ */
+
+CCL_NAMESPACE_END
+
+#endif /* __PATH_GUIDING_H__ */
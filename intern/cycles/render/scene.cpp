@@ -79,6 +79,8 @@ DeviceScene::DeviceScene(Device *device)
       lights(device, "__lights", MEM_GLOBAL),
       light_background_marginal_cdf(device, "__light_background_marginal_cdf", MEM_GLOBAL),
       light_background_conditional_cdf(device, "__light_background_conditional_cdf", MEM_GLOBAL),
+      light_tree_nodes(device, "__light_tree_nodes", MEM_GLOBAL),
+      light_tree_leaf(device, "__light_tree_leaf", MEM_GLOBAL),
       particles(device, "__particles", MEM_GLOBAL),
       svm_nodes(device, "__svm_nodes", MEM_GLOBAL),
       shaders(device, "__shaders", MEM_GLOBAL),
@@ -316,6 +318,7 @@ void Scene::device_update(Device *device_, Progress &progress)
 
   progress.set_status("Updating Integrator");
   integrator->device_update(device, &dscene, this);
+  integrator->device_update_path_guiding(device, &dscene, this);
 
   if (progress.get_cancel() || device->have_error())
     return;
@@ -21,6 +21,7 @@
 
 #include "render/film.h"
 #include "render/image.h"
+#include "render/image_cache.h"
 #include "render/shader.h"
 
 #include "device/device.h"
@@ -116,6 +117,8 @@ class DeviceScene {
   device_vector<KernelLight> lights;
   device_vector<float2> light_background_marginal_cdf;
   device_vector<float2> light_background_conditional_cdf;
+  device_vector<KernelLightTreeNode> light_tree_nodes;
+  device_vector<int> light_tree_leaf;
 
   /* particles */
   device_vector<KernelParticle> particles;
@@ -180,6 +183,7 @@ class SceneParams {
   CurveShapeType hair_shape;
   bool persistent_data;
   int texture_limit;
+  TextureCacheParams texture_cache;
 
   bool background;
 
@@ -206,7 +210,8 @@ class SceneParams {
              use_bvh_unaligned_nodes == params.use_bvh_unaligned_nodes &&
              num_bvh_time_steps == params.num_bvh_time_steps &&
              hair_subdivisions == params.hair_subdivisions && hair_shape == params.hair_shape &&
-             persistent_data == params.persistent_data && texture_limit == params.texture_limit);
+             persistent_data == params.persistent_data && texture_limit == params.texture_limit &&
+             texture_cache == params.texture_cache);
   }
 
   int curve_subdivisions()
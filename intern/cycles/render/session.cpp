@@ -424,6 +424,7 @@ bool Session::steal_tile(RenderTile &rtile, Device *tile_device, thread_scoped_l
   rtile.buffers->buffer.move_device(tile_device);
   rtile.buffer = rtile.buffers->buffer.device_pointer;
   rtile.stealing_state = RenderTile::NO_STEALING;
+  rtile.can_split = false;
   rtile.num_samples -= (rtile.sample - rtile.start_sample);
   rtile.start_sample = rtile.sample;
 
@@ -443,6 +444,93 @@ bool Session::get_tile_stolen()
   return tile_stealing_state.compare_exchange_weak(expected, RELEASING_TILE);
 }
 
+/* Tiles are only split when parts have at least this many rows and samples left. */
+static const int TILE_SPLIT_MIN_ROWS = 4;
+static const int TILE_SPLIT_MIN_SAMPLES = 2;
+/* Splitting tiles with less work left than this costs more in synchronization than it gains. */
+static const int64_t TILE_SPLIT_MIN_PIXEL_SAMPLES = 8192;
+
+bool Session::split_tile(RenderTile &rtile)
+{
+  /* Avoid locking when no thread is waiting for work, this is called for every sample. */
+  if (split_requests == 0) {
+    return false;
+  }
+
+  thread_scoped_lock tile_lock(tile_mutex);
+
+  /* Other tiles were already split for all waiting threads. */
+  if (split_requests <= (int)split_tile_parts.size()) {
+    return false;
+  }
+
+  const int remaining_samples = rtile.start_sample + rtile.num_samples - rtile.sample;
+  const int part_h = rtile.h / 2;
+
+  if (part_h < TILE_SPLIT_MIN_ROWS || remaining_samples < TILE_SPLIT_MIN_SAMPLES ||
+      (int64_t)rtile.w * part_h * remaining_samples < TILE_SPLIT_MIN_PIXEL_SAMPLES) {
+    /* Not enough work left, stop waiting threads from counting on this tile. */
+    rtile.can_split = false;
+    splittable_tiles--;
+    if (splittable_tiles == 0) {
+      tile_split_cond.notify_all();
+    }
+    return false;
+  }
+
+  /* Parts share the buffers of the tile, which then can't be moved to another device. */
+  if (rtile.stealing_state == RenderTile::CAN_BE_STOLEN) {
+    rtile.stealing_state = RenderTile::NO_STEALING;
+    stealable_tiles--;
+    if (stealable_tiles == 0) {
+      tile_steal_cond.notify_all();
+    }
+  }
+
+  /* Hand the bottom rows over with the remaining samples, samples already rendered for them
+   * stay in the buffer. */
+  RenderTile part = rtile;
+  part.y = rtile.y + part_h;
+  part.h = rtile.h - part_h;
+  part.start_sample = rtile.sample;
+  part.num_samples = remaining_samples;
+  rtile.h = part_h;
+
+  Tile &tile = tile_manager.state.tiles[rtile.tile_index];
+  tile.num_parts++;
+  tile.was_split = true;
+
+  splittable_tiles++;
+  split_tile_parts.push_back(part);
+  tile_split_cond.notify_one();
+
+  return true;
+}
+
+bool Session::acquire_tile_part(RenderTile &rtile,
+                                Device *tile_device,
+                                thread_scoped_lock &tile_lock)
+{
+  /* Only threads of the CPU device split their tiles. */
+  if (tile_device->info.type != DEVICE_CPU) {
+    return false;
+  }
+
+  split_requests++;
+  while (split_tile_parts.empty() && splittable_tiles > 0 && !progress.get_cancel()) {
+    tile_split_cond.wait(tile_lock);
+  }
+  split_requests--;
+
+  if (split_tile_parts.empty()) {
+    return false;
+  }
+
+  rtile = split_tile_parts.front();
+  split_tile_parts.pop_front();
+  return true;
+}
+
 bool Session::acquire_tile(RenderTile &rtile, Device *tile_device, uint tile_types)
 {
   if (progress.get_cancel()) {
@@ -467,6 +555,12 @@ bool Session::acquire_tile(RenderTile &rtile, Device *tile_device, uint tile_typ
       return true;
     }
 
+    /* Render part of a tile that is still in progress on another thread. */
+    if ((tile_types & RenderTile::PATH_TRACE) &&
+        acquire_tile_part(rtile, tile_device, tile_lock)) {
+      return true;
+    }
+
     /* Wait for denoising tiles to become available */
     if ((tile_types & RenderTile::DENOISE) && !progress.get_cancel() && tile_manager.has_tiles()) {
       denoising_cond.wait(tile_lock);
@@ -486,6 +580,9 @@ bool Session::acquire_tile(RenderTile &rtile, Device *tile_device, uint tile_typ
   rtile.resolution = tile_manager.state.resolution_divider;
   rtile.tile_index = tile->index;
   rtile.stealing_state = RenderTile::NO_STEALING;
+  rtile.can_split = false;
+  tile->num_parts = 1;
+  tile->was_split = false;
 
   if (tile->state == Tile::DENOISE) {
     rtile.task = RenderTile::DENOISE;
@@ -501,6 +598,14 @@ bool Session::acquire_tile(RenderTile &rtile, Device *tile_device, uint tile_typ
     }
     else {
       rtile.task = RenderTile::PATH_TRACE;
+
+      /* Parts of the tile can be rendered by other threads when they run out of tiles. Not
+       * with a full frame buffer, which is written to by the display. */
+      if (tile_device->info.type == DEVICE_CPU && !buffers && !params.progressive_refine &&
+          rtile.num_samples > 1) {
+        splittable_tiles++;
+        rtile.can_split = true;
+      }
     }
   }
 
@@ -582,7 +687,10 @@ void Session::update_tile_sample(RenderTile &rtile)
   thread_scoped_lock tile_lock(tile_mutex);
 
   if (update_render_tile_cb) {
-    if (params.progressive_refine == false) {
+    /* The rectangle of a split tile only covers part of the tile, the full tile is written
+     * when the last part is released. */
+    const Tile &tile = tile_manager.state.tiles[rtile.tile_index];
+    if (params.progressive_refine == false && !tile.was_split) {
       /* todo: optimize this by making it thread safe and removing lock */
 
       update_render_tile_cb(rtile, true);
@@ -596,6 +704,15 @@ void Session::release_tile(RenderTile &rtile, const bool need_denoise)
 {
   thread_scoped_lock tile_lock(tile_mutex);
 
+  if (rtile.can_split) {
+    rtile.can_split = false;
+    splittable_tiles--;
+    if (splittable_tiles == 0) {
+      /* If this was the last splittable tile, wake up any threads still waiting for a part. */
+      tile_split_cond.notify_all();
+    }
+  }
+
   if (rtile.stealing_state != RenderTile::NO_STEALING) {
     stealable_tiles--;
     if (rtile.stealing_state == RenderTile::WAS_STOLEN) {
@@ -616,6 +733,25 @@ void Session::release_tile(RenderTile &rtile, const bool need_denoise)
     }
   }
 
+  if (rtile.task == RenderTile::PATH_TRACE) {
+    Tile &tile = tile_manager.state.tiles[rtile.tile_index];
+    if (tile.num_parts > 1) {
+      /* Other parts of the tile are still being rendered. */
+      tile.num_parts--;
+      return;
+    }
+    if (tile.was_split) {
+      /* Write the full tile, not just the last part. */
+      tile.was_split = false;
+      rtile.x = tile_manager.state.buffer.full_x + tile.x;
+      rtile.y = tile_manager.state.buffer.full_y + tile.y;
+      rtile.w = tile.w;
+      rtile.h = tile.h;
+      rtile.start_sample = tile_manager.state.sample;
+      rtile.num_samples = tile_manager.state.num_samples;
+    }
+  }
+
   progress.add_finished_tile(rtile.task == RenderTile::DENOISE);
 
   bool delete_tile;
@@ -925,6 +1061,9 @@ void Session::reset_(BufferParams &buffer_params, int samples)
   tile_manager.reset(buffer_params, samples);
   stealable_tiles = 0;
   tile_stealing_state = NOT_STEALING;
+  split_tile_parts.clear();
+  split_requests = 0;
+  splittable_tiles = 0;
   progress.reset_sample();
 
   bool show_progress = params.background || tile_manager.get_num_effective_samples() != INT_MAX;
@@ -1176,6 +1315,7 @@ void Session::render(bool need_denoise)
   task.update_tile_sample = function_bind(&Session::update_tile_sample, this, _1);
   task.update_progress_sample = function_bind(&Progress::add_samples, &this->progress, _1, _2);
   task.get_tile_stolen = function_bind(&Session::get_tile_stolen, this);
+  task.split_tile = function_bind(&Session::split_tile, this, _1);
   task.need_finish_queue = params.progressive_refine;
   task.integrator_branched = scene->integrator->get_method() == Integrator::BRANCHED_PATH;
 
@@ -197,6 +197,8 @@ class Session {
 
   bool steal_tile(RenderTile &tile, Device *tile_device, thread_scoped_lock &tile_lock);
   bool get_tile_stolen();
+  bool split_tile(RenderTile &tile);
+  bool acquire_tile_part(RenderTile &tile, Device *tile_device, thread_scoped_lock &tile_lock);
   bool acquire_tile(RenderTile &tile, Device *tile_device, uint tile_types);
   void update_tile_sample(RenderTile &tile);
   void release_tile(RenderTile &tile, const bool need_denoise);
@@ -222,6 +224,7 @@ class Session {
   thread_mutex display_mutex;
   thread_condition_variable denoising_cond;
   thread_condition_variable tile_steal_cond;
+  thread_condition_variable tile_split_cond;
 
   double reset_time;
   double last_update_time;
@@ -237,6 +240,12 @@ class Session {
   std::atomic<TileStealingState> tile_stealing_state;
   int stealable_tiles;
 
+  /* Work balancing between threads of the CPU device: threads without tiles wait for parts
+   * of tiles that are still being rendered. */
+  list<RenderTile> split_tile_parts;
+  std::atomic<int> split_requests;
+  int splittable_tiles;
+
   /* progressive refine */
   bool update_progressive_refine(bool cancel);
 };
@@ -40,12 +40,26 @@ class Tile {
   State state;
   RenderBuffers *buffers;
 
+  /* Number of threads rendering parts of the tile. Tiles are split while rendering when other
+   * threads run out of work, the tile is finished when the last part is released. */
+  int num_parts;
+  bool was_split;
+
   Tile()
   {
   }
 
   Tile(int index_, int x_, int y_, int w_, int h_, int device_, State state_ = RENDER)
-      : index(index_), x(x_), y(y_), w(w_), h(h_), device(device_), state(state_), buffers(NULL)
+      : index(index_),
+        x(x_),
+        y(y_),
+        w(w_),
+        h(h_),
+        device(device_),
+        state(state_),
+        buffers(NULL),
+        num_parts(1),
+        was_split(false)
   {
   }
 };
@@ -95,6 +95,8 @@ typedef enum ExtensionType {
 typedef struct TextureInfo {
   /* Pointer, offset or texture depending on device. */
   uint64_t data;
+  /* Image loaded on demand by the CPU texture cache, see #TextureCacheHandle. */
+  uint64_t cache_handle;
   /* Data Type */
   uint data_type;
   /* Buffer number for OpenCL. */
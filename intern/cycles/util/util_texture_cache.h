@@ -0,0 +1,78 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __UTIL_TEXTURE_CACHE_H__
+#define __UTIL_TEXTURE_CACHE_H__
+
+/* Lookups into image textures that are loaded on demand by the OpenImageIO texture system,
+ * one tile of one mipmap level at a time. Only available on the CPU. */
+
+#include <OpenImageIO/texture.h>
+
+#include "util/util_texture.h"
+#include "util/util_types.h"
+
+CCL_NAMESPACE_BEGIN
+
+OIIO_NAMESPACE_USING
+
+/* Image in the texture cache, referenced from #TextureInfo.cache_handle and owned by the
+ * #TextureCache of the image manager. */
+struct TextureCacheHandle {
+  TextureSystem *texture_system;
+  TextureSystem::TextureHandle *handle;
+  /* Wrap and interpolation modes of the image. */
+  TextureOpt options;
+  /* Blur in texture space after diffuse and glossy bounces. */
+  float diffuse_blur;
+  float glossy_blur;
+};
+
+/* Lookup with the derivatives of the texture coordinates along the x and y ray differentials,
+ * which select the mipmap level to read from. */
+inline float4 texture_cache_lookup(
+    const TextureCacheHandle *handle, float x, float y, float2 dx, float2 dy, float blur)
+{
+  TextureOpt options = handle->options;
+  options.sblur = blur;
+  options.tblur = blur;
+
+  TextureSystem *texture_system = handle->texture_system;
+  TextureSystem::Perthread *thread_info = texture_system->get_perthread_info();
+
+  /* OpenImageIO has the origin at the top of the image. */
+  float rgba[4];
+  if (!texture_system->texture(handle->handle,
+                               thread_info,
+                               options,
+                               x,
+                               1.0f - y,
+                               dx.x,
+                               -dx.y,
+                               dy.x,
+                               -dy.y,
+                               4,
+                               rgba)) {
+    return make_float4(
+        TEX_IMAGE_MISSING_R, TEX_IMAGE_MISSING_G, TEX_IMAGE_MISSING_B, TEX_IMAGE_MISSING_A);
+  }
+
+  return make_float4(rgba[0], rgba[1], rgba[2], rgba[3]);
+}
+
+CCL_NAMESPACE_END
+
+#endif /* __UTIL_TEXTURE_CACHE_H__ */
@@ -100,6 +100,15 @@ def blend_extract_thumb(path):
         blendfile.close()
         blendfile = gzip.GzipFile('', 'rb', 0, open_wrapper(path, 'rb'))
         head = blendfile.read(12)
+    elif head[0:4] == b'\x28\xb5\x2f\xfd':  # zstd magic
+        blendfile.close()
+        try:
+            import zstandard
+        except ImportError:
+            # Reading Zstandard compressed files needs the 'zstandard' module.
+            return None, 0, 0
+        blendfile = zstandard.ZstdDecompressor().stream_reader(open_wrapper(path, 'rb'))
+        head = blendfile.read(12)
 
     if not head.startswith(b'BLENDER'):
         blendfile.close()
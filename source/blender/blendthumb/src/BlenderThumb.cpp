@@ -97,7 +97,9 @@ IFACEMETHODIMP CBlendThumb::Initialize(IStream *pStream, DWORD)
 #include "Wincodec.h"
 #include <math.h>
 #include <zlib.h>
+#include <zstd.h>
 const unsigned char gzip_magic[3] = {0x1f, 0x8b, 0x08};
+const unsigned char zstd_magic[4] = {0x28, 0xb5, 0x2f, 0xfd};
 
 // IThumbnailProvider
 IFACEMETHODIMP CBlendThumb::GetThumbnail(UINT cx, HBITMAP *phbmp, WTS_ALPHATYPE *pdwAlpha)
@@ -107,14 +109,20 @@ IFACEMETHODIMP CBlendThumb::GetThumbnail(UINT cx, HBITMAP *phbmp, WTS_ALPHATYPE
   LARGE_INTEGER SeekPos;
 
   // Compressed?
-  unsigned char in_magic[3];
-  _pStream->Read(&in_magic, 3, &BytesRead);
+  unsigned char in_magic[4];
+  _pStream->Read(&in_magic, 4, &BytesRead);
   bool gzipped = true;
   for (int i = 0; i < 3; i++)
     if (in_magic[i] != gzip_magic[i]) {
       gzipped = false;
       break;
     }
+  bool zstd_compressed = (BytesRead == 4);
+  for (int i = 0; i < 4; i++)
+    if (in_magic[i] != zstd_magic[i]) {
+      zstd_compressed = false;
+      break;
+    }
 
   if (gzipped) {
     // Zlib inflate
@@ -167,6 +175,41 @@ IFACEMETHODIMP CBlendThumb::GetThumbnail(UINT cx, HBITMAP *phbmp, WTS_ALPHATYPE
     delete[] src;
     delete[] dest;
   }
+  else if (zstd_compressed) {
+    // The thumbnail is in the first 70KB (see above), which is part of the first frame.
+    const size_t dest_size = 1024 * 70;
+    const size_t src_size = ZSTD_DStreamInSize();
+    char *src = new char[src_size];
+    char *dest = new char[dest_size];
+
+    ZSTD_DCtx *ctx = ZSTD_createDCtx();
+    ZSTD_outBuffer out = {dest, dest_size, 0};
+    ZSTD_inBuffer in = {src, 0, 0};
+
+    SeekPos.QuadPart = 0;
+    _pStream->Seek(SeekPos, STREAM_SEEK_SET, NULL);
+    while (out.pos < out.size) {
+      if (in.pos == in.size) {
+        _pStream->Read(src, (ULONG)src_size, &BytesRead);
+        if (BytesRead == 0) {
+          break;
+        }
+        in.size = BytesRead;
+        in.pos = 0;
+      }
+      if (ZSTD_isError(ZSTD_decompressStream(ctx, &out, &in))) {
+        break;
+      }
+    }
+    ZSTD_freeDCtx(ctx);
+
+    // Replace the IStream, which is read-only
+    _pStream->Release();
+    _pStream = SHCreateMemStream((const BYTE *)dest, (UINT)out.pos);
+
+    delete[] src;
+    delete[] dest;
+  }
 
   // Blender version, early out if sub 2.5
   SeekPos.QuadPart = 9;
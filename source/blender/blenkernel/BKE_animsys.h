@@ -30,6 +30,7 @@ extern "C" {
 #endif
 
 struct AnimData;
+struct AnimPathCache;
 struct BlendDataReader;
 struct BlendExpander;
 struct BlendLibReader;
@@ -242,6 +243,25 @@ bool BKE_animsys_store_rna_setting(struct PointerRNA *ptr,
 bool BKE_animsys_read_rna_setting(struct PathResolvedRNA *anim_rna, float *r_value);
 bool BKE_animsys_write_rna_setting(struct PathResolvedRNA *anim_rna, const float value);
 
+/* Resolved RNA paths of F-Curves and driver targets, stored as runtime data of evaluated
+ * animation data so that playback doesn't parse the paths again on every frame. Entries are
+ * keyed by the F-Curve or driver target, with separate slots for the evaluated and original
+ * data-block. */
+struct AnimPathCache *BKE_animsys_path_cache_new(void);
+void BKE_animsys_path_cache_free(struct AnimPathCache *cache);
+bool BKE_animsys_path_cache_lookup(const struct AnimPathCache *cache,
+                                   const void *key,
+                                   const bool orig,
+                                   const struct PointerRNA *ptr,
+                                   struct PathResolvedRNA *r_result);
+void BKE_animsys_path_cache_store(struct AnimPathCache *cache,
+                                  const void *key,
+                                  const bool orig,
+                                  const struct PointerRNA *ptr,
+                                  const struct PathResolvedRNA *result);
+/* Invalidate all cached paths, needed whenever data they point to may have been freed. */
+void BKE_animsys_path_cache_invalidate(void);
+
 /* Evaluation loop for evaluating animation data  */
 void BKE_animsys_evaluate_animdata(struct ID *id,
                                    struct AnimData *adt,
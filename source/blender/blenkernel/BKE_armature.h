@@ -429,6 +429,12 @@ void BKE_pose_eval_proxy_copy_bone(struct Depsgraph *depsgraph,
 /* Note that we could have a 'BKE_armature_deform_coords' that doesn't take object data
  * currently there are no callers for this though. */
 
+/**
+ * Blend the bone matrices of vertex weights for linear blend skinning, instead of deforming the
+ * vertex by every weight separately. Only changed by tests, to compare both.
+ */
+extern bool BKE_armature_deform_blend_matrices;
+
 void BKE_armature_deform_coords_with_gpencil_stroke(const struct Object *ob_arm,
                                                     const struct Object *ob_target,
                                                     float (*vert_coords)[3],
@@ -270,7 +270,18 @@ void free_bvhtree_from_pointcloud(struct BVHTreeFromPointCloud *data);
 
 /* Using local coordinates */
 
+typedef struct BVHCacheStats {
+  /** Number of lookups that found a built tree. */
+  int hit_count;
+  /** Number of lookups that waited for another thread to finish building the tree. */
+  int wait_count;
+  /** Number of trees built and the total time spent building them (in seconds). */
+  int build_count;
+  float build_time;
+} BVHCacheStats;
+
 bool bvhcache_has_tree(const struct BVHCache *bvh_cache, const BVHTree *tree);
+void bvhcache_stats_get(const struct BVHCache *bvh_cache, BVHCacheStats *r_stats);
 struct BVHCache *bvhcache_init(void);
 void bvhcache_free(struct BVHCache *bvh_cache);
 
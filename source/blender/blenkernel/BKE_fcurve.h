@@ -32,6 +32,7 @@ extern "C" {
 struct ChannelDriver;
 struct FCM_EnvelopeData;
 struct FCurve;
+struct FCurveBatch;
 struct FModifier;
 
 struct AnimData;
@@ -306,6 +307,12 @@ float calculate_fcurve(struct PathResolvedRNA *anim_rna,
                        struct FCurve *fcu,
                        const struct AnimationEvalContext *anim_eval_context);
 
+/* evaluate a compiled list of fcurves */
+struct FCurveBatch *BKE_fcurve_batch_new(ListBase *fcurves);
+void BKE_fcurve_batch_free(struct FCurveBatch *batch);
+void BKE_fcurve_batch_evaluate(struct FCurveBatch *batch, float evaltime);
+bool BKE_fcurve_batch_value(const struct FCurveBatch *batch, int index, float *r_value);
+
 /* ************* F-Curve Samples API ******************** */
 
 /* -------- Defines --------  */
@@ -150,6 +150,10 @@ class GeometryComponent {
   void user_remove() const;
   bool is_mutable() const;
 
+  /* Returns false when the component references data that is owned by someone else, and might be
+   * freed while the component is still alive. */
+  virtual bool owns_direct_data() const;
+
   GeometryComponentType type() const;
 
   /* Return true when any attribute with this name exists, including built in attributes. */
@@ -359,6 +363,7 @@ class MeshComponent : public GeometryComponent {
   void replace_mesh_but_keep_vertex_group_names(
       Mesh *mesh, GeometryOwnershipType ownership = GeometryOwnershipType::Owned);
   Mesh *release();
+  bool owns_direct_data() const final;
 
   void copy_vertex_group_names_from_object(const struct Object &object);
   const blender::Map<std::string, int> &vertex_group_names() const;
@@ -395,6 +400,7 @@ class PointCloudComponent : public GeometryComponent {
   void replace(PointCloud *pointcloud,
                GeometryOwnershipType ownership = GeometryOwnershipType::Owned);
   PointCloud *release();
+  bool owns_direct_data() const final;
 
   const PointCloud *get_for_read() const;
   PointCloud *get_for_write();
@@ -452,6 +458,7 @@ class VolumeComponent : public GeometryComponent {
   bool has_volume() const;
   void replace(Volume *volume, GeometryOwnershipType ownership = GeometryOwnershipType::Owned);
   Volume *release();
+  bool owns_direct_data() const final;
 
   const Volume *get_for_read() const;
   Volume *get_for_write();
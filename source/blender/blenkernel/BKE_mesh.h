@@ -44,6 +44,7 @@ struct MDisps;
 struct MEdge;
 struct MFace;
 struct MLoop;
+struct MLoopSplitFans;
 struct MLoopTri;
 struct MLoopUV;
 struct MPoly;
@@ -424,6 +425,25 @@ void BKE_mesh_normals_loop_split(const struct MVert *mverts,
                                  short (*clnors_data)[2],
                                  int *r_loop_to_poly);
 
+struct MLoopSplitFans *BKE_mesh_loop_split_fans_create(const struct MVert *mverts,
+                                                       const struct MEdge *medges,
+                                                       const int numEdges,
+                                                       const struct MLoop *mloops,
+                                                       const int numLoops,
+                                                       const struct MPoly *mpolys,
+                                                       const int numPolys);
+struct MLoopSplitFans *BKE_mesh_loop_split_fans_ref(struct MLoopSplitFans *fans);
+void BKE_mesh_loop_split_fans_free(struct MLoopSplitFans *fans);
+void BKE_mesh_normals_loop_split_from_fans(const struct MLoopSplitFans *fans,
+                                           const struct MVert *mverts,
+                                           const struct MEdge *medges,
+                                           const struct MLoop *mloops,
+                                           float (*r_loopnors)[3],
+                                           const float (*polynors)[3],
+                                           MLoopNorSpaceArray *r_lnors_spacearr,
+                                           short (*clnors_data)[2],
+                                           int *r_loop_to_poly);
+
 void BKE_mesh_normals_loop_custom_set(const struct MVert *mverts,
                                       const int numVerts,
                                       struct MEdge *medges,
@@ -459,6 +479,7 @@ bool BKE_mesh_has_custom_loop_normals(struct Mesh *me);
 void BKE_mesh_calc_normals_split(struct Mesh *mesh);
 void BKE_mesh_calc_normals_split_ex(struct Mesh *mesh,
                                     struct MLoopNorSpaceArray *r_lnors_spacearr);
+void BKE_mesh_loop_split_fans_ensure(struct Mesh *mesh);
 
 void BKE_mesh_set_custom_normals(struct Mesh *mesh, float (*r_custom_loopnors)[3]);
 void BKE_mesh_set_custom_normals_from_vertices(struct Mesh *mesh, float (*r_custom_vertnors)[3]);
@@ -792,6 +792,33 @@ static void add_orco_mesh(Object *ob, BMEditMesh *em, Mesh *mesh, Mesh *mesh_orc
   }
 }
 
+/**
+ * Store the smooth fans of split normals on a deformed result, so they are only walked again
+ * when the topology changes. The fans of the previous evaluation are reused when there is one,
+ * see #mesh_build_data_eval_prev_take.
+ */
+static void mesh_calc_modifier_final_loop_split_fans(const Mesh *mesh_eval_prev, Mesh *mesh_final)
+{
+  /* Same condition as #BKE_mesh_calc_normals_split_ex, for edges that are not split by angle. */
+  if (!mesh_final->runtime.deformed_only || (mesh_final->flag & ME_AUTOSMOOTH) == 0 ||
+      (mesh_final->smoothresh < (float)M_PI &&
+       !CustomData_has_layer(&mesh_final->ldata, CD_CUSTOMLOOPNORMAL))) {
+    return;
+  }
+  BLI_assert(mesh_final->runtime.loop_split_fans == nullptr);
+  if (mesh_eval_prev != nullptr && mesh_eval_prev->runtime.loop_split_fans != nullptr &&
+      mesh_eval_prev->totvert == mesh_final->totvert &&
+      mesh_eval_prev->totedge == mesh_final->totedge &&
+      mesh_eval_prev->totloop == mesh_final->totloop &&
+      mesh_eval_prev->totpoly == mesh_final->totpoly) {
+    mesh_final->runtime.loop_split_fans = BKE_mesh_loop_split_fans_ref(
+        mesh_eval_prev->runtime.loop_split_fans);
+  }
+  else {
+    BKE_mesh_loop_split_fans_ensure(mesh_final);
+  }
+}
+
 static void mesh_calc_modifier_final_normals(const Mesh *mesh_input,
                                              const CustomData_MeshMasks *final_datamask,
                                              const bool sculpt_dyntopo,
@@ -941,6 +968,7 @@ static void mesh_calc_modifiers(struct Depsgraph *depsgraph,
                                 const int index,
                                 const bool use_cache,
                                 const bool allow_shared_mesh,
+                                const Mesh *mesh_eval_prev,
                                 /* return args */
                                 Mesh **r_deform,
                                 Mesh **r_final,
@@ -1410,6 +1438,9 @@ static void mesh_calc_modifiers(struct Depsgraph *depsgraph,
 
   /* Compute normals. */
   if (is_own_mesh) {
+    if (use_cache) {
+      mesh_calc_modifier_final_loop_split_fans(mesh_eval_prev, mesh_final);
+    }
     mesh_calc_modifier_final_normals(mesh_input, &final_datamask, sculpt_dyntopo, mesh_final);
   }
   else {
@@ -1848,6 +1879,56 @@ static void mesh_runtime_check_normals_valid(const Mesh *mesh)
   BLI_assert(!(mesh->runtime.cd_dirty_poly & CD_MASK_NORMAL));
 }
 
+/**
+ * Detach the previous evaluated mesh from the object when its batch cache and smooth fans can be
+ * reused by the new evaluation. This is the case when the object is only re-evaluated because its
+ * deformation changed (armature or shape-key animation for example), and neither the object nor
+ * its mesh were edited, so all the data drawn from the mesh except the vertex positions is
+ * unchanged.
+ *
+ * The mesh is freed by #mesh_build_data_eval_prev_reuse once the new mesh is built.
+ */
+static Mesh *mesh_build_data_eval_prev_take(Object *ob)
+{
+  if (ob->runtime.data_eval == nullptr || !ob->runtime.is_data_eval_owned ||
+      ob->runtime.data_orig == nullptr || GS(ob->runtime.data_eval->name) != ID_ME) {
+    return nullptr;
+  }
+  Mesh *mesh_eval_prev = (Mesh *)ob->runtime.data_eval;
+  if ((mesh_eval_prev->runtime.batch_cache == nullptr &&
+       mesh_eval_prev->runtime.loop_split_fans == nullptr) ||
+      !mesh_eval_prev->runtime.deformed_only) {
+    return nullptr;
+  }
+  if ((ob->id.recalc | ob->runtime.data_orig->recalc) & ID_RECALC_COPY_ON_WRITE) {
+    return nullptr;
+  }
+  ob->runtime.data_eval = nullptr;
+  return mesh_eval_prev;
+}
+
+static void mesh_build_data_eval_prev_reuse(Mesh *mesh_eval_prev,
+                                            Mesh *mesh_eval,
+                                            const bool is_mesh_eval_owned)
+{
+  if (mesh_eval_prev == nullptr) {
+    return;
+  }
+  /* The topology is checked further when drawing, see #BKE_MESH_BATCH_DIRTY_DEFORM. */
+  if (is_mesh_eval_owned && mesh_eval->runtime.deformed_only &&
+      mesh_eval->runtime.batch_cache == nullptr &&
+      mesh_eval_prev->runtime.batch_cache != nullptr &&
+      mesh_eval->totvert == mesh_eval_prev->totvert &&
+      mesh_eval->totedge == mesh_eval_prev->totedge &&
+      mesh_eval->totloop == mesh_eval_prev->totloop &&
+      mesh_eval->totpoly == mesh_eval_prev->totpoly) {
+    mesh_eval->runtime.batch_cache = mesh_eval_prev->runtime.batch_cache;
+    mesh_eval->runtime.batch_cache_deform_update = true;
+    mesh_eval_prev->runtime.batch_cache = nullptr;
+  }
+  BKE_mesh_eval_delete(mesh_eval_prev);
+}
+
 static void mesh_build_data(struct Depsgraph *depsgraph,
                             Scene *scene,
                             Object *ob,
@@ -1860,6 +1941,7 @@ static void mesh_build_data(struct Depsgraph *depsgraph,
    * they aren't cleaned up properly on mode switch, causing crashes, e.g T58150. */
   BLI_assert(ob->id.tag & LIB_TAG_COPIED_ON_WRITE);
 
+  Mesh *mesh_eval_prev = mesh_build_data_eval_prev_take(ob);
   BKE_object_free_derived_caches(ob);
   if (DEG_is_active(depsgraph)) {
     BKE_sculpt_update_object_before_eval(ob);
@@ -1885,6 +1967,7 @@ static void mesh_build_data(struct Depsgraph *depsgraph,
                       -1,
                       true,
                       true,
+                      mesh_eval_prev,
                       &mesh_deform_eval,
                       &mesh_eval,
                       &geometry_set_eval);
@@ -1898,6 +1981,7 @@ static void mesh_build_data(struct Depsgraph *depsgraph,
   Mesh *mesh = (Mesh *)ob->data;
   const bool is_mesh_eval_owned = (mesh_eval != mesh->runtime.mesh_eval);
   BKE_object_eval_assign_data(ob, &mesh_eval->id, is_mesh_eval_owned);
+  mesh_build_data_eval_prev_reuse(mesh_eval_prev, mesh_eval, is_mesh_eval_owned);
 
   /* Add the final mesh as read-only non-owning component to the geometry set. */
   MeshComponent &mesh_component = geometry_set_eval->get_component_for_write<MeshComponent>();
@@ -2103,8 +2187,19 @@ Mesh *mesh_create_eval_final(Depsgraph *depsgraph,
 {
   Mesh *final;
 
-  mesh_calc_modifiers(
-      depsgraph, scene, ob, 1, false, dataMask, -1, false, false, nullptr, &final, nullptr);
+  mesh_calc_modifiers(depsgraph,
+                      scene,
+                      ob,
+                      1,
+                      false,
+                      dataMask,
+                      -1,
+                      false,
+                      false,
+                      nullptr,
+                      nullptr,
+                      &final,
+                      nullptr);
 
   return final;
 }
@@ -2117,8 +2212,19 @@ Mesh *mesh_create_eval_final_index_render(Depsgraph *depsgraph,
 {
   Mesh *final;
 
-  mesh_calc_modifiers(
-      depsgraph, scene, ob, 1, false, dataMask, index, false, false, nullptr, &final, nullptr);
+  mesh_calc_modifiers(depsgraph,
+                      scene,
+                      ob,
+                      1,
+                      false,
+                      dataMask,
+                      index,
+                      false,
+                      false,
+                      nullptr,
+                      nullptr,
+                      &final,
+                      nullptr);
 
   return final;
 }
@@ -2130,8 +2236,19 @@ Mesh *mesh_create_eval_no_deform(Depsgraph *depsgraph,
 {
   Mesh *final;
 
-  mesh_calc_modifiers(
-      depsgraph, scene, ob, 0, false, dataMask, -1, false, false, nullptr, &final, nullptr);
+  mesh_calc_modifiers(depsgraph,
+                      scene,
+                      ob,
+                      0,
+                      false,
+                      dataMask,
+                      -1,
+                      false,
+                      false,
+                      nullptr,
+                      nullptr,
+                      &final,
+                      nullptr);
 
   return final;
 }
@@ -2143,8 +2260,19 @@ Mesh *mesh_create_eval_no_deform_render(Depsgraph *depsgraph,
 {
   Mesh *final;
 
-  mesh_calc_modifiers(
-      depsgraph, scene, ob, 0, false, dataMask, -1, false, false, nullptr, &final, nullptr);
+  mesh_calc_modifiers(depsgraph,
+                      scene,
+                      ob,
+                      0,
+                      false,
+                      dataMask,
+                      -1,
+                      false,
+                      false,
+                      nullptr,
+                      nullptr,
+                      &final,
+                      nullptr);
 
   return final;
 }
@@ -425,6 +425,138 @@ bool BKE_animsys_store_rna_setting(PointerRNA *ptr,
   return success;
 }
 
+/* ----------------------------------------- */
+/* Resolved Path Cache */
+
+typedef struct AnimPathCacheSlot {
+  /** Value of #anim_path_cache_generation when the path was resolved, 0 when unused. */
+  uint generation;
+  /** Data of the pointer the path was resolved from. */
+  const void *owner_data;
+  PathResolvedRNA rna;
+} AnimPathCacheSlot;
+
+typedef struct AnimPathCacheEntry {
+  /** Paths resolved in the evaluated and the original data-block. */
+  AnimPathCacheSlot slots[2];
+} AnimPathCacheEntry;
+
+typedef struct AnimPathCache {
+  GHash *entries;
+  /** Compiled F-Curves of the action, with the generation and list they were compiled for. */
+  struct FCurveBatch *fcurve_batch;
+  const ListBase *fcurve_batch_list;
+  uint fcurve_batch_generation;
+} AnimPathCache;
+
+/* Bumped whenever cached pointers may have become invalid. Copy-on-write data-blocks are
+ * only freed or updated outside of the evaluation of the data depending on them, so reading
+ * this while evaluating is safe. */
+static uint anim_path_cache_generation = 1;
+
+AnimPathCache *BKE_animsys_path_cache_new(void)
+{
+  AnimPathCache *cache = MEM_callocN(sizeof(AnimPathCache), "AnimPathCache");
+  cache->entries = BLI_ghash_ptr_new("AnimPathCache::entries");
+  return cache;
+}
+
+void BKE_animsys_path_cache_free(AnimPathCache *cache)
+{
+  if (cache == NULL) {
+    return;
+  }
+  BLI_ghash_free(cache->entries, NULL, MEM_freeN);
+  BKE_fcurve_batch_free(cache->fcurve_batch);
+  MEM_freeN(cache);
+}
+
+bool BKE_animsys_path_cache_lookup(const AnimPathCache *cache,
+                                   const void *key,
+                                   const bool orig,
+                                   const PointerRNA *ptr,
+                                   PathResolvedRNA *r_result)
+{
+  const AnimPathCacheEntry *entry = BLI_ghash_lookup(cache->entries, key);
+  if (entry == NULL) {
+    return false;
+  }
+  const AnimPathCacheSlot *slot = &entry->slots[orig];
+  if (slot->generation != anim_path_cache_generation ||
+      slot->owner_data != ptr->data) {
+    return false;
+  }
+  *r_result = slot->rna;
+  return true;
+}
+
+void BKE_animsys_path_cache_store(AnimPathCache *cache,
+                                  const void *key,
+                                  const bool orig,
+                                  const PointerRNA *ptr,
+                                  const PathResolvedRNA *result)
+{
+  AnimPathCacheEntry **entry_p;
+  if (!BLI_ghash_ensure_p(cache->entries, (void *)key, (void ***)&entry_p)) {
+    *entry_p = MEM_callocN(sizeof(AnimPathCacheEntry), "AnimPathCacheEntry");
+  }
+  AnimPathCacheSlot *slot = &(*entry_p)->slots[orig];
+  slot->generation = anim_path_cache_generation;
+  slot->owner_data = ptr->data;
+  slot->rna = *result;
+}
+
+void BKE_animsys_path_cache_invalidate(void)
+{
+  /* Zero marks unused slots, skip it on overflow. */
+  if (atomic_add_and_fetch_uint32(&anim_path_cache_generation, 1) == 0) {
+    atomic_add_and_fetch_uint32(&anim_path_cache_generation, 1);
+  }
+}
+
+/* Compiled F-Curves of the list, compiling them again when they may have changed. */
+static struct FCurveBatch *animsys_path_cache_fcurve_batch(AnimPathCache *cache, ListBase *fcurves)
+{
+  if (cache->fcurve_batch != NULL &&
+      (cache->fcurve_batch_generation != anim_path_cache_generation ||
+       cache->fcurve_batch_list != fcurves)) {
+    BKE_fcurve_batch_free(cache->fcurve_batch);
+    cache->fcurve_batch = NULL;
+  }
+  if (cache->fcurve_batch == NULL) {
+    cache->fcurve_batch = BKE_fcurve_batch_new(fcurves);
+    cache->fcurve_batch_list = fcurves;
+    cache->fcurve_batch_generation = anim_path_cache_generation;
+  }
+  return cache->fcurve_batch;
+}
+
+/* Same as #BKE_animsys_store_rna_setting, using and filling the cache when one is given. */
+static bool animsys_store_rna_setting_cached(AnimPathCache *cache,
+                                             const void *key,
+                                             const bool orig,
+                                             PointerRNA *ptr,
+                                             const char *rna_path,
+                                             const int array_index,
+                                             PathResolvedRNA *r_result)
+{
+  if (cache == NULL) {
+    return BKE_animsys_store_rna_setting(ptr, rna_path, array_index, r_result);
+  }
+  if (BKE_animsys_path_cache_lookup(cache, key, orig, ptr, r_result)) {
+    return true;
+  }
+  if (!BKE_animsys_store_rna_setting(ptr, rna_path, array_index, r_result)) {
+    return false;
+  }
+  /* ID properties of original data can be removed without tagging the depsgraph, so only
+   * properties defined by RNA are cached there. */
+  if (!orig || !RNA_property_is_idprop(r_result->prop)) {
+    BKE_animsys_path_cache_store(cache, key, orig, ptr, r_result);
+  }
+  return true;
+}
+
 /* less than 1.0 evaluates to false, use epsilon to avoid float error */
 #define ANIMSYS_FLOAT_AS_BOOL(value) ((value) > ((1.0f - FLT_EPSILON)))
 
@@ -581,6 +713,8 @@ static bool animsys_construct_orig_pointer_rna(const PointerRNA *ptr, PointerRNA
 }
 
 static void animsys_write_orig_anim_rna(PointerRNA *ptr,
+                                        AnimPathCache *path_cache,
+                                        const void *path_cache_key,
                                         const char *rna_path,
                                         int array_index,
                                         float value)
@@ -590,8 +724,13 @@ static void animsys_write_orig_anim_rna(PointerRNA *ptr,
     return;
   }
   PathResolvedRNA orig_anim_rna;
-  /* TODO(sergey): Should be possible to cache resolved path in dependency graph somehow. */
-  if (BKE_animsys_store_rna_setting(&ptr_orig, rna_path, array_index, &orig_anim_rna)) {
+  if (animsys_store_rna_setting_cached(path_cache,
+                                       path_cache_key,
+                                       true,
+                                       &ptr_orig,
+                                       rna_path,
+                                       array_index,
+                                       &orig_anim_rna)) {
     BKE_animsys_write_rna_setting(&orig_anim_rna, value);
   }
 }
@@ -600,25 +739,40 @@ static void animsys_write_orig_anim_rna(PointerRNA *ptr,
  * Evaluate all the F-Curves in the given list
  * This performs a set of standard checks. If extra checks are required,
  * separate code should be used.
+ *
+ * \param path_cache: Optional cache of resolved paths, only to be used when the caller has
+ * exclusive access to it. The curves are also compiled into it, to evaluate them all at once.
  */
 static void animsys_evaluate_fcurves(PointerRNA *ptr,
                                      ListBase *list,
                                      const AnimationEvalContext *anim_eval_context,
-                                     bool flush_to_original)
+                                     bool flush_to_original,
+                                     AnimPathCache *path_cache)
 {
+  struct FCurveBatch *batch = NULL;
+  if (path_cache != NULL) {
+    batch = animsys_path_cache_fcurve_batch(path_cache, list);
+    BKE_fcurve_batch_evaluate(batch, anim_eval_context->eval_time);
+  }
+
   /* Calculate then execute each curve. */
-  LISTBASE_FOREACH (FCurve *, fcu, list) {
+  int index;
+  LISTBASE_FOREACH_INDEX (FCurve *, fcu, list, index) {
 
     if (!is_fcurve_evaluatable(fcu)) {
       continue;
     }
 
     PathResolvedRNA anim_rna;
-    if (BKE_animsys_store_rna_setting(ptr, fcu->rna_path, fcu->array_index, &anim_rna)) {
-      const float curval = calculate_fcurve(&anim_rna, fcu, anim_eval_context);
+    if (animsys_store_rna_setting_cached(
+            path_cache, fcu, false, ptr, fcu->rna_path, fcu->array_index, &anim_rna)) {
+      float curval;
+      if (batch == NULL || !BKE_fcurve_batch_value(batch, index, &curval)) {
+        curval = calculate_fcurve(&anim_rna, fcu, anim_eval_context);
+      }
       BKE_animsys_write_rna_setting(&anim_rna, curval);
       if (flush_to_original) {
-        animsys_write_orig_anim_rna(ptr, fcu->rna_path, fcu->array_index, curval);
+        animsys_write_orig_anim_rna(ptr, path_cache, fcu, fcu->rna_path, fcu->array_index, curval);
       }
     }
   }
@@ -759,7 +913,8 @@ void animsys_evaluate_action_group(PointerRNA *ptr,
 static void animsys_evaluate_action_ex(PointerRNA *ptr,
                                        bAction *act,
                                        const AnimationEvalContext *anim_eval_context,
-                                       const bool flush_to_original)
+                                       const bool flush_to_original,
+                                       AnimPathCache *path_cache)
 {
   /* check if mapper is appropriate for use here (we set to NULL if it's inappropriate) */
   if (act == NULL) {
@@ -769,7 +924,7 @@ static void animsys_evaluate_action_ex(PointerRNA *ptr,
   action_idcode_patch_check(ptr->owner_id, act);
 
   /* calculate then execute each curve */
-  animsys_evaluate_fcurves(ptr, &act->curves, anim_eval_context, flush_to_original);
+  animsys_evaluate_fcurves(ptr, &act->curves, anim_eval_context, flush_to_original, path_cache);
 }
 
 void animsys_evaluate_action(PointerRNA *ptr,
@@ -777,7 +932,7 @@ void animsys_evaluate_action(PointerRNA *ptr,
                              const AnimationEvalContext *anim_eval_context,
                              const bool flush_to_original)
 {
-  animsys_evaluate_action_ex(ptr, act, anim_eval_context, flush_to_original);
+  animsys_evaluate_action_ex(ptr, act, anim_eval_context, flush_to_original, NULL);
 }
 
 /* ***************************************** */
@@ -817,7 +972,8 @@ static void nlastrip_evaluate_controls(NlaStrip *strip,
     RNA_pointer_create(NULL, &RNA_NlaStrip, strip, &strip_ptr);
 
     /* execute these settings as per normal */
-    animsys_evaluate_fcurves(&strip_ptr, &strip->fcurves, anim_eval_context, flush_to_original);
+    animsys_evaluate_fcurves(
+        &strip_ptr, &strip->fcurves, anim_eval_context, flush_to_original, NULL);
   }
 
   /* analytically generate values for influence and time (if applicable)
@@ -1998,7 +2154,7 @@ void nladata_flush_channels(PointerRNA *ptr,
         }
         BKE_animsys_write_rna_setting(&rna, value);
         if (flush_to_original) {
-          animsys_write_orig_anim_rna(ptr, nec->rna_path, rna.prop_index, value);
+          animsys_write_orig_anim_rna(ptr, NULL, NULL, nec->rna_path, rna.prop_index, value);
         }
       }
     }
@@ -2775,11 +2931,12 @@ static void animsys_evaluate_overrides(PointerRNA *ptr, AnimData *adt)
  * and that the flags for which parts of the anim-data settings need to be recalculated
  * have been set already by the depsgraph. Now, we use the recalc
  */
-void BKE_animsys_evaluate_animdata(ID *id,
-                                   AnimData *adt,
-                                   const AnimationEvalContext *anim_eval_context,
-                                   eAnimData_Recalc recalc,
-                                   const bool flush_to_original)
+static void animsys_evaluate_animdata_ex(ID *id,
+                                         AnimData *adt,
+                                         const AnimationEvalContext *anim_eval_context,
+                                         eAnimData_Recalc recalc,
+                                         const bool flush_to_original,
+                                         const bool use_path_cache)
 {
   PointerRNA id_ptr;
 
@@ -2806,7 +2963,14 @@ void BKE_animsys_evaluate_animdata(ID *id,
     }
     /* evaluate Active Action only */
     else if (adt->action) {
-      animsys_evaluate_action_ex(&id_ptr, adt->action, anim_eval_context, flush_to_original);
+      if (use_path_cache && adt->path_cache == NULL) {
+        adt->path_cache = BKE_animsys_path_cache_new();
+      }
+      animsys_evaluate_action_ex(&id_ptr,
+                                 adt->action,
+                                 anim_eval_context,
+                                 flush_to_original,
+                                 use_path_cache ? adt->path_cache : NULL);
     }
   }
 
@@ -2828,6 +2992,15 @@ void BKE_animsys_evaluate_animdata(ID *id,
   animsys_evaluate_overrides(&id_ptr, adt);
 }
 
+void BKE_animsys_evaluate_animdata(ID *id,
+                                   AnimData *adt,
+                                   const AnimationEvalContext *anim_eval_context,
+                                   eAnimData_Recalc recalc,
+                                   const bool flush_to_original)
+{
+  animsys_evaluate_animdata_ex(id, adt, anim_eval_context, recalc, flush_to_original, false);
+}
+
 /* Evaluation of all ID-blocks with Animation Data blocks - Animation Data Only
  *
  * This will evaluate only the animation info available in the animation data-blocks
@@ -2997,7 +3170,11 @@ void BKE_animsys_eval_animdata(Depsgraph *depsgraph, ID *id)
 
   const AnimationEvalContext anim_eval_context = BKE_animsys_eval_context_construct(depsgraph,
                                                                                     ctime);
-  BKE_animsys_evaluate_animdata(id, adt, &anim_eval_context, ADT_RECALC_ANIM, flush_to_original);
+  /* The animation of the copy-on-write data-block is only evaluated here, so resolved paths
+   * can be kept in its animation data. */
+  const bool use_path_cache = (id->tag & LIB_TAG_COPIED_ON_WRITE) != 0;
+  animsys_evaluate_animdata_ex(
+      id, adt, &anim_eval_context, ADT_RECALC_ANIM, flush_to_original, use_path_cache);
 }
 
 void BKE_animsys_update_driver_array(ID *id)
@@ -3055,8 +3232,20 @@ void BKE_animsys_eval_driver(Depsgraph *depsgraph, ID *id, int driver_index, FCu
        * adding new to only be done when drivers only changed */
       // printf("\told val = %f\n", fcu->curval);
 
+      /* The driver is only evaluated here, so resolved paths can be kept in it. */
+      ChannelDriver *driver = fcu->driver;
+      if (driver->path_cache == NULL && (id->tag & LIB_TAG_COPIED_ON_WRITE)) {
+        driver->path_cache = BKE_animsys_path_cache_new();
+      }
+
       PathResolvedRNA anim_rna;
-      if (BKE_animsys_store_rna_setting(&id_ptr, fcu->rna_path, fcu->array_index, &anim_rna)) {
+      if (animsys_store_rna_setting_cached(driver->path_cache,
+                                           fcu,
+                                           false,
+                                           &id_ptr,
+                                           fcu->rna_path,
+                                           fcu->array_index,
+                                           &anim_rna)) {
         /* Evaluate driver, and write results to COW-domain destination */
         const float ctime = DEG_get_ctime(depsgraph);
         const AnimationEvalContext anim_eval_context = BKE_animsys_eval_context_construct(
@@ -3066,7 +3255,8 @@ void BKE_animsys_eval_driver(Depsgraph *depsgraph, ID *id, int driver_index, FCu
 
         /* Flush results & status codes to original data for UI (T59984) */
         if (ok && DEG_is_active(depsgraph)) {
-          animsys_write_orig_anim_rna(&id_ptr, fcu->rna_path, fcu->array_index, curval);
+          animsys_write_orig_anim_rna(
+              &id_ptr, driver->path_cache, fcu, fcu->rna_path, fcu->array_index, curval);
 
           /* curval is displayed in the UI, and flag contains error-status codes */
           fcu_orig->curval = fcu->curval;
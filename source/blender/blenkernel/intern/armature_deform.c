@@ -237,6 +237,18 @@ static void pchan_bone_deform(bPoseChannel *pchan,
  * #BKE_armature_deform_coords and related functions.
  * \{ */
 
+bool BKE_armature_deform_blend_matrices = true;
+
+/* How the bone of a vertex group deforms vertices, for #ArmatureUserdata.defbase_skin. */
+typedef enum eArmatureDefbaseSkin {
+  /** No deforming bone for the vertex group. */
+  ARM_DEFBASE_SKIN_NONE = 0,
+  /** Deformation only depends on the bone matrix, so it can be blended with other bones. */
+  ARM_DEFBASE_SKIN_MATRIX = 1,
+  /** Deformation depends on the vertex position (B-Bones, envelope multiplied weights). */
+  ARM_DEFBASE_SKIN_COMPLEX = 2,
+} eArmatureDefbaseSkin;
+
 typedef struct ArmatureUserdata {
   const Object *ob_arm;
   const Object *ob_target;
@@ -258,6 +270,14 @@ typedef struct ArmatureUserdata {
   bPoseChannel **pchan_from_defbase;
   int defbase_len;
 
+  /**
+   * Deform matrices of the bones of vertex groups, copied into one array so linear blend
+   * skinning doesn't look up bones per weight. NULL when not using linear blend skinning.
+   */
+  float (*defbase_mats)[4][4];
+  /** #eArmatureDefbaseSkin for each vertex group. */
+  char *defbase_skin;
+
   float premat[4][4];
   float postmat[4][4];
 
@@ -267,6 +287,76 @@ typedef struct ArmatureUserdata {
   } bmesh;
 } ArmatureUserdata;
 
+/**
+ * Linear blend skinning of a vertex with weights of bones that only deform by their matrix:
+ * the bone matrices are blended with the weights first, so the vertex is only transformed once.
+ *
+ * \return false when some weight needs the bone to be evaluated per vertex, or when no weight
+ * has a deforming bone, in which case nothing is accumulated.
+ */
+static bool armature_vert_skin_blend_matrices(const ArmatureUserdata *data,
+                                              const MDeformVert *dvert,
+                                              const float co[3],
+                                              float vec[3],
+                                              float smat[3][3],
+                                              float *contrib)
+{
+  const float(*defbase_mats)[4][4] = data->defbase_mats;
+  const char *defbase_skin = data->defbase_skin;
+  const uint defbase_len = (uint)data->defbase_len;
+  const MDeformWeight *dw = dvert->dw;
+  float blend_mat[4][4];
+  float weight_sum = 0.0f;
+  bool deformed = false;
+
+  zero_m4(blend_mat);
+
+  for (uint j = dvert->totweight; j != 0; j--, dw++) {
+    const uint index = dw->def_nr;
+    if (index >= defbase_len) {
+      continue;
+    }
+
+    switch (defbase_skin[index]) {
+      case ARM_DEFBASE_SKIN_NONE:
+        break;
+      case ARM_DEFBASE_SKIN_MATRIX: {
+        const float weight = dw->weight;
+        const float(*mat)[4] = defbase_mats[index];
+
+        madd_v4_v4fl(blend_mat[0], mat[0], weight);
+        madd_v4_v4fl(blend_mat[1], mat[1], weight);
+        madd_v4_v4fl(blend_mat[2], mat[2], weight);
+        madd_v4_v4fl(blend_mat[3], mat[3], weight);
+        weight_sum += weight;
+        deformed = true;
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+
+  if (!deformed) {
+    return false;
+  }
+
+  /* Same as accumulating `weight * (mat * co - co)` for each bone. */
+  float tmp[3];
+  mul_v3_m4v3(tmp, blend_mat, co);
+  madd_v3_v3fl(tmp, co, -weight_sum);
+  add_v3_v3(vec, tmp);
+
+  if (smat) {
+    float tmpmat[3][3];
+    copy_m3_m4(tmpmat, blend_mat);
+    add_m3_m3m3(smat, smat, tmpmat);
+  }
+
+  *contrib += weight_sum;
+  return true;
+}
+
 static void armature_vert_task_with_dvert(const ArmatureUserdata *data,
                                           const int i,
                                           const MDeformVert *dvert)
@@ -327,7 +417,11 @@ static void armature_vert_task_with_dvert(const ArmatureUserdata *data,
   /* Apply the object's matrix */
   mul_m4_v3(data->premat, co);
 
-  if (use_dverts && dvert && dvert->totweight) { /* use weight groups ? */
+  if (use_dverts && dvert && dvert->totweight && data->defbase_mats &&
+      armature_vert_skin_blend_matrices(data, dvert, co, vec, smat, &contrib)) {
+    /* Deformed by blending bone matrices. */
+  }
+  else if (use_dverts && dvert && dvert->totweight) { /* use weight groups ? */
     const MDeformWeight *dw = dvert->dw;
     int deformed = 0;
     unsigned int j;
@@ -473,6 +567,8 @@ static void armature_deform_coords_impl(const Object *ob_arm,
 {
   bArmature *arm = ob_arm->data;
   bPoseChannel **pchan_from_defbase = NULL;
+  float(*defbase_mats)[4][4] = NULL;
+  char *defbase_skin = NULL;
   const MDeformVert *dverts = NULL;
   bDeformGroup *dg;
   const bool use_envelope = (deformflag & ARM_DEF_ENVELOPE) != 0;
@@ -556,6 +652,27 @@ static void armature_deform_coords_impl(const Object *ob_arm,
             }
           }
         }
+
+        if (!use_quaternion && BKE_armature_deform_blend_matrices) {
+          defbase_mats = MEM_mallocN(sizeof(*defbase_mats) * defbase_len, "defbase_mats");
+          defbase_skin = MEM_mallocN(sizeof(*defbase_skin) * defbase_len, "defbase_skin");
+
+          for (i = 0; i < defbase_len; i++) {
+            const bPoseChannel *pchan = pchan_from_defbase[i];
+            if (pchan == NULL) {
+              defbase_skin[i] = ARM_DEFBASE_SKIN_NONE;
+            }
+            else if ((pchan->bone->flag & BONE_MULT_VG_ENV) ||
+                     (pchan->bone->segments > 1 &&
+                      pchan->runtime.bbone_segments == pchan->bone->segments)) {
+              defbase_skin[i] = ARM_DEFBASE_SKIN_COMPLEX;
+            }
+            else {
+              defbase_skin[i] = ARM_DEFBASE_SKIN_MATRIX;
+              copy_m4_m4(defbase_mats[i], pchan->chan_mat);
+            }
+          }
+        }
       }
     }
   }
@@ -576,6 +693,8 @@ static void armature_deform_coords_impl(const Object *ob_arm,
       .dverts_len = dverts_len,
       .pchan_from_defbase = pchan_from_defbase,
       .defbase_len = defbase_len,
+      .defbase_mats = defbase_mats,
+      .defbase_skin = defbase_skin,
       .bmesh =
           {
               .cd_dvert_offset = cd_dvert_offset,
@@ -611,6 +730,8 @@ static void armature_deform_coords_impl(const Object *ob_arm,
   if (pchan_from_defbase) {
     MEM_freeN(pchan_from_defbase);
   }
+  MEM_SAFE_FREE(defbase_mats);
+  MEM_SAFE_FREE(defbase_skin);
 }
 
 void BKE_armature_deform_coords_with_gpencil_stroke(const Object *ob_arm,
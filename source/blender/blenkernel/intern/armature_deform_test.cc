@@ -0,0 +1,246 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include "BKE_action.h"
+#include "BKE_armature.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "DNA_armature_types.h"
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_object_types.h"
+
+#include "BLI_listbase.h"
+#include "BLI_math.h"
+#include "BLI_string.h"
+
+namespace blender::bke::tests {
+
+static const float FLOAT_EPSILON = 1e-5f;
+
+struct ArmatureDeformTestContext {
+  bArmature arm;
+  Object ob_arm;
+  Mesh mesh;
+  Object ob_mesh;
+};
+
+static Bone *test_bone_add(
+    ArmatureDeformTestContext *ctx, const char *name, const float head[3], const float tail[3])
+{
+  Bone *bone = static_cast<Bone *>(MEM_callocN(sizeof(Bone), __func__));
+  BLI_strncpy(bone->name, name, sizeof(bone->name));
+  copy_v3_v3(bone->arm_head, head);
+  copy_v3_v3(bone->arm_tail, tail);
+  bone->length = len_v3v3(head, tail);
+  bone->rad_head = 0.25f;
+  bone->rad_tail = 0.25f;
+  bone->dist = 0.5f;
+  bone->weight = 1.0f;
+  bone->segments = 1;
+  BLI_addtail(&ctx->arm.bonebase, bone);
+
+  bPoseChannel *pchan = BKE_pose_channel_verify(ctx->ob_arm.pose, name);
+  pchan->bone = bone;
+
+  /* Deform by rotating, scaling and moving, differently for every bone. */
+  const float index = BLI_listbase_count(&ctx->arm.bonebase);
+  const float loc[3] = {0.1f * index, -0.2f, 0.3f * index};
+  const float eul[3] = {0.2f, -0.1f * index, 0.3f * index};
+  const float size[3] = {1.0f, 1.0f + 0.1f * index, 0.9f};
+  loc_eul_size_to_mat4(pchan->chan_mat, loc, eul, size);
+
+  return bone;
+}
+
+static void test_vertex_group_add(ArmatureDeformTestContext *ctx, const char *name)
+{
+  bDeformGroup *dg = static_cast<bDeformGroup *>(MEM_callocN(sizeof(bDeformGroup), __func__));
+  BLI_strncpy(dg->name, name, sizeof(dg->name));
+  BLI_addtail(&ctx->ob_mesh.defbase, dg);
+}
+
+static void test_weights_set(MDeformVert *dvert,
+                             const int groups[],
+                             const float weights[],
+                             int len)
+{
+  dvert->totweight = len;
+  dvert->dw = static_cast<MDeformWeight *>(
+      MEM_calloc_arrayN(len, sizeof(MDeformWeight), __func__));
+  for (int i = 0; i < len; i++) {
+    dvert->dw[i].def_nr = groups[i];
+    dvert->dw[i].weight = weights[i];
+  }
+}
+
+static void test_armature_deform(ArmatureDeformTestContext *ctx,
+                                 const float (*coords_orig)[3],
+                                 float (*coords)[3],
+                                 float (*deform_mats)[3][3])
+{
+  const int len = ctx->mesh.totvert;
+  for (int i = 0; i < len; i++) {
+    copy_v3_v3(coords[i], coords_orig[i]);
+    unit_m3(deform_mats[i]);
+  }
+  BKE_armature_deform_coords_with_mesh(&ctx->ob_arm,
+                                       &ctx->ob_mesh,
+                                       coords,
+                                       deform_mats,
+                                       len,
+                                       ARM_DEF_VGROUP | ARM_DEF_ENVELOPE,
+                                       nullptr,
+                                       nullptr,
+                                       &ctx->mesh);
+}
+
+TEST(armature_deform, BlendMatricesSameAsPerWeight)
+{
+  ArmatureDeformTestContext ctx = {{{nullptr}}};
+
+  ctx.ob_arm.type = OB_ARMATURE;
+  ctx.ob_arm.data = &ctx.arm;
+  ctx.ob_arm.pose = static_cast<bPose *>(MEM_callocN(sizeof(bPose), __func__));
+  const float ob_arm_loc[3] = {0.5f, -0.25f, 1.0f};
+  const float ob_arm_eul[3] = {0.0f, 0.0f, 0.4f};
+  const float ob_arm_size[3] = {1.0f, 1.0f, 1.0f};
+  loc_eul_size_to_mat4(ctx.ob_arm.obmat, ob_arm_loc, ob_arm_eul, ob_arm_size);
+
+  ctx.ob_mesh.type = OB_MESH;
+  ctx.ob_mesh.data = &ctx.mesh;
+  unit_m4(ctx.ob_mesh.obmat);
+
+  const float p0[3] = {0.0f, 0.0f, 0.0f};
+  const float p1[3] = {1.0f, 0.0f, 0.0f};
+  const float p2[3] = {2.0f, 0.0f, 0.0f};
+  const float p3[3] = {3.0f, 0.0f, 0.0f};
+  test_bone_add(&ctx, "A", p0, p1);
+  test_bone_add(&ctx, "B", p1, p2);
+  /* Weights of this bone are multiplied by its envelope, so they are deformed per weight. */
+  Bone *bone_c = test_bone_add(&ctx, "C", p2, p3);
+  bone_c->flag |= BONE_MULT_VG_ENV;
+
+  enum { GROUP_A, GROUP_B, GROUP_C, GROUP_NO_BONE };
+  test_vertex_group_add(&ctx, "A");
+  test_vertex_group_add(&ctx, "B");
+  test_vertex_group_add(&ctx, "C");
+  test_vertex_group_add(&ctx, "NoBone");
+
+  const float coords_orig[][3] = {
+      {0.5f, 0.1f, 0.0f},
+      {1.1f, -0.2f, 0.1f},
+      {2.4f, 0.5f, 0.0f},
+      {1.5f, 0.0f, 0.3f},
+      {0.8f, 0.2f, -0.1f},
+      {0.9f, 0.3f, 0.0f},
+      {1.6f, -0.1f, 0.2f},
+      {0.3f, 0.0f, 0.4f},
+  };
+  const int len = ARRAY_SIZE(coords_orig);
+  ctx.mesh.totvert = len;
+  ctx.mesh.dvert = static_cast<MDeformVert *>(
+      MEM_calloc_arrayN(len, sizeof(MDeformVert), __func__));
+
+  {
+    /* Single bone. */
+    const int groups[] = {GROUP_A};
+    const float weights[] = {1.0f};
+    test_weights_set(&ctx.mesh.dvert[0], groups, weights, ARRAY_SIZE(groups));
+  }
+  {
+    /* Several bones, with weights not adding up to one. */
+    const int groups[] = {GROUP_A, GROUP_B};
+    const float weights[] = {0.3f, 0.5f};
+    test_weights_set(&ctx.mesh.dvert[1], groups, weights, ARRAY_SIZE(groups));
+  }
+  {
+    /* Bone blended by matrix mixed with a bone deforming per weight. */
+    const int groups[] = {GROUP_A, GROUP_C};
+    const float weights[] = {0.5f, 0.5f};
+    test_weights_set(&ctx.mesh.dvert[2], groups, weights, ARRAY_SIZE(groups));
+  }
+  {
+    /* Only zero weights, not deformed. */
+    const int groups[] = {GROUP_A, GROUP_B};
+    const float weights[] = {0.0f, 0.0f};
+    test_weights_set(&ctx.mesh.dvert[3], groups, weights, ARRAY_SIZE(groups));
+  }
+  {
+    /* Zero weight next to other weights. */
+    const int groups[] = {GROUP_B, GROUP_A};
+    const float weights[] = {0.0f, 0.4f};
+    test_weights_set(&ctx.mesh.dvert[4], groups, weights, ARRAY_SIZE(groups));
+  }
+  {
+    /* No group with a bone, deformed by the envelopes. */
+    const int groups[] = {GROUP_NO_BONE};
+    const float weights[] = {1.0f};
+    test_weights_set(&ctx.mesh.dvert[5], groups, weights, ARRAY_SIZE(groups));
+  }
+  {
+    /* Group without a bone next to a group with one. */
+    const int groups[] = {GROUP_NO_BONE, GROUP_B};
+    const float weights[] = {0.6f, 0.4f};
+    test_weights_set(&ctx.mesh.dvert[6], groups, weights, ARRAY_SIZE(groups));
+  }
+  /* The last vertex has no weights, so it is deformed by the envelopes. */
+
+  float(*coords_blend)[3] = static_cast<float(*)[3]>(
+      MEM_malloc_arrayN(len, sizeof(float[3]), __func__));
+  float(*mats_blend)[3][3] = static_cast<float(*)[3][3]>(
+      MEM_malloc_arrayN(len, sizeof(float[3][3]), __func__));
+  float(*coords_per_weight)[3] = static_cast<float(*)[3]>(
+      MEM_malloc_arrayN(len, sizeof(float[3]), __func__));
+  float(*mats_per_weight)[3][3] = static_cast<float(*)[3][3]>(
+      MEM_malloc_arrayN(len, sizeof(float[3][3]), __func__));
+
+  test_armature_deform(&ctx, coords_orig, coords_blend, mats_blend);
+  BKE_armature_deform_blend_matrices = false;
+  test_armature_deform(&ctx, coords_orig, coords_per_weight, mats_per_weight);
+  BKE_armature_deform_blend_matrices = true;
+
+  for (int i = 0; i < len; i++) {
+    SCOPED_TRACE(i);
+    EXPECT_V3_NEAR(coords_blend[i], coords_per_weight[i], FLOAT_EPSILON);
+    EXPECT_M3_NEAR(mats_blend[i], mats_per_weight[i], FLOAT_EPSILON);
+  }
+
+  /* Make sure the test covers deformed vertices. */
+  EXPECT_FALSE(equals_v3v3(coords_blend[1], coords_orig[1]));
+  EXPECT_FALSE(equals_v3v3(coords_blend[2], coords_orig[2]));
+  EXPECT_V3_NEAR(coords_blend[3], coords_orig[3], FLOAT_EPSILON);
+  EXPECT_FALSE(equals_v3v3(coords_blend[5], coords_orig[5]));
+  EXPECT_FALSE(equals_v3v3(coords_blend[7], coords_orig[7]));
+
+  MEM_freeN(coords_blend);
+  MEM_freeN(mats_blend);
+  MEM_freeN(coords_per_weight);
+  MEM_freeN(mats_per_weight);
+  for (int i = 0; i < len; i++) {
+    MEM_SAFE_FREE(ctx.mesh.dvert[i].dw);
+  }
+  MEM_freeN(ctx.mesh.dvert);
+  BLI_freelistN(&ctx.ob_mesh.defbase);
+  BKE_pose_free(ctx.ob_arm.pose);
+  BLI_freelistN(&ctx.arm.bonebase);
+}
+
+}  // namespace blender::bke::tests
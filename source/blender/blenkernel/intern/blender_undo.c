@@ -129,7 +129,12 @@ MemFileUndoData *BKE_memfile_undo_encode(Main *bmain, MemFileUndoData *mfu_prev)
       BLO_memfile_clear_future(prevfile);
     }
     /* success = */ /* UNUSED */ BLO_write_file_mem(bmain, prevfile, &mfu->memfile, G.fileflags);
+    /* Only an upper bound until the background encoding of the new step is finished, the size of
+     * the previous step is final now since writing waited for its encoding. */
     mfu->undo_size = mfu->memfile.size;
+    if (mfu_prev) {
+      mfu_prev->undo_size = prevfile->size;
+    }
   }
 
   bmain->is_memfile_undo_written = true;
@@ -36,6 +36,8 @@
 #include "BLI_system.h"
 #include "BLI_utildefines.h"
 
+#include "PIL_time.h"
+
 #include "IMB_colormanagement.h"
 
 #include "BKE_addon.h"
@@ -444,7 +446,23 @@ bool BKE_blendfile_read_ex(bContext *C,
     printf("Read blend: %s\n", filepath);
   }
 
+  const double time_start = PIL_check_seconds_timer();
+  /* Resident memory includes the pages of the memory-mapped file, which are released while
+   * reading. */
+  const size_t memory_start = (G.debug & G_DEBUG_IO) ? BLI_system_resident_memory() : 0;
+
   BlendFileData *bfd = BLO_read_from_file(filepath, params->skip_flags, reports);
+
+  if (G.debug & G_DEBUG_IO) {
+    char memory_start_str[32], memory_end_str[32];
+    BLI_str_format_byte_unit(memory_start_str, memory_start, false);
+    BLI_str_format_byte_unit(memory_end_str, BLI_system_resident_memory(), false);
+    printf("Read blend: %.3f sec, resident memory %s before, %s after\n",
+           PIL_check_seconds_timer() - time_start,
+           memory_start_str,
+           memory_end_str);
+  }
+
   if (bfd) {
     handle_subversion_warning(bfd->main, reports);
     if (startup_update_defaults) {
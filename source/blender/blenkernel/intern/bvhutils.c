@@ -41,6 +41,14 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "PIL_time.h"
+
+#include "CLG_log.h"
+
+#include "atomic_ops.h"
+
+static CLG_LogRef LOG = {"bke.bvhutils"};
+
 /* -------------------------------------------------------------------- */
 /** \name BVHCache
  * \{ */
@@ -48,18 +56,28 @@
 typedef struct BVHCacheItem {
   bool is_filled;
   BVHTree *tree;
+  /** Held while the tree is being built, other threads requesting the tree wait on it. */
+  ThreadMutex mutex;
+  /** Start time of the build in progress (only valid while `mutex` is locked). */
+  double build_start;
 } BVHCacheItem;
 
 typedef struct BVHCache {
   BVHCacheItem items[BVHTREE_MAX_ITEM];
-  ThreadMutex mutex;
+  /** Statistics, see #bvhcache_stats_get. */
+  uint32_t hit_count;
+  uint32_t wait_count;
+  uint32_t build_count;
+  float build_time;
 } BVHCache;
 
 /**
  * Queries a bvhcache for the cache bvhtree of the request type
  *
- * When the `r_locked` is filled and the tree could not be found the caches mutex will be
- * locked. This mutex can be unlocked by calling `bvhcache_unlock`.
+ * When the `r_locked` is filled and the tree could not be found the mutex of the cache item will
+ * be locked. This mutex can be unlocked by calling `bvhcache_unlock`.
+ * Each type has its own mutex, so trees of different types can be built in parallel,
+ * while threads requesting a tree that is being built wait for that build to finish.
  *
  * When `r_locked` is used the `mesh_eval_mutex` must contain the `Mesh_Runtime.eval_mutex`.
  */
@@ -86,27 +104,35 @@ static bool bvhcache_find(BVHCache **bvh_cache_p,
     BLI_mutex_unlock(mesh_eval_mutex);
   }
   BVHCache *bvh_cache = *bvh_cache_p;
+  BVHCacheItem *item = &bvh_cache->items[type];
 
-  if (bvh_cache->items[type].is_filled) {
-    *r_tree = bvh_cache->items[type].tree;
+  /* Pairs with the barrier in #bvhcache_insert, the tree is visible once the item is filled. */
+  if (atomic_load_uint8((const uint8_t *)&item->is_filled)) {
+    *r_tree = item->tree;
+    atomic_fetch_and_add_uint32(&bvh_cache->hit_count, 1);
     return true;
   }
   if (do_lock) {
-    BLI_mutex_lock(&bvh_cache->mutex);
+    if (!BLI_mutex_trylock(&item->mutex)) {
+      /* Another thread is building this tree, wait for it. */
+      atomic_fetch_and_add_uint32(&bvh_cache->wait_count, 1);
+      BLI_mutex_lock(&item->mutex);
+    }
     bool in_cache = bvhcache_find(bvh_cache_p, type, r_tree, NULL, NULL);
     if (in_cache) {
-      BLI_mutex_unlock(&bvh_cache->mutex);
+      BLI_mutex_unlock(&item->mutex);
       return in_cache;
     }
+    item->build_start = PIL_check_seconds_timer();
     *r_locked = true;
   }
   return false;
 }
 
-static void bvhcache_unlock(BVHCache *bvh_cache, bool lock_started)
+static void bvhcache_unlock(BVHCache *bvh_cache, BVHCacheType type, bool lock_started)
 {
   if (lock_started) {
-    BLI_mutex_unlock(&bvh_cache->mutex);
+    BLI_mutex_unlock(&bvh_cache->items[type].mutex);
   }
 }
 
@@ -124,10 +150,28 @@ bool bvhcache_has_tree(const BVHCache *bvh_cache, const BVHTree *tree)
   return false;
 }
 
+/**
+ * Get the number of trees built and looked up in \a bvh_cache, for profiling.
+ * They are logged when the cache is freed, with `--log "bke.bvhutils" --log-level 1`.
+ */
+void bvhcache_stats_get(const BVHCache *bvh_cache, BVHCacheStats *r_stats)
+{
+  if (bvh_cache == NULL) {
+    memset(r_stats, 0, sizeof(*r_stats));
+    return;
+  }
+  r_stats->hit_count = (int)bvh_cache->hit_count;
+  r_stats->wait_count = (int)bvh_cache->wait_count;
+  r_stats->build_count = (int)bvh_cache->build_count;
+  r_stats->build_time = bvh_cache->build_time;
+}
+
 BVHCache *bvhcache_init(void)
 {
   BVHCache *cache = MEM_callocN(sizeof(BVHCache), __func__);
-  BLI_mutex_init(&cache->mutex);
+  for (BVHCacheType i = 0; i < BVHTREE_MAX_ITEM; i++) {
+    BLI_mutex_init(&cache->items[i].mutex);
+  }
   return cache;
 }
 /**
@@ -136,6 +180,7 @@ BVHCache *bvhcache_init(void)
  * as that will be done when the cache is freed.
  *
  * A call to this assumes that there was no previous cached tree of the given type
+ * and that the item is locked by #bvhcache_find.
  * \warning The #BVHTree can be NULL.
  */
 static void bvhcache_insert(BVHCache *bvh_cache, BVHTree *tree, BVHCacheType type)
@@ -143,7 +188,12 @@ static void bvhcache_insert(BVHCache *bvh_cache, BVHTree *tree, BVHCacheType typ
   BVHCacheItem *item = &bvh_cache->items[type];
   BLI_assert(!item->is_filled);
   item->tree = tree;
-  item->is_filled = true;
+  /* Full barrier, the tree must be visible to threads that don't lock once this is set. */
+  atomic_fetch_and_or_uint8((uint8_t *)&item->is_filled, true);
+
+  atomic_fetch_and_add_uint32(&bvh_cache->build_count, 1);
+  atomic_add_and_fetch_fl(&bvh_cache->build_time,
+                          (float)(PIL_check_seconds_timer() - item->build_start));
 }
 
 /**
@@ -151,12 +201,25 @@ static void bvhcache_insert(BVHCache *bvh_cache, BVHTree *tree, BVHCacheType typ
  */
 void bvhcache_free(BVHCache *bvh_cache)
 {
+  if (CLOG_CHECK(&LOG, 1)) {
+    BVHCacheStats stats;
+    bvhcache_stats_get(bvh_cache, &stats);
+    if (stats.build_count != 0) {
+      CLOG_INFO(&LOG,
+                1,
+                "%d builds in %.3f sec, %d hits, %d waits",
+                stats.build_count,
+                stats.build_time,
+                stats.hit_count,
+                stats.wait_count);
+    }
+  }
   for (BVHCacheType index = 0; index < BVHTREE_MAX_ITEM; index++) {
     BVHCacheItem *item = &bvh_cache->items[index];
     BLI_bvhtree_free(item->tree);
     item->tree = NULL;
+    BLI_mutex_end(&item->mutex);
   }
-  BLI_mutex_end(&bvh_cache->mutex);
   MEM_freeN(bvh_cache);
 }
 
@@ -655,7 +718,7 @@ BVHTree *bvhtree_from_editmesh_verts_ex(BVHTreeFromEditMesh *data,
       bvhcache_insert(*bvh_cache_p, tree, bvh_cache_type);
       data->cached = true;
     }
-    bvhcache_unlock(*bvh_cache_p, lock_started);
+    bvhcache_unlock(*bvh_cache_p, bvh_cache_type, lock_started);
   }
   else {
     tree = bvhtree_from_editmesh_verts_create_tree(
@@ -722,7 +785,7 @@ BVHTree *bvhtree_from_mesh_verts_ex(BVHTreeFromMesh *data,
   }
 
   if (bvh_cache_p) {
-    bvhcache_unlock(*bvh_cache_p, lock_started);
+    bvhcache_unlock(*bvh_cache_p, bvh_cache_type, lock_started);
   }
 
   /* Setup BVHTreeFromMesh */
@@ -867,7 +930,7 @@ BVHTree *bvhtree_from_editmesh_edges_ex(BVHTreeFromEditMesh *data,
       bvhcache_insert(bvh_cache, tree, bvh_cache_type);
       data->cached = true;
     }
-    bvhcache_unlock(bvh_cache, lock_started);
+    bvhcache_unlock(bvh_cache, bvh_cache_type, lock_started);
   }
   else {
     tree = bvhtree_from_editmesh_edges_create_tree(
@@ -937,7 +1000,7 @@ BVHTree *bvhtree_from_mesh_edges_ex(BVHTreeFromMesh *data,
   }
 
   if (bvh_cache_p) {
-    bvhcache_unlock(*bvh_cache_p, lock_started);
+    bvhcache_unlock(*bvh_cache_p, bvh_cache_type, lock_started);
   }
 
   /* Setup BVHTreeFromMesh */
@@ -1068,7 +1131,7 @@ BVHTree *bvhtree_from_mesh_faces_ex(BVHTreeFromMesh *data,
   }
 
   if (bvh_cache_p) {
-    bvhcache_unlock(*bvh_cache_p, lock_started);
+    bvhcache_unlock(*bvh_cache_p, bvh_cache_type, lock_started);
   }
 
   /* Setup BVHTreeFromMesh */
@@ -1238,7 +1301,7 @@ BVHTree *bvhtree_from_editmesh_looptri_ex(BVHTreeFromEditMesh *data,
       /* printf("BVHTree built and saved on cache\n"); */
       bvhcache_insert(bvh_cache, tree, bvh_cache_type);
     }
-    bvhcache_unlock(bvh_cache, lock_started);
+    bvhcache_unlock(bvh_cache, bvh_cache_type, lock_started);
   }
   else {
     tree = bvhtree_from_editmesh_looptri_create_tree(
@@ -1311,7 +1374,7 @@ BVHTree *bvhtree_from_mesh_looptri_ex(BVHTreeFromMesh *data,
   }
 
   if (bvh_cache_p) {
-    bvhcache_unlock(*bvh_cache_p, lock_started);
+    bvhcache_unlock(*bvh_cache_p, bvh_cache_type, lock_started);
   }
 
   /* Setup BVHTreeFromMesh */
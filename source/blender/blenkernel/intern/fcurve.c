@@ -54,6 +54,8 @@
 
 #include "CLG_log.h"
 
+#include "atomic_ops.h"
+
 #define SMALL -1.0e-10
 #define SELECT 1
 
@@ -1760,6 +1762,61 @@ static float fcurve_eval_keyframes_extrapolate(
   return endpoint_bezt->vec[1][1] - (fac * dx);
 }
 
+/* Find the keyframe that evaltime is on or occurs before, with the same result as
+ * #BKE_fcurve_bezt_binarysearch_index_ex for evaltime between the first and last keyframe.
+ *
+ * Playback and baking evaluate the curve at increasing (or decreasing) times, so the segment
+ * found by the previous evaluation and its neighbors are checked before searching all keyframes.
+ */
+static int fcurve_eval_keyframes_find_index(FCurve *fcu,
+                                            BezTriple *bezts,
+                                            float evaltime,
+                                            float threshold,
+                                            bool *r_exact)
+{
+  const int totvert = (int)fcu->totvert;
+  /* The same F-Curve can be evaluated from multiple threads, so the index is only a hint, read
+   * and written atomically. */
+  const int hint = atomic_load_int32(&fcu->eval_keyframe_index);
+  const int offsets[3] = {0, 1, -1};
+  int a = -1;
+
+  for (int i = 0; i < ARRAY_SIZE(offsets); i++) {
+    const int segment = hint + offsets[i];
+    if (segment < 1 || segment >= totvert) {
+      continue;
+    }
+
+    const float prevframe = bezts[segment - 1].vec[1][0];
+    const float frame = bezts[segment].vec[1][0];
+    if (evaltime < prevframe || evaltime > frame) {
+      continue;
+    }
+
+    *r_exact = true;
+    if (IS_EQT(evaltime, prevframe, threshold)) {
+      a = segment - 1;
+    }
+    else if (IS_EQT(evaltime, frame, threshold)) {
+      a = segment;
+    }
+    else {
+      *r_exact = false;
+      a = segment;
+    }
+    break;
+  }
+
+  if (a == -1) {
+    a = BKE_fcurve_bezt_binarysearch_index_ex(bezts, evaltime, totvert, threshold, r_exact);
+  }
+
+  if (hint != a) {
+    atomic_store_int32(&fcu->eval_keyframe_index, a);
+  }
+  return a;
+}
+
 static float fcurve_eval_keyframes_interpolate(FCurve *fcu, BezTriple *bezts, float evaltime)
 {
   const float eps = 1.e-8f;
@@ -1779,7 +1836,7 @@ static float fcurve_eval_keyframes_interpolate(FCurve *fcu, BezTriple *bezts, fl
    *   Weird errors, like selecting the wrong keyframe range (see T39207), occur.
    *   This lower bound was established in b888a32eee8147b028464336ad2404d8155c64dd.
    */
-  a = BKE_fcurve_bezt_binarysearch_index_ex(bezts, evaltime, fcu->totvert, 0.0001, &exact);
+  a = fcurve_eval_keyframes_find_index(fcu, bezts, evaltime, 0.0001, &exact);
   bezt = bezts + a;
 
   if (exact) {
@@ -2214,6 +2271,283 @@ float calculate_fcurve(PathResolvedRNA *anim_rna,
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name F-Curve - Batch Evaluation
+ *
+ * Compiled form of a list of F-Curves, for evaluating all of them at many frames like during
+ * playback. Curves with only constant, linear and Bezier keyframes and without modifiers or
+ * driver are stored as arrays of key times and values with precomputed segments, and remember
+ * the segment of their last evaluation. The values are the same as from #evaluate_fcurve.
+ * \{ */
+
+typedef enum eFCurveBatchSegment {
+  FCURVE_BATCH_SEGMENT_CONSTANT = 0,
+  FCURVE_BATCH_SEGMENT_LINEAR = 1,
+  FCURVE_BATCH_SEGMENT_BEZIER = 2,
+} eFCurveBatchSegment;
+
+typedef struct FCurveBatch {
+  int fcurves_num;
+  /** F-Curves of the list in order, NULL for curves that are not compiled. */
+  FCurve **fcurves;
+  /** Keys of the curve `i` are in the key arrays from `key_offsets[i]` to `key_offsets[i + 1]`. */
+  int *key_offsets;
+  /** Key index where the last evaluation of every curve found its segment. */
+  int *cursors;
+  /** Values of the last evaluation. */
+  float *values;
+
+  float *key_frames;
+  float *key_values;
+  /** Interpolation of the segment that starts at every key, see #eFCurveBatchSegment. */
+  char *segment_types;
+  /**
+   * Bezier control points between the keys of the segment that starts at every key, corrected
+   * with #BKE_fcurve_correct_bezpart: the x and y of the key's right handle, then the x and y
+   * of the next key's left handle.
+   */
+  float (*segment_handles)[4];
+} FCurveBatch;
+
+static bool fcurve_batch_is_supported(const FCurve *fcu)
+{
+  /* Muted curves are not evaluated at all. */
+  if ((fcu->flag & FCURVE_MUTED) || (fcu->grp != NULL && (fcu->grp->flag & AGRP_MUTED))) {
+    return false;
+  }
+  if (fcu->driver != NULL || !BLI_listbase_is_empty(&fcu->modifiers) || fcu->bezt == NULL ||
+      fcu->totvert < 2) {
+    return false;
+  }
+  for (int i = 0; i + 1 < fcu->totvert; i++) {
+    /* Keys must be sorted, so a segment search gives the same result as the binary search. */
+    if (fcu->bezt[i + 1].vec[1][0] < fcu->bezt[i].vec[1][0]) {
+      return false;
+    }
+    /* The interpolation of the last key is only used for extrapolation. */
+    if (!ELEM(fcu->bezt[i].ipo, BEZT_IPO_CONST, BEZT_IPO_LIN, BEZT_IPO_BEZ)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Same as #fcurve_eval_keyframes_interpolate decides between the keys. */
+static char fcurve_batch_compile_segment(const FCurve *fcu,
+                                         const BezTriple *prevbezt,
+                                         const BezTriple *bezt,
+                                         float r_handles[4])
+{
+  zero_v4(r_handles);
+
+  if ((prevbezt->ipo == BEZT_IPO_CONST) || (fcu->flag & FCURVE_DISCRETE_VALUES) ||
+      (bezt->vec[1][0] - prevbezt->vec[1][0] == 0)) {
+    return FCURVE_BATCH_SEGMENT_CONSTANT;
+  }
+  if (prevbezt->ipo == BEZT_IPO_LIN) {
+    return FCURVE_BATCH_SEGMENT_LINEAR;
+  }
+
+  float v1[2], v2[2], v3[2], v4[2];
+  copy_v2_v2(v1, prevbezt->vec[1]);
+  copy_v2_v2(v2, prevbezt->vec[2]);
+  copy_v2_v2(v3, bezt->vec[0]);
+  copy_v2_v2(v4, bezt->vec[1]);
+
+  if (fabsf(v1[1] - v4[1]) < FLT_EPSILON && fabsf(v2[1] - v3[1]) < FLT_EPSILON &&
+      fabsf(v3[1] - v4[1]) < FLT_EPSILON) {
+    return FCURVE_BATCH_SEGMENT_CONSTANT;
+  }
+  BKE_fcurve_correct_bezpart(v1, v2, v3, v4);
+
+  copy_v2_v2(r_handles, v2);
+  copy_v2_v2(r_handles + 2, v3);
+  return FCURVE_BATCH_SEGMENT_BEZIER;
+}
+
+/* Compile the F-Curves of the list. The batch stays valid until any of the curves changes. */
+FCurveBatch *BKE_fcurve_batch_new(ListBase *fcurves)
+{
+  FCurveBatch *batch = MEM_callocN(sizeof(FCurveBatch), __func__);
+  batch->fcurves_num = BLI_listbase_count(fcurves);
+  batch->fcurves = MEM_calloc_arrayN(batch->fcurves_num, sizeof(FCurve *), __func__);
+  batch->key_offsets = MEM_calloc_arrayN(batch->fcurves_num + 1, sizeof(int), __func__);
+  batch->cursors = MEM_calloc_arrayN(batch->fcurves_num, sizeof(int), __func__);
+  batch->values = MEM_calloc_arrayN(batch->fcurves_num, sizeof(float), __func__);
+
+  int keys_num = 0;
+  int index = 0;
+  LISTBASE_FOREACH_INDEX (FCurve *, fcu, fcurves, index) {
+    batch->key_offsets[index] = keys_num;
+    if (fcurve_batch_is_supported(fcu)) {
+      batch->fcurves[index] = fcu;
+      keys_num += (int)fcu->totvert;
+    }
+  }
+  batch->key_offsets[batch->fcurves_num] = keys_num;
+
+  batch->key_frames = MEM_malloc_arrayN(keys_num, sizeof(float), __func__);
+  batch->key_values = MEM_malloc_arrayN(keys_num, sizeof(float), __func__);
+  batch->segment_types = MEM_malloc_arrayN(keys_num, sizeof(char), __func__);
+  batch->segment_handles = MEM_malloc_arrayN(keys_num, sizeof(float[4]), __func__);
+
+  for (index = 0; index < batch->fcurves_num; index++) {
+    const FCurve *fcu = batch->fcurves[index];
+    if (fcu == NULL) {
+      continue;
+    }
+    const int offset = batch->key_offsets[index];
+    for (int i = 0; i < fcu->totvert; i++) {
+      const BezTriple *bezt = &fcu->bezt[i];
+      batch->key_frames[offset + i] = bezt->vec[1][0];
+      batch->key_values[offset + i] = bezt->vec[1][1];
+      if (i + 1 < fcu->totvert) {
+        batch->segment_types[offset + i] = fcurve_batch_compile_segment(
+            fcu, bezt, bezt + 1, batch->segment_handles[offset + i]);
+      }
+      else {
+        batch->segment_types[offset + i] = FCURVE_BATCH_SEGMENT_CONSTANT;
+        zero_v4(batch->segment_handles[offset + i]);
+      }
+    }
+  }
+
+  return batch;
+}
+
+void BKE_fcurve_batch_free(FCurveBatch *batch)
+{
+  if (batch == NULL) {
+    return;
+  }
+  MEM_freeN(batch->fcurves);
+  MEM_freeN(batch->key_offsets);
+  MEM_freeN(batch->cursors);
+  MEM_freeN(batch->values);
+  MEM_freeN(batch->key_frames);
+  MEM_freeN(batch->key_values);
+  MEM_freeN(batch->segment_types);
+  MEM_freeN(batch->segment_handles);
+  MEM_freeN(batch);
+}
+
+/* Find the segment with `frames[a - 1] <= evaltime <= frames[a]`, for evaltime strictly between
+ * the first and last key. */
+static int fcurve_batch_find_segment(const float *frames, int keys_num, int hint, float evaltime)
+{
+  const int offsets[3] = {0, 1, -1};
+  for (int i = 0; i < ARRAY_SIZE(offsets); i++) {
+    const int a = hint + offsets[i];
+    if (a >= 1 && a < keys_num && frames[a - 1] <= evaltime && evaltime <= frames[a]) {
+      return a;
+    }
+  }
+
+  /* First key at or after evaltime. */
+  int start = 1, end = keys_num - 1;
+  while (start < end) {
+    const int mid = start + ((end - start) / 2);
+    if (frames[mid] < evaltime) {
+      start = mid + 1;
+    }
+    else {
+      end = mid;
+    }
+  }
+  return start;
+}
+
+static float fcurve_batch_evaluate_curve(FCurveBatch *batch, int index, float evaltime)
+{
+  FCurve *fcu = batch->fcurves[index];
+  const int offset = batch->key_offsets[index];
+  const int keys_num = batch->key_offsets[index + 1] - offset;
+  const float *frames = batch->key_frames + offset;
+  const float *values = batch->key_values + offset;
+
+  if (evaltime <= frames[0] || frames[keys_num - 1] <= evaltime) {
+    /* Extrapolation depends on the handles and settings of the end keys, it doesn't need a
+     * search so just evaluate the curve. */
+    return evaluate_fcurve(fcu, evaltime);
+  }
+
+  const int a = fcurve_batch_find_segment(frames, keys_num, batch->cursors[index], evaltime);
+  batch->cursors[index] = a;
+
+  /* Same threshold as #fcurve_eval_keyframes_interpolate. */
+  const float threshold = 0.0001f;
+  float cvalue;
+  if (IS_EQT(evaltime, frames[a - 1], threshold)) {
+    cvalue = values[a - 1];
+  }
+  else if (IS_EQT(evaltime, frames[a], threshold)) {
+    cvalue = values[a];
+  }
+  else {
+    const int prev = a - 1;
+    switch (batch->segment_types[offset + prev]) {
+      case FCURVE_BATCH_SEGMENT_LINEAR:
+        cvalue = BLI_easing_linear_ease(evaltime - frames[prev],
+                                        values[prev],
+                                        values[a] - values[prev],
+                                        frames[a] - frames[prev]);
+        break;
+      case FCURVE_BATCH_SEGMENT_BEZIER: {
+        const float *handles = batch->segment_handles[offset + prev];
+        float opl[32];
+        if (findzero(evaltime, frames[prev], handles[0], handles[2], frames[a], opl)) {
+          berekeny(values[prev], handles[1], handles[3], values[a], opl, 1);
+          cvalue = opl[0];
+        }
+        else {
+          cvalue = 0.0f;
+        }
+        break;
+      }
+      default:
+        cvalue = values[prev];
+        break;
+    }
+  }
+
+  if (fcu->flag & FCURVE_INT_VALUES) {
+    cvalue = floorf(cvalue + 0.5f);
+  }
+  return cvalue;
+}
+
+/**
+ * Evaluate all compiled F-Curves at the given time.
+ *
+ * Not thread safe, the batch keeps the position of the last evaluation of every curve.
+ */
+void BKE_fcurve_batch_evaluate(FCurveBatch *batch, float evaltime)
+{
+  for (int index = 0; index < batch->fcurves_num; index++) {
+    FCurve *fcu = batch->fcurves[index];
+    if (fcu != NULL && !(fcu->flag & FCURVE_DISABLED)) {
+      batch->values[index] = fcurve_batch_evaluate_curve(batch, index, evaltime);
+      fcu->curval = batch->values[index]; /* Debug display only, not thread safe! */
+    }
+  }
+}
+
+/**
+ * Value of the F-Curve at the given index of the list from the last evaluation of the batch.
+ * Returns false if the curve is not compiled, then it has to be evaluated with
+ * #calculate_fcurve.
+ */
+bool BKE_fcurve_batch_value(const FCurveBatch *batch, int index, float *r_value)
+{
+  if (batch->fcurves[index] == NULL) {
+    return false;
+  }
+  *r_value = batch->values[index];
+  return true;
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name F-Curve - .blend file API
  * \{ */
@@ -2387,6 +2721,8 @@ void BKE_fcurve_blend_read_data(BlendDataReader *reader, ListBase *fcurves)
      */
     fcu->flag &= ~FCURVE_DISABLED;
 
+    fcu->eval_keyframe_index = 0;
+
     /* driver */
     BLO_read_data_address(reader, &fcu->driver);
     if (fcu->driver) {
@@ -2396,6 +2732,7 @@ void BKE_fcurve_blend_read_data(BlendDataReader *reader, ListBase *fcurves)
        * (old pointer may still be set here). */
       driver->expr_comp = NULL;
       driver->expr_simple = NULL;
+      driver->path_cache = NULL;
 
       /* Give the driver a fresh chance - the operating environment may be different now
        * (addons, etc. may be different) so the driver namespace may be sane now T32155. */
@@ -95,6 +95,36 @@ static ID *dtar_id_ensure_proxy_from(ID *id)
   return id;
 }
 
+/**
+ * Resolve the path of the target, using the resolved path cache of evaluated drivers.
+ */
+static bool dtar_resolve_property_cached(ChannelDriver *driver,
+                                         DriverTarget *dtar,
+                                         PointerRNA *id_ptr,
+                                         PointerRNA *r_ptr,
+                                         PropertyRNA **r_prop,
+                                         int *r_index)
+{
+  PathResolvedRNA resolved;
+
+  if (driver->path_cache == NULL) {
+    return RNA_path_resolve_property_full(id_ptr, dtar->rna_path, r_ptr, r_prop, r_index);
+  }
+
+  if (!BKE_animsys_path_cache_lookup(driver->path_cache, dtar, false, id_ptr, &resolved)) {
+    if (!RNA_path_resolve_property_full(
+            id_ptr, dtar->rna_path, &resolved.ptr, &resolved.prop, &resolved.prop_index)) {
+      return false;
+    }
+    BKE_animsys_path_cache_store(driver->path_cache, dtar, false, id_ptr, &resolved);
+  }
+
+  *r_ptr = resolved.ptr;
+  *r_prop = resolved.prop;
+  *r_index = resolved.prop_index;
+  return true;
+}
+
 /**
  * Helper function to obtain a value using RNA from the specified source
  * (for evaluating drivers).
@@ -129,7 +159,7 @@ static float dtar_get_prop_val(ChannelDriver *driver, DriverTarget *dtar)
   RNA_id_pointer_create(id, &id_ptr);
 
   /* Get property to read from, and get value as appropriate. */
-  if (!RNA_path_resolve_property_full(&id_ptr, dtar->rna_path, &ptr, &prop, &index)) {
+  if (!dtar_resolve_property_cached(driver, dtar, &id_ptr, &ptr, &prop, &index)) {
     /* Path couldn't be resolved. */
     if (G.debug & G_DEBUG) {
       CLOG_ERROR(&LOG,
@@ -932,6 +962,7 @@ void fcurve_free_driver(FCurve *fcu)
 #endif
 
   BLI_expr_pylike_free(driver->expr_simple);
+  BKE_animsys_path_cache_free(driver->path_cache);
 
   /* Free driver itself, then set F-Curve's point to this to NULL
    * (as the curve may still be used). */
@@ -953,6 +984,7 @@ ChannelDriver *fcurve_copy_driver(const ChannelDriver *driver)
   ndriver = MEM_dupallocN(driver);
   ndriver->expr_comp = NULL;
   ndriver->expr_simple = NULL;
+  ndriver->path_cache = NULL;
 
   /* Copy variables. */
 
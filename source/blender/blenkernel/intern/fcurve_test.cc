@@ -21,6 +21,8 @@
 
 #include "BKE_fcurve.h"
 
+#include "BLI_listbase.h"
+
 #include "ED_keyframing.h"
 #include "ED_types.h" /* For SELECT. */
 
@@ -212,6 +214,100 @@ TEST(evaluate_fcurve, ExtrapolationBezierKeys)
   BKE_fcurve_free(fcu);
 }
 
+TEST(evaluate_fcurve, SequentialEvaluation)
+{
+  FCurve *fcu = BKE_fcurve_create();
+
+  /* Keys on every other frame, with the value twice the frame. */
+  for (int i = 0; i < 10; i++) {
+    const float frame = 2.0f * i;
+    insert_vert_fcurve(fcu, frame, 2.0f * frame, BEZT_KEYTYPE_KEYFRAME, INSERTKEY_NO_USERPREF);
+    fcu->bezt[i].ipo = BEZT_IPO_LIN;
+  }
+
+  /* Forward, backward and jumping around, which all start from the keyframe index found by the
+   * previous evaluation. */
+  for (float frame = 0.0f; frame <= 18.0f; frame += 0.5f) {
+    EXPECT_NEAR(evaluate_fcurve(fcu, frame), 2.0f * frame, EPSILON);
+  }
+  for (float frame = 18.0f; frame >= 0.0f; frame -= 0.5f) {
+    EXPECT_NEAR(evaluate_fcurve(fcu, frame), 2.0f * frame, EPSILON);
+  }
+  EXPECT_NEAR(evaluate_fcurve(fcu, 15.0f), 30.0f, EPSILON);
+  EXPECT_NEAR(evaluate_fcurve(fcu, 3.0f), 6.0f, EPSILON);
+  EXPECT_NEAR(evaluate_fcurve(fcu, 4.0f + 0.00008f), 8.0f, EPSILON);
+
+  /* The index of the previous evaluation is beyond the last keyframe after this. */
+  EXPECT_NEAR(evaluate_fcurve(fcu, 17.0f), 34.0f, EPSILON);
+  fcu->totvert = 5;
+  EXPECT_NEAR(evaluate_fcurve(fcu, 7.0f), 14.0f, EPSILON);
+
+  BKE_fcurve_free(fcu);
+}
+
+TEST(evaluate_fcurve, BatchEvaluation)
+{
+  ListBase fcurves = {nullptr, nullptr};
+  const float values[6] = {3.0f, -2.0f, 5.0f, 5.0f, 8.5f, 1.0f};
+
+  /* Bezier with linear extrapolation, a flat segment and an overlapping handle. */
+  FCurve *fcu_bezier = BKE_fcurve_create();
+  /* Linear, with rounding to integers. */
+  FCurve *fcu_linear = BKE_fcurve_create();
+  /* Every key has a different interpolation. */
+  FCurve *fcu_mixed = BKE_fcurve_create();
+  /* Interpolation that is not compiled. */
+  FCurve *fcu_bounce = BKE_fcurve_create();
+  FCurve *fcurves_all[4] = {fcu_bezier, fcu_linear, fcu_mixed, fcu_bounce};
+
+  for (FCurve *fcu : fcurves_all) {
+    for (int i = 0; i < ARRAY_SIZE(values); i++) {
+      insert_vert_fcurve(fcu, 3.0f * i, values[i], BEZT_KEYTYPE_KEYFRAME, INSERTKEY_NO_USERPREF);
+    }
+    BLI_addtail(&fcurves, fcu);
+  }
+  fcu_bezier->extend = FCURVE_EXTRAPOLATE_LINEAR;
+  fcu_bezier->bezt[4].vec[2][0] = 16.0f;
+  fcu_linear->flag |= FCURVE_INT_VALUES;
+  const char mixed_ipo[6] = {
+      BEZT_IPO_CONST, BEZT_IPO_LIN, BEZT_IPO_BEZ, BEZT_IPO_LIN, BEZT_IPO_CONST, BEZT_IPO_BEZ};
+  for (int i = 0; i < ARRAY_SIZE(values); i++) {
+    fcu_linear->bezt[i].ipo = BEZT_IPO_LIN;
+    fcu_mixed->bezt[i].ipo = mixed_ipo[i];
+    fcu_bounce->bezt[i].ipo = BEZT_IPO_BOUNCE;
+  }
+
+  FCurveBatch *batch = BKE_fcurve_batch_new(&fcurves);
+
+  /* Forward, backward, on and near keys and extrapolated, all with the same values as
+   * evaluating the curves one by one. */
+  auto expect_same = [&](const float frame) {
+    BKE_fcurve_batch_evaluate(batch, frame);
+    for (int index = 0; index < ARRAY_SIZE(fcurves_all); index++) {
+      float value;
+      if (fcurves_all[index] == fcu_bounce) {
+        EXPECT_FALSE(BKE_fcurve_batch_value(batch, index, &value));
+        continue;
+      }
+      EXPECT_TRUE(BKE_fcurve_batch_value(batch, index, &value));
+      EXPECT_EQ(value, evaluate_fcurve(fcurves_all[index], frame)) << "frame " << frame;
+    }
+  };
+  for (float frame = -2.0f; frame <= 17.0f; frame += 0.125f) {
+    expect_same(frame);
+  }
+  for (float frame = 17.0f; frame >= -2.0f; frame -= 0.375f) {
+    expect_same(frame);
+  }
+  expect_same(12.00005f);
+  expect_same(2.99995f);
+  expect_same(1.0f);
+  expect_same(14.5f);
+
+  BKE_fcurve_batch_free(batch);
+  BKE_fcurves_free(&fcurves);
+}
+
 TEST(fcurve_subdivide, BKE_fcurve_bezt_subdivide_handles)
 {
   FCurve *fcu = BKE_fcurve_create();
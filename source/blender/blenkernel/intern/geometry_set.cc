@@ -90,6 +90,11 @@ bool GeometryComponent::is_empty() const
   return false;
 }
 
+bool GeometryComponent::owns_direct_data() const
+{
+  return true;
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -412,6 +417,11 @@ bool MeshComponent::is_empty() const
   return mesh_ == nullptr;
 }
 
+bool MeshComponent::owns_direct_data() const
+{
+  return mesh_ == nullptr || ownership_ == GeometryOwnershipType::Owned;
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -498,6 +508,11 @@ bool PointCloudComponent::is_empty() const
   return pointcloud_ == nullptr;
 }
 
+bool PointCloudComponent::owns_direct_data() const
+{
+  return pointcloud_ == nullptr || ownership_ == GeometryOwnershipType::Owned;
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -637,6 +652,11 @@ Volume *VolumeComponent::release()
   return volume;
 }
 
+bool VolumeComponent::owns_direct_data() const
+{
+  return volume_ == nullptr || ownership_ == GeometryOwnershipType::Owned;
+}
+
 /* Get the volume from this component. This method can be used by multiple threads at the same
  * time. Therefore, the returned volume should not be modified. No ownership is transferred. */
 const Volume *VolumeComponent::get_for_read() const
@@ -1786,6 +1786,27 @@ void BKE_mesh_vert_normals_apply(Mesh *mesh, const short (*vert_normals)[3])
   mesh->runtime.cd_dirty_vert &= ~CD_MASK_NORMAL;
 }
 
+/**
+ * Create the smooth fans of split normals of the mesh, when they are not stored yet.
+ *
+ * Only meshes whose topology and sharp/smooth flags are not modified anymore may keep their fans
+ * (evaluated meshes), since they are not checked against the mesh before use. Modifying the
+ * topology of the mesh requires freeing them with #BKE_mesh_runtime_clear_geometry.
+ */
+void BKE_mesh_loop_split_fans_ensure(Mesh *mesh)
+{
+  if (mesh->runtime.loop_split_fans != NULL || mesh->totloop == 0) {
+    return;
+  }
+  mesh->runtime.loop_split_fans = BKE_mesh_loop_split_fans_create(mesh->mvert,
+                                                                  mesh->medge,
+                                                                  mesh->totedge,
+                                                                  mesh->mloop,
+                                                                  mesh->totloop,
+                                                                  mesh->mpoly,
+                                                                  mesh->totpoly);
+}
+
 /**
  * Compute 'split' (aka loop, or per face corner's) normals.
  *
@@ -1838,21 +1859,39 @@ void BKE_mesh_calc_normals_split_ex(Mesh *mesh, MLoopNorSpaceArray *r_lnors_spac
     free_polynors = true;
   }
 
-  BKE_mesh_normals_loop_split(mesh->mvert,
-                              mesh->totvert,
-                              mesh->medge,
-                              mesh->totedge,
-                              mesh->mloop,
-                              r_loopnors,
-                              mesh->totloop,
-                              mesh->mpoly,
-                              (const float(*)[3])polynors,
-                              mesh->totpoly,
-                              use_split_normals,
-                              split_angle,
-                              r_lnors_spacearr,
-                              clnors,
-                              NULL);
+  /* Without angle threshold the smooth fans only depend on the topology, so the ones stored by
+   * #BKE_mesh_loop_split_fans_ensure can be used. */
+  const bool use_fans = use_split_normals && (split_angle >= (float)M_PI || clnors != NULL);
+  const struct MLoopSplitFans *fans = use_fans ? mesh->runtime.loop_split_fans : NULL;
+
+  if (fans) {
+    BKE_mesh_normals_loop_split_from_fans(fans,
+                                          mesh->mvert,
+                                          mesh->medge,
+                                          mesh->mloop,
+                                          r_loopnors,
+                                          (const float(*)[3])polynors,
+                                          r_lnors_spacearr,
+                                          clnors,
+                                          NULL);
+  }
+  else {
+    BKE_mesh_normals_loop_split(mesh->mvert,
+                                mesh->totvert,
+                                mesh->medge,
+                                mesh->totedge,
+                                mesh->mloop,
+                                r_loopnors,
+                                mesh->totloop,
+                                mesh->mpoly,
+                                (const float(*)[3])polynors,
+                                mesh->totpoly,
+                                use_split_normals,
+                                split_angle,
+                                r_lnors_spacearr,
+                                clnors,
+                                NULL);
+  }
 
   if (free_polynors) {
     MEM_freeN(polynors);
@@ -1740,6 +1740,445 @@ void BKE_mesh_normals_loop_split(const MVert *mverts,
 #endif
 }
 
+/* Cached smooth fans.
+ *
+ * When edges are not split by angle (custom normals, or auto-smooth disabled), which loops share
+ * a smooth fan only depends on the topology and on the sharp/smooth flags of the mesh.
+ * #MLoopSplitFans stores the fans walked by #loop_split_generator, so deformed meshes only have
+ * to compute the normal values of each fan, which is done in parallel. */
+
+/** One loop of a smooth fan. */
+typedef struct MLoopSplitFanStep {
+  /** Loop using the vertex the fan is around. */
+  int loop;
+  /** Edge from that loop to the next one of the fan (or previous edge of a single loop). */
+  int edge;
+} MLoopSplitFanStep;
+
+typedef struct MLoopSplitFans {
+  /** Shared by evaluated meshes with the same topology, see #BKE_mesh_loop_split_fans_ref. */
+  int users;
+
+  int numLoops;
+  int fans_len;
+  /** Start of each fan in #steps, with an extra item for the end of the last fan. */
+  int *fan_offsets;
+  /** Loops of all fans, in the order they are walked around their vertex. */
+  MLoopSplitFanStep *steps;
+  int *loop_to_poly;
+} MLoopSplitFans;
+
+/**
+ * Walk all smooth fans of the mesh, like #loop_split_generator does, storing their loops.
+ * Returns NULL if the fans do not cover each loop exactly once (should not happen).
+ */
+MLoopSplitFans *BKE_mesh_loop_split_fans_create(const MVert *mverts,
+                                                const MEdge *medges,
+                                                const int numEdges,
+                                                const MLoop *mloops,
+                                                const int numLoops,
+                                                const MPoly *mpolys,
+                                                const int numPolys)
+{
+  int(*edge_to_loops)[2] = MEM_calloc_arrayN((size_t)numEdges, sizeof(*edge_to_loops), __func__);
+  int *loop_to_poly = MEM_malloc_arrayN((size_t)numLoops, sizeof(*loop_to_poly), __func__);
+  int *fan_offsets = MEM_malloc_arrayN((size_t)numLoops + 1, sizeof(*fan_offsets), __func__);
+  MLoopSplitFanStep *steps = MEM_malloc_arrayN((size_t)numLoops, sizeof(*steps), __func__);
+  BLI_bitmap *skip_loops = BLI_BITMAP_NEW(numLoops, __func__);
+  int fans_len = 0;
+  int steps_len = 0;
+  /* Set when a loop is part of several fans, so the steps don't fit in their array. */
+  bool is_overflow = false;
+
+#ifdef DEBUG_TIME
+  TIMEIT_START_AVERAGED(BKE_mesh_loop_split_fans_create);
+#endif
+
+  LoopSplitTaskDataCommon common_data = {
+      .mverts = mverts,
+      .medges = medges,
+      .mloops = mloops,
+      .mpolys = mpolys,
+      .edge_to_loops = edge_to_loops,
+      .loop_to_poly = loop_to_poly,
+      .numEdges = numEdges,
+      .numLoops = numLoops,
+      .numPolys = numPolys,
+  };
+
+  /* No angle check, so neither normals nor positions are used here. */
+  mesh_edges_sharp_tag(&common_data, false, (float)M_PI, false);
+
+  for (int mp_index = 0; mp_index < numPolys; mp_index++) {
+    const MPoly *mp = &mpolys[mp_index];
+    const int ml_last_index = (mp->loopstart + mp->totloop) - 1;
+    int ml_curr_index = mp->loopstart;
+    int ml_prev_index = ml_last_index;
+
+    for (; ml_curr_index <= ml_last_index; ml_curr_index++) {
+      const MLoop *ml_curr = &mloops[ml_curr_index];
+      const MLoop *ml_prev = &mloops[ml_prev_index];
+      const int *e2l_curr = edge_to_loops[ml_curr->e];
+      const int *e2l_prev = edge_to_loops[ml_prev->e];
+
+      /* Same fan entry points as #loop_split_generator. */
+      if (!IS_EDGE_SHARP(e2l_curr) && (BLI_BITMAP_TEST(skip_loops, ml_curr_index) ||
+                                       !loop_split_generator_check_cyclic_smooth_fan(mloops,
+                                                                                     mpolys,
+                                                                                     edge_to_loops,
+                                                                                     loop_to_poly,
+                                                                                     e2l_prev,
+                                                                                     skip_loops,
+                                                                                     ml_curr,
+                                                                                     ml_prev,
+                                                                                     ml_curr_index,
+                                                                                     ml_prev_index,
+                                                                                     mp_index))) {
+        /* Skip. */
+      }
+      else if (steps_len == numLoops) {
+        is_overflow = true;
+      }
+      else if (IS_EDGE_SHARP(e2l_curr) && IS_EDGE_SHARP(e2l_prev)) {
+        fan_offsets[fans_len++] = steps_len;
+        steps[steps_len].loop = ml_curr_index;
+        steps[steps_len].edge = (int)ml_prev->e;
+        steps_len++;
+      }
+      else {
+        /* Same walk as #split_loop_nor_fan_do. */
+        const uint mv_pivot_index = ml_curr->v;
+        const int *e2lfan_curr = e2l_prev;
+        const MLoop *mlfan_curr = ml_prev;
+        int mlfan_curr_index = ml_prev_index;
+        int mlfan_vert_index = ml_curr_index;
+        int mpfan_curr_index = mp_index;
+
+        fan_offsets[fans_len++] = steps_len;
+        while (true) {
+          if (steps_len == numLoops) {
+            is_overflow = true;
+            break;
+          }
+          steps[steps_len].loop = mlfan_vert_index;
+          steps[steps_len].edge = (int)mlfan_curr->e;
+          steps_len++;
+
+          if (IS_EDGE_SHARP(e2lfan_curr) || (mlfan_curr->e == ml_curr->e)) {
+            break;
+          }
+
+          BKE_mesh_loop_manifold_fan_around_vert_next(mloops,
+                                                      mpolys,
+                                                      loop_to_poly,
+                                                      e2lfan_curr,
+                                                      mv_pivot_index,
+                                                      &mlfan_curr,
+                                                      &mlfan_curr_index,
+                                                      &mlfan_vert_index,
+                                                      &mpfan_curr_index);
+
+          e2lfan_curr = edge_to_loops[mlfan_curr->e];
+        }
+      }
+
+      ml_prev_index = ml_curr_index;
+    }
+  }
+
+  MEM_freeN(edge_to_loops);
+  MEM_freeN(skip_loops);
+
+#ifdef DEBUG_TIME
+  TIMEIT_END_AVERAGED(BKE_mesh_loop_split_fans_create);
+#endif
+
+  if (is_overflow || steps_len != numLoops) {
+    BLI_assert(!"Smooth fans do not cover all loops");
+    MEM_freeN(loop_to_poly);
+    MEM_freeN(fan_offsets);
+    MEM_freeN(steps);
+    return NULL;
+  }
+
+  fan_offsets[fans_len] = steps_len;
+
+  MLoopSplitFans *fans = MEM_callocN(sizeof(*fans), __func__);
+  fans->users = 1;
+  fans->numLoops = numLoops;
+  fans->fans_len = fans_len;
+  fans->fan_offsets = MEM_reallocN(fan_offsets, sizeof(*fan_offsets) * (size_t)(fans_len + 1));
+  fans->steps = steps;
+  fans->loop_to_poly = loop_to_poly;
+  return fans;
+}
+
+/** Add a user, the fans are never modified once created so they can be shared between meshes. */
+MLoopSplitFans *BKE_mesh_loop_split_fans_ref(MLoopSplitFans *fans)
+{
+  atomic_add_and_fetch_int32(&fans->users, 1);
+  return fans;
+}
+
+/** Remove a user, freeing the fans when it was the last one. */
+void BKE_mesh_loop_split_fans_free(MLoopSplitFans *fans)
+{
+  if (atomic_sub_and_fetch_int32(&fans->users, 1) != 0) {
+    return;
+  }
+  MEM_freeN(fans->fan_offsets);
+  MEM_freeN(fans->steps);
+  MEM_freeN(fans->loop_to_poly);
+  MEM_freeN(fans);
+}
+
+typedef struct LoopSplitFansData {
+  const MLoopSplitFans *fans;
+  MLoopNorSpaceArray *lnors_spacearr;
+  /** All the spaces, allocated at once since the memarena can't be used from several threads. */
+  MLoopNorSpace *lnor_spaces;
+  float (*loopnors)[3];
+  short (*clnors_data)[2];
+
+  const MVert *mverts;
+  const MEdge *medges;
+  const MLoop *mloops;
+  const float (*polynors)[3];
+} LoopSplitFansData;
+
+typedef struct LoopSplitFansTLS {
+  /** Edge vectors of the current fan, only used when computing lnor spaces. */
+  BLI_Stack *edge_vectors;
+} LoopSplitFansTLS;
+
+BLI_INLINE void loop_split_fan_edge_vector(const MVert *mverts,
+                                           const MEdge *me,
+                                           const uint mv_pivot_index,
+                                           float r_vec[3])
+{
+  const uint mv_other_index = (me->v1 == mv_pivot_index) ? me->v2 : me->v1;
+  sub_v3_v3v3(r_vec, mverts[mv_other_index].co, mverts[mv_pivot_index].co);
+  normalize_v3(r_vec);
+}
+
+/** Same as #split_loop_nor_single_do, for a fan with a single loop. */
+static void loop_split_fans_single_do(const LoopSplitFansData *data,
+                                      const MLoopSplitFanStep *step,
+                                      MLoopNorSpace *lnor_space)
+{
+  const int ml_curr_index = step->loop;
+  const MLoop *ml_curr = &data->mloops[ml_curr_index];
+  float *lnor = data->loopnors[ml_curr_index];
+
+  copy_v3_v3(lnor, data->polynors[data->fans->loop_to_poly[ml_curr_index]]);
+
+  if (lnor_space) {
+    float vec_curr[3], vec_prev[3];
+
+    loop_split_fan_edge_vector(data->mverts, &data->medges[ml_curr->e], ml_curr->v, vec_curr);
+    loop_split_fan_edge_vector(data->mverts, &data->medges[step->edge], ml_curr->v, vec_prev);
+
+    BKE_lnor_space_define(lnor_space, lnor, vec_curr, vec_prev, NULL);
+    BKE_lnor_space_add_loop(data->lnors_spacearr, lnor_space, ml_curr_index, NULL, true);
+
+    if (data->clnors_data) {
+      BKE_lnor_space_custom_data_to_normal(lnor_space, data->clnors_data[ml_curr_index], lnor);
+    }
+  }
+}
+
+/** Same as #split_loop_nor_fan_do, walking the stored loops instead of the topology. */
+static void loop_split_fans_fan_do(const LoopSplitFansData *data,
+                                   const MLoopSplitFanStep *steps,
+                                   const int steps_len,
+                                   MLoopNorSpace *lnor_space,
+                                   BLI_Stack *edge_vectors)
+{
+  const int *loop_to_poly = data->fans->loop_to_poly;
+  float(*loopnors)[3] = data->loopnors;
+  short(*clnors_data)[2] = data->clnors_data;
+
+  const MLoop *ml_curr = &data->mloops[steps[0].loop];
+  const uint mv_pivot_index = ml_curr->v;
+  const int me_org_index = (int)ml_curr->e;
+
+  float vec_curr[3], vec_prev[3], vec_org[3];
+  float lnor[3] = {0.0f, 0.0f, 0.0f};
+
+  int clnors_avg[2] = {0, 0};
+  bool clnors_invalid = false;
+
+  loop_split_fan_edge_vector(data->mverts, &data->medges[me_org_index], mv_pivot_index, vec_org);
+  copy_v3_v3(vec_prev, vec_org);
+  if (lnor_space) {
+    BLI_stack_push(edge_vectors, vec_org);
+  }
+
+  for (int i = 0; i < steps_len; i++) {
+    const int mlfan_vert_index = steps[i].loop;
+
+    const MEdge *me_curr = &data->medges[steps[i].edge];
+
+    loop_split_fan_edge_vector(data->mverts, me_curr, mv_pivot_index, vec_curr);
+
+    /* Calculate angle between the two poly edges incident on this vertex. */
+    const float fac = saacos(dot_v3v3(vec_curr, vec_prev));
+    madd_v3_v3fl(lnor, data->polynors[loop_to_poly[mlfan_vert_index]], fac);
+
+    if (clnors_data) {
+      const short *clnor = clnors_data[mlfan_vert_index];
+      const short *clnor_ref = clnors_data[steps[0].loop];
+      clnors_invalid |= (clnor_ref[0] != clnor[0] || clnor_ref[1] != clnor[1]);
+      clnors_avg[0] += clnor[0];
+      clnors_avg[1] += clnor[1];
+    }
+
+    if (lnor_space) {
+      BKE_lnor_space_add_loop(data->lnors_spacearr, lnor_space, mlfan_vert_index, NULL, false);
+      if (steps[i].edge != me_org_index) {
+        BLI_stack_push(edge_vectors, vec_curr);
+      }
+    }
+
+    copy_v3_v3(vec_prev, vec_curr);
+  }
+
+  float lnor_len = normalize_v3(lnor);
+
+  if (UNLIKELY(lnor_len == 0.0f)) {
+    /* Use vertex normal as fallback! */
+    normal_short_to_float_v3(lnor, data->mverts[mv_pivot_index].no);
+    lnor_len = 1.0f;
+  }
+
+  if (lnor_space) {
+    BKE_lnor_space_define(lnor_space, lnor, vec_org, vec_curr, edge_vectors);
+
+    if (clnors_data) {
+      if (clnors_invalid) {
+        clnors_avg[0] /= steps_len;
+        clnors_avg[1] /= steps_len;
+        /* Fix/update all clnors of this fan with computed average value. */
+        if (G.debug & G_DEBUG) {
+          printf("Invalid clnors in this fan!\n");
+        }
+        for (int i = 0; i < steps_len; i++) {
+          clnors_data[steps[i].loop][0] = (short)clnors_avg[0];
+          clnors_data[steps[i].loop][1] = (short)clnors_avg[1];
+        }
+      }
+
+      BKE_lnor_space_custom_data_to_normal(lnor_space, clnors_data[steps[0].loop], lnor);
+    }
+  }
+
+  for (int i = 0; i < steps_len; i++) {
+    copy_v3_v3(loopnors[steps[i].loop], lnor);
+  }
+}
+
+static void loop_split_fans_cb(void *__restrict userdata,
+                               const int fan_index,
+                               const TaskParallelTLS *__restrict tls)
+{
+  const LoopSplitFansData *data = userdata;
+  const MLoopSplitFans *fans = data->fans;
+  const int steps_start = fans->fan_offsets[fan_index];
+  const int steps_len = fans->fan_offsets[fan_index + 1] - steps_start;
+  MLoopNorSpace *lnor_space = data->lnor_spaces ? &data->lnor_spaces[fan_index] : NULL;
+
+  if (steps_len == 1) {
+    loop_split_fans_single_do(data, &fans->steps[steps_start], lnor_space);
+    return;
+  }
+
+  LoopSplitFansTLS *tls_data = tls->userdata_chunk;
+  if (lnor_space && tls_data->edge_vectors == NULL) {
+    tls_data->edge_vectors = BLI_stack_new(sizeof(float[3]), __func__);
+  }
+  loop_split_fans_fan_do(
+      data, &fans->steps[steps_start], steps_len, lnor_space, tls_data->edge_vectors);
+}
+
+static void loop_split_fans_free_cb(const void *__restrict UNUSED(userdata),
+                                    void *__restrict tls_v)
+{
+  LoopSplitFansTLS *tls_data = tls_v;
+  if (tls_data->edge_vectors) {
+    BLI_stack_free(tls_data->edge_vectors);
+  }
+}
+
+/**
+ * Compute split normals from smooth fans created by #BKE_mesh_loop_split_fans_create,
+ * giving the same result as #BKE_mesh_normals_loop_split with \a split_angle disabled.
+ * The fans are not checked against the mesh: its topology and sharp/smooth flags must be the
+ * ones the fans were created for, only vertex positions and normals and polygon normals may have
+ * changed.
+ */
+void BKE_mesh_normals_loop_split_from_fans(const MLoopSplitFans *fans,
+                                           const MVert *mverts,
+                                           const MEdge *medges,
+                                           const MLoop *mloops,
+                                           float (*r_loopnors)[3],
+                                           const float (*polynors)[3],
+                                           MLoopNorSpaceArray *r_lnors_spacearr,
+                                           short (*clnors_data)[2],
+                                           int *r_loop_to_poly)
+{
+  MLoopNorSpaceArray _lnors_spacearr = {NULL};
+
+#ifdef DEBUG_TIME
+  TIMEIT_START_AVERAGED(BKE_mesh_normals_loop_split_from_fans);
+#endif
+
+  if (!r_lnors_spacearr && clnors_data) {
+    /* We need to compute lnor spacearr if some custom lnor data are given to us! */
+    r_lnors_spacearr = &_lnors_spacearr;
+  }
+
+  LoopSplitFansData data = {
+      .fans = fans,
+      .lnors_spacearr = r_lnors_spacearr,
+      .loopnors = r_loopnors,
+      .clnors_data = clnors_data,
+      .mverts = mverts,
+      .medges = medges,
+      .mloops = mloops,
+      .polynors = polynors,
+  };
+
+  if (r_lnors_spacearr) {
+    BKE_lnor_spacearr_init(r_lnors_spacearr, fans->numLoops, MLNOR_SPACEARR_LOOP_INDEX);
+    data.lnor_spaces = BLI_memarena_calloc(r_lnors_spacearr->mem,
+                                           sizeof(*data.lnor_spaces) * (size_t)fans->fans_len);
+    r_lnors_spacearr->num_spaces += fans->fans_len;
+  }
+
+  LoopSplitFansTLS tls_data = {NULL};
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = LOOP_SPLIT_TASK_BLOCK_SIZE;
+  settings.userdata_chunk = &tls_data;
+  settings.userdata_chunk_size = sizeof(tls_data);
+  settings.func_free = loop_split_fans_free_cb;
+
+  BLI_task_parallel_range(0, fans->fans_len, &data, loop_split_fans_cb, &settings);
+
+  if (r_loop_to_poly) {
+    memcpy(r_loop_to_poly, fans->loop_to_poly, sizeof(*r_loop_to_poly) * (size_t)fans->numLoops);
+  }
+
+  if (r_lnors_spacearr == &_lnors_spacearr) {
+    BKE_lnor_spacearr_free(r_lnors_spacearr);
+  }
+
+#ifdef DEBUG_TIME
+  TIMEIT_END_AVERAGED(BKE_mesh_normals_loop_split_from_fans);
+#endif
+}
+
 #undef INDEX_UNSET
 #undef INDEX_INVALID
 #undef IS_EDGE_SHARP
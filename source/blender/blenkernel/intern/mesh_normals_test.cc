@@ -0,0 +1,271 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "BKE_mesh.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "DNA_meshdata_types.h"
+
+#include "BLI_float3.hh"
+#include "BLI_linklist.h"
+#include "BLI_map.hh"
+#include "BLI_math_vector.h"
+#include "BLI_rand.hh"
+#include "BLI_vector.hh"
+
+namespace blender::bke::tests {
+
+struct MeshNormalsTestMesh {
+  Vector<MVert> verts;
+  Vector<MEdge> edges;
+  Vector<MLoop> loops;
+  Vector<MPoly> polys;
+  Map<std::pair<int, int>, int> edge_map;
+
+  int add_vert(const float x, const float y, const float z)
+  {
+    MVert mv = {{0.0f}};
+    mv.co[0] = x;
+    mv.co[1] = y;
+    mv.co[2] = z;
+    verts.append(mv);
+    return verts.size() - 1;
+  }
+
+  int add_edge(const int v1, const int v2)
+  {
+    const std::pair<int, int> key(std::min(v1, v2), std::max(v1, v2));
+    return edge_map.lookup_or_add_cb(key, [&]() {
+      MEdge me = {0};
+      me.v1 = key.first;
+      me.v2 = key.second;
+      edges.append(me);
+      return edges.size() - 1;
+    });
+  }
+
+  void add_poly(const Span<int> poly_verts, const bool use_smooth)
+  {
+    MPoly mp = {0};
+    mp.loopstart = loops.size();
+    mp.totloop = poly_verts.size();
+    mp.flag = use_smooth ? ME_SMOOTH : 0;
+    for (const int i : poly_verts.index_range()) {
+      MLoop ml;
+      ml.v = poly_verts[i];
+      ml.e = add_edge(poly_verts[i], poly_verts[(i + 1) % poly_verts.size()]);
+      loops.append(ml);
+    }
+    polys.append(mp);
+  }
+
+  void set_edge_sharp(const int v1, const int v2)
+  {
+    edges[edge_map.lookup({std::min(v1, v2), std::max(v1, v2)})].flag |= ME_SHARP;
+  }
+};
+
+/* Wavy grid of quads with a few sharp edges and flat faces, and optionally a fan around a vertex
+ * that only has zero area triangles. */
+static void test_mesh_normals_create(MeshNormalsTestMesh &mesh, const bool use_zero_area_fan)
+{
+  const int size = 8;
+  for (int y = 0; y < size; y++) {
+    for (int x = 0; x < size; x++) {
+      mesh.add_vert(x, y, sinf(x * 0.7f) * cosf(y * 0.5f));
+    }
+  }
+  for (int y = 0; y < size - 1; y++) {
+    for (int x = 0; x < size - 1; x++) {
+      const int v = y * size + x;
+      mesh.add_poly({v, v + 1, v + size + 1, v + size}, (x + y) % 5 != 0);
+    }
+  }
+  for (int x = 0; x < size - 1; x++) {
+    mesh.set_edge_sharp(3 * size + x, 3 * size + x + 1);
+  }
+  for (int y = 0; y < size - 1; y += 2) {
+    mesh.set_edge_sharp(y * size + 5, (y + 1) * size + 5);
+  }
+
+  if (use_zero_area_fan) {
+    const int v0 = mesh.add_vert(20.0f, 0.0f, 0.0f);
+    const int v1 = mesh.add_vert(20.0f, 0.0f, 0.0f);
+    const int v2 = mesh.add_vert(20.0f, 0.0f, 0.0f);
+    const int v3 = mesh.add_vert(20.0f, 0.0f, 0.0f);
+    mesh.add_poly({v0, v1, v2}, true);
+    mesh.add_poly({v0, v2, v3}, true);
+  }
+}
+
+struct MeshNormalsTestResult {
+  Vector<float3> loopnors;
+  Vector<int> loop_to_poly;
+  Vector<std::array<short, 2>> clnors;
+  MLoopNorSpaceArray lnors_spacearr = {nullptr};
+
+  ~MeshNormalsTestResult()
+  {
+    BKE_lnor_spacearr_free(&lnors_spacearr);
+  }
+};
+
+static Vector<std::array<short, 2>> test_mesh_normals_clnors(const MeshNormalsTestMesh &mesh)
+{
+  /* Random data, so loops of the same fan mostly have different custom normals too, which is
+   * fixed by averaging them. */
+  RandomNumberGenerator rng;
+  Vector<std::array<short, 2>> clnors(mesh.loops.size());
+  for (std::array<short, 2> &clnor : clnors) {
+    clnor[0] = (short)(rng.get_int32() % 2048 - 1024);
+    clnor[1] = (short)(rng.get_int32() % 2048 - 1024);
+  }
+  return clnors;
+}
+
+static void test_mesh_normals_compute(MeshNormalsTestMesh &mesh,
+                                      const bool use_clnors,
+                                      const bool use_fans,
+                                      MeshNormalsTestResult &r_result)
+{
+  Vector<float3> polynors(mesh.polys.size());
+  BKE_mesh_calc_normals_poly(mesh.verts.data(),
+                             nullptr,
+                             mesh.verts.size(),
+                             mesh.loops.data(),
+                             mesh.polys.data(),
+                             mesh.loops.size(),
+                             mesh.polys.size(),
+                             (float(*)[3])polynors.data(),
+                             false);
+
+  r_result.loopnors.resize(mesh.loops.size());
+  r_result.loop_to_poly.resize(mesh.loops.size());
+  if (use_clnors) {
+    r_result.clnors = test_mesh_normals_clnors(mesh);
+  }
+  short(*clnors)[2] = use_clnors ? (short(*)[2])r_result.clnors.data() : nullptr;
+
+  if (use_fans) {
+    MLoopSplitFans *fans = BKE_mesh_loop_split_fans_create(mesh.verts.data(),
+                                                           mesh.edges.data(),
+                                                           mesh.edges.size(),
+                                                           mesh.loops.data(),
+                                                           mesh.loops.size(),
+                                                           mesh.polys.data(),
+                                                           mesh.polys.size());
+    ASSERT_NE(fans, nullptr);
+    BKE_mesh_normals_loop_split_from_fans(fans,
+                                          mesh.verts.data(),
+                                          mesh.edges.data(),
+                                          mesh.loops.data(),
+                                          (float(*)[3])r_result.loopnors.data(),
+                                          (const float(*)[3])polynors.data(),
+                                          &r_result.lnors_spacearr,
+                                          clnors,
+                                          r_result.loop_to_poly.data());
+    BKE_mesh_loop_split_fans_free(fans);
+  }
+  else {
+    BKE_mesh_normals_loop_split(mesh.verts.data(),
+                                mesh.verts.size(),
+                                mesh.edges.data(),
+                                mesh.edges.size(),
+                                mesh.loops.data(),
+                                (float(*)[3])r_result.loopnors.data(),
+                                mesh.loops.size(),
+                                mesh.polys.data(),
+                                (const float(*)[3])polynors.data(),
+                                mesh.polys.size(),
+                                true,
+                                (float)M_PI,
+                                &r_result.lnors_spacearr,
+                                clnors,
+                                r_result.loop_to_poly.data());
+  }
+}
+
+static std::vector<int> test_mesh_normals_space_loops(const MLoopNorSpace *lnor_space)
+{
+  std::vector<int> loops;
+  if (lnor_space->flags & MLNOR_SPACE_IS_SINGLE) {
+    loops.push_back(POINTER_AS_INT(lnor_space->loops));
+  }
+  else {
+    for (const LinkNode *node = lnor_space->loops; node; node = node->next) {
+      loops.push_back(POINTER_AS_INT(node->link));
+    }
+  }
+  std::sort(loops.begin(), loops.end());
+  return loops;
+}
+
+static void test_mesh_normals_compare(const bool use_clnors, const bool use_zero_area_fan)
+{
+  MeshNormalsTestMesh mesh;
+  test_mesh_normals_create(mesh, use_zero_area_fan);
+
+  MeshNormalsTestResult result;
+  MeshNormalsTestResult result_fans;
+  test_mesh_normals_compute(mesh, use_clnors, false, result);
+  test_mesh_normals_compute(mesh, use_clnors, true, result_fans);
+
+  EXPECT_EQ(result.lnors_spacearr.num_spaces, result_fans.lnors_spacearr.num_spaces);
+  for (const int i : mesh.loops.index_range()) {
+    EXPECT_V3_NEAR(result.loopnors[i], result_fans.loopnors[i], 1e-6f);
+    EXPECT_EQ(result.loop_to_poly[i], result_fans.loop_to_poly[i]);
+    if (use_clnors) {
+      EXPECT_EQ(result.clnors[i], result_fans.clnors[i]);
+    }
+
+    const MLoopNorSpace *lnor_space = result.lnors_spacearr.lspacearr[i];
+    const MLoopNorSpace *lnor_space_fans = result_fans.lnors_spacearr.lspacearr[i];
+    EXPECT_V3_NEAR(lnor_space->vec_lnor, lnor_space_fans->vec_lnor, 1e-6f);
+    EXPECT_V3_NEAR(lnor_space->vec_ref, lnor_space_fans->vec_ref, 1e-6f);
+    EXPECT_V3_NEAR(lnor_space->vec_ortho, lnor_space_fans->vec_ortho, 1e-6f);
+    EXPECT_NEAR(lnor_space->ref_alpha, lnor_space_fans->ref_alpha, 1e-6f);
+    EXPECT_NEAR(lnor_space->ref_beta, lnor_space_fans->ref_beta, 1e-6f);
+    EXPECT_EQ(lnor_space->flags, lnor_space_fans->flags);
+    EXPECT_EQ(test_mesh_normals_space_loops(lnor_space),
+              test_mesh_normals_space_loops(lnor_space_fans));
+  }
+}
+
+TEST(mesh_normals, LoopSplitFans)
+{
+  test_mesh_normals_compare(false, false);
+}
+
+TEST(mesh_normals, LoopSplitFansCustomNormals)
+{
+  test_mesh_normals_compare(true, false);
+}
+
+TEST(mesh_normals, LoopSplitFansZeroAreaFan)
+{
+  test_mesh_normals_compare(false, true);
+  test_mesh_normals_compare(true, true);
+}
+
+}  // namespace blender::bke::tests
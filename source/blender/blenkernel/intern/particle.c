@@ -2683,10 +2683,35 @@ void psys_find_parents(ParticleSimulationData *sim, const bool use_render_params
 
   BLI_kdtree_3d_balance(tree);
 
-  for (; p < totchild; p++, cpa++) {
-    psys_particle_on_emitter(
-        sim->psmd, from, cpa->num, DMCACHE_ISCHILD, cpa->fuv, cpa->foffset, co, 0, 0, 0, orco);
-    cpa->parent = BLI_kdtree_3d_find_nearest(tree, orco, NULL);
+  if (p < totchild) {
+    const int child_len = totchild - p;
+    float(*child_orco)[3] = MEM_mallocN(sizeof(*child_orco) * (size_t)child_len, __func__);
+    int *child_parent = MEM_mallocN(sizeof(*child_parent) * (size_t)child_len, __func__);
+    ChildParticle *cpa_first = cpa;
+
+    for (int i = 0; i < child_len; i++, cpa++) {
+      psys_particle_on_emitter(sim->psmd,
+                               from,
+                               cpa->num,
+                               DMCACHE_ISCHILD,
+                               cpa->fuv,
+                               cpa->foffset,
+                               co,
+                               0,
+                               0,
+                               0,
+                               child_orco[i]);
+    }
+
+    BLI_kdtree_3d_find_nearest_batch(tree, child_orco, (uint)child_len, child_parent, NULL);
+
+    cpa = cpa_first;
+    for (int i = 0; i < child_len; i++, cpa++) {
+      cpa->parent = child_parent[i];
+    }
+
+    MEM_freeN(child_orco);
+    MEM_freeN(child_parent);
   }
 
   BLI_kdtree_3d_free(tree);
@@ -49,6 +49,15 @@ bool BLI_mmap_read(BLI_mmap_file *file, void *dest, size_t offset, size_t length
 
 void *BLI_mmap_get_pointer(BLI_mmap_file *file) ATTR_WARN_UNUSED_RESULT;
 
+/* Hints that the file will mostly be read from start to end, which allows the OS to read ahead
+ * more aggressively and to free the pages that have been read. */
+void BLI_mmap_advise_sequential(BLI_mmap_file *file) ATTR_NONNULL(1);
+
+/* Releases the memory of the pages in the given range, so that data which has been copied
+ * already doesn't stay in memory twice. Only pages that lie completely in the range are released,
+ * they are read from the file again when accessed later. */
+void BLI_mmap_release(BLI_mmap_file *file, size_t offset, size_t length) ATTR_NONNULL(1);
+
 void BLI_mmap_free(BLI_mmap_file *file) ATTR_NONNULL(1);
 
 #ifdef __cplusplus
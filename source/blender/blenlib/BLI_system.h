@@ -49,6 +49,12 @@ void BLI_hostname_get(char *buffer, size_t bufsize);
 size_t BLI_system_memory_max_in_megabytes(void);
 int BLI_system_memory_max_in_megabytes_int(void);
 
+/**
+ * Get the current resident set size of the process in bytes (0 when unknown).
+ * Unlike the guarded allocator statistics this includes memory-mapped files.
+ */
+size_t BLI_system_resident_memory(void);
+
 /* For `getpid`. */
 #ifdef WIN32
 #  define BLI_SYSTEM_PID_H <process.h>
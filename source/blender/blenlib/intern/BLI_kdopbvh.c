@@ -88,12 +88,13 @@ typedef struct BVHNode {
   char main_axis; /* Axis used to split this node */
 } BVHNode;
 
-/* keep under 26 bytes for speed purposes */
+/* keep small for speed purposes */
 struct BVHTree {
   BVHNode **nodes;
   BVHNode *nodearray;  /* pre-alloc branch nodes */
   BVHNode **nodechild; /* pre-alloc children for nodes */
   float *nodebv;       /* pre-alloc bounding-volumes for nodes */
+  float *nodechildbv;  /* bounding-boxes of the children of branches, see #node_children_bv */
   float epsilon;       /* Epsilon is used for inflation of the K-DOP. */
   int totleaf;         /* leafs */
   int totbranch;
@@ -103,8 +104,8 @@ struct BVHTree {
 };
 
 /* optimization, ensure we stay small */
-BLI_STATIC_ASSERT((sizeof(void *) == 8 && sizeof(BVHTree) <= 48) ||
-                      (sizeof(void *) == 4 && sizeof(BVHTree) <= 32),
+BLI_STATIC_ASSERT((sizeof(void *) == 8 && sizeof(BVHTree) <= 56) ||
+                      (sizeof(void *) == 4 && sizeof(BVHTree) <= 36),
                   "over sized")
 
 /* avoid duplicating vars in BVHOverlapData_Thread */
@@ -384,58 +385,6 @@ static void create_kdop_hull(
   }
 }
 
-/**
- * \note depends on the fact that the BVH's for each face is already built
- */
-static void refit_kdop_hull(const BVHTree *tree, BVHNode *node, int start, int end)
-{
-  float newmin, newmax;
-  float *__restrict bv = node->bv;
-  int j;
-  axis_t axis_iter;
-
-  node_minmax_init(tree, node);
-
-  for (j = start; j < end; j++) {
-    float *__restrict node_bv = tree->nodes[j]->bv;
-
-    /* for all Axes. */
-    for (axis_iter = tree->start_axis; axis_iter < tree->stop_axis; axis_iter++) {
-      newmin = node_bv[(2 * axis_iter)];
-      if ((newmin < bv[(2 * axis_iter)])) {
-        bv[(2 * axis_iter)] = newmin;
-      }
-
-      newmax = node_bv[(2 * axis_iter) + 1];
-      if ((newmax > bv[(2 * axis_iter) + 1])) {
-        bv[(2 * axis_iter) + 1] = newmax;
-      }
-    }
-  }
-}
-
-/**
- * only supports x,y,z axis in the moment
- * but we should use a plain and simple function here for speed sake */
-static char get_largest_axis(const float *bv)
-{
-  float middle_point[3];
-
-  middle_point[0] = (bv[1]) - (bv[0]); /* x axis */
-  middle_point[1] = (bv[3]) - (bv[2]); /* y axis */
-  middle_point[2] = (bv[5]) - (bv[4]); /* z axis */
-  if (middle_point[0] > middle_point[1]) {
-    if (middle_point[0] > middle_point[2]) {
-      return 1; /* max x axis */
-    }
-    return 5; /* max z axis */
-  }
-  if (middle_point[1] > middle_point[2]) {
-    return 3; /* max y axis */
-  }
-  return 5; /* max z axis */
-}
-
 /**
  * bottom-up update of bvh node BV
  * join the children on the parent BV */
@@ -466,6 +415,40 @@ static void node_join(BVHTree *tree, BVHNode *node)
   }
 }
 
+/**
+ * The X, Y and Z bounds of the children of every branch are also stored next to each other
+ * (`[6][tree_type]` values per branch), so queries can test all children of a branch at once
+ * with loops the compiler can vectorize, without loading the child nodes.
+ *
+ * Only used when the first three k-DOP axes are X, Y and Z, like queries expect.
+ */
+BLI_INLINE const float *node_children_bv(const BVHTree *tree, const BVHNode *node)
+{
+  const size_t branch_index = (size_t)(node - tree->nodearray - tree->totleaf);
+  return &tree->nodechildbv[branch_index * 6 * (size_t)tree->tree_type];
+}
+
+static void node_children_bv_update(const BVHTree *tree, const BVHNode *node)
+{
+  const int tree_type = tree->tree_type;
+  float *children_bv = (float *)node_children_bv(tree, node);
+
+  for (int i = 0; i < tree_type; i++) {
+    if (i < node->totnode) {
+      for (int j = 0; j < 6; j++) {
+        children_bv[j * tree_type + i] = node->children[i]->bv[j];
+      }
+    }
+    else {
+      /* Unused children never pass any test. */
+      for (int j = 0; j < 6; j += 2) {
+        children_bv[j * tree_type + i] = FLT_MAX;
+        children_bv[(j + 1) * tree_type + i] = -FLT_MAX;
+      }
+    }
+  }
+}
+
 #ifdef USE_PRINT_TREE
 
 /**
@@ -566,299 +549,363 @@ static void bvhtree_verify(BVHTree *tree)
 }
 #endif /* USE_VERIFY_TREE */
 
-/* Helper data and structures to build a min-leaf generalized implicit tree
- * This code can be easily reduced
- * (basically this is only method to calculate pow(k, n) in O(1).. and stuff like that) */
-typedef struct BVHBuildHelper {
-  int tree_type;
-  int totleafs;
+/** \} */
 
-  /** Min number of leafs that are achievable from a node at depth `N`. */
-  int leafs_per_child[32];
-  /** Number of nodes at depth `N (tree_type^N)`. */
-  int branches_on_level[32];
+/* -------------------------------------------------------------------- */
+/** \name SAH Build
+ *
+ * The tree is built top-down, splitting the leafs of every branch using the surface area
+ * heuristic (SAH), evaluated over a fixed number of bins along the axis with the largest extent
+ * of the leaf centers.
+ *
+ * Branches with more than two children are built by splitting the child with the largest
+ * surface area in two until there are `tree_type` children, so children are ordered along the
+ * first split axis (stored as #BVHNode.main_axis).
+ *
+ * Branches are built one depth level at a time, since all branches of a level only depend
+ * on their parents, which allows to use multi-threading.
+ * Branches are stored in breadth first order, so all the children of a branch have an index
+ * greater than their parent and the branches of a level are sequential in memory.
+ *
+ * \{ */
+
+#define BVH_SAH_BINS 16
 
-  /** Number of leafs that are placed on the level that is not 100% filled */
-  int remain_leafs;
+typedef struct BVHBuildBin {
+  float bounds[6];
+  int count;
+} BVHBuildBin;
 
-} BVHBuildHelper;
+/* Ranges of the leafs array split in the children of a branch. */
+typedef struct BVHBuildBranch {
+  int leafs_begin, leafs_end;
+  int totnode;
+  char main_axis;
+} BVHBuildBranch;
 
-static void build_implicit_tree_helper(const BVHTree *tree, BVHBuildHelper *data)
+typedef struct BVHBuildData {
+  const BVHTree *tree;
+  BVHNode **leafs_array;
+  BVHBuildBranch *branches;
+  /** `tree_type + 1` child leaf positions per branch, child `N` uses the leafs
+   * `[nth[N], nth[N + 1])`. */
+  int *branches_nth;
+} BVHBuildData;
+
+/* This functions returns the number of branches needed to have the requested number of leafs,
+ * when all branches use all their children. */
+static int implicit_needed_branches(int tree_type, int leafs)
 {
-  int depth = 0;
-  int remain;
-  int nnodes;
+  return max_ii(1, (leafs + tree_type - 3) / (tree_type - 1));
+}
 
-  data->totleafs = tree->totleaf;
-  data->tree_type = tree->tree_type;
+BLI_INLINE float bvh_build_leaf_center(const BVHNode *node, const int bv_axis)
+{
+  return node->bv[bv_axis] + node->bv[bv_axis + 1];
+}
 
-  /* Calculate the smallest tree_type^n such that tree_type^n >= num_leafs */
-  for (data->leafs_per_child[0] = 1; data->leafs_per_child[0] < data->totleafs;
-       data->leafs_per_child[0] *= data->tree_type) {
-    /* pass */
+BLI_INLINE void bvh_build_bounds_init(float bounds[6])
+{
+  for (int i = 0; i < 6; i += 2) {
+    bounds[i] = FLT_MAX;
+    bounds[i + 1] = -FLT_MAX;
   }
+}
 
-  data->branches_on_level[0] = 1;
-
-  for (depth = 1; (depth < 32) && data->leafs_per_child[depth - 1]; depth++) {
-    data->branches_on_level[depth] = data->branches_on_level[depth - 1] * data->tree_type;
-    data->leafs_per_child[depth] = data->leafs_per_child[depth - 1] / data->tree_type;
+BLI_INLINE void bvh_build_bounds_merge(float bounds[6], const float bounds_other[6])
+{
+  for (int i = 0; i < 6; i += 2) {
+    bounds[i] = min_ff(bounds[i], bounds_other[i]);
+    bounds[i + 1] = max_ff(bounds[i + 1], bounds_other[i + 1]);
   }
-
-  remain = data->totleafs - data->leafs_per_child[1];
-  nnodes = (remain + data->tree_type - 2) / (data->tree_type - 1);
-  data->remain_leafs = remain + nnodes;
 }
 
-/**
- * Return the min index of all the leafs achievable with the given branch.
- */
-static int implicit_leafs_index(const BVHBuildHelper *data, const int depth, const int child_index)
+BLI_INLINE float bvh_build_bounds_area(const float bounds[6])
 {
-  int min_leaf_index = child_index * data->leafs_per_child[depth - 1];
-  if (min_leaf_index <= data->remain_leafs) {
-    return min_leaf_index;
+  if (bounds[0] > bounds[1]) {
+    return 0.0f;
   }
-  if (data->leafs_per_child[depth]) {
-    return data->totleafs -
-           (data->branches_on_level[depth - 1] - child_index) * data->leafs_per_child[depth];
-  }
-  return data->remain_leafs;
+  const float x = bounds[1] - bounds[0];
+  const float y = bounds[3] - bounds[2];
+  const float z = bounds[5] - bounds[4];
+  return x * y + y * z + z * x;
 }
 
-/**
- * Generalized implicit tree build
- *
- * An implicit tree is a tree where its structure is implied,
- * thus there is no need to store child pointers or indexes.
- * It's possible to find the position of the child or the parent with simple maths
- * (multiplication and addition).
- * This type of tree is for example used on heaps..
- * where node N has its child at indices N*2 and N*2+1.
- *
- * Although in this case the tree type is general.. and not know until run-time.
- * tree_type stands for the maximum number of children that a tree node can have.
- * All tree types >= 2 are supported.
- *
- * Advantages of the used trees include:
- * - No need to store child/parent relations (they are implicit);
- * - Any node child always has an index greater than the parent;
- * - Brother nodes are sequential in memory;
- * Some math relations derived for general implicit trees:
- *
- *   K = tree_type, ( 2 <= K )
- *   ROOT = 1
- *   N child of node A = A * K + (2 - K) + N, (0 <= N < K)
- *
- * Util methods:
- *   TODO...
- *    (looping elements, knowing if its a leaf or not.. etc...)
- */
-
-/* This functions returns the number of branches needed to have the requested number of leafs. */
-static int implicit_needed_branches(int tree_type, int leafs)
+BLI_INLINE int bvh_build_bin_index(const float center, const float center_min, const float scale)
 {
-  return max_ii(1, (leafs + tree_type - 3) / (tree_type - 1));
+  const int bin = (int)((center - center_min) * scale);
+  return CLAMPIS(bin, 0, BVH_SAH_BINS - 1);
 }
 
 /**
- * This function handles the problem of "sorting" the leafs (along the split_axis).
- *
- * It arranges the elements in the given partitions such that:
- * - any element in partition N is less or equal to any element in partition N+1.
- * - if all elements are different all partition will get the same subset of elements
- *   as if the array was sorted.
- *
- * partition P is described as the elements in the range ( nth[P], nth[P+1] ]
+ * Split the leafs in the range `[begin, end)` (with at least two leafs) in two non-empty ranges,
+ * `[begin, mid)` and `[mid, end)`, returning `mid`.
  *
- * TODO: This can be optimized a bit by doing a specialized nth_element instead of K nth_elements
+ * \param r_axis: The axis (0-2) along which the leafs were split, relative to
+ * #BVHTree.start_axis.
+ * \param r_area: The surface area of both ranges, used to choose the next range to split.
  */
-static void split_leafs(BVHNode **leafs_array,
-                        const int nth[],
-                        const int partitions,
-                        const int split_axis)
-{
-  int i;
-  for (i = 0; i < partitions - 1; i++) {
-    if (nth[i] >= nth[partitions]) {
-      break;
+static int bvh_build_split(const BVHTree *tree,
+                           BVHNode **leafs_array,
+                           const int begin,
+                           const int end,
+                           char *r_axis,
+                           float r_area[2])
+{
+  /* Use the first three axes of the k-DOP. These are X, Y and Z for all trees besides 18-DOP,
+   * which starts at #bvhtree_kdop_axes index 7 and uses the diagonals (1, 1, 0), (1, 0, 1) and
+   * (0, 1, 1) instead. The areas computed from them are then no real surface areas, but they
+   * are only compared with each other so they still work as split cost. */
+  const int bv_offset = 2 * tree->start_axis;
+  float center_min[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+  float center_max[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+  for (int i = begin; i < end; i++) {
+    for (int axis = 0; axis < 3; axis++) {
+      const float center = bvh_build_leaf_center(leafs_array[i], bv_offset + 2 * axis);
+      center_min[axis] = min_ff(center_min[axis], center);
+      center_max[axis] = max_ff(center_max[axis], center);
+    }
+  }
+
+  int axis = 0;
+  for (int i = 1; i < 3; i++) {
+    if (center_max[i] - center_min[i] > center_max[axis] - center_min[axis]) {
+      axis = i;
+    }
+  }
+  *r_axis = (char)axis;
+  const int bv_axis = bv_offset + 2 * axis;
+  const float extent = center_max[axis] - center_min[axis];
+  const float scale = (extent > 0.0f) ? (float)BVH_SAH_BINS / extent : 0.0f;
+
+  int mid;
+  if (!(scale > 0.0f && scale < FLT_MAX)) {
+    /* All leafs share the same center, split them in two halves. */
+    mid = (begin + end) / 2;
+    partition_nth_element(leafs_array, begin, end, mid, bv_axis);
+  }
+  else {
+    BVHBuildBin bins[BVH_SAH_BINS];
+    for (int i = 0; i < BVH_SAH_BINS; i++) {
+      bvh_build_bounds_init(bins[i].bounds);
+      bins[i].count = 0;
     }
 
-    partition_nth_element(leafs_array, nth[i], nth[partitions], nth[i + 1], split_axis);
-  }
-}
+    for (int i = begin; i < end; i++) {
+      const BVHNode *node = leafs_array[i];
+      BVHBuildBin *bin = &bins[bvh_build_bin_index(
+          bvh_build_leaf_center(node, bv_axis), center_min[axis], scale)];
+      bvh_build_bounds_merge(bin->bounds, &node->bv[bv_offset]);
+      bin->count++;
+    }
 
-typedef struct BVHDivNodesData {
-  const BVHTree *tree;
-  BVHNode *branches_array;
-  BVHNode **leafs_array;
+    /* Sweep from the right to accumulate the cost of the right side of every split. */
+    float right_cost[BVH_SAH_BINS];
+    {
+      float bounds[6];
+      bvh_build_bounds_init(bounds);
+      int count = 0;
+      for (int i = BVH_SAH_BINS - 1; i > 0; i--) {
+        bvh_build_bounds_merge(bounds, bins[i].bounds);
+        count += bins[i].count;
+        right_cost[i] = bvh_build_bounds_area(bounds) * (float)count;
+      }
+    }
 
-  int tree_type;
-  int tree_offset;
+    /* Sweep from the left, leafs in bins up to `split_bin` go to the left side. */
+    int split_bin = -1;
+    {
+      float bounds[6];
+      bvh_build_bounds_init(bounds);
+      int count = 0;
+      float cost_best = FLT_MAX;
+      for (int i = 0; i < BVH_SAH_BINS - 1; i++) {
+        bvh_build_bounds_merge(bounds, bins[i].bounds);
+        count += bins[i].count;
+        if (count == 0 || count == end - begin) {
+          continue;
+        }
+        const float cost = bvh_build_bounds_area(bounds) * (float)count + right_cost[i + 1];
+        if (cost < cost_best) {
+          cost_best = cost;
+          split_bin = i;
+        }
+      }
+    }
 
-  const BVHBuildHelper *data;
+    if (split_bin == -1) {
+      /* All leafs fell in a single bin, only possible with float precision issues. */
+      mid = (begin + end) / 2;
+      partition_nth_element(leafs_array, begin, end, mid, bv_axis);
+    }
+    else {
+      int i = begin, j = end - 1;
+      while (true) {
+        while (i <= j && bvh_build_bin_index(bvh_build_leaf_center(leafs_array[i], bv_axis),
+                                             center_min[axis],
+                                             scale) <= split_bin) {
+          i++;
+        }
+        while (i <= j && bvh_build_bin_index(bvh_build_leaf_center(leafs_array[j], bv_axis),
+                                             center_min[axis],
+                                             scale) > split_bin) {
+          j--;
+        }
+        if (i >= j) {
+          break;
+        }
+        SWAP(BVHNode *, leafs_array[i], leafs_array[j]);
+        i++;
+        j--;
+      }
+      mid = i;
+    }
+  }
 
-  int depth;
-  int i;
-  int first_of_next_level;
-} BVHDivNodesData;
+  BLI_assert(mid > begin && mid < end);
 
-static void non_recursive_bvh_div_nodes_task_cb(void *__restrict userdata,
-                                                const int j,
-                                                const TaskParallelTLS *__restrict UNUSED(tls))
+  for (int side = 0; side < 2; side++) {
+    float bounds[6];
+    bvh_build_bounds_init(bounds);
+    for (int i = side ? mid : begin; i < (side ? end : mid); i++) {
+      bvh_build_bounds_merge(bounds, &leafs_array[i]->bv[bv_offset]);
+    }
+    r_area[side] = bvh_build_bounds_area(bounds);
+  }
+
+  return mid;
+}
+
+static void bvh_build_branch_task_cb(void *__restrict userdata,
+                                     const int branch_index,
+                                     const TaskParallelTLS *__restrict UNUSED(tls))
 {
-  BVHDivNodesData *data = userdata;
+  const BVHBuildData *data = userdata;
+  const int tree_type = data->tree->tree_type;
+  BVHBuildBranch *branch = &data->branches[branch_index];
+  int *nth = &data->branches_nth[branch_index * (tree_type + 1)];
+  float area[MAX_TREETYPE];
 
-  int k;
-  const int parent_level_index = j - data->i;
-  BVHNode *parent = &data->branches_array[j];
-  int nth_positions[MAX_TREETYPE + 1];
-  char split_axis;
-
-  int parent_leafs_begin = implicit_leafs_index(data->data, data->depth, parent_level_index);
-  int parent_leafs_end = implicit_leafs_index(data->data, data->depth, parent_level_index + 1);
-
-  /* This calculates the bounding box of this branch
-   * and chooses the largest axis as the axis to divide leafs */
-  refit_kdop_hull(data->tree, parent, parent_leafs_begin, parent_leafs_end);
-  split_axis = get_largest_axis(parent->bv);
-
-  /* Save split axis (this can be used on ray-tracing to speedup the query time) */
-  parent->main_axis = split_axis / 2;
-
-  /* Split the children along the split_axis, note: its not needed to sort the whole leafs array
-   * Only to assure that the elements are partitioned on a way that each child takes the elements
-   * it would take in case the whole array was sorted.
-   * Split_leafs takes care of that "sort" problem. */
-  nth_positions[0] = parent_leafs_begin;
-  nth_positions[data->tree_type] = parent_leafs_end;
-  for (k = 1; k < data->tree_type; k++) {
-    const int child_index = j * data->tree_type + data->tree_offset + k;
-    /* child level index */
-    const int child_level_index = child_index - data->first_of_next_level;
-    nth_positions[k] = implicit_leafs_index(data->data, data->depth + 1, child_level_index);
-  }
-
-  split_leafs(data->leafs_array, nth_positions, data->tree_type, split_axis);
-
-  /* Setup children and totnode counters
-   * Not really needed but currently most of BVH code
-   * relies on having an explicit children structure */
-  for (k = 0; k < data->tree_type; k++) {
-    const int child_index = j * data->tree_type + data->tree_offset + k;
-    /* child level index */
-    const int child_level_index = child_index - data->first_of_next_level;
-
-    const int child_leafs_begin = implicit_leafs_index(
-        data->data, data->depth + 1, child_level_index);
-    const int child_leafs_end = implicit_leafs_index(
-        data->data, data->depth + 1, child_level_index + 1);
-
-    if (child_leafs_end - child_leafs_begin > 1) {
-      parent->children[k] = &data->branches_array[child_index];
-      parent->children[k]->parent = parent;
-    }
-    else if (child_leafs_end - child_leafs_begin == 1) {
-      parent->children[k] = data->leafs_array[child_leafs_begin];
-      parent->children[k]->parent = parent;
+  nth[0] = branch->leafs_begin;
+  nth[1] = branch->leafs_end;
+  area[0] = FLT_MAX;
+  branch->totnode = (branch->leafs_end > branch->leafs_begin) ? 1 : 0;
+  branch->main_axis = 0;
+
+  while (branch->totnode < tree_type) {
+    /* Split the child with the largest surface area. */
+    int child = -1;
+    for (int i = 0; i < branch->totnode; i++) {
+      if ((nth[i + 1] - nth[i] > 1) && (child == -1 || area[i] > area[child])) {
+        child = i;
+      }
     }
-    else {
+    if (child == -1) {
       break;
     }
+
+    char axis;
+    float split_area[2];
+    const int mid = bvh_build_split(
+        data->tree, data->leafs_array, nth[child], nth[child + 1], &axis, split_area);
+    if (branch->totnode == 1) {
+      branch->main_axis = axis;
+    }
+
+    for (int i = branch->totnode; i > child; i--) {
+      nth[i + 1] = nth[i];
+      area[i] = area[i - 1];
+    }
+    nth[child + 1] = mid;
+    area[child] = split_area[0];
+    area[child + 1] = split_area[1];
+    branch->totnode++;
   }
-  parent->totnode = (char)k;
 }
 
 /**
- * This functions builds an optimal implicit tree from the given leafs.
- * Where optimal stands for:
- * - The resulting tree will have the smallest number of branches;
- * - At most only one branch will have NULL children;
- * - All leafs will be stored at level N or N+1.
- *
- * This function creates an implicit tree on branches_array,
- * the leafs are given on the leafs_array.
- *
- * The tree is built per depth levels. First branches at depth 1.. then branches at depth 2.. etc..
- * The reason is that we can build level N+1 from level N without any data dependencies..
- * thus it allows to use multi-thread building.
- *
- * To archive this is necessary to find how much leafs are accessible from a certain branch,
- * #BVHBuildHelper, #implicit_needed_branches and #implicit_leafs_index
- * are auxiliary functions to solve that "optimal-split".
+ * Build the branches of the tree, returning the number of branches.
+ * Only the order of the leafs array is modified, the branches are written in `r_branches`.
  */
-static void non_recursive_bvh_div_nodes(const BVHTree *tree,
-                                        BVHNode *branches_array,
-                                        BVHNode **leafs_array,
-                                        int num_leafs)
+static int bvh_build_branches(const BVHTree *tree,
+                              BVHNode **leafs_array,
+                              const int num_leafs,
+                              BVHBuildBranch *r_branches,
+                              int *r_branches_nth)
 {
-  int i;
-
   const int tree_type = tree->tree_type;
-  /* this value is 0 (on binary trees) and negative on the others */
-  const int tree_offset = 2 - tree->tree_type;
 
-  const int num_branches = implicit_needed_branches(tree_type, num_leafs);
-
-  BVHBuildHelper data;
-  int depth;
+  BVHBuildData data = {
+      .tree = tree,
+      .leafs_array = leafs_array,
+      .branches = r_branches,
+      .branches_nth = r_branches_nth,
+  };
 
-  {
-    /* set parent from root node to NULL */
-    BVHNode *root = &branches_array[1];
-    root->parent = NULL;
+  r_branches[0].leafs_begin = 0;
+  r_branches[0].leafs_end = num_leafs;
+  int num_branches = 1;
 
-    /* Most of bvhtree code relies on 1-leaf trees having at least one branch
-     * We handle that special case here */
-    if (num_leafs == 1) {
-      refit_kdop_hull(tree, root, 0, num_leafs);
-      root->main_axis = get_largest_axis(root->bv) / 2;
-      root->totnode = 1;
-      root->children[0] = leafs_array[0];
-      root->children[0]->parent = root;
-      return;
+  /* Loop tree levels. */
+  for (int level_begin = 0, level_end = 1; level_begin != level_end;) {
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.use_threading = (num_leafs > KDOPBVH_THREAD_LEAF_THRESHOLD);
+    settings.min_iter_per_thread = 1;
+    BLI_task_parallel_range(level_begin, level_end, &data, bvh_build_branch_task_cb, &settings);
+
+    /* Children with more than a single leaf are the branches of the next level. */
+    for (int i = level_begin; i < level_end; i++) {
+      const int *nth = &r_branches_nth[i * (tree_type + 1)];
+      for (int k = 0; k < r_branches[i].totnode; k++) {
+        if (nth[k + 1] - nth[k] > 1) {
+          r_branches[num_branches].leafs_begin = nth[k];
+          r_branches[num_branches].leafs_end = nth[k + 1];
+          num_branches++;
+        }
+      }
     }
+    level_begin = level_end;
+    level_end = num_branches;
   }
 
-  build_implicit_tree_helper(tree, &data);
+  return num_branches;
+}
 
-  BVHDivNodesData cb_data = {
-      .tree = tree,
-      .branches_array = branches_array,
-      .leafs_array = leafs_array,
-      .tree_type = tree_type,
-      .tree_offset = tree_offset,
-      .data = &data,
-      .first_of_next_level = 0,
-      .depth = 0,
-      .i = 0,
-  };
+/**
+ * Ensure the node arrays can store `totbranch` branches after the leafs.
+ * The initial allocation assumes all branches use all their children,
+ * which isn't the case of SAH splits.
+ */
+static void bvhtree_nodes_ensure(BVHTree *tree, const int totbranch)
+{
+  const int numnodes_prev = (int)(MEM_allocN_len(tree->nodearray) / sizeof(*tree->nodearray));
+  const int numnodes = tree->totleaf + totbranch + tree->tree_type;
+  if (numnodes <= numnodes_prev) {
+    return;
+  }
 
-  /* Loop tree levels (log N) loops */
-  for (i = 1, depth = 1; i <= num_branches; i = i * tree_type + tree_offset, depth++) {
-    const int first_of_next_level = i * tree_type + tree_offset;
-    /* index of last branch on this level */
-    const int i_stop = min_ii(first_of_next_level, num_branches + 1);
+  /* Leafs are referenced by their position in the node array. */
+  int *leafs_index = MEM_mallocN(sizeof(*leafs_index) * (size_t)tree->totleaf, __func__);
+  for (int i = 0; i < tree->totleaf; i++) {
+    leafs_index[i] = (int)(tree->nodes[i] - tree->nodearray);
+  }
 
-    /* Loop all branches on this level */
-    cb_data.first_of_next_level = first_of_next_level;
-    cb_data.i = i;
-    cb_data.depth = depth;
+  tree->nodes = MEM_recallocN(tree->nodes, sizeof(*tree->nodes) * (size_t)numnodes);
+  tree->nodearray = MEM_recallocN(tree->nodearray, sizeof(*tree->nodearray) * (size_t)numnodes);
+  tree->nodebv = MEM_recallocN(tree->nodebv, sizeof(float) * (size_t)(tree->axis * numnodes));
+  tree->nodechild = MEM_recallocN(tree->nodechild,
+                                  sizeof(BVHNode *) * (size_t)(tree->tree_type * numnodes));
 
-    if (true) {
-      TaskParallelSettings settings;
-      BLI_parallel_range_settings_defaults(&settings);
-      settings.use_threading = (num_leafs > KDOPBVH_THREAD_LEAF_THRESHOLD);
-      BLI_task_parallel_range(i, i_stop, &cb_data, non_recursive_bvh_div_nodes_task_cb, &settings);
-    }
-    else {
-      /* Less hassle for debugging. */
-      TaskParallelTLS tls = {0};
-      for (int i_task = i; i_task < i_stop; i_task++) {
-        non_recursive_bvh_div_nodes_task_cb(&cb_data, i_task, &tls);
-      }
-    }
+  for (int i = 0; i < numnodes; i++) {
+    tree->nodearray[i].bv = &tree->nodebv[i * tree->axis];
+    tree->nodearray[i].children = &tree->nodechild[i * tree->tree_type];
+  }
+  for (int i = 0; i < tree->totleaf; i++) {
+    tree->nodes[i] = &tree->nodearray[leafs_index[i]];
   }
+  MEM_freeN(leafs_index);
 }
 
 /** \} */
@@ -949,29 +996,69 @@ void BLI_bvhtree_free(BVHTree *tree)
     MEM_SAFE_FREE(tree->nodearray);
     MEM_SAFE_FREE(tree->nodebv);
     MEM_SAFE_FREE(tree->nodechild);
+    MEM_SAFE_FREE(tree->nodechildbv);
     MEM_freeN(tree);
   }
 }
 
 void BLI_bvhtree_balance(BVHTree *tree)
 {
-  BVHNode **leafs_array = tree->nodes;
+  const int tree_type = tree->tree_type;
 
   /* This function should only be called once
    * (some big bug goes here if its being called more than once per tree) */
   BLI_assert(tree->totbranch == 0);
 
-  /* Build the implicit tree */
-  non_recursive_bvh_div_nodes(
-      tree, tree->nodearray + (tree->totleaf - 1), leafs_array, tree->totleaf);
+  /* Every branch splits its leafs at least in two, so there are less branches than leafs. */
+  const int branches_len_max = max_ii(1, tree->totleaf - 1);
+  BVHBuildBranch *branches = MEM_mallocN(sizeof(*branches) * (size_t)branches_len_max, __func__);
+  int *branches_nth = MEM_mallocN(
+      sizeof(*branches_nth) * (size_t)((tree_type + 1) * branches_len_max), __func__);
+
+  const int totbranch = bvh_build_branches(
+      tree, tree->nodes, tree->totleaf, branches, branches_nth);
+  bvhtree_nodes_ensure(tree, totbranch);
+
+  /* Link the branches, stored after the leafs in the nodes array. */
+  BVHNode **leafs_array = tree->nodes;
+  BVHNode *branches_array = tree->nodearray + tree->totleaf;
+  int child_branch = 1;
+  for (int i = 0; i < totbranch; i++) {
+    BVHNode *node = &branches_array[i];
+    const int *nth = &branches_nth[i * (tree_type + 1)];
+    int k;
+    for (k = 0; k < branches[i].totnode; k++) {
+      node->children[k] = (nth[k + 1] - nth[k] > 1) ? &branches_array[child_branch++] :
+                                                       leafs_array[nth[k]];
+      node->children[k]->parent = node;
+    }
+    for (; k < tree_type; k++) {
+      node->children[k] = NULL;
+    }
+    node->totnode = (char)branches[i].totnode;
+    node->main_axis = branches[i].main_axis;
+  }
+  BLI_assert(child_branch == totbranch);
+  branches_array[0].parent = NULL;
+
+  MEM_freeN(branches);
+  MEM_freeN(branches_nth);
 
   /* current code expects the branches to be linked to the nodes array
    * we perform that linkage here */
-  tree->totbranch = implicit_needed_branches(tree->tree_type, tree->totleaf);
+  tree->totbranch = totbranch;
   for (int i = 0; i < tree->totbranch; i++) {
-    tree->nodes[tree->totleaf + i] = &tree->nodearray[tree->totleaf + i];
+    tree->nodes[tree->totleaf + i] = &branches_array[i];
+  }
+
+  if (tree->start_axis == 0) {
+    tree->nodechildbv = MEM_mallocN(
+        sizeof(float[6]) * (size_t)(tree_type * tree->totbranch), "BVHNodeChildBV");
   }
 
+  /* Children always have a greater index than their parent. */
+  BLI_bvhtree_update_tree(tree);
+
 #ifdef USE_SKIP_LINKS
   build_skip_links(tree, tree->nodes[tree->totleaf], NULL, NULL);
 #endif
@@ -1052,6 +1139,9 @@ void BLI_bvhtree_update_tree(BVHTree *tree)
 
   for (; index >= root; index--) {
     node_join(tree, *index);
+    if (tree->nodechildbv) {
+      node_children_bv_update(tree, *index);
+    }
   }
 }
 /**
@@ -1508,6 +1598,28 @@ static float calc_nearest_point_squared(const float proj[3], BVHNode *node, floa
   return len_squared_v3v3(proj, nearest);
 }
 
+/* Same as #calc_nearest_point_squared for all the children of a branch. */
+static void calc_nearest_children_squared(const BVHTree *tree,
+                                          const float proj[3],
+                                          const BVHNode *node,
+                                          float r_dist_sq[MAX_TREETYPE])
+{
+  const int tree_type = tree->tree_type;
+  const float *bv = node_children_bv(tree, node);
+
+  for (int i = 0; i < tree_type; i++) {
+    r_dist_sq[i] = 0.0f;
+  }
+  for (int axis = 0; axis != 3; axis++, bv += 2 * tree_type) {
+    for (int i = 0; i < tree_type; i++) {
+      float val = proj[axis];
+      val = (bv[i] > val) ? bv[i] : val;
+      val = (bv[tree_type + i] < val) ? bv[tree_type + i] : val;
+      r_dist_sq[i] += (proj[axis] - val) * (proj[axis] - val);
+    }
+  }
+}
+
 /* Depth first search method */
 static void dfs_find_nearest_dfs(BVHNearestData *data, BVHNode *node)
 {
@@ -1520,6 +1632,22 @@ static void dfs_find_nearest_dfs(BVHNearestData *data, BVHNode *node)
       data->nearest.dist_sq = calc_nearest_point_squared(data->proj, node, data->nearest.co);
     }
   }
+  else if (data->tree->nodechildbv) {
+    float dist_sq[MAX_TREETYPE];
+    calc_nearest_children_squared(data->tree, data->proj, node, dist_sq);
+
+    /* Same heuristic as below. */
+    const bool forward = data->proj[node->main_axis] <=
+                         node_children_bv(data->tree, node)[(node->main_axis * 2 + 1) *
+                                                            data->tree->tree_type];
+    for (int j = 0; j != node->totnode; j++) {
+      const int i = forward ? j : node->totnode - 1 - j;
+      if (dist_sq[i] >= data->nearest.dist_sq) {
+        continue;
+      }
+      dfs_find_nearest_dfs(data, node->children[i]);
+    }
+  }
   else {
     /* Better heuristic to pick the closest node to dive on */
     int i;
@@ -1569,6 +1697,16 @@ static void heap_find_nearest_inner(BVHNearestData *data, HeapSimple *heap, BVHN
       data->nearest.dist_sq = calc_nearest_point_squared(data->proj, node, data->nearest.co);
     }
   }
+  else if (data->tree->nodechildbv) {
+    float dist_sq[MAX_TREETYPE];
+    calc_nearest_children_squared(data->tree, data->proj, node, dist_sq);
+
+    for (int i = 0; i != node->totnode; i++) {
+      if (dist_sq[i] < data->nearest.dist_sq) {
+        BLI_heapsimple_insert(heap, dist_sq[i], node->children[i]);
+      }
+    }
+  }
   else {
     float nearest[3];
 
@@ -1825,6 +1963,83 @@ static float fast_ray_nearest_hit(const BVHRayCastData *data, const BVHNode *nod
   return max_fff(t1x, t1y, t1z);
 }
 
+/**
+ * Same as #fast_ray_nearest_hit for all the children of a branch.
+ */
+static void fast_ray_nearest_hit_children(const BVHRayCastData *data,
+                                          const BVHNode *node,
+                                          float r_dist[MAX_TREETYPE])
+{
+  const int tree_type = data->tree->tree_type;
+  const float *children_bv = node_children_bv(data->tree, node);
+  const float *bv[6];
+  for (int i = 0; i < 6; i++) {
+    bv[i] = &children_bv[data->index[i] * tree_type];
+  }
+
+  for (int i = 0; i < tree_type; i++) {
+    const float t1x = (bv[0][i] - data->ray.origin[0]) * data->idot_axis[0];
+    const float t2x = (bv[1][i] - data->ray.origin[0]) * data->idot_axis[0];
+    const float t1y = (bv[2][i] - data->ray.origin[1]) * data->idot_axis[1];
+    const float t2y = (bv[3][i] - data->ray.origin[1]) * data->idot_axis[1];
+    const float t1z = (bv[4][i] - data->ray.origin[2]) * data->idot_axis[2];
+    const float t2z = (bv[5][i] - data->ray.origin[2]) * data->idot_axis[2];
+    const float t_near = max_fff(t1x, t1y, t1z);
+    const float t_far = min_fff(t2x, t2y, t2z);
+    r_dist[i] = (t_near <= t_far && t_far >= 0.0f && t_near <= data->hit.dist) ? t_near :
+                                                                                 FLT_MAX;
+  }
+}
+
+static void dfs_raycast_leaf(BVHRayCastData *data, const BVHNode *node, const float dist)
+{
+  if (data->callback) {
+    data->callback(data->userdata, node->index, &data->ray, &data->hit);
+  }
+  else {
+    data->hit.index = node->index;
+    data->hit.dist = dist;
+    madd_v3_v3v3fl(data->hit.co, data->ray.origin, data->ray.direction, dist);
+  }
+}
+
+/**
+ * A version of #dfs_raycast testing all children of a branch at once, then visiting them
+ * from the nearest to the farthest, so the closest hit is found early and more branches skipped.
+ */
+static void dfs_raycast_children(BVHRayCastData *data, const BVHNode *node)
+{
+  float dist[MAX_TREETYPE];
+  int order[MAX_TREETYPE];
+  int order_len = 0;
+
+  fast_ray_nearest_hit_children(data, node, dist);
+
+  for (int i = 0; i < node->totnode; i++) {
+    if (dist[i] < data->hit.dist) {
+      /* Insertion sort, there are only a few children. */
+      int j;
+      for (j = order_len++; j > 0 && dist[order[j - 1]] > dist[i]; j--) {
+        order[j] = order[j - 1];
+      }
+      order[j] = i;
+    }
+  }
+
+  for (int i = 0; i < order_len; i++) {
+    const BVHNode *child = node->children[order[i]];
+    if (dist[order[i]] >= data->hit.dist) {
+      continue;
+    }
+    if (child->totnode == 0) {
+      dfs_raycast_leaf(data, child, dist[order[i]]);
+    }
+    else {
+      dfs_raycast_children(data, child);
+    }
+  }
+}
+
 static void dfs_raycast(BVHRayCastData *data, BVHNode *node)
 {
   int i;
@@ -1839,14 +2054,10 @@ static void dfs_raycast(BVHRayCastData *data, BVHNode *node)
   }
 
   if (node->totnode == 0) {
-    if (data->callback) {
-      data->callback(data->userdata, node->index, &data->ray, &data->hit);
-    }
-    else {
-      data->hit.index = node->index;
-      data->hit.dist = dist;
-      madd_v3_v3v3fl(data->hit.co, data->ray.origin, data->ray.direction, dist);
-    }
+    dfs_raycast_leaf(data, node, dist);
+  }
+  else if (data->ray.radius == 0.0f && data->tree->nodechildbv) {
+    dfs_raycast_children(data, node);
   }
   else {
     /* pick loop direction to dive into the tree (based on ray direction and split axis) */
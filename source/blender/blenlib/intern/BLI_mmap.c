@@ -223,6 +223,38 @@ void *BLI_mmap_get_pointer(BLI_mmap_file *file)
   return file->memory;
 }
 
+void BLI_mmap_advise_sequential(BLI_mmap_file *file)
+{
+#ifndef WIN32
+  madvise(file->memory, file->length, MADV_SEQUENTIAL);
+#else
+  UNUSED_VARS(file);
+#endif
+}
+
+void BLI_mmap_release(BLI_mmap_file *file, size_t offset, size_t length)
+{
+#ifndef WIN32
+  if (file->io_error || (offset + length > file->length)) {
+    return;
+  }
+
+  /* Round inwards to whole pages, the pages at the ends may contain data that is still needed. */
+  const size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+  const size_t begin = (offset + page_size - 1) / page_size * page_size;
+  const size_t end = (offset + length) / page_size * page_size;
+  if (begin >= end) {
+    return;
+  }
+  /* The mapping is private and read-only, so the pages are simply dropped and mapped from the
+   * file again when they are accessed. */
+  madvise(file->memory + begin, end - begin, MADV_DONTNEED);
+#else
+  /* Unmodified pages of the view are trimmed from the working set by the OS as needed. */
+  UNUSED_VARS(file, offset, length);
+#endif
+}
+
 void BLI_mmap_free(BLI_mmap_file *file)
 {
 #ifndef WIN32
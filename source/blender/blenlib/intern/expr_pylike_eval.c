@@ -29,14 +29,17 @@
  *  - Literals:
  *      floating point and decimal integer.
  *  - Constants:
- *      pi, True, False
+ *      pi, e, tau, True, False
  *  - Operators:
- *      +, -, *, /, ==, !=, <, <=, >, >=, and, or, not, ternary if
+ *      +, -, *, /, //, %, **, ==, !=, <, <=, >, >=, and, or, not, ternary if
  *  - Functions:
  *      min, max, radians, degrees,
- *      abs, fabs, floor, ceil, trunc, int,
+ *      abs, fabs, floor, ceil, trunc, round, int, float, bool,
  *      sin, cos, tan, asin, acos, atan, atan2,
- *      exp, log, sqrt, pow, fmod
+ *      sinh, cosh, tanh, asinh, acosh, atanh,
+ *      exp, log, log2, log10, sqrt, pow, fmod, hypot, copysign,
+ *      clamp, lerp, smoothstep
+ *  - Functions and constants of the math module can also be accessed as math.name.
  *
  * The implementation has no global state and can be used multi-threaded.
  */
@@ -325,6 +328,53 @@ static double op_sub(double a, double b)
   return a - b;
 }
 
+/* Python float floor division, see float_floor_div in floatobject.c. */
+static double op_floordiv(double a, double b)
+{
+  if (b == 0.0) {
+    /* Python raises ZeroDivisionError, even for a zero or NaN dividend. */
+    feraiseexcept(FE_DIVBYZERO);
+    return 0.0;
+  }
+
+  const double mod = fmod(a, b);
+  double div = (a - mod) / b;
+
+  if (mod && ((b < 0) != (mod < 0))) {
+    div -= 1.0;
+  }
+
+  if (div) {
+    const double floordiv = floor(div);
+    return (div - floordiv > 0.5) ? floordiv + 1.0 : floordiv;
+  }
+
+  return copysign(0.0, a / b);
+}
+
+/* Python float modulo, the result has the sign of the divisor. */
+static double op_mod(double a, double b)
+{
+  if (b == 0.0) {
+    /* Same as in #op_floordiv, instead of the invalid operation from fmod. */
+    feraiseexcept(FE_DIVBYZERO);
+    return 0.0;
+  }
+
+  double mod = fmod(a, b);
+
+  if (mod) {
+    if ((b < 0) != (mod < 0)) {
+      mod += b;
+    }
+  }
+  else {
+    mod = copysign(0.0, b);
+  }
+
+  return mod;
+}
+
 static double op_radians(double arg)
 {
   return arg * M_PI / 180.0;
@@ -340,6 +390,16 @@ static double op_log2(double a, double b)
   return log(a) / log(b);
 }
 
+static double op_float(double arg)
+{
+  return arg;
+}
+
+static double op_bool(double arg)
+{
+  return arg ? 1.0 : 0.0;
+}
+
 static double op_lerp(double a, double b, double x)
 {
   return a * (1.0 - x) + b * x;
@@ -405,7 +465,13 @@ typedef struct BuiltinConstDef {
 } BuiltinConstDef;
 
 static BuiltinConstDef builtin_consts[] = {
-    {"pi", M_PI}, {"True", 1.0}, {"False", 0.0}, {NULL, 0.0}};
+    {"pi", M_PI},
+    {"e", M_E},
+    {"tau", 2.0 * M_PI},
+    {"True", 1.0},
+    {"False", 0.0},
+    {NULL, 0.0},
+};
 
 typedef struct BuiltinOpDef {
   const char *name;
@@ -430,6 +496,8 @@ static BuiltinOpDef builtin_ops[] = {
     {"trunc", OPCODE_FUNC1, trunc},
     {"round", OPCODE_FUNC1, round},
     {"int", OPCODE_FUNC1, trunc},
+    {"float", OPCODE_FUNC1, op_float},
+    {"bool", OPCODE_FUNC1, op_bool},
     {"sin", OPCODE_FUNC1, sin},
     {"cos", OPCODE_FUNC1, cos},
     {"tan", OPCODE_FUNC1, tan},
@@ -437,12 +505,22 @@ static BuiltinOpDef builtin_ops[] = {
     {"acos", OPCODE_FUNC1, acos},
     {"atan", OPCODE_FUNC1, atan},
     {"atan2", OPCODE_FUNC2, atan2},
+    {"sinh", OPCODE_FUNC1, sinh},
+    {"cosh", OPCODE_FUNC1, cosh},
+    {"tanh", OPCODE_FUNC1, tanh},
+    {"asinh", OPCODE_FUNC1, asinh},
+    {"acosh", OPCODE_FUNC1, acosh},
+    {"atanh", OPCODE_FUNC1, atanh},
     {"exp", OPCODE_FUNC1, exp},
     {"log", OPCODE_FUNC1, log},
     {"log", OPCODE_FUNC2, op_log2},
+    {"log2", OPCODE_FUNC1, log2},
+    {"log10", OPCODE_FUNC1, log10},
     {"sqrt", OPCODE_FUNC1, sqrt},
     {"pow", OPCODE_FUNC2, pow},
     {"fmod", OPCODE_FUNC2, fmod},
+    {"hypot", OPCODE_FUNC2, hypot},
+    {"copysign", OPCODE_FUNC2, copysign},
     {"lerp", OPCODE_FUNC3, op_lerp},
     {"clamp", OPCODE_FUNC1, op_clamp},
     {"clamp", OPCODE_FUNC3, op_clamp3},
@@ -450,6 +528,42 @@ static BuiltinOpDef builtin_ops[] = {
     {NULL, OPCODE_CONST, NULL},
 };
 
+/* Built-in constants and functions that are also in the Python math module. */
+static const char *builtin_math_module_names[] = {
+    "pi",
+    "e",
+    "tau",
+    "radians",
+    "degrees",
+    "fabs",
+    "floor",
+    "ceil",
+    "trunc",
+    "sin",
+    "cos",
+    "tan",
+    "asin",
+    "acos",
+    "atan",
+    "atan2",
+    "sinh",
+    "cosh",
+    "tanh",
+    "asinh",
+    "acosh",
+    "atanh",
+    "exp",
+    "log",
+    "log2",
+    "log10",
+    "sqrt",
+    "pow",
+    "fmod",
+    "hypot",
+    "copysign",
+    NULL,
+};
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -477,6 +591,8 @@ static BuiltinOpDef builtin_ops[] = {
 #define TOKEN_NOT MAKE_CHAR2('N', 'O')
 #define TOKEN_IF MAKE_CHAR2('I', 'F')
 #define TOKEN_ELSE MAKE_CHAR2('E', 'L')
+#define TOKEN_POW MAKE_CHAR2('*', '*')
+#define TOKEN_FLOORDIV MAKE_CHAR2('/', '/')
 
 static const char *token_eq_characters = "!=><";
 static const char *token_characters = "~`!@#$%^&*+-=/\\?:;<>(){}[]|.,\"'";
@@ -650,6 +766,41 @@ static bool parse_add_func(ExprParseState *state, eOpCode code, int args, void *
   return true;
 }
 
+/* Add a minimum or maximum operation, applying constant folding when possible. */
+static void parse_add_minmax(ExprParseState *state, eOpCode code, int args)
+{
+  ExprOp *prev_ops = &state->ops[state->ops_count];
+  int jmp_gap = state->ops_count - state->last_jmp;
+
+  if (jmp_gap >= args) {
+    bool is_const = true;
+
+    for (int i = 1; i <= args; i++) {
+      is_const = is_const && prev_ops[-i].opcode == OPCODE_CONST;
+    }
+
+    if (is_const) {
+      double result = prev_ops[-args].arg.dval;
+
+      for (int i = args - 1; i >= 1; i--) {
+        if (code == OPCODE_MIN) {
+          CLAMP_MAX(result, prev_ops[-i].arg.dval);
+        }
+        else {
+          CLAMP_MIN(result, prev_ops[-i].arg.dval);
+        }
+      }
+
+      prev_ops[-args].arg.dval = result;
+      state->ops_count -= args - 1;
+      state->stack_ptr -= args - 1;
+      return;
+    }
+  }
+
+  parse_add_op(state, code, 1 - args)->arg.ival = args;
+}
+
 /* Extract the next token from raw characters. */
 static bool parse_next_token(ExprParseState *state)
 {
@@ -720,6 +871,13 @@ static bool parse_next_token(ExprParseState *state)
     return true;
   }
 
+  /* ** and // tokens */
+  if (ELEM(state->cur[0], '*', '/') && state->cur[1] == state->cur[0]) {
+    state->token = MAKE_CHAR2(state->cur[0], state->cur[1]);
+    state->cur += 2;
+    return true;
+  }
+
   /* Special characters (single character tokens) */
   if (strchr(token_characters, *state->cur)) {
     state->token = *state->cur++;
@@ -792,19 +950,13 @@ static int parse_function_args(ExprParseState *state)
   }
 }
 
-static bool parse_unary(ExprParseState *state)
+static bool parse_unary(ExprParseState *state);
+
+static bool parse_primary(ExprParseState *state)
 {
   int i;
 
   switch (state->token) {
-    case '+':
-      return parse_next_token(state) && parse_unary(state);
-
-    case '-':
-      CHECK_ERROR(parse_next_token(state) && parse_unary(state));
-      parse_add_func(state, OPCODE_FUNC1, 1, op_negate);
-      return true;
-
     case '(':
       return parse_next_token(state) && parse_expr(state) && state->token == ')' &&
              parse_next_token(state);
@@ -823,6 +975,20 @@ static bool parse_unary(ExprParseState *state)
         }
       }
 
+      /* Builtins of the math module, accessed with the module name. */
+      if (STREQ(state->tokenbuf, "math")) {
+        CHECK_ERROR(parse_next_token(state) && state->token == '.');
+        CHECK_ERROR(parse_next_token(state) && state->token == TOKEN_ID);
+
+        for (i = 0; builtin_math_module_names[i]; i++) {
+          if (STREQ(state->tokenbuf, builtin_math_module_names[i])) {
+            break;
+          }
+        }
+
+        CHECK_ERROR(builtin_math_module_names[i] != NULL);
+      }
+
       /* Ordinary builtin constants. */
       for (i = 0; builtin_consts[i].name; i++) {
         if (STREQ(state->tokenbuf, builtin_consts[i].name)) {
@@ -856,7 +1022,7 @@ static bool parse_unary(ExprParseState *state)
         int cnt = parse_function_args(state);
         CHECK_ERROR(cnt > 0);
 
-        parse_add_op(state, OPCODE_MIN, 1 - cnt)->arg.ival = cnt;
+        parse_add_minmax(state, OPCODE_MIN, cnt);
         return true;
       }
 
@@ -864,7 +1030,7 @@ static bool parse_unary(ExprParseState *state)
         int cnt = parse_function_args(state);
         CHECK_ERROR(cnt > 0);
 
-        parse_add_op(state, OPCODE_MAX, 1 - cnt)->arg.ival = cnt;
+        parse_add_minmax(state, OPCODE_MAX, cnt);
         return true;
       }
 
@@ -875,6 +1041,36 @@ static bool parse_unary(ExprParseState *state)
   }
 }
 
+static bool parse_power(ExprParseState *state)
+{
+  CHECK_ERROR(parse_primary(state));
+
+  /* Like in Python, the power operator binds more tightly than unary operators on its left,
+   * and less tightly than those on its right: -2 ** -1 is -(2 ** (-1)). */
+  if (state->token == TOKEN_POW) {
+    CHECK_ERROR(parse_next_token(state) && parse_unary(state));
+    parse_add_func(state, OPCODE_FUNC2, 2, pow);
+  }
+
+  return true;
+}
+
+static bool parse_unary(ExprParseState *state)
+{
+  switch (state->token) {
+    case '+':
+      return parse_next_token(state) && parse_unary(state);
+
+    case '-':
+      CHECK_ERROR(parse_next_token(state) && parse_unary(state));
+      parse_add_func(state, OPCODE_FUNC1, 1, op_negate);
+      return true;
+
+    default:
+      return parse_power(state);
+  }
+}
+
 static bool parse_mul(ExprParseState *state)
 {
   CHECK_ERROR(parse_unary(state));
@@ -891,6 +1087,16 @@ static bool parse_mul(ExprParseState *state)
         parse_add_func(state, OPCODE_FUNC2, 2, op_div);
         break;
 
+      case TOKEN_FLOORDIV:
+        CHECK_ERROR(parse_next_token(state) && parse_unary(state));
+        parse_add_func(state, OPCODE_FUNC2, 2, op_floordiv);
+        break;
+
+      case '%':
+        CHECK_ERROR(parse_next_token(state) && parse_unary(state));
+        parse_add_func(state, OPCODE_FUNC2, 2, op_mod);
+        break;
+
       default:
         return true;
     }
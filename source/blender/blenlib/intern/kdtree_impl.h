@@ -23,6 +23,7 @@
 #include "BLI_kdtree_impl.h"
 #include "BLI_math.h"
 #include "BLI_strict_flags.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #define _CONCAT_AUX(MACRO_ARG1, MACRO_ARG2) MACRO_ARG1##MACRO_ARG2
@@ -56,6 +57,9 @@ struct KDTree {
 #define KD_NEAR_ALLOC_INC 100 /* alloc increment for collecting nearest */
 #define KD_FOUND_ALLOC_INC 50 /* alloc increment for collecting nearest */
 
+/* Minimum number of queries per thread for batch lookups. */
+#define KD_BATCH_THREADED_MIN 1024
+
 #define KD_NODE_UNSET ((uint)-1)
 
 /**
@@ -230,34 +234,51 @@ static uint *realloc_nodes(uint *stack, uint *stack_len_capacity, const bool is_
   return stack_new;
 }
 
+BLI_INLINE bool kdtree_node_is_nearer(const KDTreeNode *node,
+                                      const float dist,
+                                      const KDTreeNode *min_node,
+                                      const float min_dist)
+{
+  return (dist < min_dist) || ((dist == min_dist) && (node->index < min_node->index));
+}
+
 /**
- * Find nearest returns index, and -1 if no node is found.
+ * Find the nearest node to \a co.
+ *
+ * Of equally distant nodes the one with the lowest index is returned, so the result does not
+ * depend on the order in which the nodes are visited.
+ *
+ * \param min_node_init: When not null, the search starts with this node as the nearest,
+ * a close node prunes most of the tree (used for spatially coherent queries).
+ * \param stack_p, stack_len_capacity_p: The traversal stack,
+ * reallocated when it needs to grow (unless it's \a stack_default).
  */
-int BLI_kdtree_nd_(find_nearest)(const KDTree *tree,
-                                 const float co[KD_DIMS],
-                                 KDTreeNearest *r_nearest)
+static const KDTreeNode *kdtree_find_nearest_ex(const KDTree *tree,
+                                                const float co[KD_DIMS],
+                                                const KDTreeNode *min_node_init,
+                                                uint **stack_p,
+                                                uint *stack_len_capacity_p,
+                                                const uint *stack_default,
+                                                float *r_min_dist)
 {
   const KDTreeNode *nodes = tree->nodes;
   const KDTreeNode *root, *min_node;
-  uint *stack, stack_default[KD_STACK_INIT];
+  uint *stack = *stack_p;
   float min_dist, cur_dist;
-  uint stack_len_capacity, cur = 0;
-
-#ifdef DEBUG
-  BLI_assert(tree->is_balanced == true);
-#endif
-
-  if (UNLIKELY(tree->root == KD_NODE_UNSET)) {
-    return -1;
-  }
-
-  stack = stack_default;
-  stack_len_capacity = KD_STACK_INIT;
+  uint cur = 0;
 
   root = &nodes[tree->root];
   min_node = root;
   min_dist = len_squared_vnvn(root->co, co);
 
+  if (min_node_init != NULL) {
+    cur_dist = len_squared_vnvn(min_node_init->co, co);
+    if (kdtree_node_is_nearer(min_node_init, cur_dist, min_node, min_dist)) {
+      min_dist = cur_dist;
+      min_node = min_node_init;
+    }
+  }
+
   if (co[root->d] < root->co[root->d]) {
     if (root->right != KD_NODE_UNSET) {
       stack[cur++] = root->right;
@@ -283,9 +304,9 @@ int BLI_kdtree_nd_(find_nearest)(const KDTree *tree,
     if (cur_dist < 0.0f) {
       cur_dist = -cur_dist * cur_dist;
 
-      if (-cur_dist < min_dist) {
+      if (-cur_dist <= min_dist) {
         cur_dist = len_squared_vnvn(node->co, co);
-        if (cur_dist < min_dist) {
+        if (kdtree_node_is_nearer(node, cur_dist, min_node, min_dist)) {
           min_dist = cur_dist;
           min_node = node;
         }
@@ -300,9 +321,9 @@ int BLI_kdtree_nd_(find_nearest)(const KDTree *tree,
     else {
       cur_dist = cur_dist * cur_dist;
 
-      if (cur_dist < min_dist) {
+      if (cur_dist <= min_dist) {
         cur_dist = len_squared_vnvn(node->co, co);
-        if (cur_dist < min_dist) {
+        if (kdtree_node_is_nearer(node, cur_dist, min_node, min_dist)) {
           min_dist = cur_dist;
           min_node = node;
         }
@@ -314,11 +335,42 @@ int BLI_kdtree_nd_(find_nearest)(const KDTree *tree,
         stack[cur++] = node->left;
       }
     }
-    if (UNLIKELY(cur + KD_DIMS > stack_len_capacity)) {
-      stack = realloc_nodes(stack, &stack_len_capacity, stack_default != stack);
+    if (UNLIKELY(cur + KD_DIMS > *stack_len_capacity_p)) {
+      stack = realloc_nodes(stack, stack_len_capacity_p, stack_default != stack);
     }
   }
 
+  *stack_p = stack;
+  *r_min_dist = min_dist;
+  return min_node;
+}
+
+/**
+ * Find nearest returns index, and -1 if no node is found.
+ */
+int BLI_kdtree_nd_(find_nearest)(const KDTree *tree,
+                                 const float co[KD_DIMS],
+                                 KDTreeNearest *r_nearest)
+{
+  const KDTreeNode *min_node;
+  uint *stack, stack_default[KD_STACK_INIT];
+  uint stack_len_capacity;
+  float min_dist;
+
+#ifdef DEBUG
+  BLI_assert(tree->is_balanced == true);
+#endif
+
+  if (UNLIKELY(tree->root == KD_NODE_UNSET)) {
+    return -1;
+  }
+
+  stack = stack_default;
+  stack_len_capacity = KD_STACK_INIT;
+
+  min_node = kdtree_find_nearest_ex(
+      tree, co, NULL, &stack, &stack_len_capacity, stack_default, &min_dist);
+
   if (r_nearest) {
     r_nearest->index = min_node->index;
     r_nearest->dist = sqrtf(min_dist);
@@ -332,6 +384,113 @@ int BLI_kdtree_nd_(find_nearest)(const KDTree *tree,
   return min_node->index;
 }
 
+typedef struct KDFindNearestBatchData {
+  const KDTree *tree;
+  const float (*co)[KD_DIMS];
+  int *r_index;
+  KDTreeNearest *r_nearest;
+} KDFindNearestBatchData;
+
+typedef struct KDFindNearestBatchTLS {
+  /** Null until the stack outgrows `stack_default`. */
+  uint *stack;
+  uint stack_len_capacity;
+  /** The result of the previous query in this thread, used as a starting point. */
+  const KDTreeNode *min_node_prev;
+  uint stack_default[KD_STACK_INIT];
+} KDFindNearestBatchTLS;
+
+static void kdtree_find_nearest_batch_cb(void *__restrict userdata,
+                                         const int i,
+                                         const TaskParallelTLS *__restrict tls)
+{
+  const KDFindNearestBatchData *data = userdata;
+  KDFindNearestBatchTLS *data_tls = tls->userdata_chunk;
+  /* The thread local storage is copied per thread, never store a pointer to its own stack. */
+  uint *stack = data_tls->stack ? data_tls->stack : data_tls->stack_default;
+  float min_dist;
+
+  const KDTreeNode *min_node = kdtree_find_nearest_ex(data->tree,
+                                                     data->co[i],
+                                                     data_tls->min_node_prev,
+                                                     &stack,
+                                                     &data_tls->stack_len_capacity,
+                                                     data_tls->stack_default,
+                                                     &min_dist);
+  if (stack != data_tls->stack_default) {
+    data_tls->stack = stack;
+  }
+  data_tls->min_node_prev = min_node;
+
+  if (data->r_index) {
+    data->r_index[i] = min_node->index;
+  }
+  if (data->r_nearest) {
+    KDTreeNearest *nearest = &data->r_nearest[i];
+    nearest->index = min_node->index;
+    nearest->dist = sqrtf(min_dist);
+    copy_vn_vn(nearest->co, min_node->co);
+  }
+}
+
+static void kdtree_find_nearest_batch_free(const void *__restrict UNUSED(userdata),
+                                           void *__restrict userdata_chunk)
+{
+  KDFindNearestBatchTLS *data_tls = userdata_chunk;
+  MEM_SAFE_FREE(data_tls->stack);
+}
+
+/**
+ * Find the nearest node for each of \a co_len points, multi-threaded.
+ *
+ * Equivalent to calling #BLI_kdtree_3d_find_nearest for every point, but each thread
+ * reuses its traversal stack and starts from the result of its previous query.
+ * Points are processed in contiguous ranges, so spatially coherent input
+ * (such as mesh vertices) prunes the most. Equally distant nodes are resolved by their index,
+ * so the result does not depend on how the points are distributed over the threads.
+ *
+ * \param r_index: Optional array of \a co_len indices, -1 when the tree is empty.
+ * \param r_nearest: Optional array of \a co_len results (unchanged when the tree is empty).
+ */
+void BLI_kdtree_nd_(find_nearest_batch)(const KDTree *tree,
+                                        const float (*co)[KD_DIMS],
+                                        const uint co_len,
+                                        int *r_index,
+                                        KDTreeNearest *r_nearest)
+{
+#ifdef DEBUG
+  BLI_assert(tree->is_balanced == true);
+#endif
+
+  if (UNLIKELY(tree->root == KD_NODE_UNSET)) {
+    if (r_index) {
+      copy_vn_i(r_index, (int)co_len, -1);
+    }
+    return;
+  }
+
+  KDFindNearestBatchData data = {
+      .tree = tree,
+      .co = co,
+      .r_index = r_index,
+      .r_nearest = r_nearest,
+  };
+  KDFindNearestBatchTLS data_tls = {
+      .stack = NULL,
+      .stack_len_capacity = KD_STACK_INIT,
+      .min_node_prev = NULL,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (co_len > KD_BATCH_THREADED_MIN);
+  settings.min_iter_per_thread = KD_BATCH_THREADED_MIN;
+  settings.userdata_chunk = &data_tls;
+  settings.userdata_chunk_size = sizeof(data_tls);
+  settings.func_free = kdtree_find_nearest_batch_free;
+  BLI_task_parallel_range(0, (int)co_len, &data, kdtree_find_nearest_batch_cb, &settings);
+}
+
 /**
  * A version of #BLI_kdtree_3d_find_nearest which runs a callback
  * to filter out values.
@@ -34,9 +34,13 @@
 #  include <intrin.h>
 
 #  include "BLI_winstuff.h"
+#  include <psapi.h>
 #else
 #  include <execinfo.h>
 #  include <unistd.h>
+#  ifdef __APPLE__
+#    include <mach/mach.h>
+#  endif
 #endif
 
 int BLI_cpu_support_sse2(void)
@@ -194,3 +198,37 @@ int BLI_system_memory_max_in_megabytes_int(void)
   /* NOTE: The result will fit into integer. */
   return (int)min_zz(limit_megabytes, (size_t)INT_MAX);
 }
+
+size_t BLI_system_resident_memory(void)
+{
+#if defined(WIN32)
+  PROCESS_MEMORY_COUNTERS counters;
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+    return 0;
+  }
+  return (size_t)counters.WorkingSetSize;
+#elif defined(__APPLE__)
+  struct mach_task_basic_info info;
+  mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+  if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) !=
+      KERN_SUCCESS) {
+    return 0;
+  }
+  return (size_t)info.resident_size;
+#elif defined(__linux__)
+  /* The second value is the number of resident pages. */
+  FILE *file = fopen("/proc/self/statm", "r");
+  if (file == NULL) {
+    return 0;
+  }
+  unsigned long size_pages, resident_pages;
+  const int items = fscanf(file, "%lu %lu", &size_pages, &resident_pages);
+  fclose(file);
+  if (items != 2) {
+    return 0;
+  }
+  return (size_t)resident_pages * (size_t)sysconf(_SC_PAGESIZE);
+#else
+  return 0;
+#endif
+}
@@ -111,6 +111,15 @@ TEST_PARSE_FAIL(Truncated7, "1 and")
 TEST_PARSE_FAIL(Truncated8, "1 or")
 TEST_PARSE_FAIL(Truncated9, "sqrt(1")
 TEST_PARSE_FAIL(Truncated10, "fmod(1,")
+TEST_PARSE_FAIL(Truncated11, "2 **")
+TEST_PARSE_FAIL(Truncated12, "2 //")
+TEST_PARSE_FAIL(Truncated13, "2 %")
+
+TEST_PARSE_FAIL(BadPower, "2 *** 3")
+TEST_PARSE_FAIL(BadMathModule1, "math")
+TEST_PARSE_FAIL(BadMathModule2, "math.")
+TEST_PARSE_FAIL(BadMathModule3, "math.lerp(1, 2, 0.5)")
+TEST_PARSE_FAIL(BadMathModule4, "math.min(1, 2)")
 
 /* Constant expression with working constant folding */
 #define TEST_CONST(name, str, value) \
@@ -143,6 +152,8 @@ TEST_CONST(TenE, "1.e+1", 10.0)
 TEST_CONST(Half, ".5", 0.5)
 
 TEST_CONST(Pi, "pi", M_PI)
+TEST_CONST(E, "e", M_E)
+TEST_CONST(Tau, "tau", 2.0 * M_PI)
 TEST_CONST(True, "True", TRUE_VAL)
 TEST_CONST(False, "False", FALSE_VAL)
 
@@ -156,6 +167,20 @@ TEST_CONST(Pow, "pow(4, 0.5)", 2.0)
 TEST_EVAL(Pow, "pow(4, x)", 0.5, 2.0)
 
 TEST_CONST(Log2_1, "log(4, 2)", 2.0)
+TEST_CONST(Log2_2, "log2(8)", 3.0)
+TEST_CONST(Log10, "log10(100)", 2.0)
+
+TEST_CONST(Tanh, "tanh(0)", 0.0)
+TEST_CONST(Hypot, "hypot(3, 4)", 5.0)
+TEST_CONST(CopySign, "copysign(2, -1)", -2.0)
+
+TEST_CONST(Float, "float(2)", 2.0)
+TEST_CONST(Bool1, "bool(3)", TRUE_VAL)
+TEST_CONST(Bool2, "bool(0)", FALSE_VAL)
+
+TEST_CONST(MathModule1, "math.pi", M_PI)
+TEST_CONST(MathModule2, "math.sqrt(4)", 2.0)
+TEST_EVAL(MathModule, "math.floor(x) + math.e", 1.5, 1.0 + M_E)
 
 TEST_CONST(Round1, "round(-0.5)", -1.0)
 TEST_CONST(Round2, "round(-0.4)", 0.0)
@@ -181,12 +206,14 @@ TEST_CONST(Smoothstep4, "smoothstep(-10,10,20)", 1.0)
 TEST_CONST(Smoothstep5, "smoothstep(-10,10,-5)", 0.15625)
 TEST_EVAL(Smoothstep1, "smoothstep(-10,10,x)", 5, 0.84375)
 
-TEST_RESULT(Min1, "min(3,1,2)", 1.0)
-TEST_RESULT(Max1, "max(3,1,2)", 3.0)
-TEST_RESULT(Min2, "min(1,2,3)", 1.0)
-TEST_RESULT(Max2, "max(1,2,3)", 3.0)
-TEST_RESULT(Min3, "min(2,3,1)", 1.0)
-TEST_RESULT(Max3, "max(2,3,1)", 3.0)
+TEST_CONST(Min1, "min(3,1,2)", 1.0)
+TEST_CONST(Max1, "max(3,1,2)", 3.0)
+TEST_CONST(Min2, "min(1,2,3)", 1.0)
+TEST_CONST(Max2, "max(1,2,3)", 3.0)
+TEST_CONST(Min3, "min(2,3,1)", 1.0)
+TEST_CONST(Max3, "max(2,3,1)", 3.0)
+TEST_EVAL(Min1, "min(3,x,2)", 1, 1.0)
+TEST_EVAL(Max1, "max(3,x,2)", 4, 4.0)
 
 TEST_CONST(UnaryPlus, "+1", 1.0)
 
@@ -205,12 +232,32 @@ TEST_EVAL(BinaryMul, "x*3", 2, 6.0)
 TEST_CONST(BinaryDiv, "3/2", 1.5)
 TEST_EVAL(BinaryDiv, "3/x", 2, 1.5)
 
+TEST_CONST(BinaryFloorDiv1, "7 // 2", 3.0)
+TEST_CONST(BinaryFloorDiv2, "-7 // 2", -4.0)
+TEST_CONST(BinaryFloorDiv3, "7 // -2", -4.0)
+TEST_CONST(BinaryFloorDiv4, "1 // 0.1", 9.0)
+TEST_EVAL(BinaryFloorDiv, "x // 2", 7, 3.0)
+
+TEST_CONST(BinaryMod1, "7 % 3", 1.0)
+TEST_CONST(BinaryMod2, "-7 % 3", 2.0)
+TEST_CONST(BinaryMod3, "7 % -3", -2.0)
+TEST_CONST(BinaryMod4, "5.5 % 2", 1.5)
+TEST_EVAL(BinaryMod, "x % 3", 8, 2.0)
+
+TEST_CONST(Power1, "2 ** 3", 8.0)
+TEST_CONST(Power2, "2 ** 3 ** 2", 512.0)
+TEST_CONST(Power3, "-2 ** 2", -4.0)
+TEST_CONST(Power4, "2 ** -1", 0.5)
+TEST_EVAL(Power1, "x ** 2", 3, 9.0)
+TEST_EVAL(Power2, "-x ** 2", 3, -9.0)
+
 TEST_CONST(Arith1, "1 + -2 * 3", -5.0)
 TEST_CONST(Arith2, "(1 + -2) * 3", -3.0)
 TEST_CONST(Arith3, "-1 + 2 * 3", 5.0)
 TEST_CONST(Arith4, "3 * (-2 + 1)", -3.0)
 
 TEST_EVAL(Arith1, "1 + -x * 3", 2, -5.0)
+TEST_EVAL(Arith2, "2 * x ** 2 % 5", 2, 3.0)
 
 TEST_CONST(Eq1, "1 == 1.0", TRUE_VAL)
 TEST_CONST(Eq2, "1 == 2.0", FALSE_VAL)
@@ -329,6 +376,12 @@ TEST_ERROR(DivZero1, "0 / 0", 0.0, EXPR_PYLIKE_MATH_ERROR)
 TEST_ERROR(DivZero2, "1 / 0", 0.0, EXPR_PYLIKE_DIV_BY_ZERO)
 TEST_ERROR(DivZero3, "1 / x", 0.0, EXPR_PYLIKE_DIV_BY_ZERO)
 TEST_ERROR(DivZero4, "1 / x", 1.0, EXPR_PYLIKE_SUCCESS)
+TEST_ERROR(DivZero5, "1 // x", 0.0, EXPR_PYLIKE_DIV_BY_ZERO)
+TEST_ERROR(DivZero6, "1 % x", 0.0, EXPR_PYLIKE_DIV_BY_ZERO)
+TEST_ERROR(DivZero7, "x ** -1", 0.0, EXPR_PYLIKE_DIV_BY_ZERO)
+TEST_ERROR(DivZero8, "0 // 0", 0.0, EXPR_PYLIKE_DIV_BY_ZERO)
+TEST_ERROR(DivZero9, "x % 0", 0.0, EXPR_PYLIKE_DIV_BY_ZERO)
+TEST_ERROR(DivZero10, "x // -0.0", 1.0, EXPR_PYLIKE_DIV_BY_ZERO)
 
 TEST_ERROR(SqrtDomain1, "sqrt(-1)", 0.0, EXPR_PYLIKE_MATH_ERROR)
 TEST_ERROR(SqrtDomain2, "sqrt(x)", -1.0, EXPR_PYLIKE_MATH_ERROR)
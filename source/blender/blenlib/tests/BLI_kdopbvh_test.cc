@@ -8,6 +8,7 @@
 
 #include "BLI_compiler_attrs.h"
 #include "BLI_kdopbvh.h"
+#include "BLI_math_geom.h"
 #include "BLI_math_vector.h"
 #include "BLI_rand.h"
 
@@ -66,11 +67,16 @@ static void optimal_check_callback(void *userdata,
  * Note that a small epsilon is added to the BVH nodes bounds, even if we pass in zero.
  * Use rounding to ensure very close nodes don't cause the wrong node to be found as nearest.
  */
-static void find_nearest_points_test(
-    int points_len, float scale, int round, int random_seed, bool optimal = false)
+static void find_nearest_points_test(int points_len,
+                                     float scale,
+                                     int round,
+                                     int random_seed,
+                                     bool optimal = false,
+                                     char tree_type = 8,
+                                     char axis = 8)
 {
   struct RNG *rng = BLI_rng_new(random_seed);
-  BVHTree *tree = BLI_bvhtree_new(points_len, 0.0, 8, 8);
+  BVHTree *tree = BLI_bvhtree_new(points_len, 0.0, tree_type, axis);
 
   void *mem = MEM_mallocN(sizeof(float[3]) * points_len, __func__);
   float(*points)[3] = (float(*)[3])mem;
@@ -132,3 +138,127 @@ TEST(kdopbvh, OptimalFindNearest_500)
 {
   find_nearest_points_test(500, 1.0, 1000, 12, true);
 }
+
+TEST(kdopbvh, FindNearest_Binary_500)
+{
+  find_nearest_points_test(500, 1.0, 1000, 12, false, 2, 6);
+}
+TEST(kdopbvh, FindNearest_Quad_5000)
+{
+  find_nearest_points_test(5000, 1.0, 1000, 12, false, 4, 6);
+}
+TEST(kdopbvh, OptimalFindNearest_Quad_5000)
+{
+  find_nearest_points_test(5000, 1.0, 1000, 12, true, 4, 26);
+}
+/* Many points at the same location. */
+TEST(kdopbvh, FindNearest_Duplicates)
+{
+  find_nearest_points_test(2000, 1.0, 2, 12, false, 4, 6);
+}
+
+static void raycast_tris_callback(void *userdata,
+                                  int index,
+                                  const BVHTreeRay *ray,
+                                  BVHTreeRayHit *hit)
+{
+  const float(*tris)[3][3] = (const float(*)[3][3])userdata;
+  float dist;
+  if (isect_ray_tri_v3(ray->origin, ray->direction, UNPACK3(tris[index]), &dist, nullptr) &&
+      (dist < hit->dist)) {
+    hit->index = index;
+    hit->dist = dist;
+  }
+}
+
+/**
+ * Compare ray-casts against testing all triangles.
+ */
+static void raycast_tris_test(
+    int tris_len, int rays_len, int random_seed, char tree_type, char axis)
+{
+  struct RNG *rng = BLI_rng_new(random_seed);
+  BVHTree *tree = BLI_bvhtree_new(tris_len, 0.0, tree_type, axis);
+
+  float(*tris)[3][3] = (float(*)[3][3])MEM_mallocN(sizeof(float[3][3]) * tris_len, __func__);
+  for (int i = 0; i < tris_len; i++) {
+    float center[3], offset[3];
+    rng_v3_round(center, 3, rng, 1000, 1.0f);
+    for (int j = 0; j < 3; j++) {
+      rng_v3_round(offset, 3, rng, 1000, 0.05f);
+      add_v3_v3v3(tris[i][j], center, offset);
+    }
+    BLI_bvhtree_insert(tree, i, tris[i][0], 3);
+  }
+  BLI_bvhtree_balance(tree);
+
+  for (int i = 0; i < rays_len; i++) {
+    float origin[3], direction[3];
+    rng_v3_round(origin, 3, rng, 1000, 1.5f);
+    BLI_rng_get_float_unit_v3(rng, direction);
+
+    BVHTreeRayHit hit_expect = {-1, BVH_RAYCAST_DIST_MAX};
+    BVHTreeRay ray = {{0}};
+    copy_v3_v3(ray.origin, origin);
+    copy_v3_v3(ray.direction, direction);
+    for (int j = 0; j < tris_len; j++) {
+      raycast_tris_callback(tris, j, &ray, &hit_expect);
+    }
+
+    BVHTreeRayHit hit = {-1, BVH_RAYCAST_DIST_MAX};
+    BLI_bvhtree_ray_cast(tree, origin, direction, 0.0f, &hit, raycast_tris_callback, tris);
+    EXPECT_EQ(hit.index, hit_expect.index);
+    EXPECT_EQ(hit.dist, hit_expect.dist);
+  }
+
+  BLI_bvhtree_free(tree);
+  BLI_rng_free(rng);
+  MEM_freeN(tris);
+}
+
+TEST(kdopbvh, RayCast_Binary)
+{
+  raycast_tris_test(2000, 500, 1, 2, 6);
+}
+TEST(kdopbvh, RayCast_Quad)
+{
+  raycast_tris_test(2000, 500, 2, 4, 6);
+}
+TEST(kdopbvh, RayCast_Oct)
+{
+  raycast_tris_test(2000, 500, 3, 8, 8);
+}
+TEST(kdopbvh, RayCast_Oct_26DOP)
+{
+  raycast_tris_test(2000, 500, 4, 8, 26);
+}
+
+/* Moving all points and updating the tree must give the same result as a new tree. */
+TEST(kdopbvh, UpdateTree)
+{
+  const int points_len = 1000;
+  struct RNG *rng = BLI_rng_new(5);
+  BVHTree *tree = BLI_bvhtree_new(points_len, 0.0, 4, 6);
+
+  float(*points)[3] = (float(*)[3])MEM_mallocN(sizeof(float[3]) * points_len, __func__);
+  for (int i = 0; i < points_len; i++) {
+    rng_v3_round(points[i], 3, rng, 1000, 1.0f);
+    BLI_bvhtree_insert(tree, i, points[i], 1);
+  }
+  BLI_bvhtree_balance(tree);
+
+  for (int i = 0; i < points_len; i++) {
+    rng_v3_round(points[i], 3, rng, 1000, 1.0f);
+    BLI_bvhtree_update_node(tree, i, points[i], nullptr, 1);
+  }
+  BLI_bvhtree_update_tree(tree);
+
+  for (int i = 0; i < points_len; i++) {
+    const int j = BLI_bvhtree_find_nearest(tree, points[i], nullptr, nullptr, nullptr);
+    EXPECT_EQ_ARRAY(points[i], points[j], 3);
+  }
+
+  BLI_bvhtree_free(tree);
+  BLI_rng_free(rng);
+  MEM_freeN(points);
+}
@@ -0,0 +1,127 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_kdtree.h"
+#include "BLI_math_vector.h"
+#include "BLI_rand.h"
+
+/* -------------------------------------------------------------------- */
+/* Helper Functions */
+
+static KDTree_3d *kdtree_random_points(float (*points)[3], int points_len, struct RNG *rng)
+{
+  KDTree_3d *tree = BLI_kdtree_3d_new((uint)points_len);
+  for (int i = 0; i < points_len; i++) {
+    BLI_rng_get_float_unit_v3(rng, points[i]);
+    BLI_kdtree_3d_insert(tree, i, points[i]);
+  }
+  BLI_kdtree_3d_balance(tree);
+  return tree;
+}
+
+/**
+ * Compare batch lookups with individual lookups.
+ */
+static void find_nearest_batch_test(int points_len, int queries_len, int random_seed)
+{
+  struct RNG *rng = BLI_rng_new(random_seed);
+  float(*points)[3] = (float(*)[3])MEM_mallocN(sizeof(float[3]) * points_len, __func__);
+  KDTree_3d *tree = kdtree_random_points(points, points_len, rng);
+
+  float(*queries)[3] = (float(*)[3])MEM_mallocN(sizeof(float[3]) * queries_len, __func__);
+  for (int i = 0; i < queries_len; i++) {
+    BLI_rng_get_float_unit_v3(rng, queries[i]);
+    mul_v3_fl(queries[i], BLI_rng_get_float(rng) * 2.0f);
+  }
+
+  int *index = (int *)MEM_mallocN(sizeof(int) * queries_len, __func__);
+  KDTreeNearest_3d *nearest = (KDTreeNearest_3d *)MEM_mallocN(
+      sizeof(KDTreeNearest_3d) * queries_len, __func__);
+  BLI_kdtree_3d_find_nearest_batch(tree, queries, (uint)queries_len, index, nearest);
+
+  for (int i = 0; i < queries_len; i++) {
+    KDTreeNearest_3d nearest_expect;
+    BLI_kdtree_3d_find_nearest(tree, queries[i], &nearest_expect);
+    EXPECT_EQ(nearest[i].index, index[i]);
+    EXPECT_EQ(index[i], nearest_expect.index);
+    EXPECT_EQ(nearest[i].dist, nearest_expect.dist);
+    EXPECT_EQ_ARRAY(nearest[i].co, points[index[i]], 3);
+  }
+
+  BLI_kdtree_3d_free(tree);
+  BLI_rng_free(rng);
+  MEM_freeN(points);
+  MEM_freeN(queries);
+  MEM_freeN(index);
+  MEM_freeN(nearest);
+}
+
+/* -------------------------------------------------------------------- */
+/* Tests */
+
+TEST(kdtree, FindNearestBatch_Empty)
+{
+  KDTree_3d *tree = BLI_kdtree_3d_new(0);
+  BLI_kdtree_3d_balance(tree);
+  const float queries[2][3] = {{0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}};
+  int index[2] = {0, 0};
+  BLI_kdtree_3d_find_nearest_batch(tree, queries, 2, index, nullptr);
+  EXPECT_EQ(index[0], -1);
+  EXPECT_EQ(index[1], -1);
+  BLI_kdtree_3d_free(tree);
+}
+
+TEST(kdtree, FindNearestBatch_Small)
+{
+  find_nearest_batch_test(10, 100, 1);
+}
+
+TEST(kdtree, FindNearestBatch_Large)
+{
+  find_nearest_batch_test(10000, 20000, 2);
+}
+
+/* Every query is equally distant to the eight corners of a grid cell, the one with the lowest
+ * index has to be found independent of the previous queries of the thread. */
+TEST(kdtree, FindNearestBatch_Ties)
+{
+  const int grid_size = 16;
+  const int points_len = grid_size * grid_size * grid_size;
+  KDTree_3d *tree = BLI_kdtree_3d_new((uint)points_len);
+  for (int i = 0; i < points_len; i++) {
+    const float co[3] = {(float)(i % grid_size),
+                         (float)((i / grid_size) % grid_size),
+                         (float)(i / (grid_size * grid_size))};
+    BLI_kdtree_3d_insert(tree, i, co);
+  }
+  BLI_kdtree_3d_balance(tree);
+
+  const int queries_len = 8192;
+  struct RNG *rng = BLI_rng_new(3);
+  float(*queries)[3] = (float(*)[3])MEM_mallocN(sizeof(float[3]) * queries_len, __func__);
+  int *index_expect = (int *)MEM_mallocN(sizeof(int) * queries_len, __func__);
+  for (int i = 0; i < queries_len; i++) {
+    int cell[3];
+    for (int j = 0; j < 3; j++) {
+      cell[j] = (int)(BLI_rng_get_uint(rng) % (grid_size - 1));
+      queries[i][j] = (float)cell[j] + 0.5f;
+    }
+    index_expect[i] = cell[0] + cell[1] * grid_size + cell[2] * grid_size * grid_size;
+  }
+
+  int *index = (int *)MEM_mallocN(sizeof(int) * queries_len, __func__);
+  BLI_kdtree_3d_find_nearest_batch(tree, queries, (uint)queries_len, index, nullptr);
+  for (int i = 0; i < queries_len; i++) {
+    EXPECT_EQ(index[i], index_expect[i]);
+    EXPECT_EQ(BLI_kdtree_3d_find_nearest(tree, queries[i], nullptr), index_expect[i]);
+  }
+
+  BLI_kdtree_3d_free(tree);
+  BLI_rng_free(rng);
+  MEM_freeN(queries);
+  MEM_freeN(index_expect);
+  MEM_freeN(index);
+}
@@ -243,6 +243,7 @@ void BLO_update_defaults_workspace(struct WorkSpace *workspace, const char *app_
 /* Disable unwanted experimental feature settings on startup. */
 void BLO_sanitize_experimental_features_userpref_blend(struct UserDef *userdef);
 
+bool BLO_file_header_is_blend(const char *filepath);
 struct BlendThumbnail *BLO_thumbnail_from_file(const char *filepath);
 
 /* datafiles (generated theme) */
@@ -25,6 +25,7 @@
  */
 
 struct GHash;
+struct MemFileEncodeTask;
 struct Scene;
 
 typedef struct {
@@ -32,8 +33,13 @@ typedef struct {
   const char *buf;
   /** Size in bytes. */
   size_t size;
-  /** When true, this chunk doesn't own the memory, it's shared with a previous #MemFileChunk */
+  /** When true, this chunk is identical to the matching #MemFileChunk of the previous step (and
+   * shares its memory). */
   bool is_identical;
+  /** When true, this chunk doesn't own the memory, it's shared with a #MemFileChunk of a previous
+   * step, either because it is identical or because a chunk with the same content was found
+   * elsewhere in the previous step. */
+  bool is_shared;
   /** When true, this chunk is also identical to the one in the next step (used by undo code to
    * detect unchanged IDs).
    * Defined when writing the next step (i.e. last undo step has those always false). */
@@ -41,11 +47,18 @@ typedef struct {
   /** Session UUID of the ID being currently written (MAIN_ID_SESSION_UUID_UNSET when not writing
    * ID-related data). Used to find matching chunks in previous memundo step. */
   uint id_session_uuid;
+  /** Hash of the chunk content, used to find identical chunks regardless of their position. */
+  uint hash;
 } MemFileChunk;
 
 typedef struct MemFile {
   ListBase chunks;
   size_t size;
+
+  /** Maps chunk content hashes to their first #MemFileChunk, built by the encode task. */
+  struct GHash *chunk_hash_mapping;
+  /** Background task deduplicating and hashing the chunks, see #BLO_memfile_wait. */
+  struct MemFileEncodeTask *encode_task;
 } MemFile;
 
 typedef struct MemFileWriteData {
@@ -75,6 +88,7 @@ void BLO_memfile_write_finalize(MemFileWriteData *mem_data);
 void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t size);
 
 /* exports */
+extern void BLO_memfile_wait(MemFile *memfile);
 extern void BLO_memfile_free(MemFile *memfile);
 extern void BLO_memfile_merge(MemFile *first, MemFile *second);
 extern void BLO_memfile_clear_future(MemFile *memfile);
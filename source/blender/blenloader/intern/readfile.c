@@ -23,6 +23,8 @@
 
 #include "zlib.h"
 
+#include <zstd.h>
+
 #include <ctype.h> /* for isdigit. */
 #include <fcntl.h> /* for open flags (O_BINARY, O_RDONLY). */
 #include <limits.h>
@@ -69,6 +71,7 @@
 #include "BLI_memarena.h"
 #include "BLI_mempool.h"
 #include "BLI_mmap.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 
 #include "BLT_translation.h"
@@ -1165,6 +1168,247 @@ static ssize_t fd_read_gzip_from_file(FileData *filedata,
   return readsize;
 }
 
+/* Zstandard file reading.
+ * Files written by Blender have a seek table, so that only the frames that contain the requested
+ * data have to be decompressed. Other files are decompressed as a stream, without seeking. */
+
+typedef struct BlendZstdReader {
+  ZSTD_DCtx *ctx;
+
+  /** Number of frames in the seek table, zero when the file is decompressed as a stream. */
+  int frames_len;
+  /** Start of every frame in the compressed and uncompressed file. Both arrays have an additional
+   * element at the end, which is the end of the last frame. */
+  off64_t *compressed_offsets;
+  off64_t *uncompressed_offsets;
+
+  /** The most recently decompressed frame, -1 if there is none yet. */
+  int frame_index;
+  char *frame_buffer;
+  size_t frame_buffer_size;
+  char *compressed_buffer;
+  size_t compressed_buffer_size;
+
+  /** Input of the stream decompression. */
+  ZSTD_inBuffer in;
+  char *in_buffer;
+  bool in_eof;
+} BlendZstdReader;
+
+static uint32_t zstd_read_uint32_le(const uchar *data)
+{
+  return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) |
+         ((uint32_t)data[3] << 24);
+}
+
+static bool zstd_is_compressed_header(const char header[4])
+{
+  return zstd_read_uint32_le((const uchar *)header) == BLEND_ZSTD_FRAME_MAGIC;
+}
+
+/**
+ * Read the seek table at the end of the file, see #BLEND_ZSTD_FRAME_SIZE.
+ * \return False when the file has no valid seek table.
+ */
+static bool zstd_read_seek_table(BlendZstdReader *zstd, int file)
+{
+  const off64_t file_size = BLI_lseek(file, 0, SEEK_END);
+
+  uchar footer[BLEND_ZSTD_SEEK_TABLE_FOOTER_SIZE];
+  if (file_size < sizeof(footer) ||
+      BLI_lseek(file, -(off64_t)sizeof(footer), SEEK_END) < 0 ||
+      read(file, footer, sizeof(footer)) != sizeof(footer)) {
+    return false;
+  }
+  if (zstd_read_uint32_le(footer + 5) != BLEND_ZSTD_SEEKABLE_MAGIC) {
+    return false;
+  }
+  const uchar descriptor = footer[4];
+  /* Bits 2 to 6 are reserved and must be zero. */
+  if (descriptor & 0x7C) {
+    return false;
+  }
+  /* Every entry may be followed by a checksum of the frame, which is not used here. */
+  const size_t entry_size = (descriptor & 0x80) ? 12 : 8;
+  const uint32_t frames_len = zstd_read_uint32_le(footer);
+  if (frames_len == 0 || frames_len > INT_MAX / 12) {
+    return false;
+  }
+
+  /* The seek table is stored in a skippable frame, which has an 8 byte header. */
+  const off64_t table_size = (off64_t)frames_len * entry_size + sizeof(footer);
+  if (table_size + 8 > file_size) {
+    return false;
+  }
+  uchar table_header[8];
+  if (BLI_lseek(file, -(table_size + 8), SEEK_END) < 0 ||
+      read(file, table_header, sizeof(table_header)) != sizeof(table_header)) {
+    return false;
+  }
+  if (zstd_read_uint32_le(table_header) != BLEND_ZSTD_SEEK_TABLE_MAGIC ||
+      zstd_read_uint32_le(table_header + 4) != table_size) {
+    return false;
+  }
+
+  const size_t entries_size = (size_t)frames_len * entry_size;
+  uchar *entries = MEM_mallocN(entries_size, __func__);
+  if (read(file, entries, entries_size) != (ssize_t)entries_size) {
+    MEM_freeN(entries);
+    return false;
+  }
+
+  zstd->compressed_offsets = MEM_malloc_arrayN(frames_len + 1, sizeof(off64_t), __func__);
+  zstd->uncompressed_offsets = MEM_malloc_arrayN(frames_len + 1, sizeof(off64_t), __func__);
+  zstd->frames_len = (int)frames_len;
+
+  off64_t compressed_offset = 0;
+  off64_t uncompressed_offset = 0;
+  for (int i = 0; i < (int)frames_len; i++) {
+    zstd->compressed_offsets[i] = compressed_offset;
+    zstd->uncompressed_offsets[i] = uncompressed_offset;
+    compressed_offset += zstd_read_uint32_le(entries + i * entry_size);
+    uncompressed_offset += zstd_read_uint32_le(entries + i * entry_size + 4);
+  }
+  zstd->compressed_offsets[frames_len] = compressed_offset;
+  zstd->uncompressed_offsets[frames_len] = uncompressed_offset;
+  MEM_freeN(entries);
+
+  /* The frames have to end where the seek table starts. */
+  if (compressed_offset != file_size - table_size - 8) {
+    MEM_SAFE_FREE(zstd->compressed_offsets);
+    MEM_SAFE_FREE(zstd->uncompressed_offsets);
+    zstd->frames_len = 0;
+    return false;
+  }
+  return true;
+}
+
+static void zstd_reader_free(BlendZstdReader *zstd)
+{
+  ZSTD_freeDCtx(zstd->ctx);
+  MEM_SAFE_FREE(zstd->compressed_offsets);
+  MEM_SAFE_FREE(zstd->uncompressed_offsets);
+  MEM_SAFE_FREE(zstd->frame_buffer);
+  MEM_SAFE_FREE(zstd->compressed_buffer);
+  MEM_SAFE_FREE(zstd->in_buffer);
+  MEM_freeN(zstd);
+}
+
+/** Find the frame that contains the given offset in the uncompressed file. */
+static int zstd_frame_find(const BlendZstdReader *zstd, off64_t offset)
+{
+  int first = 0;
+  int last = zstd->frames_len - 1;
+  while (first < last) {
+    const int mid = (first + last + 1) / 2;
+    if (zstd->uncompressed_offsets[mid] <= offset) {
+      first = mid;
+    }
+    else {
+      last = mid - 1;
+    }
+  }
+  return first;
+}
+
+static bool zstd_frame_load(FileData *filedata, int frame_index)
+{
+  BlendZstdReader *zstd = filedata->zstd;
+  if (zstd->frame_index == frame_index) {
+    return true;
+  }
+  zstd->frame_index = -1;
+
+  const off64_t compressed_offset = zstd->compressed_offsets[frame_index];
+  const size_t compressed_size = zstd->compressed_offsets[frame_index + 1] - compressed_offset;
+  const size_t frame_size = zstd->uncompressed_offsets[frame_index + 1] -
+                            zstd->uncompressed_offsets[frame_index];
+
+  if (compressed_size > zstd->compressed_buffer_size) {
+    MEM_SAFE_FREE(zstd->compressed_buffer);
+    zstd->compressed_buffer = MEM_mallocN(compressed_size, __func__);
+    zstd->compressed_buffer_size = compressed_size;
+  }
+  if (frame_size > zstd->frame_buffer_size) {
+    MEM_SAFE_FREE(zstd->frame_buffer);
+    zstd->frame_buffer = MEM_mallocN(frame_size, __func__);
+    zstd->frame_buffer_size = frame_size;
+  }
+
+  if (BLI_lseek(filedata->filedes, compressed_offset, SEEK_SET) != compressed_offset ||
+      read(filedata->filedes, zstd->compressed_buffer, compressed_size) !=
+          (ssize_t)compressed_size) {
+    return false;
+  }
+  const size_t result = ZSTD_decompressDCtx(
+      zstd->ctx, zstd->frame_buffer, frame_size, zstd->compressed_buffer, compressed_size);
+  if (ZSTD_isError(result) || result != frame_size) {
+    return false;
+  }
+
+  zstd->frame_index = frame_index;
+  return true;
+}
+
+static ssize_t fd_read_zstd_seekable_from_file(FileData *filedata,
+                                               void *buffer,
+                                               size_t size,
+                                               bool *UNUSED(r_is_memchunck_identical))
+{
+  BlendZstdReader *zstd = filedata->zstd;
+  const off64_t file_end = zstd->uncompressed_offsets[zstd->frames_len];
+
+  size_t readsize = 0;
+  while (readsize < size && filedata->file_offset < file_end) {
+    const int frame_index = zstd_frame_find(zstd, filedata->file_offset);
+    if (!zstd_frame_load(filedata, frame_index)) {
+      return EOF;
+    }
+    const off64_t frame_offset = filedata->file_offset - zstd->uncompressed_offsets[frame_index];
+    const size_t frame_remaining = zstd->uncompressed_offsets[frame_index + 1] -
+                                   filedata->file_offset;
+    const size_t copy_size = MIN2(size - readsize, frame_remaining);
+    memcpy(POINTER_OFFSET(buffer, readsize), zstd->frame_buffer + frame_offset, copy_size);
+    readsize += copy_size;
+    filedata->file_offset += copy_size;
+  }
+
+  return (ssize_t)readsize;
+}
+
+static ssize_t fd_read_zstd_stream_from_file(FileData *filedata,
+                                             void *buffer,
+                                             size_t size,
+                                             bool *UNUSED(r_is_memchunck_identical))
+{
+  BlendZstdReader *zstd = filedata->zstd;
+  ZSTD_outBuffer out = {buffer, size, 0};
+
+  while (out.pos < out.size) {
+    if (zstd->in.pos == zstd->in.size && !zstd->in_eof) {
+      const ssize_t in_size = read(filedata->filedes, zstd->in_buffer, ZSTD_DStreamInSize());
+      if (in_size < 0) {
+        return EOF;
+      }
+      zstd->in.src = zstd->in_buffer;
+      zstd->in.size = (size_t)in_size;
+      zstd->in.pos = 0;
+      zstd->in_eof = in_size == 0;
+    }
+    const size_t prev_out_pos = out.pos;
+    const size_t prev_in_pos = zstd->in.pos;
+    if (ZSTD_isError(ZSTD_decompressStream(zstd->ctx, &out, &zstd->in))) {
+      return EOF;
+    }
+    if (zstd->in_eof && out.pos == prev_out_pos && zstd->in.pos == prev_in_pos) {
+      break;
+    }
+  }
+
+  filedata->file_offset += out.pos;
+  return (ssize_t)out.pos;
+}
+
 /* Memory reading. */
 
 static ssize_t fd_read_from_memory(FileData *filedata,
@@ -1187,6 +1431,13 @@ static ssize_t fd_read_from_memory(FileData *filedata,
  * This avoids system call overhead and can significantly speed up file loading.
  */
 
+/**
+ * Large reads release the mapped pages after copying them, otherwise the pages of the file would
+ * stay resident next to the copied data until the file is closed, doubling the peak memory usage
+ * when loading large files.
+ */
+#define MMAP_RELEASE_MIN_SIZE (1 << 20)
+
 static ssize_t fd_read_from_mmap(FileData *filedata,
                                  void *buffer,
                                  size_t size,
@@ -1198,6 +1449,9 @@ static ssize_t fd_read_from_mmap(FileData *filedata,
   if (!BLI_mmap_read(filedata->mmap_file, buffer, filedata->file_offset, readsize)) {
     return 0;
   }
+  if (readsize >= MMAP_RELEASE_MIN_SIZE) {
+    BLI_mmap_release(filedata->mmap_file, filedata->file_offset, readsize);
+  }
 
   filedata->file_offset += readsize;
 
@@ -1383,6 +1637,8 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
       read_fn = fd_read_from_mmap;
       seek_fn = fd_seek_from_mmap;
       buffersize = BLI_lseek(file, 0, SEEK_END);
+      /* Blocks are read in file order, data blocks are read on demand right after their ID. */
+      BLI_mmap_advise_sequential(mmap_file);
     }
   }
 
@@ -1409,6 +1665,26 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
     file = -1;
   }
 
+  /* Zstandard file. */
+  BlendZstdReader *zstd = NULL;
+  if ((read_fn == NULL) && zstd_is_compressed_header(header)) {
+    zstd = MEM_callocN(sizeof(*zstd), __func__);
+    zstd->ctx = ZSTD_createDCtx();
+    zstd->frame_index = -1;
+
+    if (zstd_read_seek_table(zstd, file)) {
+      read_fn = fd_read_zstd_seekable_from_file;
+      /* Seeking only moves the offset in the uncompressed file, like for memory-mapped files. */
+      seek_fn = fd_seek_from_mmap;
+      buffersize = zstd->uncompressed_offsets[zstd->frames_len];
+    }
+    else {
+      read_fn = fd_read_zstd_stream_from_file;
+      zstd->in_buffer = MEM_mallocN(ZSTD_DStreamInSize(), __func__);
+    }
+    BLI_lseek(file, 0, SEEK_SET);
+  }
+
   if (read_fn == NULL) {
     BKE_reportf(reports, RPT_WARNING, "Unrecognized file format '%s'", filepath);
     return NULL;
@@ -1423,6 +1699,7 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
   fd->seek = seek_fn;
   fd->mmap_file = mmap_file;
   fd->buffersize = buffersize;
+  fd->zstd = zstd;
 
   return fd;
 }
@@ -1521,6 +1798,45 @@ static int fd_read_gzip_from_memory_init(FileData *fd)
   return 1;
 }
 
+/**
+ * The whole file is in memory already, so decompress it at once instead of using the seek table.
+ * The seek table is a skippable frame, which is ignored by the decompression.
+ */
+static bool fd_read_zstd_from_memory_init(FileData *fd)
+{
+  ZSTD_DCtx *ctx = ZSTD_createDCtx();
+  ZSTD_inBuffer in = {fd->buffer, fd->buffersize, 0};
+  ZSTD_outBuffer out = {NULL, 0, 0};
+  size_t result = 1;
+
+  /* Keep going while there is input, or output left in the context when the buffer is full. */
+  while (in.pos < in.size || (result != 0 && out.pos == out.size)) {
+    if (out.pos == out.size) {
+      out.size = MAX2(out.size * 2, fd->buffersize * 4);
+      out.dst = out.dst ? MEM_reallocN(out.dst, out.size) : MEM_mallocN(out.size, __func__);
+    }
+    result = ZSTD_decompressStream(ctx, &out, &in);
+    if (ZSTD_isError(result)) {
+      break;
+    }
+  }
+  ZSTD_freeDCtx(ctx);
+
+  /* Non-zero result means the last frame is incomplete. */
+  if (result != 0) {
+    MEM_SAFE_FREE(out.dst);
+    return false;
+  }
+
+  fd->buffer = out.dst;
+  fd->buffersize = out.pos;
+  fd->read = fd_read_from_memory;
+  /* The decompressed buffer is owned by the file data. */
+  fd->flags &= ~FD_FLAGS_NOT_MY_BUFFER;
+
+  return true;
+}
+
 FileData *blo_filedata_from_memory(const void *mem, int memsize, ReportList *reports)
 {
   if (!mem || memsize < SIZEOFBLENDERHEADER) {
@@ -1533,6 +1849,7 @@ FileData *blo_filedata_from_memory(const void *mem, int memsize, ReportList *rep
 
   fd->buffer = mem;
   fd->buffersize = memsize;
+  fd->flags |= FD_FLAGS_NOT_MY_BUFFER;
 
   /* test if gzip */
   if (cp[0] == 0x1f && cp[1] == 0x8b) {
@@ -1541,12 +1858,17 @@ FileData *blo_filedata_from_memory(const void *mem, int memsize, ReportList *rep
       return NULL;
     }
   }
+  else if (zstd_is_compressed_header(cp)) {
+    if (!fd_read_zstd_from_memory_init(fd)) {
+      BKE_report(reports, RPT_WARNING, TIP_("Unable to read"));
+      blo_filedata_free(fd);
+      return NULL;
+    }
+  }
   else {
     fd->read = fd_read_from_memory;
   }
 
-  fd->flags |= FD_FLAGS_NOT_MY_BUFFER;
-
   return blo_decode_and_check(fd, reports);
 }
 
@@ -1559,6 +1881,8 @@ FileData *blo_filedata_from_memfile(MemFile *memfile,
     return NULL;
   }
 
+  BLO_memfile_wait(memfile);
+
   FileData *fd = filedata_new();
   fd->memfile = memfile;
   fd->undo_direction = params->undo_direction;
@@ -1596,6 +1920,11 @@ void blo_filedata_free(FileData *fd)
       fd->mmap_file = NULL;
     }
 
+    if (fd->zstd) {
+      zstd_reader_free(fd->zstd);
+      fd->zstd = NULL;
+    }
+
     /* Free all BHeadN data blocks */
 #ifndef NDEBUG
     BLI_freelistN(&fd->bhead_list);
@@ -1739,6 +2068,17 @@ bool BLO_library_path_explode(const char *path, char *r_dir, char **r_group, cha
   return true;
 }
 
+/**
+ * Check whether the file starts with a valid .blend file header,
+ * decompressing it first when it's compressed with a format supported for reading.
+ */
+bool BLO_file_header_is_blend(const char *filepath)
+{
+  FileData *fd = blo_filedata_from_file_minimal(filepath);
+  blo_filedata_free(fd);
+  return fd != NULL;
+}
+
 /**
  * Does a very light reading of given .blend file to extract its stored thumbnail.
  *
@@ -3865,49 +4205,129 @@ static void do_versions_after_linking(Main *main, ReportList *reports)
 /** \name Read Library Data Block (all)
  * \{ */
 
-static void lib_link_all(FileData *fd, Main *bmain)
+/**
+ * ID types whose lib-linking only remaps ID pointers of their own data (including embedded IDs
+ * and animation data), without modifying other IDs, the Main database or reports. These can be
+ * lib-linked on multiple threads, since the lookups in #FileData.libmap don't modify it.
+ */
+static bool lib_link_id_type_is_thread_safe(const short id_code)
+{
+  switch (id_code) {
+    case ID_AC:
+    case ID_CA:
+    case ID_CU:
+    case ID_HA:
+    case ID_IM:
+    case ID_LA:
+    case ID_LP:
+    case ID_LT:
+    case ID_MA:
+    case ID_MB:
+    case ID_ME:
+    case ID_NT:
+    case ID_PT:
+    case ID_SPK:
+    case ID_TE:
+    case ID_VO:
+    case ID_WO:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static bool lib_link_id_is_needed(FileData *fd, ID *id)
 {
   const bool do_partial_undo = (fd->skip_flags & BLO_READ_SKIP_UNDO_OLD_MAIN) == 0;
 
-  BlendLibReader reader = {fd, bmain};
+  if ((id->tag & LIB_TAG_NEED_LINK) == 0) {
+    /* This ID does not need liblink, just skip to next one. */
+    return false;
+  }
 
-  ID *id;
-  FOREACH_MAIN_ID_BEGIN (bmain, id) {
-    if ((id->tag & LIB_TAG_NEED_LINK) == 0) {
-      /* This ID does not need liblink, just skip to next one. */
-      continue;
-    }
+  if (fd->memfile != NULL && GS(id->name) == ID_WM) {
+    /* No load UI for undo memfiles.
+     * Only WM currently, SCR needs it still (see below), and so does WS? */
+    return false;
+  }
 
-    if (fd->memfile != NULL && GS(id->name) == ID_WM) {
-      /* No load UI for undo memfiles.
-       * Only WM currently, SCR needs it still (see below), and so does WS? */
-      continue;
-    }
+  if (fd->memfile != NULL && do_partial_undo && (id->tag & LIB_TAG_UNDO_OLD_ID_REUSED) != 0) {
+    /* This ID has been re-used from 'old' bmain. Since it was therefore unchanged across
+     * current undo step, and old IDs re-use their old memory address, we do not need to liblink
+     * it at all. */
+    return false;
+  }
 
-    if (fd->memfile != NULL && do_partial_undo && (id->tag & LIB_TAG_UNDO_OLD_ID_REUSED) != 0) {
-      /* This ID has been re-used from 'old' bmain. Since it was therefore unchanged across
-       * current undo step, and old IDs re-use their old memory address, we do not need to liblink
-       * it at all. */
-      continue;
-    }
+  return true;
+}
 
-    lib_link_id(&reader, id);
+static void lib_link_id_full(BlendLibReader *reader, ID *id)
+{
+  lib_link_id(reader, id);
 
-    const IDTypeInfo *id_type = BKE_idtype_get_info_from_id(id);
-    if (id_type->blend_read_lib != NULL) {
-      id_type->blend_read_lib(&reader, id);
-    }
+  const IDTypeInfo *id_type = BKE_idtype_get_info_from_id(id);
+  if (id_type->blend_read_lib != NULL) {
+    id_type->blend_read_lib(reader, id);
+  }
+
+  if (GS(id->name) == ID_LI) {
+    lib_link_library(reader, (Library *)id); /* Only init users. */
+  }
 
-    if (GS(id->name) == ID_LI) {
-      lib_link_library(&reader, (Library *)id); /* Only init users. */
+  id->tag &= ~LIB_TAG_NEED_LINK;
+
+  /* Some data that should be persistent, like the 3DCursor or the tool settings, are
+   * stored in IDs affected by undo, like Scene. So this requires some specific handling. */
+  if (id_type->blend_read_undo_preserve != NULL && id->orig_id != NULL) {
+    id_type->blend_read_undo_preserve(reader, id, id->orig_id);
+  }
+}
+
+typedef struct LibLinkParallelData {
+  BlendLibReader *reader;
+  ID **ids;
+} LibLinkParallelData;
+
+static void lib_link_id_parallel_fn(void *__restrict userdata,
+                                    const int index,
+                                    const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  LibLinkParallelData *data = userdata;
+  lib_link_id_full(data->reader, data->ids[index]);
+}
+
+static void lib_link_all(FileData *fd, Main *bmain)
+{
+  BlendLibReader reader = {fd, bmain};
+
+  /* First lib-link the IDs that can be processed in parallel, then the remaining ones in their
+   * usual order. The remaining types are linked after the types they may depend on anyway. */
+  int ids_len = 0;
+  ID *id;
+  FOREACH_MAIN_ID_BEGIN (bmain, id) {
+    ids_len++;
+  }
+  FOREACH_MAIN_ID_END;
+
+  ID **parallel_ids = MEM_malloc_arrayN(ids_len, sizeof(*parallel_ids), __func__);
+  int parallel_ids_len = 0;
+  FOREACH_MAIN_ID_BEGIN (bmain, id) {
+    if (lib_link_id_is_needed(fd, id) && lib_link_id_type_is_thread_safe(GS(id->name))) {
+      parallel_ids[parallel_ids_len++] = id;
     }
+  }
+  FOREACH_MAIN_ID_END;
 
-    id->tag &= ~LIB_TAG_NEED_LINK;
+  LibLinkParallelData data = {&reader, parallel_ids};
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 16;
+  BLI_task_parallel_range(0, parallel_ids_len, &data, lib_link_id_parallel_fn, &settings);
+  MEM_freeN(parallel_ids);
 
-    /* Some data that should be persistent, like the 3DCursor or the tool settings, are
-     * stored in IDs affected by undo, like Scene. So this requires some specific handling. */
-    if (id_type->blend_read_undo_preserve != NULL && id->orig_id != NULL) {
-      id_type->blend_read_undo_preserve(&reader, id, id->orig_id);
+  FOREACH_MAIN_ID_BEGIN (bmain, id) {
+    if (lib_link_id_is_needed(fd, id)) {
+      lib_link_id_full(&reader, id);
     }
   }
   FOREACH_MAIN_ID_END;
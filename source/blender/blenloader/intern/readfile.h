@@ -64,6 +64,23 @@ enum eFileDataFlag {
 typedef int64_t off64_t;
 #endif
 
+/**
+ * Compressed files are written as a sequence of independent Zstandard frames, each containing
+ * this many bytes of the uncompressed file (except the last one). The frames are followed by a
+ * seek table in the format of the Zstandard "seekable format", so that reading can start at any
+ * frame without decompressing the data before it.
+ */
+#define BLEND_ZSTD_FRAME_SIZE (1 << 20)
+#define BLEND_ZSTD_COMPRESSION_LEVEL 3
+/** Magic number at the start of every Zstandard frame. */
+#define BLEND_ZSTD_FRAME_MAGIC 0xFD2FB528
+/** The seek table is stored in a skippable frame with this magic number. */
+#define BLEND_ZSTD_SEEK_TABLE_MAGIC 0x184D2A5E
+/** Magic number at the end of the seek table footer. */
+#define BLEND_ZSTD_SEEKABLE_MAGIC 0x8F92EAB1
+/** Size of the footer: number of frames, descriptor and magic number. */
+#define BLEND_ZSTD_SEEK_TABLE_FOOTER_SIZE 9
+
 typedef ssize_t(FileDataReadFn)(struct FileData *filedata,
                                 void *buffer,
                                 size_t size,
@@ -97,6 +114,8 @@ typedef struct FileData {
   gzFile gzfiledes;
   /** Gzip stream for memory decompression. */
   z_stream strm;
+  /** Zstandard decompression, see #BLEND_ZSTD_FRAME_SIZE. */
+  struct BlendZstdReader *zstd;
 
   /** Now only in use for library appending. */
   char relabase[FILE_MAX];
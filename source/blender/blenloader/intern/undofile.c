@@ -42,6 +42,8 @@
 
 #include "BLI_blenlib.h"
 #include "BLI_ghash.h"
+#include "BLI_hash_mm2a.h"
+#include "BLI_task.h"
 
 #include "BLO_readfile.h"
 #include "BLO_undofile.h"
@@ -54,18 +56,124 @@
 
 /* **************** support for memory-write, for undo buffers *************** */
 
+/* -------------------------------------------------------------------- */
+/** \name Background Encoding
+ *
+ * Writing the undo step itself has to happen synchronously, since the Main database can be
+ * modified as soon as the undo push is done. Chunks that differ from the chunk at the same
+ * position in the previous step are stored as plain copies at first. Hashing them and sharing the
+ * memory of identical chunks found anywhere in the previous step (e.g. after some data has been
+ * inserted in an ID, shifting all its following chunks) is done in a background task.
+ *
+ * Anything accessing the chunks of a memfile or of its previous step has to call
+ * #BLO_memfile_wait first.
+ * \{ */
+
+typedef struct MemFileEncodeTask {
+  TaskPool *task_pool;
+  MemFile *memfile;
+  /** The previous step, its encode task is always finished. */
+  MemFile *reference_memfile;
+  /** Amount of memory freed by the deduplication, applied to #MemFile.size when waiting. */
+  size_t deduplicated_size;
+} MemFileEncodeTask;
+
+static uint memfile_chunk_hash(const char *buf, size_t size)
+{
+  return BLI_hash_mm2((const unsigned char *)buf, size, 0);
+}
+
+static void memfile_encode_task_run(TaskPool *__restrict UNUSED(pool), void *taskdata)
+{
+  MemFileEncodeTask *task = taskdata;
+  MemFile *memfile = task->memfile;
+  GHash *reference_mapping = task->reference_memfile ?
+                                 task->reference_memfile->chunk_hash_mapping :
+                                 NULL;
+
+  memfile->chunk_hash_mapping = BLI_ghash_new(
+      BLI_ghashutil_inthash_p_simple, BLI_ghashutil_intcmp, __func__);
+
+  LISTBASE_FOREACH (MemFileChunk *, chunk, &memfile->chunks) {
+    /* Identical chunks got the hash of the chunk they share memory with when written. */
+    if (!chunk->is_identical) {
+      chunk->hash = memfile_chunk_hash(chunk->buf, chunk->size);
+
+      MemFileChunk *reference_chunk = reference_mapping ?
+                                          BLI_ghash_lookup(reference_mapping,
+                                                           POINTER_FROM_UINT(chunk->hash)) :
+                                          NULL;
+      if (reference_chunk != NULL && reference_chunk->size == chunk->size &&
+          memcmp(reference_chunk->buf, chunk->buf, chunk->size) == 0) {
+        MEM_freeN((void *)chunk->buf);
+        chunk->buf = reference_chunk->buf;
+        chunk->is_shared = true;
+        task->deduplicated_size += chunk->size;
+      }
+    }
+
+    void **entry;
+    if (!BLI_ghash_ensure_p(memfile->chunk_hash_mapping, POINTER_FROM_UINT(chunk->hash), &entry)) {
+      *entry = chunk;
+    }
+  }
+}
+
+static void memfile_encode_task_start(MemFile *memfile, MemFile *reference_memfile)
+{
+  BLI_assert(memfile->encode_task == NULL);
+
+  MemFileEncodeTask *task = MEM_callocN(sizeof(*task), __func__);
+  task->memfile = memfile;
+  task->reference_memfile = reference_memfile;
+  task->task_pool = BLI_task_pool_create_background(NULL, TASK_PRIORITY_LOW);
+  BLI_task_pool_push(task->task_pool, memfile_encode_task_run, task, false, NULL);
+
+  memfile->encode_task = task;
+}
+
+/**
+ * Wait for the background encoding of the memfile to be finished. Must be called before reading,
+ * modifying or freeing the chunks of the memfile.
+ */
+void BLO_memfile_wait(MemFile *memfile)
+{
+  MemFileEncodeTask *task = memfile->encode_task;
+  if (task == NULL) {
+    return;
+  }
+
+  BLI_task_pool_work_and_wait(task->task_pool);
+  BLI_task_pool_free(task->task_pool);
+
+  BLI_assert(memfile->size >= task->deduplicated_size);
+  memfile->size -= task->deduplicated_size;
+
+  MEM_freeN(task);
+  memfile->encode_task = NULL;
+}
+
+/** \} */
+
 /* not memfile itself */
 void BLO_memfile_free(MemFile *memfile)
 {
   MemFileChunk *chunk;
 
+  BLO_memfile_wait(memfile);
+
   while ((chunk = BLI_pophead(&memfile->chunks))) {
-    if (chunk->is_identical == false) {
+    if (chunk->is_shared == false) {
       MEM_freeN((void *)chunk->buf);
     }
     MEM_freeN(chunk);
   }
   memfile->size = 0;
+
+  if (memfile->chunk_hash_mapping != NULL) {
+    BLI_ghash_free(memfile->chunk_hash_mapping, NULL, NULL);
+    memfile->chunk_hash_mapping = NULL;
+  }
 }
 
 /* to keep list of memfiles consistent, 'first' is always first in list */
@@ -77,22 +185,29 @@ void BLO_memfile_merge(MemFile *first, MemFile *second)
   GHash *buffer_to_second_memchunk = BLI_ghash_new(
       BLI_ghashutil_ptrhash, BLI_ghashutil_ptrcmp, __func__);
 
-  /* First, detect all memchunks in second memfile that are not owned by it. */
+  BLO_memfile_wait(first);
+  BLO_memfile_wait(second);
+
+  /* First, detect all memchunks in second memfile that are not owned by it. Several of them may
+   * share the same buffer. */
   for (MemFileChunk *sc = second->chunks.first; sc != NULL; sc = sc->next) {
-    if (sc->is_identical) {
-      BLI_ghash_insert(buffer_to_second_memchunk, (void *)sc->buf, sc);
+    if (sc->is_shared) {
+      void **entry;
+      if (!BLI_ghash_ensure_p(buffer_to_second_memchunk, (void *)sc->buf, &entry)) {
+        *entry = sc;
+      }
     }
   }
 
   /* Now, check all chunks from first memfile (the one we are removing), and if a memchunk owned by
    * it is also used by the second memfile, transfer the ownership. */
   for (MemFileChunk *fc = first->chunks.first; fc != NULL; fc = fc->next) {
-    if (!fc->is_identical) {
+    if (!fc->is_shared) {
       MemFileChunk *sc = BLI_ghash_lookup(buffer_to_second_memchunk, fc->buf);
       if (sc != NULL) {
-        BLI_assert(sc->is_identical);
-        sc->is_identical = false;
-        fc->is_identical = true;
+        BLI_assert(sc->is_shared);
+        sc->is_shared = false;
+        fc->is_shared = true;
       }
       /* Note that if the second memfile does not use that chunk, we assume that the first one
        * fully owns it without sharing it with any other memfile, and hence it should be freed with
@@ -117,6 +232,10 @@ void BLO_memfile_write_init(MemFileWriteData *mem_data,
                             MemFile *written_memfile,
                             MemFile *reference_memfile)
 {
+  if (reference_memfile != NULL) {
+    BLO_memfile_wait(reference_memfile);
+  }
+
   mem_data->written_memfile = written_memfile;
   mem_data->reference_memfile = reference_memfile;
   mem_data->reference_current_chunk = reference_memfile ? reference_memfile->chunks.first : NULL;
@@ -152,6 +271,8 @@ void BLO_memfile_write_finalize(MemFileWriteData *mem_data)
   if (mem_data->id_session_uuid_mapping != NULL) {
     BLI_ghash_free(mem_data->id_session_uuid_mapping, NULL, NULL);
   }
+
+  memfile_encode_task_start(mem_data->written_memfile, mem_data->reference_memfile);
 }
 
 void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t size)
@@ -163,6 +284,8 @@ void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t s
   curchunk->size = size;
   curchunk->buf = NULL;
   curchunk->is_identical = false;
+  curchunk->is_shared = false;
+  curchunk->hash = 0;
   /* This is unsafe in the sense that an app handler or other code that does not
    * perform an undo push may make changes after the last undo push that
    * will then not be undo. Though it's not entirely clear that is wrong behavior. */
@@ -176,14 +299,16 @@ void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t s
     if (compchunk->size == curchunk->size) {
       if (memcmp(compchunk->buf, buf, size) == 0) {
         curchunk->buf = compchunk->buf;
+        curchunk->hash = compchunk->hash;
         curchunk->is_identical = true;
+        curchunk->is_shared = true;
         compchunk->is_identical_future = true;
       }
     }
     *compchunk_step = compchunk->next;
   }
 
-  /* not equal... */
+  /* not equal, deduplication against other chunks happens in the encode task... */
   if (curchunk->buf == NULL) {
     char *buf_new = MEM_mallocN(size, "Chunk buffer");
     memcpy(buf_new, buf, size);
@@ -241,6 +366,8 @@ bool BLO_memfile_write_file(struct MemFile *memfile, const char *filename)
 #    warning "Symbolic links will be followed on undo save, possibly causing CVE-2008-1103"
 #  endif
 #endif
+  BLO_memfile_wait(memfile);
+
   file = BLI_open(filename, oflags, 0666);
 
   if (file == -1) {
@@ -88,6 +88,8 @@
 #  include <unistd.h> /* FreeBSD, for write() and close(). */
 #endif
 
+#include <zstd.h>
+
 #include "BLI_utildefines.h"
 
 /* allow writefile to use deprecated functionality (for forward compatibility code) */
@@ -101,6 +103,7 @@
 #include "BLI_bitmap.h"
 #include "BLI_blenlib.h"
 #include "BLI_mempool.h"
+#include "BLI_threads.h"
 #include "MEM_guardedalloc.h" /* MEM_freeN */
 
 #include "BKE_blender_version.h"
@@ -147,6 +150,7 @@
 typedef enum {
   WW_WRAP_NONE = 1,
   WW_WRAP_ZLIB,
+  WW_WRAP_ZSTD,
 } eWriteWrapType;
 
 typedef struct WriteWrap WriteWrap;
@@ -163,6 +167,7 @@ struct WriteWrap {
   union {
     int file_handle;
     gzFile gz_handle;
+    struct ZstdWriteWrap *zstd_handle;
   } _user_data;
 };
 
@@ -218,6 +223,189 @@ static size_t ww_write_zlib(WriteWrap *ww, const char *buf, size_t buf_len)
 }
 #undef FILE_HANDLE
 
+/* zstd
+ * The data is split into frames of #BLEND_ZSTD_FRAME_SIZE, which are compressed on multiple
+ * threads and written in order. A seek table at the end of the file allows reading frames
+ * independently, see #zstd_read_seek_table in `readfile.c`. */
+#define FILE_HANDLE(ww) (ww)->_user_data.zstd_handle
+
+typedef struct ZstdWriteBlock {
+  struct ZstdWriteBlock *next, *prev;
+  struct ZstdWriteWrap *zstd;
+  /** Uncompressed data, freed once it is compressed. */
+  void *data;
+  uint32_t size;
+  uint32_t compressed_size;
+  int frame_index;
+} ZstdWriteBlock;
+
+typedef struct ZstdWriteWrap {
+  int file_handle;
+  ListBase threadpool;
+  /** All blocks in the order of the file, kept to write the seek table. */
+  ListBase blocks;
+  /** The oldest block that is still in the thread-pool. */
+  ZstdWriteBlock *first_running_block;
+  int frames_len;
+
+  /** Block that is filled by #ww_write_zstd. */
+  char *buffer;
+  size_t buffer_used_len;
+
+  /** Protects the members below, threads wait for their turn to write their frame. */
+  ThreadMutex mutex;
+  ThreadCondition condition;
+  int next_frame_index;
+  bool error;
+} ZstdWriteWrap;
+
+static void ww_zstd_write_uint32_le(uchar *dst, uint32_t value)
+{
+  dst[0] = (uchar)(value & 0xFF);
+  dst[1] = (uchar)((value >> 8) & 0xFF);
+  dst[2] = (uchar)((value >> 16) & 0xFF);
+  dst[3] = (uchar)((value >> 24) & 0xFF);
+}
+
+static void *ww_zstd_write_task(void *userdata)
+{
+  ZstdWriteBlock *block = userdata;
+  ZstdWriteWrap *zstd = block->zstd;
+
+  const size_t out_buf_len = ZSTD_compressBound(block->size);
+  void *out_buf = MEM_mallocN(out_buf_len, __func__);
+  const size_t out_len = ZSTD_compress(
+      out_buf, out_buf_len, block->data, block->size, BLEND_ZSTD_COMPRESSION_LEVEL);
+  MEM_freeN(block->data);
+  block->data = NULL;
+
+  /* Frames have to be written in order. */
+  BLI_mutex_lock(&zstd->mutex);
+  while (zstd->next_frame_index != block->frame_index) {
+    BLI_condition_wait(&zstd->condition, &zstd->mutex);
+  }
+  if (ZSTD_isError(out_len) || write(zstd->file_handle, out_buf, out_len) != (ssize_t)out_len) {
+    zstd->error = true;
+  }
+  else {
+    block->compressed_size = (uint32_t)out_len;
+  }
+  zstd->next_frame_index++;
+  BLI_condition_notify_all(&zstd->condition);
+  BLI_mutex_unlock(&zstd->mutex);
+
+  MEM_freeN(out_buf);
+  return NULL;
+}
+
+static void ww_zstd_dispatch_block(ZstdWriteWrap *zstd)
+{
+  ZstdWriteBlock *block = MEM_callocN(sizeof(*block), __func__);
+  block->zstd = zstd;
+  block->data = zstd->buffer;
+  block->size = (uint32_t)zstd->buffer_used_len;
+  block->frame_index = zstd->frames_len++;
+  BLI_addtail(&zstd->blocks, block);
+
+  zstd->buffer = MEM_mallocN(BLEND_ZSTD_FRAME_SIZE, __func__);
+  zstd->buffer_used_len = 0;
+
+  if (BLI_available_threads(&zstd->threadpool) == 0) {
+    /* Wait for the oldest block, which can always finish because the blocks before it have been
+     * written already. This also limits the memory used by blocks that wait to be written. */
+    BLI_threadpool_remove(&zstd->threadpool, zstd->first_running_block);
+    zstd->first_running_block = zstd->first_running_block->next;
+  }
+  if (zstd->first_running_block == NULL) {
+    zstd->first_running_block = block;
+  }
+  BLI_threadpool_insert(&zstd->threadpool, block);
+}
+
+static bool ww_open_zstd(WriteWrap *ww, const char *filepath)
+{
+  const int file = BLI_open(filepath, O_BINARY + O_WRONLY + O_CREAT + O_TRUNC, 0666);
+  if (file == -1) {
+    return false;
+  }
+
+  ZstdWriteWrap *zstd = MEM_callocN(sizeof(*zstd), __func__);
+  zstd->file_handle = file;
+  zstd->buffer = MEM_mallocN(BLEND_ZSTD_FRAME_SIZE, __func__);
+  BLI_mutex_init(&zstd->mutex);
+  BLI_condition_init(&zstd->condition);
+  BLI_threadpool_init(&zstd->threadpool, ww_zstd_write_task, BLI_system_thread_count());
+
+  FILE_HANDLE(ww) = zstd;
+  return true;
+}
+
+static bool ww_write_zstd_seek_table(ZstdWriteWrap *zstd)
+{
+  const uint32_t table_size = zstd->frames_len * 8 + BLEND_ZSTD_SEEK_TABLE_FOOTER_SIZE;
+  const size_t data_len = 8 + table_size;
+  uchar *data = MEM_mallocN(data_len, __func__);
+
+  ww_zstd_write_uint32_le(data, BLEND_ZSTD_SEEK_TABLE_MAGIC);
+  ww_zstd_write_uint32_le(data + 4, table_size);
+  uchar *entry = data + 8;
+  LISTBASE_FOREACH (ZstdWriteBlock *, block, &zstd->blocks) {
+    ww_zstd_write_uint32_le(entry, block->compressed_size);
+    ww_zstd_write_uint32_le(entry + 4, block->size);
+    entry += 8;
+  }
+  ww_zstd_write_uint32_le(entry, (uint32_t)zstd->frames_len);
+  /* The descriptor flags that there are no checksums. */
+  entry[4] = 0;
+  ww_zstd_write_uint32_le(entry + 5, BLEND_ZSTD_SEEKABLE_MAGIC);
+
+  const bool success = write(zstd->file_handle, data, data_len) == (ssize_t)data_len;
+  MEM_freeN(data);
+  return success;
+}
+
+static bool ww_close_zstd(WriteWrap *ww)
+{
+  ZstdWriteWrap *zstd = FILE_HANDLE(ww);
+
+  if (zstd->buffer_used_len != 0) {
+    ww_zstd_dispatch_block(zstd);
+  }
+  /* Waits for all blocks to be written. */
+  BLI_threadpool_end(&zstd->threadpool);
+
+  bool success = !zstd->error && ww_write_zstd_seek_table(zstd);
+  success &= close(zstd->file_handle) != -1;
+
+  BLI_freelistN(&zstd->blocks);
+  MEM_freeN(zstd->buffer);
+  BLI_mutex_end(&zstd->mutex);
+  BLI_condition_end(&zstd->condition);
+  MEM_freeN(zstd);
+
+  return success;
+}
+
+static size_t ww_write_zstd(WriteWrap *ww, const char *buf, size_t buf_len)
+{
+  ZstdWriteWrap *zstd = FILE_HANDLE(ww);
+
+  size_t written_len = 0;
+  while (written_len < buf_len) {
+    const size_t copy_len = MIN2(buf_len - written_len,
+                                 BLEND_ZSTD_FRAME_SIZE - zstd->buffer_used_len);
+    memcpy(zstd->buffer + zstd->buffer_used_len, buf + written_len, copy_len);
+    zstd->buffer_used_len += copy_len;
+    written_len += copy_len;
+
+    if (zstd->buffer_used_len == BLEND_ZSTD_FRAME_SIZE) {
+      ww_zstd_dispatch_block(zstd);
+    }
+  }
+  return buf_len;
+}
+#undef FILE_HANDLE
+
 /* --- end compression types --- */
 
 static void ww_handle_init(eWriteWrapType ww_type, WriteWrap *r_ww)
@@ -232,6 +420,13 @@ static void ww_handle_init(eWriteWrapType ww_type, WriteWrap *r_ww)
       r_ww->use_buf = false;
       break;
     }
+    case WW_WRAP_ZSTD: {
+      r_ww->open = ww_open_zstd;
+      r_ww->close = ww_close_zstd;
+      r_ww->write = ww_write_zstd;
+      r_ww->use_buf = false;
+      break;
+    }
     default: {
       r_ww->open = ww_open_none;
       r_ww->close = ww_close_none;
@@ -1149,7 +1344,7 @@ bool BLO_write_file(Main *mainvar,
   BLI_snprintf(tempname, sizeof(tempname), "%s@", filepath);
 
   if (write_flags & G_FILE_COMPRESS) {
-    ww_type = WW_WRAP_ZLIB;
+    ww_type = WW_WRAP_ZSTD;
   }
   else {
     ww_type = WW_WRAP_NONE;
@@ -1225,9 +1420,12 @@ bool BLO_write_file(Main *mainvar,
   }
 
   /* actual file writing */
-  const bool err = write_file_handle(mainvar, &ww, NULL, NULL, write_flags, use_userdef, thumb);
+  bool err = write_file_handle(mainvar, &ww, NULL, NULL, write_flags, use_userdef, thumb);
 
-  ww.close(&ww);
+  /* Compressed data may only be written when closing. */
+  if (ww.close(&ww) == false) {
+    err = true;
+  }
 
   if (UNLIKELY(path_list_backup)) {
     BKE_bpath_list_restore(mainvar, path_list_flag, path_list_backup);
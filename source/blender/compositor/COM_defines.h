@@ -58,6 +58,18 @@ typedef enum CompositorPriority {
   COM_PRIORITY_LOW = 0,
 } CompositorPriority;
 
+/**
+ * \brief Possible execution models of the compositor
+ * \see CompositorContext.get_execution_model
+ * \ingroup Execution
+ */
+typedef enum eExecutionModel {
+  /** \brief Operations are executed per chunk, output chunks are shown as soon as possible */
+  COM_EM_TILED = 0,
+  /** \brief Operations are executed one by one over their full area, from inputs to outputs */
+  COM_EM_FULL_FRAME = 1,
+} eExecutionModel;
+
 // configurable items
 
 // chunk size determination
@@ -268,6 +268,16 @@ class CompositorContext {
     return (this->getbNodeTree()->flag & NTREE_COM_GROUPNODE_BUFFER) != 0;
   }
 
+  /**
+   * \brief Get the execution model chosen in the node tree.
+   */
+  eExecutionModel get_execution_model() const
+  {
+    return this->getbNodeTree()->execution_mode == NTREE_EXECUTION_MODE_FULL_FRAME ?
+               COM_EM_FULL_FRAME :
+               COM_EM_TILED;
+  }
+
   /**
    * \brief Get the render percentage as a factor.
    * The compositor uses a factor i.o. a percentage.
@@ -0,0 +1,444 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#include <functional>
+
+#include "COM_FullFrameExecutionModel.h"
+
+#include "BLI_string.h"
+#include "BLI_task.h"
+
+#include "BLT_translation.h"
+
+#include "COM_BufferOperation.h"
+#include "COM_MemoryBuffer.h"
+#include "COM_NodeOperation.h"
+#include "COM_ReadBufferOperation.h"
+#include "COM_WriteBufferOperation.h"
+
+#include "DNA_scene_types.h"
+
+#ifdef WITH_CXX_GUARDEDALLOC
+#  include "MEM_guardedalloc.h"
+#endif
+
+using blender::Map;
+using blender::Span;
+using blender::Vector;
+
+/** Number of rows calculated by a single task when an operation is split over threads. */
+#define COM_FULL_FRAME_ROWS_PER_TASK 16
+
+FullFrameExecutionModel::FullFrameExecutionModel(const CompositorContext &context,
+                                                 Span<NodeOperation *> operations)
+    : m_context(context), m_operations(operations), m_num_operations_to_render(0)
+{
+}
+
+static NodeOperation *get_input_operation(NodeOperation *operation, int input_idx)
+{
+  NodeOperationInput *input = operation->getInputSocket(input_idx);
+  return input->isConnected() ? &input->getLink()->getOperation() : nullptr;
+}
+
+/**
+ * Operations whose result is needed to calculate \a operation. Besides the linked inputs a
+ * ReadBufferOperation created by a node reads the result of its WriteBufferOperation.
+ */
+static Vector<NodeOperation *> get_dependencies(NodeOperation *operation)
+{
+  Vector<NodeOperation *> dependencies;
+  for (int i = 0; i < operation->getNumberOfInputSockets(); i++) {
+    NodeOperation *input_op = get_input_operation(operation, i);
+    if (input_op) {
+      dependencies.append(input_op);
+    }
+  }
+  if (operation->isReadBufferOperation()) {
+    MemoryProxy *proxy = ((ReadBufferOperation *)operation)->getMemoryProxy();
+    dependencies.append(proxy->getWriteBufferOperation());
+  }
+  return dependencies;
+}
+
+static void get_operation_rect(const NodeOperation *operation, rcti &r_rect)
+{
+  BLI_rcti_init(&r_rect, 0, operation->getWidth(), 0, operation->getHeight());
+}
+
+static bool is_breaked(const bNodeTree *btree)
+{
+  return btree->test_break && btree->test_break(btree->tbh);
+}
+
+struct ExecuteWorkData {
+  const rcti *area;
+  int rows_per_task;
+  const std::function<void(const rcti &)> *work_func;
+};
+
+static void execute_work_fn(void *__restrict userdata,
+                            const int task_index,
+                            const TaskParallelTLS *__restrict /*tls*/)
+{
+  const ExecuteWorkData *data = (const ExecuteWorkData *)userdata;
+  rcti split_area = *data->area;
+  split_area.ymin = data->area->ymin + task_index * data->rows_per_task;
+  split_area.ymax = min(split_area.ymin + data->rows_per_task, data->area->ymax);
+  (*data->work_func)(split_area);
+}
+
+/**
+ * Calls \a work_func for bands of rows of \a area, in parallel unless \a single_threaded.
+ */
+static void execute_work(const rcti &area,
+                         bool single_threaded,
+                         const std::function<void(const rcti &)> &work_func)
+{
+  if (BLI_rcti_is_empty(&area)) {
+    return;
+  }
+  if (single_threaded) {
+    work_func(area);
+    return;
+  }
+
+  ExecuteWorkData data;
+  data.area = &area;
+  data.rows_per_task = COM_FULL_FRAME_ROWS_PER_TASK;
+  data.work_func = &work_func;
+  const int num_tasks = (BLI_rcti_size_y(&area) + data.rows_per_task - 1) / data.rows_per_task;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, num_tasks, &data, execute_work_fn, &settings);
+}
+
+/**
+ * Calculate \a area of an operation that doesn't implement NodeOperation.update_memory_buffer by
+ * sampling it pixel by pixel, the same way the tiled model writes buffers.
+ */
+static void render_area_sampled(NodeOperation *operation, MemoryBuffer *output, const rcti &area)
+{
+  const int num_channels = output->get_num_channels();
+  rcti tile_rect = area;
+  void *tile_data = operation->isComplex() ? operation->initializeTileData(&tile_rect) : nullptr;
+  float color[4];
+  for (int y = area.ymin; y < area.ymax; y++) {
+    float *elem = output->get_elem(area.xmin, y);
+    for (int x = area.xmin; x < area.xmax; x++, elem += num_channels) {
+      if (operation->isComplex()) {
+        operation->read(color, x, y, tile_data);
+      }
+      else {
+        operation->readSampled(color, x, y, COM_PS_NEAREST);
+      }
+      memcpy(elem, color, sizeof(float) * num_channels);
+    }
+    if (operation->isBraked()) {
+      break;
+    }
+  }
+  if (tile_data) {
+    operation->deinitializeTileData(&tile_rect, tile_data);
+  }
+}
+
+Vector<NodeOperation *> FullFrameExecutionModel::get_output_operations(
+    CompositorPriority priority) const
+{
+  Vector<NodeOperation *> outputs;
+  for (NodeOperation *operation : m_operations) {
+    if (operation->isOutputOperation(m_context.isRendering()) &&
+        operation->getRenderPriority() == priority) {
+      outputs.append(operation);
+    }
+  }
+  return outputs;
+}
+
+/**
+ * Area of an output operation to calculate, taking the render and viewer borders into account
+ * like ExecutionGroup.setRenderBorder and ExecutionGroup.setViewerBorder do.
+ */
+void FullFrameExecutionModel::get_output_render_area(NodeOperation *output_op, rcti &r_area) const
+{
+  get_operation_rect(output_op, r_area);
+  const float width = output_op->getWidth();
+  const float height = output_op->getHeight();
+
+  const RenderData *rd = m_context.getRenderData();
+  const bool has_render_border = m_context.isRendering() && (rd->mode & R_BORDER) &&
+                                 !(rd->mode & R_CROP);
+  /* Case when cropping to render border happens is handled in compositor output and render
+   * layer nodes. */
+  if (has_render_border && output_op->isOutputOperation(true) &&
+      !(output_op->isViewerOperation() || output_op->isPreviewOperation() ||
+        output_op->isFileOutputOperation())) {
+    BLI_rcti_init(&r_area,
+                  rd->border.xmin * width,
+                  rd->border.xmax * width,
+                  rd->border.ymin * height,
+                  rd->border.ymax * height);
+  }
+
+  const bNodeTree *btree = m_context.getbNodeTree();
+  const rctf *viewer_border = &btree->viewer_border;
+  const bool has_viewer_border = (btree->flag & NTREE_VIEWER_BORDER) &&
+                                 viewer_border->xmin < viewer_border->xmax &&
+                                 viewer_border->ymin < viewer_border->ymax;
+  if (has_viewer_border &&
+      (output_op->isViewerOperation() || output_op->isPreviewOperation())) {
+    BLI_rcti_init(&r_area,
+                  viewer_border->xmin * width,
+                  viewer_border->xmax * width,
+                  viewer_border->ymin * height,
+                  viewer_border->ymax * height);
+  }
+}
+
+void FullFrameExecutionModel::determine_areas_to_render(NodeOperation *operation,
+                                                        const rcti &area)
+{
+  rcti *render_area = m_areas.lookup_ptr(operation);
+  if (render_area == nullptr) {
+    m_areas.add_new(operation, area);
+  }
+  else if (BLI_rcti_inside_rcti(render_area, &area)) {
+    return;
+  }
+  else if (BLI_rcti_is_empty(render_area)) {
+    *render_area = area;
+  }
+  else {
+    BLI_rcti_union(render_area, &area);
+  }
+
+  for (int i = 0; i < operation->getNumberOfInputSockets(); i++) {
+    NodeOperation *input_op = get_input_operation(operation, i);
+    if (input_op == nullptr) {
+      continue;
+    }
+    rcti input_rect;
+    rcti input_area;
+    get_operation_rect(input_op, input_rect);
+    operation->get_area_of_interest(i, area, input_area);
+    if (!BLI_rcti_isect(&input_area, &input_rect, &input_area)) {
+      BLI_rcti_init(&input_area, 0, 0, 0, 0);
+    }
+    determine_areas_to_render(input_op, input_area);
+  }
+
+  if (operation->isReadBufferOperation()) {
+    NodeOperation *write_op =
+        ((ReadBufferOperation *)operation)->getMemoryProxy()->getWriteBufferOperation();
+    rcti write_area;
+    get_operation_rect(write_op, write_area);
+    determine_areas_to_render(write_op, write_area);
+  }
+}
+
+void FullFrameExecutionModel::determine_reader_counts()
+{
+  for (NodeOperation *operation : m_areas.keys()) {
+    for (NodeOperation *input_op : get_dependencies(operation)) {
+      m_readers_left.lookup_or_add(input_op, 0)++;
+    }
+  }
+}
+
+void FullFrameExecutionModel::execute()
+{
+  const bNodeTree *btree = m_context.getbNodeTree();
+  btree->stats_draw(btree->sdh, TIP_("Compositing | Determining areas to render"));
+
+  const CompositorPriority priorities[] = {
+      COM_PRIORITY_HIGH, COM_PRIORITY_MEDIUM, COM_PRIORITY_LOW};
+  const int num_priorities = m_context.isFastCalculation() ? 1 : ARRAY_SIZE(priorities);
+
+  Vector<NodeOperation *> outputs;
+  for (int i = 0; i < num_priorities; i++) {
+    outputs.extend(get_output_operations(priorities[i]));
+  }
+  for (NodeOperation *output_op : outputs) {
+    rcti area;
+    get_output_render_area(output_op, area);
+    determine_areas_to_render(output_op, area);
+  }
+  determine_reader_counts();
+  m_num_operations_to_render = m_areas.size();
+
+  for (NodeOperation *output_op : outputs) {
+    render_operation_and_inputs(output_op);
+    if (is_breaked(btree)) {
+      break;
+    }
+  }
+
+  /* Clean up after a break, when not every result has been read. */
+  for (MemoryBuffer *buffer : m_buffers.values()) {
+    delete buffer;
+  }
+  m_buffers.clear();
+  for (NodeOperation *operation : m_rendered) {
+    if (operation->isWriteBufferOperation() && m_readers_left.lookup_default(operation, 0) > 0) {
+      operation->deinitExecution();
+    }
+  }
+}
+
+void FullFrameExecutionModel::render_operation_and_inputs(NodeOperation *operation)
+{
+  if (m_rendered.contains(operation)) {
+    return;
+  }
+
+  for (NodeOperation *input_op : get_dependencies(operation)) {
+    render_operation_and_inputs(input_op);
+    if (!m_rendered.contains(input_op)) {
+      /* Execution has been canceled. */
+      return;
+    }
+  }
+  if (is_breaked(m_context.getbNodeTree())) {
+    return;
+  }
+
+  render_operation(operation);
+  m_rendered.add_new(operation);
+  update_progress();
+
+  for (NodeOperation *input_op : get_dependencies(operation)) {
+    release_input(input_op);
+  }
+}
+
+void FullFrameExecutionModel::render_operation(NodeOperation *operation)
+{
+  const bNodeTree *btree = m_context.getbNodeTree();
+  const rcti &area = m_areas.lookup(operation);
+
+  /* Make the operation read the results of its inputs instead of calculating them again. */
+  Vector<NodeOperationOutput *> input_links;
+  Vector<BufferOperation *> buffer_ops;
+  Vector<MemoryBuffer *> input_buffers;
+  for (int i = 0; i < operation->getNumberOfInputSockets(); i++) {
+    NodeOperationInput *input = operation->getInputSocket(i);
+    NodeOperationOutput *link = input->getLink();
+    input_links.append(link);
+    if (link == nullptr) {
+      input_buffers.append(nullptr);
+      continue;
+    }
+    NodeOperation *input_op = &link->getOperation();
+    MemoryBuffer *buffer = m_buffers.lookup(input_op);
+    BufferOperation *buffer_op = new BufferOperation(buffer, link->getDataType(), input_op);
+    buffer_op->setbNodeTree(btree);
+    input->setLink(buffer_op->getOutputSocket());
+    buffer_ops.append(buffer_op);
+    input_buffers.append(buffer);
+  }
+
+  if (operation->isReadBufferOperation()) {
+    ((ReadBufferOperation *)operation)->updateMemoryBuffer();
+  }
+  operation->setbNodeTree(btree);
+  operation->initExecution();
+
+  const bool single_threaded = operation->isSingleThreaded();
+  if (operation->getNumberOfOutputSockets() == 0) {
+    /* Output and write buffer operations store their results themselves. */
+    execute_work(area, single_threaded, [=](const rcti &split_area) {
+      rcti rect = split_area;
+      operation->executeRegion(&rect, 0);
+    });
+    if (operation->isOutputOperation(m_context.isRendering())) {
+      operation->updateDraw();
+    }
+  }
+  else {
+    rcti rect;
+    get_operation_rect(operation, rect);
+    if (BLI_rcti_is_empty(&rect)) {
+      BLI_rcti_init(&rect, 0, 1, 0, 1);
+    }
+    MemoryBuffer *output = new MemoryBuffer(operation->getOutputSocket()->getDataType(), &rect);
+    if (!BLI_rcti_compare(&rect, &area)) {
+      output->clear();
+    }
+
+    if (operation->is_full_frame_operation()) {
+      Span<MemoryBuffer *> inputs = input_buffers;
+      execute_work(area, single_threaded, [=](const rcti &split_area) {
+        operation->update_memory_buffer(output, split_area, inputs);
+      });
+    }
+    else {
+      execute_work(area, single_threaded, [=](const rcti &split_area) {
+        render_area_sampled(operation, output, split_area);
+      });
+    }
+    output->setCreatedState();
+    m_buffers.add_new(operation, output);
+  }
+
+  /* A write buffer is read through its memory proxy, which is freed on de-initialization. */
+  if (!operation->isWriteBufferOperation()) {
+    operation->deinitExecution();
+  }
+
+  for (int i = 0; i < operation->getNumberOfInputSockets(); i++) {
+    operation->getInputSocket(i)->setLink(input_links[i]);
+  }
+  for (BufferOperation *buffer_op : buffer_ops) {
+    delete buffer_op;
+  }
+}
+
+void FullFrameExecutionModel::release_input(NodeOperation *input_op)
+{
+  int &readers_left = m_readers_left.lookup(input_op);
+  BLI_assert(readers_left > 0);
+  readers_left--;
+  if (readers_left > 0) {
+    return;
+  }
+
+  if (input_op->isWriteBufferOperation()) {
+    input_op->deinitExecution();
+  }
+  else {
+    delete m_buffers.pop(input_op);
+  }
+}
+
+void FullFrameExecutionModel::update_progress()
+{
+  const bNodeTree *btree = m_context.getbNodeTree();
+  const int num_rendered = m_rendered.size();
+  btree->progress(btree->prh, (float)num_rendered / m_num_operations_to_render);
+
+  char buf[128];
+  BLI_snprintf(buf,
+               sizeof(buf),
+               TIP_("Compositing | Operation %i-%i"),
+               num_rendered,
+               m_num_operations_to_render);
+  btree->stats_draw(btree->sdh, buf);
+}
@@ -0,0 +1,81 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#pragma once
+
+#include "BLI_map.hh"
+#include "BLI_rect.h"
+#include "BLI_set.hh"
+#include "BLI_span.hh"
+#include "BLI_vector.hh"
+
+#include "COM_CompositorContext.h"
+#include "COM_defines.h"
+
+#ifdef WITH_CXX_GUARDEDALLOC
+#  include "MEM_guardedalloc.h"
+#endif
+
+class MemoryBuffer;
+class NodeOperation;
+
+/**
+ * \brief Executes operations one at a time over their full area, from the inputs to the outputs.
+ *
+ * In contrast to the tiled model, every operation result is calculated once into a MemoryBuffer
+ * that is shared by all operations reading it. A buffer is freed as soon as its last reader has
+ * been calculated. Operations implementing NodeOperation.update_memory_buffer are calculated
+ * per area, other operations are sampled pixel by pixel from the buffers of their inputs.
+ * \ingroup Execution
+ */
+class FullFrameExecutionModel {
+ private:
+  const CompositorContext &m_context;
+  blender::Span<NodeOperation *> m_operations;
+
+  /** Area that has to be calculated per operation. */
+  blender::Map<NodeOperation *, rcti> m_areas;
+  /** Number of not yet calculated operations reading the result of an operation. */
+  blender::Map<NodeOperation *, int> m_readers_left;
+  /** Results of calculated operations that are still read by other operations. */
+  blender::Map<NodeOperation *, MemoryBuffer *> m_buffers;
+  blender::Set<NodeOperation *> m_rendered;
+
+  int m_num_operations_to_render;
+
+ public:
+  FullFrameExecutionModel(const CompositorContext &context,
+                          blender::Span<NodeOperation *> operations);
+
+  void execute();
+
+ private:
+  blender::Vector<NodeOperation *> get_output_operations(CompositorPriority priority) const;
+  void get_output_render_area(NodeOperation *output_op, rcti &r_area) const;
+  void determine_areas_to_render(NodeOperation *operation, const rcti &area);
+  void determine_reader_counts();
+
+  void render_operation_and_inputs(NodeOperation *operation);
+  void render_operation(NodeOperation *operation);
+  void release_input(NodeOperation *input_op);
+  void update_progress();
+
+#ifdef WITH_CXX_GUARDEDALLOC
+  MEM_CXX_CLASS_ALLOC_FUNCS("COM:FullFrameExecutionModel")
+#endif
+};
@@ -175,6 +175,18 @@ void MemoryBuffer::copyContentFrom(MemoryBuffer *otherBuffer)
   }
 }
 
+void MemoryBuffer::fill(const rcti &area, const float *value)
+{
+  BLI_assert(BLI_rcti_inside_rcti(&this->m_rect, &area));
+  const int row_len = BLI_rcti_size_x(&area);
+  for (int y = area.ymin; y < area.ymax; y++) {
+    float *elem = this->get_elem(area.xmin, y);
+    for (int x = 0; x < row_len; x++, elem += this->m_num_channels) {
+      memcpy(elem, value, sizeof(float) * this->m_num_channels);
+    }
+  }
+}
+
 void MemoryBuffer::writePixel(int x, int y, const float color[4])
 {
   if (x >= this->m_rect.xmin && x < this->m_rect.xmax && y >= this->m_rect.ymin &&
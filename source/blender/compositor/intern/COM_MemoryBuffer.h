@@ -275,6 +275,24 @@ class MemoryBuffer {
     memcpy(result, buffer, sizeof(float) * this->m_num_channels);
   }
 
+  /**
+   * \brief get a pointer to the first channel of the pixel at x, y
+   * \note coordinates are relative to the MemoryProxy, like the rect of this buffer
+   */
+  inline float *get_elem(int x, int y)
+  {
+    BLI_assert(x >= m_rect.xmin && x < m_rect.xmax && y >= m_rect.ymin && y < m_rect.ymax);
+    const int offset = (this->m_width * (y - m_rect.ymin) + (x - m_rect.xmin)) *
+                       this->m_num_channels;
+    return &this->m_buffer[offset];
+  }
+
+  /**
+   * \brief fill every pixel of area with value
+   * \param value: one float per channel of this buffer
+   */
+  void fill(const rcti &area, const float *value);
+
   void writePixel(int x, int y, const float color[4]);
   void addPixel(int x, int y, const float color[4]);
   inline void readBilinear(float *result,
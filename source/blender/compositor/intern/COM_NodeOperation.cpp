@@ -36,6 +36,7 @@ NodeOperation::NodeOperation()
   this->m_height = 0;
   this->m_isResolutionSet = false;
   this->m_openCL = false;
+  this->m_full_frame = false;
   this->m_btree = nullptr;
 }
 
@@ -149,6 +150,19 @@ NodeOperation *NodeOperation::getInputOperation(unsigned int inputSocketIndex)
   return nullptr;
 }
 
+void NodeOperation::get_area_of_interest(int input_idx,
+                                         const rcti &output_area,
+                                         rcti &r_input_area)
+{
+  if (this->is_full_frame_operation()) {
+    r_input_area = output_area;
+    return;
+  }
+
+  NodeOperation *input_op = this->getInputOperation(input_idx);
+  BLI_rcti_init(&r_input_area, 0, input_op->getWidth(), 0, input_op->getHeight());
+}
+
 void NodeOperation::getConnectedInputSockets(Inputs *sockets)
 {
   for (Inputs::const_iterator it = m_inputs.begin(); it != m_inputs.end(); ++it) {
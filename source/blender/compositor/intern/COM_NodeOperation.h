@@ -24,6 +24,7 @@
 
 #include "BLI_math_color.h"
 #include "BLI_math_vector.h"
+#include "BLI_span.hh"
 #include "BLI_threads.h"
 
 #include "COM_MemoryBuffer.h"
@@ -102,6 +103,12 @@ class NodeOperation : public SocketReader {
    */
   bool m_openCL;
 
+  /**
+   * \brief does this operation implement update_memory_buffer.
+   * \see NodeOperation.update_memory_buffer
+   */
+  bool m_full_frame;
+
   /**
    * \brief mutex reference for very special node initializations
    * \note only use when you really know what you are doing.
@@ -245,6 +252,31 @@ class NodeOperation : public SocketReader {
   }
   virtual void deinitExecution();
 
+  /**
+   * \brief calculate the output of this operation for an area, used by the full-frame
+   * execution model.
+   * \note only called when is_full_frame_operation returns true. Can be called from multiple
+   * threads at once with non-overlapping areas.
+   * \param output: buffer covering the whole operation, only area must be written
+   * \param area: the area to calculate
+   * \param inputs: buffers of the input operations, indexed by input socket. They contain at
+   * least the areas requested by get_area_of_interest.
+   */
+  virtual void update_memory_buffer(MemoryBuffer * /*output*/,
+                                    const rcti & /*area*/,
+                                    blender::Span<MemoryBuffer *> /*inputs*/)
+  {
+  }
+
+  /**
+   * \brief get the area of an input that is needed to calculate output_area of this operation
+   * in the full-frame execution model.
+   *
+   * By default operations implementing update_memory_buffer are expected to read their inputs
+   * pixel by pixel, all other operations need their whole inputs.
+   */
+  virtual void get_area_of_interest(int input_idx, const rcti &output_area, rcti &r_input_area);
+
   bool isResolutionSet()
   {
     return this->m_isResolutionSet;
@@ -276,6 +308,16 @@ class NodeOperation : public SocketReader {
     return this->m_complex;
   }
 
+  /**
+   * \brief is this operation calculated by update_memory_buffer in full-frame mode.
+   *
+   * Other operations are calculated by sampling them pixel by pixel, which is slower.
+   */
+  bool is_full_frame_operation() const
+  {
+    return this->m_full_frame;
+  }
+
   virtual bool isSetOperation() const
   {
     return false;
@@ -412,6 +454,14 @@ class NodeOperation : public SocketReader {
     this->m_complex = complex;
   }
 
+  /**
+   * \brief set whether this operation implements update_memory_buffer
+   */
+  void set_full_frame_operation(bool full_frame)
+  {
+    this->m_full_frame = full_frame;
+  }
+
   /**
    * \brief set if this NodeOperation can be scheduled on a OpenCLDevice
    */
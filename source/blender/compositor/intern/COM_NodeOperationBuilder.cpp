@@ -104,8 +104,11 @@ void NodeOperationBuilder::convertToOperations(ExecutionSystem *system)
 
   determineResolutions();
 
-  /* surround complex ops with read/write buffer */
-  add_complex_operation_buffers();
+  /* Surround complex ops with read/write buffer. The full-frame execution model buffers the
+   * output of every operation itself. */
+  if (m_context->get_execution_model() == COM_EM_TILED) {
+    add_complex_operation_buffers();
+  }
 
   /* links not available from here on */
   /* XXX make m_links a local variable to avoid confusion! */
@@ -117,7 +120,9 @@ void NodeOperationBuilder::convertToOperations(ExecutionSystem *system)
   /*sort_operations();*/ /* not needed yet */
 
   /* create execution groups */
-  group_operations();
+  if (m_context->get_execution_model() == COM_EM_TILED) {
+    group_operations();
+  }
 
   /* transfer resulting operations to the system */
   system->set_operations(m_operations, m_groups);
@@ -29,6 +29,19 @@ class ConvertBaseOperation : public NodeOperation {
 
   void initExecution();
   void deinitExecution();
+
+  void update_memory_buffer(MemoryBuffer *output,
+                            const rcti &area,
+                            blender::Span<MemoryBuffer *> inputs);
+
+ protected:
+  /**
+   * Convert a row of len pixels, used by update_memory_buffer. Only operations setting
+   * themselves as full frame operations need to implement it.
+   */
+  virtual void convert_row(float * /*out*/, const float * /*in*/, int /*len*/) const
+  {
+  }
 };
 
 class ConvertValueToColorOperation : public ConvertBaseOperation {
@@ -36,6 +49,9 @@ class ConvertValueToColorOperation : public ConvertBaseOperation {
   ConvertValueToColorOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+
+ protected:
+  void convert_row(float *out, const float *in, int len) const;
 };
 
 class ConvertColorToValueOperation : public ConvertBaseOperation {
@@ -43,6 +59,9 @@ class ConvertColorToValueOperation : public ConvertBaseOperation {
   ConvertColorToValueOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+
+ protected:
+  void convert_row(float *out, const float *in, int len) const;
 };
 
 class ConvertColorToBWOperation : public ConvertBaseOperation {
@@ -50,6 +69,9 @@ class ConvertColorToBWOperation : public ConvertBaseOperation {
   ConvertColorToBWOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+
+ protected:
+  void convert_row(float *out, const float *in, int len) const;
 };
 
 class ConvertColorToVectorOperation : public ConvertBaseOperation {
@@ -57,6 +79,9 @@ class ConvertColorToVectorOperation : public ConvertBaseOperation {
   ConvertColorToVectorOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+
+ protected:
+  void convert_row(float *out, const float *in, int len) const;
 };
 
 class ConvertValueToVectorOperation : public ConvertBaseOperation {
@@ -64,6 +89,9 @@ class ConvertValueToVectorOperation : public ConvertBaseOperation {
   ConvertValueToVectorOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+
+ protected:
+  void convert_row(float *out, const float *in, int len) const;
 };
 
 class ConvertVectorToColorOperation : public ConvertBaseOperation {
@@ -71,6 +99,9 @@ class ConvertVectorToColorOperation : public ConvertBaseOperation {
   ConvertVectorToColorOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+
+ protected:
+  void convert_row(float *out, const float *in, int len) const;
 };
 
 class ConvertVectorToValueOperation : public ConvertBaseOperation {
@@ -78,6 +109,9 @@ class ConvertVectorToValueOperation : public ConvertBaseOperation {
   ConvertVectorToValueOperation();
 
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+
+ protected:
+  void convert_row(float *out, const float *in, int len) const;
 };
 
 class ConvertRGBToYCCOperation : public ConvertBaseOperation {
@@ -21,6 +21,7 @@
 SetColorOperation::SetColorOperation()
 {
   this->addOutputSocket(COM_DT_COLOR);
+  this->set_full_frame_operation(true);
 }
 
 void SetColorOperation::executePixelSampled(float output[4],
@@ -31,6 +32,13 @@ void SetColorOperation::executePixelSampled(float output[4],
   copy_v4_v4(output, this->m_color);
 }
 
+void SetColorOperation::update_memory_buffer(MemoryBuffer *output,
+                                             const rcti &area,
+                                             blender::Span<MemoryBuffer *> /*inputs*/)
+{
+  output->fill(area, this->m_color);
+}
+
 void SetColorOperation::determineResolution(unsigned int resolution[2],
                                             unsigned int preferredResolution[2])
 {
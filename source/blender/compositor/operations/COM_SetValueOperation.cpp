@@ -21,6 +21,7 @@
 SetValueOperation::SetValueOperation()
 {
   this->addOutputSocket(COM_DT_VALUE);
+  this->set_full_frame_operation(true);
 }
 
 void SetValueOperation::executePixelSampled(float output[4],
@@ -31,6 +32,13 @@ void SetValueOperation::executePixelSampled(float output[4],
   output[0] = this->m_value;
 }
 
+void SetValueOperation::update_memory_buffer(MemoryBuffer *output,
+                                             const rcti &area,
+                                             blender::Span<MemoryBuffer *> /*inputs*/)
+{
+  output->fill(area, &this->m_value);
+}
+
 void SetValueOperation::determineResolution(unsigned int resolution[2],
                                             unsigned int preferredResolution[2])
 {
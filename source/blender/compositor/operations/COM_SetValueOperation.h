@@ -47,6 +47,9 @@ class SetValueOperation : public NodeOperation {
    * The inner loop of this operation.
    */
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer(MemoryBuffer *output,
+                            const rcti &area,
+                            blender::Span<MemoryBuffer *> inputs);
   void determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2]);
 
   bool isSetOperation() const
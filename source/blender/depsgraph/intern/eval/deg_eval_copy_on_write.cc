@@ -1072,6 +1072,8 @@ void deg_free_copy_on_write_datablock(ID *id_cow)
   discard_edit_mode_pointers(id_cow);
   BKE_libblock_free_datablock(id_cow, 0);
   BKE_libblock_free_data(id_cow, false);
+  /* Resolved animation paths of other data-blocks may point into the freed data. */
+  BKE_animsys_path_cache_invalidate();
   /* Signal datablock as not being expanded. */
   id_cow->name[0] = '\0';
 }
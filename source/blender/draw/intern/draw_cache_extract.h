@@ -24,6 +24,10 @@
 
 struct TaskGraph;
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /* Vertex Group Selection and display options */
 typedef struct DRW_MeshWeightState {
   int defgroup_active;
@@ -237,6 +241,7 @@ typedef struct MeshBatchCache {
   int tri_len;
   int poly_len;
   int vert_len;
+  int loop_len;
   int mat_len;
   bool is_dirty; /* Instantly invalidates cache, skipping mesh check */
   bool is_editmode;
@@ -260,6 +265,12 @@ typedef struct MeshBatchCache {
   bool no_loose_wire;
 } MeshBatchCache;
 
+/**
+ * Number of elements extracted by one task. Meshes with fewer loops are extracted by a single
+ * task. Only changed by tests, to compare the threaded extraction with a single task.
+ */
+extern int mesh_extract_chunk_size;
+
 void mesh_buffer_cache_create_requested(struct TaskGraph *task_graph,
                                         MeshBatchCache *cache,
                                         MeshBufferCache mbc,
@@ -275,3 +286,7 @@ void mesh_buffer_cache_create_requested(struct TaskGraph *task_graph,
                                         const Scene *scene,
                                         const ToolSettings *ts,
                                         const bool use_hide);
+
+#ifdef __cplusplus
+}
+#endif
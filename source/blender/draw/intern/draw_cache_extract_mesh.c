@@ -763,6 +763,12 @@ typedef void(ExtractFinishFn)(const MeshRenderData *mr,
                               struct MeshBatchCache *cache,
                               void *buffer,
                               void *data);
+typedef void *(ExtractTaskInitFn)(const MeshRenderData *mr,
+                                  void *data,
+                                  const eMRIterType iter_type,
+                                  int start,
+                                  int end);
+typedef void(ExtractTaskFinishFn)(const MeshRenderData *mr, void *data, void *task_data);
 
 typedef struct MeshExtract {
   /** Executed on main thread and return user data for iteration functions. */
@@ -776,6 +782,17 @@ typedef struct MeshExtract {
   ExtractLEdgeMeshFn *iter_ledge_mesh;
   ExtractLVertBMeshFn *iter_lvert_bm;
   ExtractLVertMeshFn *iter_lvert_mesh;
+  /**
+   * Optional, executed on the worker thread of each range when the iterations are split in
+   * several ranges. Returns data of the same type as the user data, given to the iteration
+   * functions of that range instead. Used by extractors that need partial results per range.
+   */
+  ExtractTaskInitFn *task_init;
+  /**
+   * Merge and free the data of a range returned by `task_init`. Called for all ranges in
+   * iteration order after all elements iterations, so the result does not depend on threading.
+   */
+  ExtractTaskFinishFn *task_finish;
   /** Executed on one worker thread after all elements iterations. */
   ExtractFinishFn *finish;
   /** Used to request common data. */
@@ -796,6 +813,81 @@ BLI_INLINE eMRIterType mesh_extract_iter_type(const MeshExtract *ext)
 
 /** \} */
 
+/* ---------------------------------------------------------------------- */
+/** \name Index Buffer Ranges
+ *
+ * Extractors setting elements of an index buffer from several threads each work on a copy of
+ * the #GPUIndexBufBuilder sharing its data. It has to be the first member of their data.
+ * \{ */
+
+static void *extract_elb_task_init(const MeshRenderData *UNUSED(mr),
+                                   void *data,
+                                   const eMRIterType UNUSED(iter_type),
+                                   int UNUSED(start),
+                                   int UNUSED(end))
+{
+  return MEM_dupallocN(data);
+}
+
+static void extract_elb_task_finish(const MeshRenderData *UNUSED(mr), void *data, void *task_data)
+{
+  GPU_indexbuf_join((GPUIndexBufBuilder *)data, (GPUIndexBufBuilder *)task_data);
+  MEM_freeN(task_data);
+}
+
+/* Primitive restart index, as set by #GPU_indexbuf_set_line_restart. */
+#define RESTART_INDEX 0xFFFFFFFF
+
+/**
+ * Set line \a elem to the loops \a l1 and \a l2 when no loop with a higher index than \a l1
+ * set it yet. Several loops set the line of a shared edge: this gives the same result as
+ * iterating them in order on a single thread.
+ */
+BLI_INLINE void extract_elb_line_verts_set_max(GPUIndexBufBuilder *elb,
+                                               uint elem,
+                                               uint l1,
+                                               uint l2)
+{
+  BLI_assert(elb->prim_type == GPU_PRIM_LINES);
+  BLI_assert(l1 != l2);
+  BLI_assert((elem + 1) * 2 <= elb->max_index_len);
+  /* Both indices are swapped at once so a line is never made of two different loops. */
+  uint64_t *line = (uint64_t *)&elb->data[elem * 2];
+  union {
+    uint32_t verts[2];
+    uint64_t line;
+  } line_new = {{l1, l2}}, line_old;
+  line_old.line = *line;
+  /* Lines are never degenerate: equal indices are only found in unset lines. */
+  while ((line_old.verts[0] == line_old.verts[1]) || (line_old.verts[0] < l1)) {
+    const uint64_t line_prev = atomic_cas_uint64(line, line_old.line, line_new.line);
+    if (line_prev == line_old.line) {
+      break;
+    }
+    line_old.line = line_prev;
+  }
+  elb->index_len = MAX2(elb->index_len, (elem + 1) * 2);
+}
+
+/** Point version of #extract_elb_line_verts_set_max. */
+BLI_INLINE void extract_elb_point_vert_set_max(GPUIndexBufBuilder *elb, uint elem, uint l1)
+{
+  BLI_assert(elb->prim_type == GPU_PRIM_POINTS);
+  BLI_assert(elem < elb->max_index_len);
+  uint32_t *point = &elb->data[elem];
+  uint32_t point_old = *point;
+  while (point_old < l1) {
+    const uint32_t point_prev = atomic_cas_uint32(point, point_old, l1);
+    if (point_prev == point_old) {
+      break;
+    }
+    point_old = point_prev;
+  }
+  elb->index_len = MAX2(elb->index_len, elem + 1);
+}
+
+/** \} */
+
 /* ---------------------------------------------------------------------- */
 /** \name Extract Triangles Indices
  * \{ */
@@ -804,6 +896,8 @@ typedef struct MeshExtract_Tri_Data {
   GPUIndexBufBuilder elb;
   int *tri_mat_start;
   int *tri_mat_end;
+  /** Offset from the index of a loop triangle to its index in the buffer, for each polygon. */
+  int *poly_tri_offset;
 } MeshExtract_Tri_Data;
 
 static void *extract_tris_init(const MeshRenderData *mr,
@@ -848,25 +942,53 @@ static void *extract_tris_init(const MeshRenderData *mr,
 
   memcpy(data->tri_mat_end, mat_tri_len, mat_tri_idx_size);
 
+  /* Place the triangles of each polygon in the buffer up-front, so they can be set from any
+   * thread and still be sorted by material in iteration order. */
+  data->poly_tri_offset = MEM_mallocN(sizeof(int) * mr->poly_len, __func__);
+  int *mat_tri_ofs = data->tri_mat_end;
+  int tri_index = 0;
+  if (mr->extract_type == MR_EXTRACT_BMESH) {
+    BMIter iter;
+    BMFace *efa;
+    int f_index;
+    BM_ITER_MESH_INDEX (efa, &iter, mr->bm, BM_FACES_OF_MESH, f_index) {
+      if (!BM_elem_flag_test(efa, BM_ELEM_HIDDEN)) {
+        int mat = min_ii(efa->mat_nr, mr->mat_len - 1);
+        data->poly_tri_offset[f_index] = mat_tri_ofs[mat] - tri_index;
+        mat_tri_ofs[mat] += efa->len - 2;
+      }
+      tri_index += efa->len - 2;
+    }
+  }
+  else {
+    const MPoly *mp = mr->mpoly;
+    for (int mp_index = 0; mp_index < mr->poly_len; mp_index++, mp++) {
+      if (!(mr->use_hide && (mp->flag & ME_HIDE))) {
+        int mat = min_ii(mp->mat_nr, mr->mat_len - 1);
+        data->poly_tri_offset[mp_index] = mat_tri_ofs[mat] - tri_index;
+        mat_tri_ofs[mat] += mp->totloop - 2;
+      }
+      tri_index += mp->totloop - 2;
+    }
+  }
+
   int visible_tri_tot = ofs;
   GPU_indexbuf_init(&data->elb, GPU_PRIM_TRIS, visible_tri_tot, mr->loop_len);
 
   return data;
 }
 
-static void extract_tris_iter_looptri_bm(const MeshRenderData *mr,
+static void extract_tris_iter_looptri_bm(const MeshRenderData *UNUSED(mr),
                                          const struct ExtractTriBMesh_Params *params,
                                          void *_data)
 {
   MeshExtract_Tri_Data *data = _data;
-  const int mat_last = mr->mat_len - 1;
-  EXTRACT_TRIS_LOOPTRI_FOREACH_BM_BEGIN(elt, _elt_index, params)
+  EXTRACT_TRIS_LOOPTRI_FOREACH_BM_BEGIN(elt, elt_index, params)
   {
     if (!BM_elem_flag_test(elt[0]->f, BM_ELEM_HIDDEN)) {
-      int *mat_tri_ofs = data->tri_mat_end;
-      const int mat = min_ii(elt[0]->f->mat_nr, mat_last);
+      const int f_index = BM_elem_index_get(elt[0]->f);
       GPU_indexbuf_set_tri_verts(&data->elb,
-                                 mat_tri_ofs[mat]++,
+                                 elt_index + data->poly_tri_offset[f_index],
                                  BM_elem_index_get(elt[0]),
                                  BM_elem_index_get(elt[1]),
                                  BM_elem_index_get(elt[2]));
@@ -880,15 +1002,15 @@ static void extract_tris_iter_looptri_mesh(const MeshRenderData *mr,
                                            void *_data)
 {
   MeshExtract_Tri_Data *data = _data;
-  const int mat_last = mr->mat_len - 1;
-  EXTRACT_TRIS_LOOPTRI_FOREACH_MESH_BEGIN(mlt, _mlt_index, params)
+  EXTRACT_TRIS_LOOPTRI_FOREACH_MESH_BEGIN(mlt, mlt_index, params)
   {
     const MPoly *mp = &mr->mpoly[mlt->poly];
     if (!(mr->use_hide && (mp->flag & ME_HIDE))) {
-      int *mat_tri_ofs = data->tri_mat_end;
-      const int mat = min_ii(mp->mat_nr, mat_last);
-      GPU_indexbuf_set_tri_verts(
-          &data->elb, mat_tri_ofs[mat]++, mlt->tri[0], mlt->tri[1], mlt->tri[2]);
+      GPU_indexbuf_set_tri_verts(&data->elb,
+                                 mlt_index + data->poly_tri_offset[mlt->poly],
+                                 mlt->tri[0],
+                                 mlt->tri[1],
+                                 mlt->tri[2]);
     }
   }
   EXTRACT_TRIS_LOOPTRI_FOREACH_MESH_END;
@@ -922,6 +1044,7 @@ static void extract_tris_finish(const MeshRenderData *mr,
   }
   MEM_freeN(data->tri_mat_start);
   MEM_freeN(data->tri_mat_end);
+  MEM_freeN(data->poly_tri_offset);
   MEM_freeN(data);
 }
 
@@ -929,9 +1052,11 @@ static const MeshExtract extract_tris = {
     .init = extract_tris_init,
     .iter_looptri_bm = extract_tris_iter_looptri_bm,
     .iter_looptri_mesh = extract_tris_iter_looptri_mesh,
+    .task_init = extract_elb_task_init,
+    .task_finish = extract_elb_task_finish,
     .finish = extract_tris_finish,
     .data_flag = 0,
-    .use_threading = false,
+    .use_threading = true,
 };
 
 /** \} */
@@ -963,10 +1088,10 @@ static void extract_lines_iter_poly_bm(const MeshRenderData *mr,
     l_iter = l_first = BM_FACE_FIRST_LOOP(f)->prev;
     do {
       if (!BM_elem_flag_test(l_iter->e, BM_ELEM_HIDDEN)) {
-        GPU_indexbuf_set_line_verts(elb,
-                                    BM_elem_index_get(l_iter->e),
-                                    BM_elem_index_get(l_iter),
-                                    BM_elem_index_get(l_iter->next));
+        extract_elb_line_verts_set_max(elb,
+                                       BM_elem_index_get(l_iter->e),
+                                       BM_elem_index_get(l_iter),
+                                       BM_elem_index_get(l_iter->next));
       }
       else {
         GPU_indexbuf_set_line_restart(elb, BM_elem_index_get(l_iter->e));
@@ -994,7 +1119,7 @@ static void extract_lines_iter_poly_mesh(const MeshRenderData *mr,
         if (!((mr->use_hide && (med->flag & ME_HIDE)) ||
               ((mr->extract_type == MR_EXTRACT_MAPPED) && (mr->e_origindex) &&
                (mr->e_origindex[ml->e] == ORIGINDEX_NONE)))) {
-          GPU_indexbuf_set_line_verts(elb, ml->e, ml_index, ml_index_next);
+          extract_elb_line_verts_set_max(elb, ml->e, ml_index, ml_index_next);
         }
         else {
           GPU_indexbuf_set_line_restart(elb, ml->e);
@@ -1010,7 +1135,7 @@ static void extract_lines_iter_poly_mesh(const MeshRenderData *mr,
       int ml_index = ml_index_last, ml_index_next = mp->loopstart;
       do {
         const MLoop *ml = &mloop[ml_index];
-        GPU_indexbuf_set_line_verts(elb, ml->e, ml_index, ml_index_next);
+        extract_elb_line_verts_set_max(elb, ml->e, ml_index, ml_index_next);
       } while ((ml_index = ml_index_next++) != ml_index_last);
     }
     EXTRACT_POLY_FOREACH_MESH_END;
@@ -1075,9 +1200,11 @@ static const MeshExtract extract_lines = {
     .iter_poly_mesh = extract_lines_iter_poly_mesh,
     .iter_ledge_bm = extract_lines_iter_ledge_bm,
     .iter_ledge_mesh = extract_lines_iter_ledge_mesh,
+    .task_init = extract_elb_task_init,
+    .task_finish = extract_elb_task_finish,
     .finish = extract_lines_finish,
     .data_flag = 0,
-    .use_threading = false,
+    .use_threading = true,
 };
 /** \} */
 
@@ -1112,9 +1239,11 @@ static const MeshExtract extract_lines_with_lines_loose = {
     .iter_poly_mesh = extract_lines_iter_poly_mesh,
     .iter_ledge_bm = extract_lines_iter_ledge_bm,
     .iter_ledge_mesh = extract_lines_iter_ledge_mesh,
+    .task_init = extract_elb_task_init,
+    .task_finish = extract_elb_task_finish,
     .finish = extract_lines_with_lines_loose_finish,
     .data_flag = 0,
-    .use_threading = false,
+    .use_threading = true,
 };
 
 /** \} */
@@ -1136,7 +1265,7 @@ BLI_INLINE void vert_set_bm(GPUIndexBufBuilder *elb, BMVert *eve, int l_index)
 {
   const int v_index = BM_elem_index_get(eve);
   if (!BM_elem_flag_test(eve, BM_ELEM_HIDDEN)) {
-    GPU_indexbuf_set_point_vert(elb, v_index, l_index);
+    extract_elb_point_vert_set_max(elb, v_index, l_index);
   }
   else {
     GPU_indexbuf_set_point_restart(elb, v_index);
@@ -1152,7 +1281,7 @@ BLI_INLINE void vert_set_mesh(GPUIndexBufBuilder *elb,
   if (!((mr->use_hide && (mv->flag & ME_HIDE)) ||
         ((mr->extract_type == MR_EXTRACT_MAPPED) && (mr->v_origindex) &&
          (mr->v_origindex[v_index] == ORIGINDEX_NONE)))) {
-    GPU_indexbuf_set_point_vert(elb, v_index, l_index);
+    extract_elb_point_vert_set_max(elb, v_index, l_index);
   }
   else {
     GPU_indexbuf_set_point_restart(elb, v_index);
@@ -1246,9 +1375,11 @@ static const MeshExtract extract_points = {
     .iter_ledge_mesh = extract_points_iter_ledge_mesh,
     .iter_lvert_bm = extract_points_iter_lvert_bm,
     .iter_lvert_mesh = extract_points_iter_lvert_mesh,
+    .task_init = extract_elb_task_init,
+    .task_finish = extract_elb_task_finish,
     .finish = extract_points_finish,
     .data_flag = 0,
-    .use_threading = false,
+    .use_threading = true,
 };
 
 /** \} */
@@ -1327,9 +1458,11 @@ static const MeshExtract extract_fdots = {
     .init = extract_fdots_init,
     .iter_poly_bm = extract_fdots_iter_poly_bm,
     .iter_poly_mesh = extract_fdots_iter_poly_mesh,
+    .task_init = extract_elb_task_init,
+    .task_finish = extract_elb_task_finish,
     .finish = extract_fdots_finish,
     .data_flag = 0,
-    .use_threading = false,
+    .use_threading = true,
 };
 
 /** \} */
@@ -1341,19 +1474,71 @@ static const MeshExtract extract_fdots = {
 typedef struct MeshExtract_LinePaintMask_Data {
   GPUIndexBufBuilder elb;
   /** One bit per edge set if face is selected. */
-  BLI_bitmap select_map[0];
+  BLI_bitmap *select_map;
 } MeshExtract_LinePaintMask_Data;
 
 static void *extract_lines_paint_mask_init(const MeshRenderData *mr,
                                            struct MeshBatchCache *UNUSED(cache),
                                            void *UNUSED(buf))
 {
-  size_t bitmap_size = BLI_BITMAP_SIZE(mr->edge_len);
-  MeshExtract_LinePaintMask_Data *data = MEM_callocN(sizeof(*data) + bitmap_size, __func__);
+  MeshExtract_LinePaintMask_Data *data = MEM_callocN(sizeof(*data), __func__);
+  data->select_map = BLI_BITMAP_NEW(mr->edge_len, __func__);
   GPU_indexbuf_init(&data->elb, GPU_PRIM_LINES, mr->edge_len, mr->loop_len);
   return data;
 }
 
+/**
+ * Set the line of an edge from one of its loops. The edge is visible if only one of the loops
+ * is selected, or from the unselected loop with the highest index if none is selected. The line
+ * is swapped atomically as the loops of an edge can be handled by different threads.
+ */
+static void lines_paint_mask_line_set(MeshExtract_LinePaintMask_Data *data,
+                                      const int e_index,
+                                      const bool is_select,
+                                      const uint l1,
+                                      const uint l2)
+{
+  uint64_t *line = (uint64_t *)&data->elb.data[e_index * 2];
+  union {
+    uint32_t verts[2];
+    uint64_t line;
+  } line_new = {{l1, l2}}, line_old;
+  line_old.line = *line;
+
+  if (is_select) {
+    if (BLI_BITMAP_TEST_AND_SET_ATOMIC(data->select_map, e_index)) {
+      /* Hide edge as it has more than 2 selected loop. */
+      line_new.verts[0] = line_new.verts[1] = RESTART_INDEX;
+      while (atomic_cas_uint64(line, line_old.line, line_new.line) != line_old.line) {
+        line_old.line = *line;
+      }
+    }
+    else {
+      /* First selected loop. Set edge visible, overwriting any unselected loop. */
+      while (line_old.verts[0] != RESTART_INDEX) {
+        const uint64_t line_prev = atomic_cas_uint64(line, line_old.line, line_new.line);
+        if (line_prev == line_old.line) {
+          break;
+        }
+        line_old.line = line_prev;
+      }
+    }
+  }
+  else {
+    /* Set these unselected loop only if this edge has no other selected loop. The bit is set
+     * before a selected loop sets its line, so test it after reading the line. */
+    while (!BLI_BITMAP_TEST(data->select_map, e_index) &&
+           ((line_old.verts[0] == line_old.verts[1]) || (line_old.verts[0] < l1))) {
+      const uint64_t line_prev = atomic_cas_uint64(line, line_old.line, line_new.line);
+      if (line_prev == line_old.line) {
+        break;
+      }
+      line_old.line = line_prev;
+    }
+  }
+  data->elb.index_len = MAX2(data->elb.index_len, (uint)(e_index + 1) * 2);
+}
+
 static void extract_lines_paint_mask_iter_poly_mesh(const MeshRenderData *mr,
                                                     const ExtractPolyMesh_Params *params,
                                                     void *_data)
@@ -1369,22 +1554,8 @@ static void extract_lines_paint_mask_iter_poly_mesh(const MeshRenderData *mr,
 
       const int ml_index_last = mp->totloop + mp->loopstart - 1;
       const int ml_index_other = (ml_index == ml_index_last) ? mp->loopstart : (ml_index + 1);
-      if (mp->flag & ME_FACE_SEL) {
-        if (BLI_BITMAP_TEST_AND_SET_ATOMIC(data->select_map, e_index)) {
-          /* Hide edge as it has more than 2 selected loop. */
-          GPU_indexbuf_set_line_restart(&data->elb, e_index);
-        }
-        else {
-          /* First selected loop. Set edge visible, overwriting any unselected loop. */
-          GPU_indexbuf_set_line_verts(&data->elb, e_index, ml_index, ml_index_other);
-        }
-      }
-      else {
-        /* Set these unselected loop only if this edge has no other selected loop. */
-        if (!BLI_BITMAP_TEST(data->select_map, e_index)) {
-          GPU_indexbuf_set_line_verts(&data->elb, e_index, ml_index, ml_index_other);
-        }
-      }
+      lines_paint_mask_line_set(
+          data, e_index, (mp->flag & ME_FACE_SEL) != 0, ml_index, ml_index_other);
     }
     else {
       GPU_indexbuf_set_line_restart(&data->elb, e_index);
@@ -1400,15 +1571,18 @@ static void extract_lines_paint_mask_finish(const MeshRenderData *UNUSED(mr),
   MeshExtract_LinePaintMask_Data *data = _data;
 
   GPU_indexbuf_build_in_place(&data->elb, ibo);
+  MEM_freeN(data->select_map);
   MEM_freeN(data);
 }
 
 static const MeshExtract extract_lines_paint_mask = {
     .init = extract_lines_paint_mask_init,
     .iter_poly_mesh = extract_lines_paint_mask_iter_poly_mesh,
+    .task_init = extract_elb_task_init,
+    .task_finish = extract_elb_task_finish,
     .finish = extract_lines_paint_mask_finish,
     .data_flag = 0,
-    .use_threading = false,
+    .use_threading = true,
 };
 
 /** \} */
@@ -1423,8 +1597,6 @@ typedef struct MeshExtract_LineAdjacency_Data {
   GPUIndexBufBuilder elb;
   EdgeHash *eh;
   bool is_manifold;
-  /* Array to convert vert index to any loop index of this vert. */
-  uint vert_to_loop[0];
 } MeshExtract_LineAdjacency_Data;
 
 static void *extract_lines_adjacency_init(const MeshRenderData *mr,
@@ -1436,69 +1608,91 @@ static void *extract_lines_adjacency_init(const MeshRenderData *mr,
    * Accumulate for all polys and you get : */
   uint tess_edge_len = mr->loop_len + mr->tri_len - mr->poly_len;
 
-  size_t vert_to_loop_size = sizeof(uint) * mr->vert_len;
-
-  MeshExtract_LineAdjacency_Data *data = MEM_callocN(sizeof(*data) + vert_to_loop_size, __func__);
+  MeshExtract_LineAdjacency_Data *data = MEM_callocN(sizeof(*data), __func__);
   GPU_indexbuf_init(&data->elb, GPU_PRIM_LINES_ADJ, tess_edge_len, mr->loop_len);
   data->eh = BLI_edgehash_new_ex(__func__, tess_edge_len);
   data->is_manifold = true;
   return data;
 }
 
-BLI_INLINE void lines_adjacency_triangle(
-    uint v1, uint v2, uint v3, uint l1, uint l2, uint l3, MeshExtract_LineAdjacency_Data *data)
+/**
+ * Get the loops of a triangle edge, encoded as `looptri_index * 3 + edge`.
+ * The first loop is the one opposite to the edge, followed by the loops of the edge.
+ */
+BLI_INLINE void lines_adjacency_edge_loops(const MeshRenderData *mr, int tri_edge, uint r_l[3])
+{
+  const int tri = tri_edge / 3;
+  const int e = tri_edge % 3;
+  for (int i = 0; i < 3; i++) {
+    const int j = (e + 1 + i) % 3;
+    r_l[i] = (mr->extract_type == MR_EXTRACT_BMESH) ?
+                 BM_elem_index_get(mr->edit_bmesh->looptris[tri][j]) :
+                 mr->mlooptri[tri].tri[j];
+  }
+}
+
+BLI_INLINE void lines_adjacency_edge_add(const MeshRenderData *mr,
+                                         MeshExtract_LineAdjacency_Data *data,
+                                         uint v2,
+                                         uint v3,
+                                         int tri_edge)
 {
   GPUIndexBufBuilder *elb = &data->elb;
-  /* Iterate around the triangle's edges. */
-  for (int e = 0; e < 3; e++) {
-    SHIFT3(uint, v3, v2, v1);
-    SHIFT3(uint, l3, l2, l1);
-
-    bool inv_indices = (v2 > v3);
-    void **pval;
-    bool value_is_init = BLI_edgehash_ensure_p(data->eh, v2, v3, &pval);
-    int v_data = POINTER_AS_INT(*pval);
-    if (!value_is_init || v_data == NO_EDGE) {
-      /* Save the winding order inside the sign bit. Because the
-       * Edge-hash sort the keys and we need to compare winding later. */
-      int value = (int)l1 + 1; /* 0 cannot be signed so add one. */
-      *pval = POINTER_FROM_INT((inv_indices) ? -value : value);
-      /* Store loop indices for remaining non-manifold edges. */
-      data->vert_to_loop[v2] = l2;
-      data->vert_to_loop[v3] = l3;
+  bool inv_indices = (v2 > v3);
+  void **pval;
+  bool value_is_init = BLI_edgehash_ensure_p(data->eh, v2, v3, &pval);
+  int v_data = POINTER_AS_INT(*pval);
+  if (!value_is_init || v_data == NO_EDGE) {
+    /* Save the winding order inside the sign bit. Because the
+     * Edge-hash sort the keys and we need to compare winding later. */
+    int value = tri_edge + 1; /* 0 cannot be signed so add one. */
+    *pval = POINTER_FROM_INT((inv_indices) ? -value : value);
+  }
+  else {
+    /* HACK Tag as not used. Prevent overhead of BLI_edgehash_remove. */
+    *pval = POINTER_FROM_INT(NO_EDGE);
+    bool inv_opposite = (v_data < 0);
+    uint l[3], l_opposite[3];
+    lines_adjacency_edge_loops(mr, tri_edge, l);
+    lines_adjacency_edge_loops(mr, abs(v_data) - 1, l_opposite);
+    if (inv_opposite == inv_indices) {
+      /* Don't share edge if triangles have non matching winding. */
+      GPU_indexbuf_add_line_adj_verts(elb, l[0], l[1], l[2], l[0]);
+      GPU_indexbuf_add_line_adj_verts(elb, l_opposite[0], l[1], l[2], l_opposite[0]);
+      data->is_manifold = false;
     }
     else {
-      /* HACK Tag as not used. Prevent overhead of BLI_edgehash_remove. */
-      *pval = POINTER_FROM_INT(NO_EDGE);
-      bool inv_opposite = (v_data < 0);
-      uint l_opposite = (uint)abs(v_data) - 1;
-      /* TODO Make this part thread-safe. */
-      if (inv_opposite == inv_indices) {
-        /* Don't share edge if triangles have non matching winding. */
-        GPU_indexbuf_add_line_adj_verts(elb, l1, l2, l3, l1);
-        GPU_indexbuf_add_line_adj_verts(elb, l_opposite, l2, l3, l_opposite);
-        data->is_manifold = false;
-      }
-      else {
-        GPU_indexbuf_add_line_adj_verts(elb, l1, l2, l3, l_opposite);
-      }
+      GPU_indexbuf_add_line_adj_verts(elb, l[0], l[1], l[2], l_opposite[0]);
     }
   }
 }
 
-static void extract_lines_adjacency_iter_looptri_bm(const MeshRenderData *UNUSED(mr),
+BLI_INLINE void lines_adjacency_triangle(const MeshRenderData *mr,
+                                         uint v1,
+                                         uint v2,
+                                         uint v3,
+                                         int tri,
+                                         MeshExtract_LineAdjacency_Data *data)
+{
+  /* Iterate around the triangle's edges. */
+  for (int e = 0; e < 3; e++) {
+    SHIFT3(uint, v3, v2, v1);
+    lines_adjacency_edge_add(mr, data, v2, v3, tri * 3 + e);
+  }
+}
+
+static void extract_lines_adjacency_iter_looptri_bm(const MeshRenderData *mr,
                                                     const struct ExtractTriBMesh_Params *params,
                                                     void *data)
 {
-  EXTRACT_TRIS_LOOPTRI_FOREACH_BM_BEGIN(elt, _elt_index, params)
+  EXTRACT_TRIS_LOOPTRI_FOREACH_BM_BEGIN(elt, elt_index, params)
   {
     if (!BM_elem_flag_test(elt[0]->f, BM_ELEM_HIDDEN)) {
-      lines_adjacency_triangle(BM_elem_index_get(elt[0]->v),
+      lines_adjacency_triangle(mr,
+                               BM_elem_index_get(elt[0]->v),
                                BM_elem_index_get(elt[1]->v),
                                BM_elem_index_get(elt[2]->v),
-                               BM_elem_index_get(elt[0]),
-                               BM_elem_index_get(elt[1]),
-                               BM_elem_index_get(elt[2]),
+                               elt_index,
                                data);
     }
   }
@@ -1509,23 +1703,73 @@ static void extract_lines_adjacency_iter_looptri_mesh(const MeshRenderData *mr,
                                                       const struct ExtractTriMesh_Params *params,
                                                       void *data)
 {
-  EXTRACT_TRIS_LOOPTRI_FOREACH_MESH_BEGIN(mlt, _mlt_index, params)
+  EXTRACT_TRIS_LOOPTRI_FOREACH_MESH_BEGIN(mlt, mlt_index, params)
   {
     const MPoly *mp = &mr->mpoly[mlt->poly];
     if (!(mr->use_hide && (mp->flag & ME_HIDE))) {
-      lines_adjacency_triangle(mr->mloop[mlt->tri[0]].v,
+      lines_adjacency_triangle(mr,
+                               mr->mloop[mlt->tri[0]].v,
                                mr->mloop[mlt->tri[1]].v,
                                mr->mloop[mlt->tri[2]].v,
-                               mlt->tri[0],
-                               mlt->tri[1],
-                               mlt->tri[2],
+                               mlt_index,
                                data);
     }
   }
   EXTRACT_TRIS_LOOPTRI_FOREACH_MESH_END;
 }
 
-static void extract_lines_adjacency_finish(const MeshRenderData *UNUSED(mr),
+/**
+ * Each range of triangles is matched on its own. The edges left open are then matched with the
+ * other ranges in order, so the result does not depend on the scheduling of the tasks.
+ *
+ * \note Edges shared by two ranges are added when the ranges are merged, so the order of the
+ * primitives differs from the order of a single threaded extraction. It only depends on the size
+ * of the ranges, which is fixed.
+ */
+static void *extract_lines_adjacency_task_init(const MeshRenderData *mr,
+                                               void *UNUSED(data),
+                                               const eMRIterType UNUSED(iter_type),
+                                               int start,
+                                               int end)
+{
+  const uint tri_len = (uint)(min_ii(mr->tri_len, end) - start);
+  MeshExtract_LineAdjacency_Data *task_data = MEM_callocN(sizeof(*task_data), __func__);
+  GPU_indexbuf_init(&task_data->elb, GPU_PRIM_LINES_ADJ, tri_len * 3, mr->loop_len);
+  task_data->eh = BLI_edgehash_new_ex(__func__, tri_len * 3);
+  task_data->is_manifold = true;
+  return task_data;
+}
+
+static void extract_lines_adjacency_task_finish(const MeshRenderData *mr,
+                                                void *_data,
+                                                void *_task_data)
+{
+  MeshExtract_LineAdjacency_Data *data = _data;
+  MeshExtract_LineAdjacency_Data *task_data = _task_data;
+  GPU_indexbuf_add_builder(&data->elb, &task_data->elb);
+  /* Match the edges left open with the previous ranges. */
+  EdgeHashIterator *ehi = BLI_edgehashIterator_new(task_data->eh);
+  for (; !BLI_edgehashIterator_isDone(ehi); BLI_edgehashIterator_step(ehi)) {
+    uint v2, v3;
+    int v_data = POINTER_AS_INT(BLI_edgehashIterator_getValue(ehi));
+    if (v_data != NO_EDGE) {
+      BLI_edgehashIterator_getKey(ehi, &v2, &v3);
+      if (v_data < 0) { /* inv_opposite  */
+        SWAP(uint, v2, v3);
+      }
+      lines_adjacency_edge_add(mr, data, v2, v3, abs(v_data) - 1);
+    }
+  }
+  BLI_edgehashIterator_free(ehi);
+  BLI_edgehash_free(task_data->eh, NULL);
+
+  data->is_manifold = data->is_manifold && task_data->is_manifold;
+
+  MEM_freeN(task_data->elb.data);
+  MEM_freeN(task_data);
+}
+
+static void extract_lines_adjacency_finish(const MeshRenderData *mr,
                                            struct MeshBatchCache *cache,
                                            void *ibo,
                                            void *_data)
@@ -1534,17 +1778,11 @@ static void extract_lines_adjacency_finish(const MeshRenderData *UNUSED(mr),
   /* Create edges for remaining non manifold edges. */
   EdgeHashIterator *ehi = BLI_edgehashIterator_new(data->eh);
   for (; !BLI_edgehashIterator_isDone(ehi); BLI_edgehashIterator_step(ehi)) {
-    uint v2, v3, l1, l2, l3;
     int v_data = POINTER_AS_INT(BLI_edgehashIterator_getValue(ehi));
     if (v_data != NO_EDGE) {
-      BLI_edgehashIterator_getKey(ehi, &v2, &v3);
-      l1 = (uint)abs(v_data) - 1;
-      if (v_data < 0) { /* inv_opposite  */
-        SWAP(uint, v2, v3);
-      }
-      l2 = data->vert_to_loop[v2];
-      l3 = data->vert_to_loop[v3];
-      GPU_indexbuf_add_line_adj_verts(&data->elb, l1, l2, l3, l1);
+      uint l[3];
+      lines_adjacency_edge_loops(mr, abs(v_data) - 1, l);
+      GPU_indexbuf_add_line_adj_verts(&data->elb, l[0], l[1], l[2], l[0]);
       data->is_manifold = false;
     }
   }
@@ -1563,9 +1801,11 @@ static const MeshExtract extract_lines_adjacency = {
     .init = extract_lines_adjacency_init,
     .iter_looptri_bm = extract_lines_adjacency_iter_looptri_bm,
     .iter_looptri_mesh = extract_lines_adjacency_iter_looptri_mesh,
+    .task_init = extract_lines_adjacency_task_init,
+    .task_finish = extract_lines_adjacency_task_finish,
     .finish = extract_lines_adjacency_finish,
     .data_flag = 0,
-    .use_threading = false,
+    .use_threading = true,
 };
 
 /** \} */
@@ -1589,6 +1829,54 @@ static void *extract_edituv_tris_init(const MeshRenderData *mr,
   return data;
 }
 
+/**
+ * Elements are added in order: each range fills its own builder, appended in order when done.
+ * Shared by all the edit UV elements extractors.
+ */
+static void *extract_edituv_elem_task_init(const MeshRenderData *mr,
+                                           void *_data,
+                                           const eMRIterType iter_type,
+                                           int start,
+                                           int end)
+{
+  MeshExtract_EditUvElem_Data *data = _data;
+  MeshExtract_EditUvElem_Data *task_data = MEM_callocN(sizeof(*task_data), __func__);
+  task_data->sync_selection = data->sync_selection;
+  if (iter_type == MR_ITER_LOOPTRI) {
+    end = min_ii(mr->tri_len, end);
+    GPU_indexbuf_init(&task_data->elb, data->elb.prim_type, end - start, mr->loop_len);
+  }
+  else {
+    BLI_assert(iter_type == MR_ITER_POLY);
+    end = min_ii(mr->poly_len, end);
+    /* One element per loop for lines and points. */
+    int loop_len = 0;
+    if (mr->extract_type == MR_EXTRACT_BMESH) {
+      for (int i = start; i < end; i++) {
+        loop_len += mr->bm->ftable[i]->len;
+      }
+    }
+    else {
+      for (int i = start; i < end; i++) {
+        loop_len += mr->mpoly[i].totloop;
+      }
+    }
+    GPU_indexbuf_init(&task_data->elb, data->elb.prim_type, loop_len, mr->loop_len);
+  }
+  return task_data;
+}
+
+static void extract_edituv_elem_task_finish(const MeshRenderData *UNUSED(mr),
+                                            void *_data,
+                                            void *_task_data)
+{
+  MeshExtract_EditUvElem_Data *data = _data;
+  MeshExtract_EditUvElem_Data *task_data = _task_data;
+  GPU_indexbuf_add_builder(&data->elb, &task_data->elb);
+  MEM_freeN(task_data->elb.data);
+  MEM_freeN(task_data);
+}
+
 BLI_INLINE void edituv_tri_add(
     MeshExtract_EditUvElem_Data *data, bool hidden, bool selected, int v1, int v2, int v3)
 {
@@ -1644,9 +1932,11 @@ static const MeshExtract extract_edituv_tris = {
     .init = extract_edituv_tris_init,
     .iter_looptri_bm = extract_edituv_tris_iter_looptri_bm,
     .iter_looptri_mesh = extract_edituv_tris_iter_looptri_mesh,
+    .task_init = extract_edituv_elem_task_init,
+    .task_finish = extract_edituv_elem_task_finish,
     .finish = extract_edituv_tris_finish,
     .data_flag = 0,
-    .use_threading = false,
+    .use_threading = true,
 };
 
 /** \} */
@@ -1721,9 +2011,11 @@ static const MeshExtract extract_edituv_lines = {
     .init = extract_edituv_lines_init,
     .iter_poly_bm = extract_edituv_lines_iter_poly_bm,
     .iter_poly_mesh = extract_edituv_lines_iter_poly_mesh,
+    .task_init = extract_edituv_elem_task_init,
+    .task_finish = extract_edituv_elem_task_finish,
     .finish = extract_edituv_lines_finish,
     .data_flag = 0,
-    .use_threading = false,
+    .use_threading = true,
 };
 
 /** \} */
@@ -1795,9 +2087,11 @@ static const MeshExtract extract_edituv_points = {
     .init = extract_edituv_points_init,
     .iter_poly_bm = extract_edituv_points_iter_poly_bm,
     .iter_poly_mesh = extract_edituv_points_iter_poly_mesh,
+    .task_init = extract_edituv_elem_task_init,
+    .task_finish = extract_edituv_elem_task_finish,
     .finish = extract_edituv_points_finish,
     .data_flag = 0,
-    .use_threading = false,
+    .use_threading = true,
 };
 
 /** \} */
@@ -1889,9 +2183,11 @@ static const MeshExtract extract_edituv_fdots = {
     .init = extract_edituv_fdots_init,
     .iter_poly_bm = extract_edituv_fdots_iter_poly_bm,
     .iter_poly_mesh = extract_edituv_fdots_iter_poly_mesh,
+    .task_init = extract_elb_task_init,
+    .task_finish = extract_elb_task_finish,
     .finish = extract_edituv_fdots_finish,
     .data_flag = 0,
-    .use_threading = false,
+    .use_threading = true,
 };
 
 /** \} */
@@ -2461,6 +2757,15 @@ static const MeshExtract extract_lnor = {
 /** \name Extract UV  layers
  * \{ */
 
+typedef struct MeshExtract_UV_Data {
+  /** Deinterleaved: all the loops of a layer are stored before the next layer. */
+  float (*vbo_data)[2];
+  int layers_len;
+  /** Custom-data offset of each layer (BMesh), or layers data (Mesh). */
+  int cd_ofs[MAX_MTFACE];
+  const MLoopUV *layers[MAX_MTFACE];
+} MeshExtract_UV_Data;
+
 static void *extract_uv_init(const MeshRenderData *mr, struct MeshBatchCache *cache, void *buf)
 {
   GPUVertFormat format = {0};
@@ -2516,39 +2821,70 @@ static void *extract_uv_init(const MeshRenderData *mr, struct MeshBatchCache *ca
   GPU_vertbuf_init_with_format(vbo, &format);
   GPU_vertbuf_data_alloc(vbo, v_len);
 
-  float(*uv_data)[2] = (float(*)[2])GPU_vertbuf_get_data(vbo);
+  MeshExtract_UV_Data *data = MEM_callocN(sizeof(*data), __func__);
+  data->vbo_data = (float(*)[2])GPU_vertbuf_get_data(vbo);
   for (int i = 0; i < MAX_MTFACE; i++) {
     if (uv_layers & (1 << i)) {
       if (mr->extract_type == MR_EXTRACT_BMESH) {
-        int cd_ofs = CustomData_get_n_offset(cd_ldata, CD_MLOOPUV, i);
-        BMIter f_iter;
-        BMFace *efa;
-        BM_ITER_MESH (efa, &f_iter, mr->bm, BM_FACES_OF_MESH) {
-          BMLoop *l_iter, *l_first;
-          l_iter = l_first = BM_FACE_FIRST_LOOP(efa);
-          do {
-            MLoopUV *luv = BM_ELEM_CD_GET_VOID_P(l_iter, cd_ofs);
-            memcpy(uv_data, luv->uv, sizeof(*uv_data));
-            uv_data++;
-          } while ((l_iter = l_iter->next) != l_first);
-        }
+        data->cd_ofs[data->layers_len] = CustomData_get_n_offset(cd_ldata, CD_MLOOPUV, i);
       }
       else {
-        MLoopUV *layer_data = CustomData_get_layer_n(cd_ldata, CD_MLOOPUV, i);
-        for (int ml_index = 0; ml_index < mr->loop_len; ml_index++, uv_data++, layer_data++) {
-          memcpy(uv_data, layer_data->uv, sizeof(*uv_data));
-        }
+        data->layers[data->layers_len] = CustomData_get_layer_n(cd_ldata, CD_MLOOPUV, i);
       }
+      data->layers_len++;
+    }
+  }
+  return data;
+}
+
+static void extract_uv_iter_poly_bm(const MeshRenderData *mr,
+                                    const ExtractPolyBMesh_Params *params,
+                                    void *_data)
+{
+  MeshExtract_UV_Data *data = _data;
+  float(*uv_data)[2] = data->vbo_data;
+  for (int i = 0; i < data->layers_len; i++, uv_data += mr->loop_len) {
+    const int cd_ofs = data->cd_ofs[i];
+    EXTRACT_POLY_AND_LOOP_FOREACH_BM_BEGIN(l, l_index, params, mr)
+    {
+      const MLoopUV *luv = BM_ELEM_CD_GET_VOID_P(l, cd_ofs);
+      copy_v2_v2(uv_data[l_index], luv->uv);
     }
+    EXTRACT_POLY_AND_LOOP_FOREACH_BM_END(l);
   }
+}
 
-  return NULL;
+static void extract_uv_iter_poly_mesh(const MeshRenderData *mr,
+                                      const ExtractPolyMesh_Params *params,
+                                      void *_data)
+{
+  MeshExtract_UV_Data *data = _data;
+  float(*uv_data)[2] = data->vbo_data;
+  for (int i = 0; i < data->layers_len; i++, uv_data += mr->loop_len) {
+    const MLoopUV *layer_data = data->layers[i];
+    EXTRACT_POLY_AND_LOOP_FOREACH_MESH_BEGIN(mp, mp_index, ml, ml_index, params, mr)
+    {
+      copy_v2_v2(uv_data[ml_index], layer_data[ml_index].uv);
+    }
+    EXTRACT_POLY_AND_LOOP_FOREACH_MESH_END;
+  }
+}
+
+static void extract_uv_finish(const MeshRenderData *UNUSED(mr),
+                              struct MeshBatchCache *UNUSED(cache),
+                              void *UNUSED(buf),
+                              void *data)
+{
+  MEM_freeN(data);
 }
 
 static const MeshExtract extract_uv = {
     .init = extract_uv_init,
+    .iter_poly_bm = extract_uv_iter_poly_bm,
+    .iter_poly_mesh = extract_uv_iter_poly_mesh,
+    .finish = extract_uv_finish,
     .data_flag = 0,
-    .use_threading = false,
+    .use_threading = true,
 };
 
 /** \} */
@@ -2557,10 +2893,20 @@ static const MeshExtract extract_uv = {
 /** \name Extract Tangent layers
  * \{ */
 
-static void extract_tan_ex(const MeshRenderData *mr,
-                           struct MeshBatchCache *cache,
-                           GPUVertBuf *vbo,
-                           const bool do_hq)
+typedef struct MeshExtract_Tan_Data {
+  /** Deinterleaved: all the loops of a layer are stored before the next layer. */
+  void *vbo_data;
+  /** Owns the tangent layers. */
+  CustomData loop_data;
+  const float (*layers[MAX_MTFACE + 1])[4];
+  int layers_len;
+  bool do_hq;
+} MeshExtract_Tan_Data;
+
+static MeshExtract_Tan_Data *extract_tan_ex(const MeshRenderData *mr,
+                                            struct MeshBatchCache *cache,
+                                            GPUVertBuf *vbo,
+                                            const bool do_hq)
 {
   GPUVertCompType comp_type = do_hq ? GPU_COMP_I16 : GPU_COMP_I10;
   GPUVertFetchMode fetch_mode = GPU_FETCH_INT_TO_FLOAT_UNIT;
@@ -2683,62 +3029,86 @@ static void extract_tan_ex(const MeshRenderData *mr,
   GPU_vertbuf_init_with_format(vbo, &format);
   GPU_vertbuf_data_alloc(vbo, v_len);
 
-  if (do_hq) {
-    short(*tan_data)[4] = (short(*)[4])GPU_vertbuf_get_data(vbo);
-    for (int i = 0; i < tan_len; i++) {
-      const char *name = tangent_names[i];
-      float(*layer_data)[4] = (float(*)[4])CustomData_get_layer_named(
-          &loop_data, CD_TANGENT, name);
-      for (int ml_index = 0; ml_index < mr->loop_len; ml_index++) {
-        normal_float_to_short_v3(*tan_data, layer_data[ml_index]);
-        (*tan_data)[3] = (layer_data[ml_index][3] > 0.0f) ? SHRT_MAX : SHRT_MIN;
-        tan_data++;
-      }
-    }
-    if (use_orco_tan) {
-      float(*layer_data)[4] = (float(*)[4])CustomData_get_layer_n(&loop_data, CD_TANGENT, 0);
-      for (int ml_index = 0; ml_index < mr->loop_len; ml_index++) {
-        normal_float_to_short_v3(*tan_data, layer_data[ml_index]);
-        (*tan_data)[3] = (layer_data[ml_index][3] > 0.0f) ? SHRT_MAX : SHRT_MIN;
-        tan_data++;
-      }
+  MeshExtract_Tan_Data *data = MEM_callocN(sizeof(*data), __func__);
+  data->vbo_data = GPU_vertbuf_get_data(vbo);
+  data->loop_data = loop_data;
+  data->do_hq = do_hq;
+  for (int i = 0; i < tan_len; i++) {
+    data->layers[data->layers_len++] = CustomData_get_layer_named(
+        &data->loop_data, CD_TANGENT, tangent_names[i]);
+  }
+  if (use_orco_tan) {
+    data->layers[data->layers_len++] = CustomData_get_layer_n(&data->loop_data, CD_TANGENT, 0);
+  }
+  return data;
+}
+
+BLI_INLINE void extract_tan_loop(const MeshExtract_Tan_Data *data,
+                                 const int loop_len,
+                                 const int l_index)
+{
+  if (data->do_hq) {
+    short(*tan_data)[4] = (short(*)[4])data->vbo_data + l_index;
+    for (int i = 0; i < data->layers_len; i++, tan_data += loop_len) {
+      const float *layer_data = data->layers[i][l_index];
+      normal_float_to_short_v3(*tan_data, layer_data);
+      (*tan_data)[3] = (layer_data[3] > 0.0f) ? SHRT_MAX : SHRT_MIN;
     }
   }
   else {
-    GPUPackedNormal *tan_data = (GPUPackedNormal *)GPU_vertbuf_get_data(vbo);
-    for (int i = 0; i < tan_len; i++) {
-      const char *name = tangent_names[i];
-      float(*layer_data)[4] = (float(*)[4])CustomData_get_layer_named(
-          &loop_data, CD_TANGENT, name);
-      for (int ml_index = 0; ml_index < mr->loop_len; ml_index++) {
-        *tan_data = GPU_normal_convert_i10_v3(layer_data[ml_index]);
-        tan_data->w = (layer_data[ml_index][3] > 0.0f) ? 1 : -2;
-        tan_data++;
-      }
-    }
-    if (use_orco_tan) {
-      float(*layer_data)[4] = (float(*)[4])CustomData_get_layer_n(&loop_data, CD_TANGENT, 0);
-      for (int ml_index = 0; ml_index < mr->loop_len; ml_index++) {
-        *tan_data = GPU_normal_convert_i10_v3(layer_data[ml_index]);
-        tan_data->w = (layer_data[ml_index][3] > 0.0f) ? 1 : -2;
-        tan_data++;
-      }
+    GPUPackedNormal *tan_data = (GPUPackedNormal *)data->vbo_data + l_index;
+    for (int i = 0; i < data->layers_len; i++, tan_data += loop_len) {
+      const float *layer_data = data->layers[i][l_index];
+      *tan_data = GPU_normal_convert_i10_v3(layer_data);
+      tan_data->w = (layer_data[3] > 0.0f) ? 1 : -2;
     }
   }
+}
+
+static void extract_tan_iter_poly_bm(const MeshRenderData *mr,
+                                     const ExtractPolyBMesh_Params *params,
+                                     void *data)
+{
+  EXTRACT_POLY_AND_LOOP_FOREACH_BM_BEGIN(l, l_index, params, mr)
+  {
+    extract_tan_loop(data, mr->loop_len, l_index);
+  }
+  EXTRACT_POLY_AND_LOOP_FOREACH_BM_END(l);
+}
+
+static void extract_tan_iter_poly_mesh(const MeshRenderData *mr,
+                                       const ExtractPolyMesh_Params *params,
+                                       void *data)
+{
+  EXTRACT_POLY_AND_LOOP_FOREACH_MESH_BEGIN(mp, mp_index, ml, ml_index, params, mr)
+  {
+    extract_tan_loop(data, mr->loop_len, ml_index);
+  }
+  EXTRACT_POLY_AND_LOOP_FOREACH_MESH_END;
+}
 
-  CustomData_free(&loop_data, mr->loop_len);
+static void extract_tan_finish(const MeshRenderData *mr,
+                               struct MeshBatchCache *UNUSED(cache),
+                               void *UNUSED(buf),
+                               void *_data)
+{
+  MeshExtract_Tan_Data *data = _data;
+  CustomData_free(&data->loop_data, mr->loop_len);
+  MEM_freeN(data);
 }
 
 static void *extract_tan_init(const MeshRenderData *mr, struct MeshBatchCache *cache, void *buf)
 {
-  extract_tan_ex(mr, cache, buf, false);
-  return NULL;
+  return extract_tan_ex(mr, cache, buf, false);
 }
 
 static const MeshExtract extract_tan = {
     .init = extract_tan_init,
+    .iter_poly_bm = extract_tan_iter_poly_bm,
+    .iter_poly_mesh = extract_tan_iter_poly_mesh,
+    .finish = extract_tan_finish,
     .data_flag = MR_DATA_POLY_NOR | MR_DATA_TAN_LOOP_NOR | MR_DATA_LOOPTRI,
-    .use_threading = false,
+    .use_threading = true,
 };
 
 /** \} */
@@ -2749,14 +3119,16 @@ static const MeshExtract extract_tan = {
 
 static void *extract_tan_hq_init(const MeshRenderData *mr, struct MeshBatchCache *cache, void *buf)
 {
-  extract_tan_ex(mr, cache, buf, true);
-  return NULL;
+  return extract_tan_ex(mr, cache, buf, true);
 }
 
 static const MeshExtract extract_tan_hq = {
     .init = extract_tan_hq_init,
+    .iter_poly_bm = extract_tan_iter_poly_bm,
+    .iter_poly_mesh = extract_tan_iter_poly_mesh,
+    .finish = extract_tan_finish,
     .data_flag = MR_DATA_POLY_NOR | MR_DATA_TAN_LOOP_NOR | MR_DATA_LOOPTRI,
-    .use_threading = false,
+    .use_threading = true,
 };
 
 /** \} */
@@ -2765,6 +3137,20 @@ static const MeshExtract extract_tan_hq = {
 /** \name Extract Sculpt Data
  * \{ */
 
+typedef struct gpuSculptData {
+  uint8_t face_set_color[4];
+  float mask;
+} gpuSculptData;
+
+typedef struct MeshExtract_SculptData_Data {
+  gpuSculptData *vbo_data;
+  const MLoop *loops;
+  const float *cd_mask;
+  const int *cd_face_set;
+  int cd_mask_ofs;
+  int cd_face_set_ofs;
+} MeshExtract_SculptData_Data;
+
 static void *extract_sculpt_data_init(const MeshRenderData *mr,
                                       struct MeshBatchCache *UNUSED(cache),
                                       void *buf)
@@ -2775,9 +3161,6 @@ static void *extract_sculpt_data_init(const MeshRenderData *mr,
   CustomData *cd_vdata = (mr->extract_type == MR_EXTRACT_BMESH) ? &mr->bm->vdata : &mr->me->vdata;
   CustomData *cd_pdata = (mr->extract_type == MR_EXTRACT_BMESH) ? &mr->bm->pdata : &mr->me->pdata;
 
-  float *cd_mask = CustomData_get_layer(cd_vdata, CD_PAINT_MASK);
-  int *cd_face_set = CustomData_get_layer(cd_pdata, CD_SCULPT_FACE_SETS);
-
   if (format.attr_len == 0) {
     GPU_vertformat_attr_add(&format, "fset", GPU_COMP_U8, 4, GPU_FETCH_INT_TO_FLOAT_UNIT);
     GPU_vertformat_attr_add(&format, "msk", GPU_COMP_F32, 1, GPU_FETCH_FLOAT);
@@ -2787,76 +3170,88 @@ static void *extract_sculpt_data_init(const MeshRenderData *mr,
   GPU_vertbuf_init_with_format(vbo, &format);
   GPU_vertbuf_data_alloc(vbo, mr->loop_len);
 
-  typedef struct gpuSculptData {
-    uint8_t face_set_color[4];
-    float mask;
-  } gpuSculptData;
-
-  gpuSculptData *vbo_data = (gpuSculptData *)GPU_vertbuf_get_data(vbo);
-  MLoop *loops = CustomData_get_layer(cd_ldata, CD_MLOOP);
-
+  MeshExtract_SculptData_Data *data = MEM_callocN(sizeof(*data), __func__);
+  data->vbo_data = (gpuSculptData *)GPU_vertbuf_get_data(vbo);
+  data->loops = CustomData_get_layer(cd_ldata, CD_MLOOP);
+  data->cd_mask = CustomData_get_layer(cd_vdata, CD_PAINT_MASK);
+  data->cd_face_set = CustomData_get_layer(cd_pdata, CD_SCULPT_FACE_SETS);
   if (mr->extract_type == MR_EXTRACT_BMESH) {
-    int cd_mask_ofs = CustomData_get_offset(cd_vdata, CD_PAINT_MASK);
-    int cd_face_set_ofs = CustomData_get_offset(cd_pdata, CD_SCULPT_FACE_SETS);
-    BMIter f_iter;
-    BMFace *efa;
-    BM_ITER_MESH (efa, &f_iter, mr->bm, BM_FACES_OF_MESH) {
-      BMLoop *l_iter, *l_first;
-      l_iter = l_first = BM_FACE_FIRST_LOOP(efa);
-      do {
-        float v_mask = 0.0f;
-        if (cd_mask) {
-          v_mask = BM_ELEM_CD_GET_FLOAT(l_iter->v, cd_mask_ofs);
-        }
-        vbo_data->mask = v_mask;
-        uchar face_set_color[4] = {UCHAR_MAX, UCHAR_MAX, UCHAR_MAX, UCHAR_MAX};
-        if (cd_face_set) {
-          const int face_set_id = BM_ELEM_CD_GET_INT(l_iter->f, cd_face_set_ofs);
-          if (face_set_id != mr->me->face_sets_color_default) {
-            BKE_paint_face_set_overlay_color_get(
-                face_set_id, mr->me->face_sets_color_seed, face_set_color);
-          }
-        }
-        copy_v3_v3_uchar(vbo_data->face_set_color, face_set_color);
-        vbo_data++;
-      } while ((l_iter = l_iter->next) != l_first);
-    }
+    data->cd_mask_ofs = CustomData_get_offset(cd_vdata, CD_PAINT_MASK);
+    data->cd_face_set_ofs = CustomData_get_offset(cd_pdata, CD_SCULPT_FACE_SETS);
   }
-  else {
-    int mp_loop = 0;
-    for (int mp_index = 0; mp_index < mr->poly_len; mp_index++) {
-      const MPoly *p = &mr->mpoly[mp_index];
-      for (int l = 0; l < p->totloop; l++) {
-        float v_mask = 0.0f;
-        if (cd_mask) {
-          v_mask = cd_mask[loops[mp_loop].v];
-        }
-        vbo_data->mask = v_mask;
-
-        uchar face_set_color[4] = {UCHAR_MAX, UCHAR_MAX, UCHAR_MAX, UCHAR_MAX};
-        if (cd_face_set) {
-          const int face_set_id = cd_face_set[mp_index];
-          /* Skip for the default color Face Set to render it white. */
-          if (face_set_id != mr->me->face_sets_color_default) {
-            BKE_paint_face_set_overlay_color_get(
-                face_set_id, mr->me->face_sets_color_seed, face_set_color);
-          }
-        }
-        copy_v3_v3_uchar(vbo_data->face_set_color, face_set_color);
-        mp_loop++;
-        vbo_data++;
-      }
+  return data;
+}
+
+static void sculpt_data_face_set_color_get(const MeshRenderData *mr,
+                                           const int face_set_id,
+                                           uchar r_face_set_color[4])
+{
+  /* Skip for the default color Face Set to render it white. */
+  if (face_set_id != mr->me->face_sets_color_default) {
+    BKE_paint_face_set_overlay_color_get(
+        face_set_id, mr->me->face_sets_color_seed, r_face_set_color);
+  }
+}
+
+static void extract_sculpt_data_iter_poly_bm(const MeshRenderData *mr,
+                                             const ExtractPolyBMesh_Params *params,
+                                             void *_data)
+{
+  MeshExtract_SculptData_Data *data = _data;
+  EXTRACT_POLY_FOREACH_BM_BEGIN(f, f_index, params, mr)
+  {
+    uchar face_set_color[4] = {UCHAR_MAX, UCHAR_MAX, UCHAR_MAX, UCHAR_MAX};
+    if (data->cd_face_set) {
+      sculpt_data_face_set_color_get(
+          mr, BM_ELEM_CD_GET_INT(f, data->cd_face_set_ofs), face_set_color);
     }
+    BMLoop *l_iter, *l_first;
+    l_iter = l_first = BM_FACE_FIRST_LOOP(f);
+    do {
+      gpuSculptData *vbo_data = &data->vbo_data[BM_elem_index_get(l_iter)];
+      vbo_data->mask = data->cd_mask ? BM_ELEM_CD_GET_FLOAT(l_iter->v, data->cd_mask_ofs) : 0.0f;
+      copy_v3_v3_uchar(vbo_data->face_set_color, face_set_color);
+    } while ((l_iter = l_iter->next) != l_first);
   }
+  EXTRACT_POLY_FOREACH_BM_END;
+}
 
-  return NULL;
+static void extract_sculpt_data_iter_poly_mesh(const MeshRenderData *mr,
+                                               const ExtractPolyMesh_Params *params,
+                                               void *_data)
+{
+  MeshExtract_SculptData_Data *data = _data;
+  EXTRACT_POLY_FOREACH_MESH_BEGIN(mp, mp_index, params, mr)
+  {
+    uchar face_set_color[4] = {UCHAR_MAX, UCHAR_MAX, UCHAR_MAX, UCHAR_MAX};
+    if (data->cd_face_set) {
+      sculpt_data_face_set_color_get(mr, data->cd_face_set[mp_index], face_set_color);
+    }
+    const int ml_index_end = mp->loopstart + mp->totloop;
+    for (int ml_index = mp->loopstart; ml_index < ml_index_end; ml_index++) {
+      gpuSculptData *vbo_data = &data->vbo_data[ml_index];
+      vbo_data->mask = data->cd_mask ? data->cd_mask[data->loops[ml_index].v] : 0.0f;
+      copy_v3_v3_uchar(vbo_data->face_set_color, face_set_color);
+    }
+  }
+  EXTRACT_POLY_FOREACH_MESH_END;
+}
+
+static void extract_sculpt_data_finish(const MeshRenderData *UNUSED(mr),
+                                       struct MeshBatchCache *UNUSED(cache),
+                                       void *UNUSED(buf),
+                                       void *data)
+{
+  MEM_freeN(data);
 }
 
 static const MeshExtract extract_sculpt_data = {
     .init = extract_sculpt_data_init,
+    .iter_poly_bm = extract_sculpt_data_iter_poly_bm,
+    .iter_poly_mesh = extract_sculpt_data_iter_poly_mesh,
+    .finish = extract_sculpt_data_finish,
     .data_flag = 0,
-    /* TODO: enable threading. */
-    .use_threading = false,
+    .use_threading = true,
 };
 
 /** \} */
@@ -2865,6 +3260,22 @@ static const MeshExtract extract_sculpt_data = {
 /** \name Extract VCol
  * \{ */
 
+typedef struct gpuMeshVcol {
+  ushort r, g, b, a;
+} gpuMeshVcol;
+
+typedef struct MeshExtract_VCol_Data {
+  /** Deinterleaved: all the loops of a layer are stored before the next layer. */
+  gpuMeshVcol *vbo_data;
+  const MLoop *loops;
+  int layers_len;
+  /** Per layer: loop color (#MLoopCol) or sculpt vertex color (#MPropCol). */
+  bool is_sculpt_vcol[MAX_MCOL * 2];
+  /** Custom-data offset of each layer (BMesh), or layers data (Mesh). */
+  int cd_ofs[MAX_MCOL * 2];
+  const void *layers[MAX_MCOL * 2];
+} MeshExtract_VCol_Data;
+
 static void *extract_vcol_init(const MeshRenderData *mr, struct MeshBatchCache *cache, void *buf)
 {
   GPUVertFormat format = {0};
@@ -2932,79 +3343,117 @@ static void *extract_vcol_init(const MeshRenderData *mr, struct MeshBatchCache *
   GPU_vertbuf_init_with_format(vbo, &format);
   GPU_vertbuf_data_alloc(vbo, mr->loop_len);
 
-  typedef struct gpuMeshVcol {
-    ushort r, g, b, a;
-  } gpuMeshVcol;
-
-  gpuMeshVcol *vcol_data = (gpuMeshVcol *)GPU_vertbuf_get_data(vbo);
-  MLoop *loops = CustomData_get_layer(cd_ldata, CD_MLOOP);
+  MeshExtract_VCol_Data *data = MEM_callocN(sizeof(*data), __func__);
+  data->vbo_data = (gpuMeshVcol *)GPU_vertbuf_get_data(vbo);
+  data->loops = CustomData_get_layer(cd_ldata, CD_MLOOP);
 
   for (int i = 0; i < MAX_MCOL; i++) {
     if (vcol_layers & (1 << i)) {
       if (mr->extract_type == MR_EXTRACT_BMESH) {
-        int cd_ofs = CustomData_get_n_offset(cd_ldata, CD_MLOOPCOL, i);
-        BMIter f_iter;
-        BMFace *efa;
-        BM_ITER_MESH (efa, &f_iter, mr->bm, BM_FACES_OF_MESH) {
-          BMLoop *l_iter, *l_first;
-          l_iter = l_first = BM_FACE_FIRST_LOOP(efa);
-          do {
-            const MLoopCol *mloopcol = BM_ELEM_CD_GET_VOID_P(l_iter, cd_ofs);
-            vcol_data->r = unit_float_to_ushort_clamp(BLI_color_from_srgb_table[mloopcol->r]);
-            vcol_data->g = unit_float_to_ushort_clamp(BLI_color_from_srgb_table[mloopcol->g]);
-            vcol_data->b = unit_float_to_ushort_clamp(BLI_color_from_srgb_table[mloopcol->b]);
-            vcol_data->a = unit_float_to_ushort_clamp(mloopcol->a * (1.0f / 255.0f));
-            vcol_data++;
-          } while ((l_iter = l_iter->next) != l_first);
-        }
+        data->cd_ofs[data->layers_len] = CustomData_get_n_offset(cd_ldata, CD_MLOOPCOL, i);
       }
       else {
-        const MLoopCol *mloopcol = (MLoopCol *)CustomData_get_layer_n(cd_ldata, CD_MLOOPCOL, i);
-        for (int ml_index = 0; ml_index < mr->loop_len; ml_index++, mloopcol++, vcol_data++) {
-          vcol_data->r = unit_float_to_ushort_clamp(BLI_color_from_srgb_table[mloopcol->r]);
-          vcol_data->g = unit_float_to_ushort_clamp(BLI_color_from_srgb_table[mloopcol->g]);
-          vcol_data->b = unit_float_to_ushort_clamp(BLI_color_from_srgb_table[mloopcol->b]);
-          vcol_data->a = unit_float_to_ushort_clamp(mloopcol->a * (1.0f / 255.0f));
-        }
+        data->layers[data->layers_len] = CustomData_get_layer_n(cd_ldata, CD_MLOOPCOL, i);
       }
+      data->layers_len++;
     }
 
     if (svcol_layers & (1 << i) && U.experimental.use_sculpt_vertex_colors) {
       if (mr->extract_type == MR_EXTRACT_BMESH) {
-        int cd_ofs = CustomData_get_n_offset(cd_vdata, CD_PROP_COLOR, i);
-        BMIter f_iter;
-        BMFace *efa;
-        BM_ITER_MESH (efa, &f_iter, mr->bm, BM_FACES_OF_MESH) {
-          BMLoop *l_iter, *l_first;
-          l_iter = l_first = BM_FACE_FIRST_LOOP(efa);
-          do {
-            const MPropCol *prop_col = BM_ELEM_CD_GET_VOID_P(l_iter->v, cd_ofs);
-            vcol_data->r = unit_float_to_ushort_clamp(prop_col->color[0]);
-            vcol_data->g = unit_float_to_ushort_clamp(prop_col->color[1]);
-            vcol_data->b = unit_float_to_ushort_clamp(prop_col->color[2]);
-            vcol_data->a = unit_float_to_ushort_clamp(prop_col->color[3]);
-            vcol_data++;
-          } while ((l_iter = l_iter->next) != l_first);
-        }
+        data->cd_ofs[data->layers_len] = CustomData_get_n_offset(cd_vdata, CD_PROP_COLOR, i);
       }
       else {
-        MPropCol *vcol = CustomData_get_layer_n(cd_vdata, CD_PROP_COLOR, i);
-        for (int ml_index = 0; ml_index < mr->loop_len; ml_index++, vcol_data++) {
-          vcol_data->r = unit_float_to_ushort_clamp(vcol[loops[ml_index].v].color[0]);
-          vcol_data->g = unit_float_to_ushort_clamp(vcol[loops[ml_index].v].color[1]);
-          vcol_data->b = unit_float_to_ushort_clamp(vcol[loops[ml_index].v].color[2]);
-          vcol_data->a = unit_float_to_ushort_clamp(vcol[loops[ml_index].v].color[3]);
-        }
+        data->layers[data->layers_len] = CustomData_get_layer_n(cd_vdata, CD_PROP_COLOR, i);
       }
+      data->is_sculpt_vcol[data->layers_len] = true;
+      data->layers_len++;
     }
   }
-  return NULL;
+  return data;
+}
+
+BLI_INLINE void vcol_from_mloopcol(gpuMeshVcol *vcol_data, const MLoopCol *mloopcol)
+{
+  vcol_data->r = unit_float_to_ushort_clamp(BLI_color_from_srgb_table[mloopcol->r]);
+  vcol_data->g = unit_float_to_ushort_clamp(BLI_color_from_srgb_table[mloopcol->g]);
+  vcol_data->b = unit_float_to_ushort_clamp(BLI_color_from_srgb_table[mloopcol->b]);
+  vcol_data->a = unit_float_to_ushort_clamp(mloopcol->a * (1.0f / 255.0f));
+}
+
+BLI_INLINE void vcol_from_mpropcol(gpuMeshVcol *vcol_data, const MPropCol *prop_col)
+{
+  vcol_data->r = unit_float_to_ushort_clamp(prop_col->color[0]);
+  vcol_data->g = unit_float_to_ushort_clamp(prop_col->color[1]);
+  vcol_data->b = unit_float_to_ushort_clamp(prop_col->color[2]);
+  vcol_data->a = unit_float_to_ushort_clamp(prop_col->color[3]);
+}
+
+static void extract_vcol_iter_poly_bm(const MeshRenderData *mr,
+                                      const ExtractPolyBMesh_Params *params,
+                                      void *_data)
+{
+  MeshExtract_VCol_Data *data = _data;
+  gpuMeshVcol *vcol_data = data->vbo_data;
+  for (int i = 0; i < data->layers_len; i++, vcol_data += mr->loop_len) {
+    const int cd_ofs = data->cd_ofs[i];
+    if (data->is_sculpt_vcol[i]) {
+      EXTRACT_POLY_AND_LOOP_FOREACH_BM_BEGIN(l, l_index, params, mr)
+      {
+        vcol_from_mpropcol(&vcol_data[l_index], BM_ELEM_CD_GET_VOID_P(l->v, cd_ofs));
+      }
+      EXTRACT_POLY_AND_LOOP_FOREACH_BM_END(l);
+    }
+    else {
+      EXTRACT_POLY_AND_LOOP_FOREACH_BM_BEGIN(l, l_index, params, mr)
+      {
+        vcol_from_mloopcol(&vcol_data[l_index], BM_ELEM_CD_GET_VOID_P(l, cd_ofs));
+      }
+      EXTRACT_POLY_AND_LOOP_FOREACH_BM_END(l);
+    }
+  }
+}
+
+static void extract_vcol_iter_poly_mesh(const MeshRenderData *mr,
+                                        const ExtractPolyMesh_Params *params,
+                                        void *_data)
+{
+  MeshExtract_VCol_Data *data = _data;
+  gpuMeshVcol *vcol_data = data->vbo_data;
+  for (int i = 0; i < data->layers_len; i++, vcol_data += mr->loop_len) {
+    if (data->is_sculpt_vcol[i]) {
+      const MPropCol *vcol = data->layers[i];
+      EXTRACT_POLY_AND_LOOP_FOREACH_MESH_BEGIN(mp, mp_index, ml, ml_index, params, mr)
+      {
+        vcol_from_mpropcol(&vcol_data[ml_index], &vcol[data->loops[ml_index].v]);
+      }
+      EXTRACT_POLY_AND_LOOP_FOREACH_MESH_END;
+    }
+    else {
+      const MLoopCol *mloopcol = data->layers[i];
+      EXTRACT_POLY_AND_LOOP_FOREACH_MESH_BEGIN(mp, mp_index, ml, ml_index, params, mr)
+      {
+        vcol_from_mloopcol(&vcol_data[ml_index], &mloopcol[ml_index]);
+      }
+      EXTRACT_POLY_AND_LOOP_FOREACH_MESH_END;
+    }
+  }
+}
+
+static void extract_vcol_finish(const MeshRenderData *UNUSED(mr),
+                                struct MeshBatchCache *UNUSED(cache),
+                                void *UNUSED(buf),
+                                void *data)
+{
+  MEM_freeN(data);
 }
 
 static const MeshExtract extract_vcol = {
     .init = extract_vcol_init,
+    .iter_poly_bm = extract_vcol_iter_poly_bm,
+    .iter_poly_mesh = extract_vcol_iter_poly_mesh,
+    .finish = extract_vcol_finish,
     .data_flag = 0,
-    .use_threading = false,
+    .use_threading = true,
 };
 
 /** \} */
@@ -3194,28 +3643,19 @@ static void extract_edge_fac_iter_poly_mesh(const MeshRenderData *mr,
     EXTRACT_POLY_AND_LOOP_FOREACH_MESH_END;
   }
   else {
+    /* Non-manifold edges are only known once all the loops are counted, they are tagged in
+     * #extract_edge_fac_finish. */
     EXTRACT_POLY_AND_LOOP_FOREACH_MESH_BEGIN(mp, mp_index, ml, ml_index, params, mr)
     {
-      /* Count loop per edge to detect non-manifold. */
-      if (data->edge_loop_count[ml->e] < 3) {
-        data->edge_loop_count[ml->e]++;
-      }
-      if (data->edge_loop_count[ml->e] == 2) {
-        /* Manifold */
-        const int ml_index_last = mp->totloop + mp->loopstart - 1;
-        const int ml_index_other = (ml_index == ml_index_last) ? mp->loopstart : (ml_index + 1);
-        const MLoop *ml_next = &mr->mloop[ml_index_other];
-        const MVert *v1 = &mr->mvert[ml->v];
-        const MVert *v2 = &mr->mvert[ml_next->v];
-        float vnor_f[3];
-        normal_short_to_float_v3(vnor_f, v1->no);
-        float ratio = loop_edge_factor_get(mr->poly_normals[mp_index], v1->co, vnor_f, v2->co);
-        data->vbo_data[ml_index] = ratio * 253 + 1;
-      }
-      else {
-        /* Non-manifold */
-        data->vbo_data[ml_index] = 255;
-      }
+      const int ml_index_last = mp->totloop + mp->loopstart - 1;
+      const int ml_index_other = (ml_index == ml_index_last) ? mp->loopstart : (ml_index + 1);
+      const MLoop *ml_next = &mr->mloop[ml_index_other];
+      const MVert *v1 = &mr->mvert[ml->v];
+      const MVert *v2 = &mr->mvert[ml_next->v];
+      float vnor_f[3];
+      normal_short_to_float_v3(vnor_f, v1->no);
+      float ratio = loop_edge_factor_get(mr->poly_normals[mp_index], v1->co, vnor_f, v2->co);
+      data->vbo_data[ml_index] = ratio * 253 + 1;
     }
     EXTRACT_POLY_AND_LOOP_FOREACH_MESH_END;
   }
@@ -3254,6 +3694,25 @@ static void extract_edge_fac_finish(const MeshRenderData *mr,
 {
   MeshExtract_EdgeFac_Data *data = _data;
 
+  if (!data->use_edge_render) {
+    /* Count loop per edge to detect non-manifold, in order: only the second loop of an edge
+     * keeps its factor. */
+    const MPoly *mp = mr->mpoly;
+    for (int mp_index = 0; mp_index < mr->poly_len; mp_index++, mp++) {
+      const int ml_index_end = mp->loopstart + mp->totloop;
+      for (int ml_index = mp->loopstart; ml_index < ml_index_end; ml_index++) {
+        const uint e_index = mr->mloop[ml_index].e;
+        if (data->edge_loop_count[e_index] < 3) {
+          data->edge_loop_count[e_index]++;
+        }
+        if (data->edge_loop_count[e_index] != 2) {
+          /* Non-manifold */
+          data->vbo_data[ml_index] = 255;
+        }
+      }
+    }
+  }
+
   if (GPU_crappy_amd_driver()) {
     GPUVertBuf *vbo = (GPUVertBuf *)buf;
     /* Some AMD drivers strangely crash with VBO's with a one byte format.
@@ -3289,7 +3748,7 @@ static const MeshExtract extract_edge_fac = {
     .iter_ledge_mesh = extract_edge_fac_iter_ledge_mesh,
     .finish = extract_edge_fac_finish,
     .data_flag = MR_DATA_POLY_NOR,
-    .use_threading = false,
+    .use_threading = true,
 };
 
 /** \} */
@@ -3849,6 +4308,13 @@ static const MeshExtract extract_edituv_data = {
 /** \name Extract Edit UV area stretch
  * \{ */
 
+typedef struct MeshExtract_StretchArea_Data {
+  uint16_t *vbo_data;
+  int uv_ofs;
+  const MLoopUV *uv_data;
+  float tot_area, tot_uv_area;
+} MeshExtract_StretchArea_Data;
+
 static void *extract_stretch_area_init(const MeshRenderData *mr,
                                        struct MeshBatchCache *UNUSED(cache),
                                        void *buf)
@@ -3862,7 +4328,19 @@ static void *extract_stretch_area_init(const MeshRenderData *mr,
   GPU_vertbuf_init_with_format(vbo, &format);
   GPU_vertbuf_data_alloc(vbo, mr->loop_len);
 
-  return NULL;
+  MeshExtract_StretchArea_Data *data = MEM_callocN(sizeof(*data), __func__);
+  data->vbo_data = (uint16_t *)GPU_vertbuf_get_data(vbo);
+  if (mr->extract_type == MR_EXTRACT_BMESH) {
+    data->uv_ofs = CustomData_get_offset(&mr->bm->ldata, CD_MLOOPUV);
+  }
+  else if (mr->extract_type == MR_EXTRACT_MAPPED) {
+    data->uv_data = CustomData_get_layer(&mr->me->ldata, CD_MLOOPUV);
+  }
+  else {
+    /* Should not happen. */
+    BLI_assert(0);
+  }
+  return data;
 }
 
 BLI_INLINE float area_ratio_get(float area, float uvarea)
@@ -3880,89 +4358,92 @@ BLI_INLINE float area_ratio_to_stretch(float ratio, float tot_ratio, float inv_t
   return (ratio > 1.0f) ? (1.0f / ratio) : ratio;
 }
 
-static void mesh_stretch_area_finish(const MeshRenderData *mr,
-                                     struct MeshBatchCache *cache,
-                                     void *buf,
-                                     void *UNUSED(data))
+static void extract_stretch_area_iter_poly_bm(const MeshRenderData *mr,
+                                              const ExtractPolyBMesh_Params *params,
+                                              void *_data)
 {
-  float tot_area = 0.0f, tot_uv_area = 0.0f;
-  float *area_ratio = MEM_mallocN(sizeof(float) * mr->poly_len, __func__);
-
-  if (mr->extract_type == MR_EXTRACT_BMESH) {
-    CustomData *cd_ldata = &mr->bm->ldata;
-    int uv_ofs = CustomData_get_offset(cd_ldata, CD_MLOOPUV);
-
-    BMFace *efa;
-    BMIter f_iter;
-    int f;
-    BM_ITER_MESH_INDEX (efa, &f_iter, mr->bm, BM_FACES_OF_MESH, f) {
-      float area = BM_face_calc_area(efa);
-      float uvarea = BM_face_calc_area_uv(efa, uv_ofs);
-      tot_area += area;
-      tot_uv_area += uvarea;
-      area_ratio[f] = area_ratio_get(area, uvarea);
-    }
-  }
-  else if (mr->extract_type == MR_EXTRACT_MAPPED) {
-    const MLoopUV *uv_data = CustomData_get_layer(&mr->me->ldata, CD_MLOOPUV);
-    const MPoly *mp = mr->mpoly;
-    for (int mp_index = 0; mp_index < mr->poly_len; mp_index++, mp++) {
-      float area = BKE_mesh_calc_poly_area(mp, &mr->mloop[mp->loopstart], mr->mvert);
-      float uvarea = BKE_mesh_calc_poly_uv_area(mp, uv_data);
-      tot_area += area;
-      tot_uv_area += uvarea;
-      area_ratio[mp_index] = area_ratio_get(area, uvarea);
-    }
-  }
-  else {
-    /* Should not happen. */
-    BLI_assert(0);
+  MeshExtract_StretchArea_Data *data = _data;
+  EXTRACT_POLY_FOREACH_BM_BEGIN(f, f_index, params, mr)
+  {
+    float area = BM_face_calc_area(f);
+    float uvarea = BM_face_calc_area_uv(f, data->uv_ofs);
+    data->tot_area += area;
+    data->tot_uv_area += uvarea;
+    const uint16_t poly_stretch = area_ratio_get(area, uvarea) * SHRT_MAX;
+    /* Copy face data for each loop. */
+    BMLoop *l_iter, *l_first;
+    l_iter = l_first = BM_FACE_FIRST_LOOP(f);
+    do {
+      data->vbo_data[BM_elem_index_get(l_iter)] = poly_stretch;
+    } while ((l_iter = l_iter->next) != l_first);
   }
+  EXTRACT_POLY_FOREACH_BM_END;
+}
 
-  cache->tot_area = tot_area;
-  cache->tot_uv_area = tot_uv_area;
-
-  /* Convert in place to avoid an extra allocation */
-  uint16_t *poly_stretch = (uint16_t *)area_ratio;
-  for (int mp_index = 0; mp_index < mr->poly_len; mp_index++) {
-    poly_stretch[mp_index] = area_ratio[mp_index] * SHRT_MAX;
+static void extract_stretch_area_iter_poly_mesh(const MeshRenderData *mr,
+                                                const ExtractPolyMesh_Params *params,
+                                                void *_data)
+{
+  MeshExtract_StretchArea_Data *data = _data;
+  EXTRACT_POLY_FOREACH_MESH_BEGIN(mp, mp_index, params, mr)
+  {
+    float area = BKE_mesh_calc_poly_area(mp, &mr->mloop[mp->loopstart], mr->mvert);
+    float uvarea = BKE_mesh_calc_poly_uv_area(mp, data->uv_data);
+    data->tot_area += area;
+    data->tot_uv_area += uvarea;
+    const uint16_t poly_stretch = area_ratio_get(area, uvarea) * SHRT_MAX;
+    /* Copy face data for each loop. */
+    const int ml_index_end = mp->loopstart + mp->totloop;
+    for (int ml_index = mp->loopstart; ml_index < ml_index_end; ml_index++) {
+      data->vbo_data[ml_index] = poly_stretch;
+    }
   }
+  EXTRACT_POLY_FOREACH_MESH_END;
+}
 
-  /* Copy face data for each loop. */
-  GPUVertBuf *vbo = buf;
-  uint16_t *loop_stretch = (uint16_t *)GPU_vertbuf_get_data(vbo);
+/** Each range sums its own areas, added in order when done. */
+static void *extract_stretch_area_task_init(const MeshRenderData *UNUSED(mr),
+                                            void *data,
+                                            const eMRIterType UNUSED(iter_type),
+                                            int UNUSED(start),
+                                            int UNUSED(end))
+{
+  MeshExtract_StretchArea_Data *task_data = MEM_dupallocN(data);
+  task_data->tot_area = task_data->tot_uv_area = 0.0f;
+  return task_data;
+}
 
-  if (mr->extract_type == MR_EXTRACT_BMESH) {
-    BMFace *efa;
-    BMIter f_iter;
-    int f, l_index = 0;
-    BM_ITER_MESH_INDEX (efa, &f_iter, mr->bm, BM_FACES_OF_MESH, f) {
-      for (int i = 0; i < efa->len; i++, l_index++) {
-        loop_stretch[l_index] = poly_stretch[f];
-      }
-    }
-  }
-  else if (mr->extract_type == MR_EXTRACT_MAPPED) {
-    const MPoly *mp = mr->mpoly;
-    for (int mp_index = 0, l_index = 0; mp_index < mr->poly_len; mp_index++, mp++) {
-      for (int i = 0; i < mp->totloop; i++, l_index++) {
-        loop_stretch[l_index] = poly_stretch[mp_index];
-      }
-    }
-  }
-  else {
-    /* Should not happen. */
-    BLI_assert(0);
-  }
+static void extract_stretch_area_task_finish(const MeshRenderData *UNUSED(mr),
+                                             void *_data,
+                                             void *_task_data)
+{
+  MeshExtract_StretchArea_Data *data = _data;
+  MeshExtract_StretchArea_Data *task_data = _task_data;
+  data->tot_area += task_data->tot_area;
+  data->tot_uv_area += task_data->tot_uv_area;
+  MEM_freeN(task_data);
+}
 
-  MEM_freeN(area_ratio);
+static void mesh_stretch_area_finish(const MeshRenderData *UNUSED(mr),
+                                     struct MeshBatchCache *cache,
+                                     void *UNUSED(buf),
+                                     void *_data)
+{
+  MeshExtract_StretchArea_Data *data = _data;
+  cache->tot_area = data->tot_area;
+  cache->tot_uv_area = data->tot_uv_area;
+  MEM_freeN(data);
 }
 
 static const MeshExtract extract_stretch_area = {
     .init = extract_stretch_area_init,
+    .iter_poly_bm = extract_stretch_area_iter_poly_bm,
+    .iter_poly_mesh = extract_stretch_area_iter_poly_mesh,
+    .task_init = extract_stretch_area_task_init,
+    .task_finish = extract_stretch_area_task_finish,
     .finish = mesh_stretch_area_finish,
     .data_flag = 0,
-    .use_threading = false,
+    .use_threading = true,
 };
 
 /** \} */
@@ -4147,6 +4628,23 @@ static void extract_stretch_angle_iter_poly_mesh(const MeshRenderData *mr,
   EXTRACT_POLY_AND_LOOP_FOREACH_MESH_END;
 }
 
+/** The edge vectors are only kept from one loop to the next, each range needs its own. */
+static void *extract_stretch_angle_task_init(const MeshRenderData *UNUSED(mr),
+                                             void *data,
+                                             const eMRIterType UNUSED(iter_type),
+                                             int UNUSED(start),
+                                             int UNUSED(end))
+{
+  return MEM_dupallocN(data);
+}
+
+static void extract_stretch_angle_task_finish(const MeshRenderData *UNUSED(mr),
+                                              void *UNUSED(data),
+                                              void *task_data)
+{
+  MEM_freeN(task_data);
+}
+
 static void extract_stretch_angle_finish(const MeshRenderData *UNUSED(mr),
                                          struct MeshBatchCache *UNUSED(cache),
                                          void *UNUSED(buf),
@@ -4159,9 +4657,11 @@ static const MeshExtract extract_stretch_angle = {
     .init = extract_stretch_angle_init,
     .iter_poly_bm = extract_stretch_angle_iter_poly_bm,
     .iter_poly_mesh = extract_stretch_angle_iter_poly_mesh,
+    .task_init = extract_stretch_angle_task_init,
+    .task_finish = extract_stretch_angle_task_finish,
     .finish = extract_stretch_angle_finish,
     .data_flag = 0,
-    .use_threading = false,
+    .use_threading = true,
 };
 
 /** \} */
@@ -4213,47 +4713,71 @@ BLI_INLINE float overhang_remap(float fac, float min, float max, float minmax_ir
   return fac;
 }
 
+/** Get the loops of a face, they are stored contiguously. */
+BLI_INLINE void statvis_poly_loops_get(const MeshRenderData *mr,
+                                       const int f_index,
+                                       int *r_l_index,
+                                       int *r_l_len)
+{
+  if (mr->extract_type == MR_EXTRACT_BMESH) {
+    const BMFace *f = BM_face_at_index(mr->bm, f_index);
+    *r_l_index = BM_elem_index_get(BM_FACE_FIRST_LOOP(f));
+    *r_l_len = f->len;
+  }
+  else {
+    const MPoly *mp = &mr->mpoly[f_index];
+    *r_l_index = mp->loopstart;
+    *r_l_len = mp->totloop;
+  }
+}
+
+typedef struct StatVisOverhang_Data {
+  const MeshRenderData *mr;
+  float *r_overhang;
+  float dir[3];
+  float min, max, minmax_irange;
+} StatVisOverhang_Data;
+
+static void statvis_calc_overhang_cb(void *__restrict userdata,
+                                     const int f_index,
+                                     const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const StatVisOverhang_Data *data = userdata;
+  const MeshRenderData *mr = data->mr;
+  const float *no = (mr->extract_type == MR_EXTRACT_BMESH) ?
+                        bm_face_no_get(mr, BM_face_at_index(mr->bm, f_index)) :
+                        mr->poly_normals[f_index];
+  float fac = angle_normalized_v3v3(no, data->dir) / (float)M_PI;
+  fac = overhang_remap(fac, data->min, data->max, data->minmax_irange);
+
+  int l_index, l_len;
+  statvis_poly_loops_get(mr, f_index, &l_index, &l_len);
+  copy_vn_fl(&data->r_overhang[l_index], l_len, fac);
+}
+
 static void statvis_calc_overhang(const MeshRenderData *mr, float *r_overhang)
 {
   const MeshStatVis *statvis = &mr->toolsettings->statvis;
-  const float min = statvis->overhang_min / (float)M_PI;
-  const float max = statvis->overhang_max / (float)M_PI;
-  const char axis = statvis->overhang_axis;
-  BMEditMesh *em = mr->edit_bmesh;
-  BMIter iter;
-  BMesh *bm = em->bm;
-  BMFace *f;
-  float dir[3];
-  const float minmax_irange = 1.0f / (max - min);
+  StatVisOverhang_Data data = {
+      .mr = mr,
+      .r_overhang = r_overhang,
+      .min = statvis->overhang_min / (float)M_PI,
+      .max = statvis->overhang_max / (float)M_PI,
+  };
+  data.minmax_irange = 1.0f / (data.max - data.min);
 
-  BLI_assert(min <= max);
+  BLI_assert(data.min <= data.max);
 
-  axis_from_enum_v3(dir, axis);
+  axis_from_enum_v3(data.dir, statvis->overhang_axis);
 
   /* now convert into global space */
-  mul_transposed_mat3_m4_v3(mr->obmat, dir);
-  normalize_v3(dir);
+  mul_transposed_mat3_m4_v3(mr->obmat, data.dir);
+  normalize_v3(data.dir);
 
-  if (mr->extract_type == MR_EXTRACT_BMESH) {
-    int l_index = 0;
-    BM_ITER_MESH (f, &iter, bm, BM_FACES_OF_MESH) {
-      float fac = angle_normalized_v3v3(bm_face_no_get(mr, f), dir) / (float)M_PI;
-      fac = overhang_remap(fac, min, max, minmax_irange);
-      for (int i = 0; i < f->len; i++, l_index++) {
-        r_overhang[l_index] = fac;
-      }
-    }
-  }
-  else {
-    const MPoly *mp = mr->mpoly;
-    for (int mp_index = 0, l_index = 0; mp_index < mr->poly_len; mp_index++, mp++) {
-      float fac = angle_normalized_v3v3(mr->poly_normals[mp_index], dir) / (float)M_PI;
-      fac = overhang_remap(fac, min, max, minmax_irange);
-      for (int i = 0; i < mp->totloop; i++, l_index++) {
-        r_overhang[l_index] = fac;
-      }
-    }
-  }
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(0, mr->poly_len, &data, statvis_calc_overhang_cb, &settings);
 }
 
 /**
@@ -4285,9 +4809,100 @@ BLI_INLINE float thickness_remap(float fac, float min, float max, float minmax_i
   return fac;
 }
 
-static void statvis_calc_thickness(const MeshRenderData *mr, float *r_thickness)
+typedef struct StatVisThickness_Data {
+  const MeshRenderData *mr;
+  struct BMBVHTree *bmtree;
+  BVHTree *tree;
+  BVHTreeFromMesh *tree_data;
+  const float (*jit_ofs)[2];
+  int samples;
+  float max;
+  /** Thickness found from each triangle, the faces use the smallest of their triangles. */
+  float *tri_dists;
+} StatVisThickness_Data;
+
+static void statvis_calc_thickness_cb(void *__restrict userdata,
+                                      const int i,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
 {
   const float eps_offset = 0.00002f; /* values <= 0.00001 give errors */
+  StatVisThickness_Data *data = userdata;
+  const MeshRenderData *mr = data->mr;
+  float *tri_dist = &data->tri_dists[i];
+  *tri_dist = data->max;
+
+  if (mr->extract_type == MR_EXTRACT_BMESH) {
+    BMLoop **ltri = mr->edit_bmesh->looptris[i];
+    const float *cos[3] = {
+        bm_vert_co_get(mr, ltri[0]->v),
+        bm_vert_co_get(mr, ltri[1]->v),
+        bm_vert_co_get(mr, ltri[2]->v),
+    };
+    float ray_co[3];
+    float ray_no[3];
+
+    normal_tri_v3(ray_no, cos[2], cos[1], cos[0]);
+
+    for (int j = 0; j < data->samples; j++) {
+      float dist = *tri_dist;
+      interp_v3_v3v3v3_uv(ray_co, cos[0], cos[1], cos[2], data->jit_ofs[j]);
+      madd_v3_v3fl(ray_co, ray_no, eps_offset);
+
+      BMFace *f_hit = BKE_bmbvh_ray_cast(data->bmtree, ray_co, ray_no, 0.0f, &dist, NULL, NULL);
+      if (f_hit && dist < *tri_dist) {
+        float angle_fac = fabsf(
+            dot_v3v3(bm_face_no_get(mr, ltri[0]->f), bm_face_no_get(mr, f_hit)));
+        angle_fac = 1.0f - angle_fac;
+        angle_fac = angle_fac * angle_fac * angle_fac;
+        angle_fac = 1.0f - angle_fac;
+        dist /= angle_fac;
+        if (dist < *tri_dist) {
+          *tri_dist = dist;
+        }
+      }
+    }
+  }
+  else {
+    const MLoopTri *mlooptri = &mr->mlooptri[i];
+    const int index = mlooptri->poly;
+    const float *cos[3] = {mr->mvert[mr->mloop[mlooptri->tri[0]].v].co,
+                           mr->mvert[mr->mloop[mlooptri->tri[1]].v].co,
+                           mr->mvert[mr->mloop[mlooptri->tri[2]].v].co};
+    float ray_co[3];
+    float ray_no[3];
+
+    normal_tri_v3(ray_no, cos[2], cos[1], cos[0]);
+
+    for (int j = 0; j < data->samples; j++) {
+      interp_v3_v3v3v3_uv(ray_co, cos[0], cos[1], cos[2], data->jit_ofs[j]);
+      madd_v3_v3fl(ray_co, ray_no, eps_offset);
+
+      BVHTreeRayHit hit;
+      hit.index = -1;
+      hit.dist = *tri_dist;
+      if ((BLI_bvhtree_ray_cast(data->tree,
+                                ray_co,
+                                ray_no,
+                                0.0f,
+                                &hit,
+                                data->tree_data->raycast_callback,
+                                data->tree_data) != -1) &&
+          hit.dist < *tri_dist) {
+        float angle_fac = fabsf(dot_v3v3(mr->poly_normals[index], hit.no));
+        angle_fac = 1.0f - angle_fac;
+        angle_fac = angle_fac * angle_fac * angle_fac;
+        angle_fac = 1.0f - angle_fac;
+        hit.dist /= angle_fac;
+        if (hit.dist < *tri_dist) {
+          *tri_dist = hit.dist;
+        }
+      }
+    }
+  }
+}
+
+static void statvis_calc_thickness(const MeshRenderData *mr, float *r_thickness)
+{
   /* cheating to avoid another allocation */
   float *face_dists = r_thickness + (mr->loop_len - mr->poly_len);
   BMEditMesh *em = mr->edit_bmesh;
@@ -4308,50 +4923,55 @@ static void statvis_calc_thickness(const MeshRenderData *mr, float *r_thickness)
     uv_from_jitter_v2(jit_ofs[j]);
   }
 
+  /* The triangles are cast in parallel, each one only limited by its own thickness so far.
+   * Reducing them per face afterwards gives the same result as limiting the rays with the
+   * thickness of the whole face. */
+  StatVisThickness_Data data = {
+      .mr = mr,
+      .jit_ofs = (const float(*)[2])jit_ofs,
+      .samples = samples,
+      .max = max,
+      .tri_dists = MEM_mallocN(sizeof(float) * mr->tri_len, __func__),
+  };
+  BVHTreeFromMesh treeData = {NULL};
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 64;
+
   if (mr->extract_type == MR_EXTRACT_BMESH) {
     BMesh *bm = em->bm;
     BM_mesh_elem_index_ensure(bm, BM_FACE);
 
-    struct BMBVHTree *bmtree = BKE_bmbvh_new_from_editmesh(em, 0, NULL, false);
+    data.bmtree = BKE_bmbvh_new_from_editmesh(em, 0, NULL, false);
+    BLI_task_parallel_range(0, mr->tri_len, &data, statvis_calc_thickness_cb, &settings);
+    BKE_bmbvh_free(data.bmtree);
+
     struct BMLoop *(*looptris)[3] = em->looptris;
     for (int i = 0; i < mr->tri_len; i++) {
-      BMLoop **ltri = looptris[i];
-      const int index = BM_elem_index_get(ltri[0]->f);
-      const float *cos[3] = {
-          bm_vert_co_get(mr, ltri[0]->v),
-          bm_vert_co_get(mr, ltri[1]->v),
-          bm_vert_co_get(mr, ltri[2]->v),
-      };
-      float ray_co[3];
-      float ray_no[3];
-
-      normal_tri_v3(ray_no, cos[2], cos[1], cos[0]);
-
-      for (int j = 0; j < samples; j++) {
-        float dist = face_dists[index];
-        interp_v3_v3v3v3_uv(ray_co, cos[0], cos[1], cos[2], jit_ofs[j]);
-        madd_v3_v3fl(ray_co, ray_no, eps_offset);
-
-        BMFace *f_hit = BKE_bmbvh_ray_cast(bmtree, ray_co, ray_no, 0.0f, &dist, NULL, NULL);
-        if (f_hit && dist < face_dists[index]) {
-          float angle_fac = fabsf(
-              dot_v3v3(bm_face_no_get(mr, ltri[0]->f), bm_face_no_get(mr, f_hit)));
-          angle_fac = 1.0f - angle_fac;
-          angle_fac = angle_fac * angle_fac * angle_fac;
-          angle_fac = 1.0f - angle_fac;
-          dist /= angle_fac;
-          if (dist < face_dists[index]) {
-            face_dists[index] = dist;
-          }
-        }
-      }
+      const int index = BM_elem_index_get(looptris[i][0]->f);
+      face_dists[index] = min_ff(face_dists[index], data.tri_dists[i]);
     }
-    BKE_bmbvh_free(bmtree);
+  }
+  else {
+    data.tree = BKE_bvhtree_from_mesh_get(&treeData, mr->me, BVHTREE_FROM_LOOPTRI, 4);
+    data.tree_data = &treeData;
+    BLI_task_parallel_range(0, mr->tri_len, &data, statvis_calc_thickness_cb, &settings);
 
+    const MLoopTri *mlooptri = mr->mlooptri;
+    for (int i = 0; i < mr->tri_len; i++, mlooptri++) {
+      const int index = mlooptri->poly;
+      face_dists[index] = min_ff(face_dists[index], data.tri_dists[i]);
+    }
+  }
+  MEM_freeN(data.tri_dists);
+
+  /* Copy in order: the face distances are stored at the end of the loops. */
+  if (mr->extract_type == MR_EXTRACT_BMESH) {
     BMIter iter;
     BMFace *f;
     int l_index = 0;
-    BM_ITER_MESH (f, &iter, bm, BM_FACES_OF_MESH) {
+    BM_ITER_MESH (f, &iter, em->bm, BM_FACES_OF_MESH) {
       float fac = face_dists[BM_elem_index_get(f)];
       fac = thickness_remap(fac, min, max, minmax_irange);
       for (int i = 0; i < f->len; i++, l_index++) {
@@ -4360,42 +4980,6 @@ static void statvis_calc_thickness(const MeshRenderData *mr, float *r_thickness)
     }
   }
   else {
-    BVHTreeFromMesh treeData = {NULL};
-
-    BVHTree *tree = BKE_bvhtree_from_mesh_get(&treeData, mr->me, BVHTREE_FROM_LOOPTRI, 4);
-    const MLoopTri *mlooptri = mr->mlooptri;
-    for (int i = 0; i < mr->tri_len; i++, mlooptri++) {
-      const int index = mlooptri->poly;
-      const float *cos[3] = {mr->mvert[mr->mloop[mlooptri->tri[0]].v].co,
-                             mr->mvert[mr->mloop[mlooptri->tri[1]].v].co,
-                             mr->mvert[mr->mloop[mlooptri->tri[2]].v].co};
-      float ray_co[3];
-      float ray_no[3];
-
-      normal_tri_v3(ray_no, cos[2], cos[1], cos[0]);
-
-      for (int j = 0; j < samples; j++) {
-        interp_v3_v3v3v3_uv(ray_co, cos[0], cos[1], cos[2], jit_ofs[j]);
-        madd_v3_v3fl(ray_co, ray_no, eps_offset);
-
-        BVHTreeRayHit hit;
-        hit.index = -1;
-        hit.dist = face_dists[index];
-        if ((BLI_bvhtree_ray_cast(
-                 tree, ray_co, ray_no, 0.0f, &hit, treeData.raycast_callback, &treeData) != -1) &&
-            hit.dist < face_dists[index]) {
-          float angle_fac = fabsf(dot_v3v3(mr->poly_normals[index], hit.no));
-          angle_fac = 1.0f - angle_fac;
-          angle_fac = angle_fac * angle_fac * angle_fac;
-          angle_fac = 1.0f - angle_fac;
-          hit.dist /= angle_fac;
-          if (hit.dist < face_dists[index]) {
-            face_dists[index] = hit.dist;
-          }
-        }
-      }
-    }
-
     const MPoly *mp = mr->mpoly;
     for (int mp_index = 0, l_index = 0; mp_index < mr->poly_len; mp_index++, mp++) {
       float fac = face_dists[mp_index];
@@ -4526,19 +5110,94 @@ BLI_INLINE float distort_remap(float fac, float min, float UNUSED(max), float mi
   return fac;
 }
 
+typedef struct StatVisDistort_Data {
+  const MeshRenderData *mr;
+  float *r_distort;
+  float min, max, minmax_irange;
+} StatVisDistort_Data;
+
+static void statvis_calc_distort_cb(void *__restrict userdata,
+                                    const int f_index,
+                                    const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const StatVisDistort_Data *data = userdata;
+  const MeshRenderData *mr = data->mr;
+  float fac = -1.0f;
+
+  if (mr->extract_type == MR_EXTRACT_BMESH) {
+    BMFace *f = BM_face_at_index(mr->bm, f_index);
+    if (f->len > 3) {
+      BMLoop *l_iter, *l_first;
+
+      fac = 0.0f;
+      l_iter = l_first = BM_FACE_FIRST_LOOP(f);
+      do {
+        const float *no_face;
+        float no_corner[3];
+        if (mr->bm_vert_coords != NULL) {
+          no_face = mr->bm_poly_normals[f_index];
+          BM_loop_calc_face_normal_safe_vcos(l_iter, no_face, mr->bm_vert_coords, no_corner);
+        }
+        else {
+          no_face = f->no;
+          BM_loop_calc_face_normal_safe(l_iter, no_corner);
+        }
+
+        /* simple way to detect (what is most likely) concave */
+        if (dot_v3v3(no_face, no_corner) < 0.0f) {
+          negate_v3(no_corner);
+        }
+        fac = max_ff(fac, angle_normalized_v3v3(no_face, no_corner));
+
+      } while ((l_iter = l_iter->next) != l_first);
+      fac *= 2.0f;
+    }
+  }
+  else {
+    const MPoly *mp = &mr->mpoly[f_index];
+    if (mp->totloop > 3) {
+      const float *f_no = mr->poly_normals[f_index];
+      fac = 0.0f;
+
+      for (int i = 1; i <= mp->totloop; i++) {
+        const MLoop *l_prev = &mr->mloop[mp->loopstart + (i - 1) % mp->totloop];
+        const MLoop *l_curr = &mr->mloop[mp->loopstart + (i + 0) % mp->totloop];
+        const MLoop *l_next = &mr->mloop[mp->loopstart + (i + 1) % mp->totloop];
+        float no_corner[3];
+        normal_tri_v3(no_corner,
+                      mr->mvert[l_prev->v].co,
+                      mr->mvert[l_curr->v].co,
+                      mr->mvert[l_next->v].co);
+        /* simple way to detect (what is most likely) concave */
+        if (dot_v3v3(f_no, no_corner) < 0.0f) {
+          negate_v3(no_corner);
+        }
+        fac = max_ff(fac, angle_normalized_v3v3(f_no, no_corner));
+      }
+      fac *= 2.0f;
+    }
+  }
+
+  fac = distort_remap(fac, data->min, data->max, data->minmax_irange);
+
+  int l_index, l_len;
+  statvis_poly_loops_get(mr, f_index, &l_index, &l_len);
+  copy_vn_fl(&data->r_distort[l_index], l_len, fac);
+}
+
 static void statvis_calc_distort(const MeshRenderData *mr, float *r_distort)
 {
   BMEditMesh *em = mr->edit_bmesh;
   const MeshStatVis *statvis = &mr->toolsettings->statvis;
-  const float min = statvis->distort_min;
-  const float max = statvis->distort_max;
-  const float minmax_irange = 1.0f / (max - min);
+  StatVisDistort_Data data = {
+      .mr = mr,
+      .r_distort = r_distort,
+      .min = statvis->distort_min,
+      .max = statvis->distort_max,
+  };
+  data.minmax_irange = 1.0f / (data.max - data.min);
 
   if (mr->extract_type == MR_EXTRACT_BMESH) {
-    BMIter iter;
-    BMesh *bm = em->bm;
-    BMFace *f;
-
     if (mr->bm_vert_coords != NULL) {
       BKE_editmesh_cache_ensure_poly_normals(em, mr->edit_data);
 
@@ -4546,78 +5205,12 @@ static void statvis_calc_distort(const MeshRenderData *mr, float *r_distort)
        * Needed for #BM_loop_calc_face_normal_safe_vcos. */
       BM_mesh_elem_index_ensure(em->bm, BM_VERT);
     }
-
-    int l_index = 0;
-    int f_index = 0;
-    BM_ITER_MESH_INDEX (f, &iter, bm, BM_FACES_OF_MESH, f_index) {
-      float fac = -1.0f;
-
-      if (f->len > 3) {
-        BMLoop *l_iter, *l_first;
-
-        fac = 0.0f;
-        l_iter = l_first = BM_FACE_FIRST_LOOP(f);
-        do {
-          const float *no_face;
-          float no_corner[3];
-          if (mr->bm_vert_coords != NULL) {
-            no_face = mr->bm_poly_normals[f_index];
-            BM_loop_calc_face_normal_safe_vcos(l_iter, no_face, mr->bm_vert_coords, no_corner);
-          }
-          else {
-            no_face = f->no;
-            BM_loop_calc_face_normal_safe(l_iter, no_corner);
-          }
-
-          /* simple way to detect (what is most likely) concave */
-          if (dot_v3v3(no_face, no_corner) < 0.0f) {
-            negate_v3(no_corner);
-          }
-          fac = max_ff(fac, angle_normalized_v3v3(no_face, no_corner));
-
-        } while ((l_iter = l_iter->next) != l_first);
-        fac *= 2.0f;
-      }
-
-      fac = distort_remap(fac, min, max, minmax_irange);
-      for (int i = 0; i < f->len; i++, l_index++) {
-        r_distort[l_index] = fac;
-      }
-    }
   }
-  else {
-    const MPoly *mp = mr->mpoly;
-    for (int mp_index = 0, l_index = 0; mp_index < mr->poly_len; mp_index++, mp++) {
-      float fac = -1.0f;
-
-      if (mp->totloop > 3) {
-        float *f_no = mr->poly_normals[mp_index];
-        fac = 0.0f;
-
-        for (int i = 1; i <= mp->totloop; i++) {
-          const MLoop *l_prev = &mr->mloop[mp->loopstart + (i - 1) % mp->totloop];
-          const MLoop *l_curr = &mr->mloop[mp->loopstart + (i + 0) % mp->totloop];
-          const MLoop *l_next = &mr->mloop[mp->loopstart + (i + 1) % mp->totloop];
-          float no_corner[3];
-          normal_tri_v3(no_corner,
-                        mr->mvert[l_prev->v].co,
-                        mr->mvert[l_curr->v].co,
-                        mr->mvert[l_next->v].co);
-          /* simple way to detect (what is most likely) concave */
-          if (dot_v3v3(f_no, no_corner) < 0.0f) {
-            negate_v3(no_corner);
-          }
-          fac = max_ff(fac, angle_normalized_v3v3(f_no, no_corner));
-        }
-        fac *= 2.0f;
-      }
 
-      fac = distort_remap(fac, min, max, minmax_irange);
-      for (int i = 0; i < mp->totloop; i++, l_index++) {
-        r_distort[l_index] = fac;
-      }
-    }
-  }
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(0, mr->poly_len, &data, statvis_calc_distort_cb, &settings);
 }
 
 BLI_INLINE float sharp_remap(float fac, float min, float UNUSED(max), float minmax_irange)
@@ -4877,63 +5470,59 @@ static void *extract_fdots_nor_init(const MeshRenderData *mr,
   GPU_vertbuf_init_with_format(vbo, &format);
   GPU_vertbuf_data_alloc(vbo, mr->poly_len);
 
-  return NULL;
+  return GPU_vertbuf_get_data(vbo);
 }
 
-static void extract_fdots_nor_finish(const MeshRenderData *mr,
-                                     struct MeshBatchCache *UNUSED(cache),
-                                     void *buf,
-                                     void *UNUSED(data))
+BLI_INLINE void fdots_nor_set(const MeshRenderData *mr,
+                              GPUPackedNormal *nor,
+                              const int f,
+                              const BMFace *efa,
+                              const bool is_face_hidden)
 {
   static float invalid_normal[3] = {0.0f, 0.0f, 0.0f};
-  GPUVertBuf *vbo = buf;
-  GPUPackedNormal *nor = (GPUPackedNormal *)GPU_vertbuf_get_data(vbo);
-  BMFace *efa;
-
-  /* Quicker than doing it for each loop. */
-  if (mr->extract_type == MR_EXTRACT_BMESH) {
-    for (int f = 0; f < mr->poly_len; f++) {
-      efa = BM_face_at_index(mr->bm, f);
-      const bool is_face_hidden = BM_elem_flag_test(efa, BM_ELEM_HIDDEN);
-      if (is_face_hidden || (mr->extract_type == MR_EXTRACT_MAPPED && mr->p_origindex &&
-                             mr->p_origindex[f] == ORIGINDEX_NONE)) {
-        nor[f] = GPU_normal_convert_i10_v3(invalid_normal);
-        nor[f].w = NOR_AND_FLAG_HIDDEN;
-      }
-      else {
-        nor[f] = GPU_normal_convert_i10_v3(bm_face_no_get(mr, efa));
-        /* Select / Active Flag. */
-        nor[f].w = (BM_elem_flag_test(efa, BM_ELEM_SELECT) ?
-                        ((efa == mr->efa_act) ? NOR_AND_FLAG_ACTIVE : NOR_AND_FLAG_SELECT) :
-                        NOR_AND_FLAG_DEFAULT);
-      }
-    }
+  if (is_face_hidden || (mr->extract_type == MR_EXTRACT_MAPPED && mr->p_origindex &&
+                         mr->p_origindex[f] == ORIGINDEX_NONE)) {
+    nor[f] = GPU_normal_convert_i10_v3(invalid_normal);
+    nor[f].w = NOR_AND_FLAG_HIDDEN;
   }
   else {
-    for (int f = 0; f < mr->poly_len; f++) {
-      efa = bm_original_face_get(mr, f);
-      const bool is_face_hidden = efa && BM_elem_flag_test(efa, BM_ELEM_HIDDEN);
-      if (is_face_hidden || (mr->extract_type == MR_EXTRACT_MAPPED && mr->p_origindex &&
-                             mr->p_origindex[f] == ORIGINDEX_NONE)) {
-        nor[f] = GPU_normal_convert_i10_v3(invalid_normal);
-        nor[f].w = NOR_AND_FLAG_HIDDEN;
-      }
-      else {
-        nor[f] = GPU_normal_convert_i10_v3(bm_face_no_get(mr, efa));
-        /* Select / Active Flag. */
-        nor[f].w = (BM_elem_flag_test(efa, BM_ELEM_SELECT) ?
-                        ((efa == mr->efa_act) ? NOR_AND_FLAG_ACTIVE : NOR_AND_FLAG_SELECT) :
-                        NOR_AND_FLAG_DEFAULT);
-      }
-    }
+    nor[f] = GPU_normal_convert_i10_v3(bm_face_no_get(mr, efa));
+    /* Select / Active Flag. */
+    nor[f].w = (BM_elem_flag_test(efa, BM_ELEM_SELECT) ?
+                    ((efa == mr->efa_act) ? NOR_AND_FLAG_ACTIVE : NOR_AND_FLAG_SELECT) :
+                    NOR_AND_FLAG_DEFAULT);
+  }
+}
+
+static void extract_fdots_nor_iter_poly_bm(const MeshRenderData *mr,
+                                           const ExtractPolyBMesh_Params *params,
+                                           void *nor)
+{
+  EXTRACT_POLY_FOREACH_BM_BEGIN(efa, f, params, mr)
+  {
+    fdots_nor_set(mr, nor, f, efa, BM_elem_flag_test(efa, BM_ELEM_HIDDEN));
   }
+  EXTRACT_POLY_FOREACH_BM_END;
+}
+
+static void extract_fdots_nor_iter_poly_mesh(const MeshRenderData *mr,
+                                             const ExtractPolyMesh_Params *params,
+                                             void *nor)
+{
+  EXTRACT_POLY_FOREACH_MESH_BEGIN(mp, f, params, mr)
+  {
+    const BMFace *efa = bm_original_face_get(mr, f);
+    fdots_nor_set(mr, nor, f, efa, efa && BM_elem_flag_test(efa, BM_ELEM_HIDDEN));
+  }
+  EXTRACT_POLY_FOREACH_MESH_END;
 }
 
 static const MeshExtract extract_fdots_nor = {
     .init = extract_fdots_nor_init,
-    .finish = extract_fdots_nor_finish,
+    .iter_poly_bm = extract_fdots_nor_iter_poly_bm,
+    .iter_poly_mesh = extract_fdots_nor_iter_poly_mesh,
     .data_flag = MR_DATA_POLY_NOR,
-    .use_threading = false,
+    .use_threading = true,
 };
 
 /** \} */
@@ -4953,63 +5542,59 @@ static void *extract_fdots_nor_hq_init(const MeshRenderData *mr,
   GPU_vertbuf_init_with_format(vbo, &format);
   GPU_vertbuf_data_alloc(vbo, mr->poly_len);
 
-  return NULL;
+  return GPU_vertbuf_get_data(vbo);
 }
 
-static void extract_fdots_nor_hq_finish(const MeshRenderData *mr,
-                                        struct MeshBatchCache *UNUSED(cache),
-                                        void *buf,
-                                        void *UNUSED(data))
+BLI_INLINE void fdots_nor_hq_set(const MeshRenderData *mr,
+                                 short *nor,
+                                 const int f,
+                                 const BMFace *efa,
+                                 const bool is_face_hidden)
 {
   static float invalid_normal[3] = {0.0f, 0.0f, 0.0f};
-  GPUVertBuf *vbo = buf;
-  short *nor = (short *)GPU_vertbuf_get_data(vbo);
-  BMFace *efa;
-
-  /* Quicker than doing it for each loop. */
-  if (mr->extract_type == MR_EXTRACT_BMESH) {
-    for (int f = 0; f < mr->poly_len; f++) {
-      efa = BM_face_at_index(mr->bm, f);
-      const bool is_face_hidden = BM_elem_flag_test(efa, BM_ELEM_HIDDEN);
-      if (is_face_hidden || (mr->extract_type == MR_EXTRACT_MAPPED && mr->p_origindex &&
-                             mr->p_origindex[f] == ORIGINDEX_NONE)) {
-        normal_float_to_short_v3(&nor[f * 4], invalid_normal);
-        nor[f * 4 + 3] = NOR_AND_FLAG_HIDDEN;
-      }
-      else {
-        normal_float_to_short_v3(&nor[f * 4], bm_face_no_get(mr, efa));
-        /* Select / Active Flag. */
-        nor[f * 4 + 3] = (BM_elem_flag_test(efa, BM_ELEM_SELECT) ?
-                              ((efa == mr->efa_act) ? NOR_AND_FLAG_ACTIVE : NOR_AND_FLAG_SELECT) :
-                              NOR_AND_FLAG_DEFAULT);
-      }
-    }
+  if (is_face_hidden || (mr->extract_type == MR_EXTRACT_MAPPED && mr->p_origindex &&
+                         mr->p_origindex[f] == ORIGINDEX_NONE)) {
+    normal_float_to_short_v3(&nor[f * 4], invalid_normal);
+    nor[f * 4 + 3] = NOR_AND_FLAG_HIDDEN;
   }
   else {
-    for (int f = 0; f < mr->poly_len; f++) {
-      efa = bm_original_face_get(mr, f);
-      const bool is_face_hidden = efa && BM_elem_flag_test(efa, BM_ELEM_HIDDEN);
-      if (is_face_hidden || (mr->extract_type == MR_EXTRACT_MAPPED && mr->p_origindex &&
-                             mr->p_origindex[f] == ORIGINDEX_NONE)) {
-        normal_float_to_short_v3(&nor[f * 4], invalid_normal);
-        nor[f * 4 + 3] = NOR_AND_FLAG_HIDDEN;
-      }
-      else {
-        normal_float_to_short_v3(&nor[f * 4], bm_face_no_get(mr, efa));
-        /* Select / Active Flag. */
-        nor[f * 4 + 3] = (BM_elem_flag_test(efa, BM_ELEM_SELECT) ?
-                              ((efa == mr->efa_act) ? NOR_AND_FLAG_ACTIVE : NOR_AND_FLAG_SELECT) :
-                              NOR_AND_FLAG_DEFAULT);
-      }
-    }
+    normal_float_to_short_v3(&nor[f * 4], bm_face_no_get(mr, efa));
+    /* Select / Active Flag. */
+    nor[f * 4 + 3] = (BM_elem_flag_test(efa, BM_ELEM_SELECT) ?
+                          ((efa == mr->efa_act) ? NOR_AND_FLAG_ACTIVE : NOR_AND_FLAG_SELECT) :
+                          NOR_AND_FLAG_DEFAULT);
+  }
+}
+
+static void extract_fdots_nor_hq_iter_poly_bm(const MeshRenderData *mr,
+                                              const ExtractPolyBMesh_Params *params,
+                                              void *nor)
+{
+  EXTRACT_POLY_FOREACH_BM_BEGIN(efa, f, params, mr)
+  {
+    fdots_nor_hq_set(mr, nor, f, efa, BM_elem_flag_test(efa, BM_ELEM_HIDDEN));
+  }
+  EXTRACT_POLY_FOREACH_BM_END;
+}
+
+static void extract_fdots_nor_hq_iter_poly_mesh(const MeshRenderData *mr,
+                                                const ExtractPolyMesh_Params *params,
+                                                void *nor)
+{
+  EXTRACT_POLY_FOREACH_MESH_BEGIN(mp, f, params, mr)
+  {
+    const BMFace *efa = bm_original_face_get(mr, f);
+    fdots_nor_hq_set(mr, nor, f, efa, efa && BM_elem_flag_test(efa, BM_ELEM_HIDDEN));
   }
+  EXTRACT_POLY_FOREACH_MESH_END;
 }
 
 static const MeshExtract extract_fdots_nor_hq = {
     .init = extract_fdots_nor_hq_init,
-    .finish = extract_fdots_nor_hq_finish,
+    .iter_poly_bm = extract_fdots_nor_hq_iter_poly_bm,
+    .iter_poly_mesh = extract_fdots_nor_hq_iter_poly_mesh,
     .data_flag = MR_DATA_POLY_NOR,
-    .use_threading = false,
+    .use_threading = true,
 };
 
 /** \} */
@@ -5503,6 +6088,9 @@ static const MeshExtract extract_fdot_idx = {
  * \{ */
 typedef struct ExtractUserData {
   void *user_data;
+  /** Data of each range created by #MeshExtract.task_init, merged in this order. */
+  void **task_user_data;
+  int task_len;
 } ExtractUserData;
 
 typedef enum ExtractTaskDataType {
@@ -5518,6 +6106,8 @@ typedef struct ExtractTaskData {
   ExtractTaskDataType tasktype;
   eMRIterType iter_type;
   int start, end;
+  /** Index of the range in #ExtractUserData.task_user_data. */
+  int task_index;
   /** Decremented each time a task is finished. */
   int32_t *task_counter;
   void *buf;
@@ -5550,6 +6140,7 @@ static ExtractTaskData *extract_task_data_create_mesh_extract(const MeshRenderDa
   taskdata->task_counter = task_counter;
   taskdata->start = 0;
   taskdata->end = INT_MAX;
+  taskdata->task_index = 0;
   return taskdata;
 }
 
@@ -5566,6 +6157,9 @@ static ExtractTaskData *extract_task_data_create_lines_loose(const MeshRenderDat
 static void extract_task_data_free(void *data)
 {
   ExtractTaskData *task_data = data;
+  if (task_data->user_data) {
+    MEM_SAFE_FREE(task_data->user_data->task_user_data);
+  }
   MEM_SAFE_FREE(task_data->user_data);
   MEM_freeN(task_data);
 }
@@ -5659,17 +6253,31 @@ static void extract_run(void *__restrict taskdata)
 {
   ExtractTaskData *data = (ExtractTaskData *)taskdata;
   if (data->tasktype == EXTRACT_MESH_EXTRACT) {
-    mesh_extract_iter(data->mr,
-                      data->iter_type,
-                      data->start,
-                      data->end,
-                      data->extract,
-                      data->user_data->user_data);
+    const MeshExtract *extract = data->extract;
+    ExtractUserData *user_data = data->user_data;
+    if (user_data->task_user_data != NULL) {
+      void *task_user_data = extract->task_init(
+          data->mr, user_data->user_data, data->iter_type, data->start, data->end);
+      mesh_extract_iter(
+          data->mr, data->iter_type, data->start, data->end, extract, task_user_data);
+      user_data->task_user_data[data->task_index] = task_user_data;
+    }
+    else {
+      mesh_extract_iter(
+          data->mr, data->iter_type, data->start, data->end, extract, user_data->user_data);
+    }
 
     /* If this is the last task, we do the finish function. */
     int remainin_tasks = atomic_sub_and_fetch_int32(data->task_counter, 1);
-    if (remainin_tasks == 0 && data->extract->finish != NULL) {
-      data->extract->finish(data->mr, data->cache, data->buf, data->user_data->user_data);
+    if (remainin_tasks == 0) {
+      if (user_data->task_user_data != NULL) {
+        for (int i = 0; i < user_data->task_len; i++) {
+          extract->task_finish(data->mr, user_data->user_data, user_data->task_user_data[i]);
+        }
+      }
+      if (extract->finish != NULL) {
+        extract->finish(data->mr, data->cache, data->buf, user_data->user_data);
+      }
     }
   }
   else if (data->tasktype == EXTRACT_LINES_LOOSE) {
@@ -5821,18 +6429,22 @@ static void extract_range_task_create(struct TaskGraph *task_graph,
                                       ExtractTaskData *taskdata,
                                       const eMRIterType type,
                                       int start,
-                                      int length)
+                                      int length,
+                                      int *r_task_len)
 {
   taskdata = MEM_dupallocN(taskdata);
   atomic_add_and_fetch_int32(taskdata->task_counter, 1);
   taskdata->iter_type = type;
   taskdata->start = start;
   taskdata->end = start + length;
+  taskdata->task_index = (*r_task_len)++;
   struct TaskNode *task_node = BLI_task_graph_node_create(
       task_graph, extract_run, taskdata, MEM_freeN);
   BLI_task_graph_edge_create(task_node_user_data_init, task_node);
 }
 
+int mesh_extract_chunk_size = 8192;
+
 static void extract_task_create(struct TaskGraph *task_graph,
                                 struct TaskNode *task_node_mesh_render_data,
                                 struct TaskNode *task_node_user_data_init,
@@ -5868,35 +6480,62 @@ static void extract_task_create(struct TaskGraph *task_graph,
       mr, cache, extract, buf, task_counter);
 
   /* Simple heuristic. */
-  const int chunk_size = 8192;
+  const int chunk_size = mesh_extract_chunk_size;
   const bool use_thread = (mr->loop_len + mr->loop_loose_len) > chunk_size;
   if (use_thread && extract->use_threading) {
 
     /* Divide task into sensible chunks. */
+    int task_len = 0;
     if (taskdata->iter_type & MR_ITER_LOOPTRI) {
       for (int i = 0; i < mr->tri_len; i += chunk_size) {
-        extract_range_task_create(
-            task_graph, task_node_user_data_init, taskdata, MR_ITER_LOOPTRI, i, chunk_size);
+        extract_range_task_create(task_graph,
+                                  task_node_user_data_init,
+                                  taskdata,
+                                  MR_ITER_LOOPTRI,
+                                  i,
+                                  chunk_size,
+                                  &task_len);
       }
     }
     if (taskdata->iter_type & MR_ITER_POLY) {
       for (int i = 0; i < mr->poly_len; i += chunk_size) {
-        extract_range_task_create(
-            task_graph, task_node_user_data_init, taskdata, MR_ITER_POLY, i, chunk_size);
+        extract_range_task_create(task_graph,
+                                  task_node_user_data_init,
+                                  taskdata,
+                                  MR_ITER_POLY,
+                                  i,
+                                  chunk_size,
+                                  &task_len);
       }
     }
     if (taskdata->iter_type & MR_ITER_LEDGE) {
       for (int i = 0; i < mr->edge_loose_len; i += chunk_size) {
-        extract_range_task_create(
-            task_graph, task_node_user_data_init, taskdata, MR_ITER_LEDGE, i, chunk_size);
+        extract_range_task_create(task_graph,
+                                  task_node_user_data_init,
+                                  taskdata,
+                                  MR_ITER_LEDGE,
+                                  i,
+                                  chunk_size,
+                                  &task_len);
       }
     }
     if (taskdata->iter_type & MR_ITER_LVERT) {
       for (int i = 0; i < mr->vert_loose_len; i += chunk_size) {
-        extract_range_task_create(
-            task_graph, task_node_user_data_init, taskdata, MR_ITER_LVERT, i, chunk_size);
+        extract_range_task_create(task_graph,
+                                  task_node_user_data_init,
+                                  taskdata,
+                                  MR_ITER_LVERT,
+                                  i,
+                                  chunk_size,
+                                  &task_len);
       }
     }
+    /* A single range can work on the user data directly. The range tasks only run once the
+     * user data is initialized, and share the #ExtractUserData container. */
+    if (extract->task_init != NULL && task_len > 1) {
+      taskdata->user_data->task_user_data = MEM_callocN(sizeof(void *) * task_len, __func__);
+      taskdata->user_data->task_len = task_len;
+    }
     BLI_addtail(user_data_init_task_datas, taskdata);
   }
   else if (use_thread) {
@@ -476,6 +476,18 @@ static bool mesh_batch_cache_valid(Mesh *me)
   return true;
 }
 
+/**
+ * The cache is only taken over by a mesh that is only deformed, when neither the object nor the
+ * original mesh had a copy-on-write update (see #mesh_build_data), so the topology is known to be
+ * unchanged. The element counts are only checked as a safety net.
+ */
+static bool mesh_batch_cache_topology_equals(const MeshBatchCache *cache, const Mesh *me)
+{
+  return (cache->is_editmode == false) && (me->runtime.deformed_only) &&
+         (cache->vert_len == me->totvert) && (cache->edge_len == me->totedge) &&
+         (cache->loop_len == me->totloop) && (cache->poly_len == me->totpoly);
+}
+
 static void mesh_batch_cache_init(Mesh *me)
 {
   MeshBatchCache *cache = me->runtime.batch_cache;
@@ -490,10 +502,10 @@ static void mesh_batch_cache_init(Mesh *me)
   cache->is_editmode = me->edit_mesh != NULL;
 
   if (cache->is_editmode == false) {
-    // cache->edge_len = mesh_render_edges_len_get(me);
-    // cache->tri_len = mesh_render_looptri_len_get(me);
-    // cache->poly_len = mesh_render_polys_len_get(me);
-    // cache->vert_len = mesh_render_verts_len_get(me);
+    cache->edge_len = me->totedge;
+    cache->poly_len = me->totpoly;
+    cache->vert_len = me->totvert;
+    cache->loop_len = me->totloop;
   }
 
   cache->mat_len = mesh_render_mat_len_get(me);
@@ -622,6 +634,38 @@ static void mesh_batch_cache_discard_uvedit_select(MeshBatchCache *cache)
   cache->batch_ready &= ~MBC_EDITUV;
 }
 
+/* Discard the buffers depending on vertex positions, keeping the topology and attributes. */
+static void mesh_batch_cache_discard_deform(MeshBatchCache *cache)
+{
+  /* The triangulation of quads and n-gons depends on the vertex positions. */
+  for (int i = 0; i < cache->mat_len; i++) {
+    GPU_INDEXBUF_DISCARD_SAFE(cache->final.tris_per_mat[i]);
+  }
+  FOREACH_MESH_BUFFER_CACHE (cache, mbufcache) {
+    GPU_INDEXBUF_DISCARD_SAFE(mbufcache->ibo.tris);
+    GPU_INDEXBUF_DISCARD_SAFE(mbufcache->ibo.lines_adjacency);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.pos_nor);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.lnor);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.tan);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.edge_fac);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.mesh_analysis);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.stretch_area);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.stretch_angle);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.fdots_pos);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.fdots_nor);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.skin_roots);
+  }
+  /* Batches only reference buffers, re-creating them is cheap. */
+  for (int i = 0; i < sizeof(cache->batch) / sizeof(void *); i++) {
+    GPUBatch **batch = (GPUBatch **)&cache->batch;
+    GPU_BATCH_DISCARD_SAFE(batch[i]);
+  }
+  for (int i = 0; i < cache->mat_len; i++) {
+    GPU_BATCH_DISCARD_SAFE(cache->surface_per_mat[i]);
+  }
+  cache->batch_ready = 0;
+}
+
 void DRW_mesh_batch_cache_dirty_tag(Mesh *me, eMeshBatchDirtyMode mode)
 {
   MeshBatchCache *cache = me->runtime.batch_cache;
@@ -667,6 +711,15 @@ void DRW_mesh_batch_cache_dirty_tag(Mesh *me, eMeshBatchDirtyMode mode)
     case BKE_MESH_BATCH_DIRTY_ALL:
       cache->is_dirty = true;
       break;
+    case BKE_MESH_BATCH_DIRTY_DEFORM:
+      /* The cache may come from the previous evaluated mesh, see #mesh_build_data. */
+      if (mesh_batch_cache_topology_equals(cache, me)) {
+        mesh_batch_cache_discard_deform(cache);
+      }
+      else {
+        cache->is_dirty = true;
+      }
+      break;
     case BKE_MESH_BATCH_DIRTY_SHADING:
       mesh_batch_cache_discard_shaded_tri(cache);
       mesh_batch_cache_discard_uvedit(cache);
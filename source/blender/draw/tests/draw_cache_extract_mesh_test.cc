@@ -0,0 +1,405 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <vector>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_array.hh"
+#include "BLI_math_matrix.h"
+#include "BLI_task.h"
+#include "BLI_vector.hh"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_scene_types.h"
+
+#include "BKE_customdata.h"
+#include "BKE_idtype.h"
+#include "BKE_lib_id.h"
+#include "BKE_mesh.h"
+
+#include "GPU_batch.h"
+
+#include "gpu_index_buffer_private.hh"
+#include "gpu_vertex_buffer_private.hh"
+
+#include "PIL_time.h"
+
+#include "intern/draw_cache_extract.h"
+
+namespace blender::draw::tests {
+
+using blender::gpu::IndexBuf;
+using blender::gpu::VertBuf;
+
+/* Vertex buffer living in CPU memory only, so extraction can run without a GPU context. */
+class TestVertBuf : public VertBuf {
+ public:
+  void update_sub(uint UNUSED(start), uint UNUSED(len), void *UNUSED(data)) override
+  {
+  }
+
+ protected:
+  void acquire_data(void) override
+  {
+    MEM_SAFE_FREE(data);
+    data = (uchar *)MEM_mallocN(sizeof(uchar) * this->size_alloc_get(), __func__);
+  }
+  void resize_data(void) override
+  {
+    data = (uchar *)MEM_reallocN(data, sizeof(uchar) * this->size_alloc_get());
+  }
+  void release_data(void) override
+  {
+    MEM_SAFE_FREE(data);
+  }
+  void upload_data(void) override
+  {
+  }
+  void duplicate_data(VertBuf *dst) override
+  {
+    dst->data = (uchar *)MEM_dupallocN(data);
+  }
+};
+
+class TestIndexBuf : public IndexBuf {
+ public:
+  /* Index after decompression, with the primitive restart as `0xFFFFFFFF`. */
+  uint32_t index_get(uint i) const
+  {
+    if (index_type_ == gpu::GPU_INDEX_U16) {
+      const uint16_t index = static_cast<const uint16_t *>(data_)[i];
+      return (index == 0xFFFF) ? 0xFFFFFFFF : index + index_base_;
+    }
+    return static_cast<const uint32_t *>(data_)[i];
+  }
+
+  Vector<uint32_t> indices_get() const
+  {
+    Vector<uint32_t> indices;
+    for (uint i = 0; i < index_len_get(); i++) {
+      indices.append(index_get(i));
+    }
+    return indices;
+  }
+};
+
+struct ExtractTestContext {
+  Mesh *mesh;
+  Scene *scene;
+  MeshBatchCache *cache;
+};
+
+/* Grid of `size * size` quads, with every third face selected. */
+static void test_extract_init(ExtractTestContext *ctx, const int size)
+{
+  const int verts_len = (size + 1) * (size + 1);
+  const int polys_len = size * size;
+  Mesh *me = BKE_mesh_new_nomain(verts_len, 0, 0, polys_len * 4, polys_len);
+
+  for (int y = 0; y <= size; y++) {
+    for (int x = 0; x <= size; x++) {
+      float *co = me->mvert[y * (size + 1) + x].co;
+      co[0] = (float)x;
+      co[1] = (float)y;
+      co[2] = (float)((x * y) % 3) * 0.1f;
+    }
+  }
+  MLoopUV *mloopuv = (MLoopUV *)CustomData_add_layer(
+      &me->ldata, CD_MLOOPUV, CD_CALLOC, nullptr, me->totloop);
+  for (int y = 0; y < size; y++) {
+    for (int x = 0; x < size; x++) {
+      const int p_index = y * size + x;
+      MPoly *mp = &me->mpoly[p_index];
+      mp->loopstart = p_index * 4;
+      mp->totloop = 4;
+      mp->flag = (p_index % 3 == 0) ? ME_FACE_SEL : 0;
+      const int v = y * (size + 1) + x;
+      const int quad[4] = {v, v + 1, v + size + 2, v + size + 1};
+      for (int i = 0; i < 4; i++) {
+        me->mloop[mp->loopstart + i].v = quad[i];
+        copy_v2_v2(mloopuv[mp->loopstart + i].uv, me->mvert[quad[i]].co);
+      }
+    }
+  }
+  BKE_mesh_calc_edges(me, false, false);
+  BKE_mesh_calc_normals(me);
+
+  ctx->mesh = me;
+  ctx->scene = (Scene *)MEM_callocN(sizeof(Scene), __func__);
+  ctx->scene->toolsettings = (ToolSettings *)MEM_callocN(sizeof(ToolSettings), __func__);
+  ctx->cache = (MeshBatchCache *)MEM_callocN(sizeof(MeshBatchCache), __func__);
+  ctx->cache->cd_used.uv = 1;
+}
+
+static void test_extract_free(ExtractTestContext *ctx)
+{
+  BKE_id_free(nullptr, ctx->mesh);
+  MEM_freeN(ctx->scene->toolsettings);
+  MEM_freeN(ctx->scene);
+  MEM_freeN(ctx->cache);
+}
+
+static void test_extract_buffers_free(MeshBufferCache *mbc)
+{
+  GPUVertBuf **vbos = (GPUVertBuf **)&mbc->vbo;
+  for (int i = 0; i < sizeof(mbc->vbo) / sizeof(void *); i++) {
+    GPU_VERTBUF_DISCARD_SAFE(vbos[i]);
+  }
+  GPUIndexBuf **ibos = (GPUIndexBuf **)&mbc->ibo;
+  for (int i = 0; i < sizeof(mbc->ibo) / sizeof(void *); i++) {
+    GPU_INDEXBUF_DISCARD_SAFE(ibos[i]);
+  }
+}
+
+/* Request the buffers used in object mode and by the paint modes. */
+static MeshBufferCache test_extract_run(ExtractTestContext *ctx)
+{
+  MeshBufferCache mbc = {{nullptr}};
+  mbc.vbo.pos_nor = gpu::wrap(new TestVertBuf());
+  mbc.vbo.lnor = gpu::wrap(new TestVertBuf());
+  mbc.vbo.uv = gpu::wrap(new TestVertBuf());
+  mbc.vbo.edge_fac = gpu::wrap(new TestVertBuf());
+  mbc.vbo.poly_idx = gpu::wrap(new TestVertBuf());
+  mbc.ibo.tris = gpu::wrap(new TestIndexBuf());
+  mbc.ibo.lines = gpu::wrap(new TestIndexBuf());
+  mbc.ibo.points = gpu::wrap(new TestIndexBuf());
+  mbc.ibo.lines_paint_mask = gpu::wrap(new TestIndexBuf());
+  mbc.ibo.lines_adjacency = gpu::wrap(new TestIndexBuf());
+
+  float obmat[4][4];
+  unit_m4(obmat);
+
+  struct TaskGraph *task_graph = BLI_task_graph_create();
+  mesh_buffer_cache_create_requested(task_graph,
+                                     ctx->cache,
+                                     mbc,
+                                     ctx->mesh,
+                                     false,
+                                     false,
+                                     false,
+                                     obmat,
+                                     true,
+                                     false,
+                                     false,
+                                     &ctx->cache->cd_used,
+                                     ctx->scene,
+                                     ctx->scene->toolsettings,
+                                     true);
+  BLI_task_graph_work_and_wait(task_graph);
+  BLI_task_graph_free(task_graph);
+  return mbc;
+}
+
+static Vector<uint32_t> indices_get(GPUIndexBuf *ibo)
+{
+  return static_cast<TestIndexBuf *>(gpu::unwrap(ibo))->indices_get();
+}
+
+static bool vbo_equal(GPUVertBuf *a, GPUVertBuf *b)
+{
+  const VertBuf *vbo_a = gpu::unwrap(a), *vbo_b = gpu::unwrap(b);
+  return (vbo_a->size_used_get() == vbo_b->size_used_get()) &&
+         (memcmp(vbo_a->data, vbo_b->data, vbo_a->size_used_get()) == 0);
+}
+
+static bool ibo_equal(GPUIndexBuf *a, GPUIndexBuf *b)
+{
+  const Vector<uint32_t> indices_a = indices_get(a), indices_b = indices_get(b);
+  return (indices_a.size() == indices_b.size()) &&
+         std::equal(indices_a.begin(), indices_a.end(), indices_b.begin());
+}
+
+/* Sorted primitives of an index buffer, to compare buffers whose primitive order differs. */
+static std::vector<std::array<uint32_t, 4>> ibo_primitives_sorted(GPUIndexBuf *ibo)
+{
+  const Vector<uint32_t> indices = indices_get(ibo);
+  std::vector<std::array<uint32_t, 4>> primitives;
+  for (int i = 0; i + 4 <= indices.size(); i += 4) {
+    primitives.push_back({indices[i], indices[i + 1], indices[i + 2], indices[i + 3]});
+  }
+  std::sort(primitives.begin(), primitives.end());
+  return primitives;
+}
+
+/* Extract with a single task, like a mesh that is too small to be split in several ranges. */
+static MeshBufferCache test_extract_run_single_task(ExtractTestContext *ctx)
+{
+  const int chunk_size = mesh_extract_chunk_size;
+  mesh_extract_chunk_size = INT_MAX;
+  MeshBufferCache mbc = test_extract_run(ctx);
+  mesh_extract_chunk_size = chunk_size;
+  return mbc;
+}
+
+class DrawCacheExtractMeshTest : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    BKE_idtype_init();
+    BLI_task_scheduler_init();
+  }
+  static void TearDownTestSuite()
+  {
+    BLI_task_scheduler_exit();
+  }
+};
+
+/* Large enough to be split in several ranges. */
+TEST_F(DrawCacheExtractMeshTest, index_buffers)
+{
+  const int size = 64;
+  ExtractTestContext ctx;
+  test_extract_init(&ctx, size);
+  MeshBufferCache mbc = test_extract_run(&ctx);
+  const Mesh *me = ctx.mesh;
+
+  /* The result of a single thread iterating the loops in order: shared elements use the loop
+   * with the highest index. */
+  Array<int> edge_loop(me->totedge, -1), vert_loop(me->totvert, -1);
+  Array<int> edge_loop_next(me->totedge, -1);
+  Array<int> edge_select_len(me->totedge, 0), edge_select_loop(me->totedge, -1);
+  for (int p = 0; p < me->totpoly; p++) {
+    const MPoly *mp = &me->mpoly[p];
+    for (int i = 0; i < mp->totloop; i++) {
+      const int l = mp->loopstart + i;
+      const int l_next = mp->loopstart + (i + 1) % mp->totloop;
+      const MLoop *ml = &me->mloop[l];
+      edge_loop[ml->e] = l;
+      edge_loop_next[ml->e] = l_next;
+      vert_loop[ml->v] = l;
+      if (mp->flag & ME_FACE_SEL) {
+        edge_select_len[ml->e]++;
+        edge_select_loop[ml->e] = l;
+      }
+    }
+  }
+
+  Vector<uint32_t> lines = indices_get(mbc.ibo.lines);
+  ASSERT_EQ(lines.size(), me->totedge * 2);
+  for (int e = 0; e < me->totedge; e++) {
+    EXPECT_EQ(lines[e * 2], edge_loop[e]);
+    EXPECT_EQ(lines[e * 2 + 1], edge_loop_next[e]);
+  }
+
+  Vector<uint32_t> points = indices_get(mbc.ibo.points);
+  ASSERT_EQ(points.size(), me->totvert);
+  for (int v = 0; v < me->totvert; v++) {
+    EXPECT_EQ(points[v], vert_loop[v]);
+  }
+
+  Vector<uint32_t> paint_lines = indices_get(mbc.ibo.lines_paint_mask);
+  ASSERT_EQ(paint_lines.size(), me->totedge * 2);
+  for (int e = 0; e < me->totedge; e++) {
+    if (edge_select_len[e] > 1) {
+      EXPECT_EQ(paint_lines[e * 2], 0xFFFFFFFF);
+    }
+    else if (edge_select_len[e] == 1) {
+      EXPECT_EQ(paint_lines[e * 2], edge_select_loop[e]);
+    }
+    else {
+      EXPECT_EQ(paint_lines[e * 2], edge_loop[e]);
+    }
+  }
+
+  Vector<uint32_t> tris = indices_get(mbc.ibo.tris);
+  EXPECT_EQ(tris.size(), me->totpoly * 2 * 3);
+  EXPECT_FALSE(tris.contains(0xFFFFFFFF));
+
+  /* One primitive per edge of the triangulated grid. */
+  Vector<uint32_t> lines_adj = indices_get(mbc.ibo.lines_adjacency);
+  EXPECT_EQ(lines_adj.size(), (me->totedge + me->totpoly) * 4);
+  EXPECT_FALSE(ctx.cache->is_manifold);
+
+  test_extract_buffers_free(&mbc);
+  test_extract_free(&ctx);
+}
+
+/* The merge of the ranges must not depend on the scheduling of the tasks. */
+TEST_F(DrawCacheExtractMeshTest, deterministic)
+{
+  ExtractTestContext ctx;
+  test_extract_init(&ctx, 128);
+  MeshBufferCache mbc_a = test_extract_run(&ctx);
+  for (int run = 0; run < 4; run++) {
+    MeshBufferCache mbc_b = test_extract_run(&ctx);
+    EXPECT_TRUE(vbo_equal(mbc_a.vbo.pos_nor, mbc_b.vbo.pos_nor));
+    EXPECT_TRUE(vbo_equal(mbc_a.vbo.lnor, mbc_b.vbo.lnor));
+    EXPECT_TRUE(vbo_equal(mbc_a.vbo.uv, mbc_b.vbo.uv));
+    EXPECT_TRUE(vbo_equal(mbc_a.vbo.edge_fac, mbc_b.vbo.edge_fac));
+    EXPECT_TRUE(vbo_equal(mbc_a.vbo.poly_idx, mbc_b.vbo.poly_idx));
+    EXPECT_TRUE(ibo_equal(mbc_a.ibo.tris, mbc_b.ibo.tris));
+    EXPECT_TRUE(ibo_equal(mbc_a.ibo.lines, mbc_b.ibo.lines));
+    EXPECT_TRUE(ibo_equal(mbc_a.ibo.points, mbc_b.ibo.points));
+    EXPECT_TRUE(ibo_equal(mbc_a.ibo.lines_paint_mask, mbc_b.ibo.lines_paint_mask));
+    EXPECT_TRUE(ibo_equal(mbc_a.ibo.lines_adjacency, mbc_b.ibo.lines_adjacency));
+    test_extract_buffers_free(&mbc_b);
+  }
+  test_extract_buffers_free(&mbc_a);
+  test_extract_free(&ctx);
+}
+
+/* Splitting the extraction in ranges must not change the result of a single task. */
+TEST_F(DrawCacheExtractMeshTest, single_task)
+{
+  ExtractTestContext ctx;
+  test_extract_init(&ctx, 128);
+  MeshBufferCache mbc_single = test_extract_run_single_task(&ctx);
+  const bool is_manifold_single = ctx.cache->is_manifold;
+  MeshBufferCache mbc = test_extract_run(&ctx);
+  EXPECT_TRUE(vbo_equal(mbc_single.vbo.pos_nor, mbc.vbo.pos_nor));
+  EXPECT_TRUE(vbo_equal(mbc_single.vbo.lnor, mbc.vbo.lnor));
+  EXPECT_TRUE(vbo_equal(mbc_single.vbo.uv, mbc.vbo.uv));
+  EXPECT_TRUE(vbo_equal(mbc_single.vbo.edge_fac, mbc.vbo.edge_fac));
+  EXPECT_TRUE(vbo_equal(mbc_single.vbo.poly_idx, mbc.vbo.poly_idx));
+  EXPECT_TRUE(ibo_equal(mbc_single.ibo.tris, mbc.ibo.tris));
+  EXPECT_TRUE(ibo_equal(mbc_single.ibo.lines, mbc.ibo.lines));
+  EXPECT_TRUE(ibo_equal(mbc_single.ibo.points, mbc.ibo.points));
+  EXPECT_TRUE(ibo_equal(mbc_single.ibo.lines_paint_mask, mbc.ibo.lines_paint_mask));
+  /* Edges shared by two ranges are added when the ranges are merged, so the order of the line
+   * adjacency primitives differs from a single task on purpose. Only the primitives themselves
+   * are compared. */
+  EXPECT_EQ(ibo_primitives_sorted(mbc_single.ibo.lines_adjacency),
+            ibo_primitives_sorted(mbc.ibo.lines_adjacency));
+  EXPECT_EQ(is_manifold_single, ctx.cache->is_manifold);
+  test_extract_buffers_free(&mbc);
+  test_extract_buffers_free(&mbc_single);
+  test_extract_free(&ctx);
+}
+
+static void test_extract_performance(const int size)
+{
+  const int runs = 4;
+  ExtractTestContext ctx;
+  test_extract_init(&ctx, size);
+  const double time_start = PIL_check_seconds_timer();
+  for (int run = 0; run < runs; run++) {
+    MeshBufferCache mbc = test_extract_run(&ctx);
+    test_extract_buffers_free(&mbc);
+  }
+  const double time = (PIL_check_seconds_timer() - time_start) / runs;
+  printf("Extracted %d loops in %.2fms: %.2f M loops/s (%d threads)\n",
+         ctx.mesh->totloop,
+         time * 1000.0,
+         ctx.mesh->totloop / time * 1e-6,
+         BLI_task_scheduler_num_threads());
+  test_extract_free(&ctx);
+}
+
+/* Benchmarks, disabled by default. Run them with `--gtest_also_run_disabled_tests`. */
+TEST_F(DrawCacheExtractMeshTest, DISABLED_performance_grid_256)
+{
+  test_extract_performance(256);
+}
+
+TEST_F(DrawCacheExtractMeshTest, DISABLED_performance_grid_512)
+{
+  test_extract_performance(512);
+}
+
+}  // namespace blender::draw::tests
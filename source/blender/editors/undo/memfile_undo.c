@@ -100,6 +100,9 @@ static bool memfile_undosys_step_encode(struct bContext *UNUSED(C),
       ustack, BKE_UNDOSYS_TYPE_MEMFILE);
   us->data = BKE_memfile_undo_encode(bmain, us_prev ? us_prev->data : NULL);
   us->step.data_size = us->data->undo_size;
+  if (us_prev != NULL) {
+    us_prev->step.data_size = us_prev->data->undo_size;
+  }
 
   /* Store the fact that we should not re-use old data with that undo step, and reset the Main
    * flag. */
@@ -67,6 +67,13 @@ void GPU_indexbuf_set_point_restart(GPUIndexBufBuilder *builder, uint elem);
 void GPU_indexbuf_set_line_restart(GPUIndexBufBuilder *builder, uint elem);
 void GPU_indexbuf_set_tri_restart(GPUIndexBufBuilder *builder, uint elem);
 
+/* Merge a copy of `builder_to` that was filled using the `set` functions (e.g. on another thread)
+ * back into it. Both builders share the same data. */
+void GPU_indexbuf_join(GPUIndexBufBuilder *builder_to, const GPUIndexBufBuilder *builder_from);
+/* Append all the indices added to `builder_from`. */
+void GPU_indexbuf_add_builder(GPUIndexBufBuilder *builder_to,
+                              const GPUIndexBufBuilder *builder_from);
+
 GPUIndexBuf *GPU_indexbuf_build(GPUIndexBufBuilder *);
 void GPU_indexbuf_build_in_place(GPUIndexBufBuilder *, GPUIndexBuf *);
 
@@ -31,6 +31,8 @@
 
 #include "gpu_index_buffer_private.hh"
 
+#include <cstring>
+
 #define KEEP_SINGLE_COPY 1
 
 #define RESTART_INDEX 0xFFFFFFFF
@@ -204,6 +206,23 @@ void GPU_indexbuf_set_tri_restart(GPUIndexBufBuilder *builder, uint elem)
   }
 }
 
+void GPU_indexbuf_join(GPUIndexBufBuilder *builder_to, const GPUIndexBufBuilder *builder_from)
+{
+  BLI_assert(builder_to->data == builder_from->data);
+  builder_to->index_len = MAX2(builder_to->index_len, builder_from->index_len);
+}
+
+void GPU_indexbuf_add_builder(GPUIndexBufBuilder *builder_to,
+                              const GPUIndexBufBuilder *builder_from)
+{
+  BLI_assert(builder_to->prim_type == builder_from->prim_type);
+  BLI_assert(builder_to->index_len + builder_from->index_len <= builder_to->max_index_len);
+  memcpy(builder_to->data + builder_to->index_len,
+         builder_from->data,
+         sizeof(*builder_from->data) * builder_from->index_len);
+  builder_to->index_len += builder_from->index_len;
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
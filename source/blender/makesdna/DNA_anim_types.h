@@ -505,6 +505,9 @@ typedef struct ChannelDriver {
   /** Compiled simple arithmetic expression. */
   struct ExprPyLike_Parsed *expr_simple;
 
+  /** Runtime data, resolved RNA paths of the driven property and targets. */
+  struct AnimPathCache *path_cache;
+
   /** Result of previous evaluation. */
   float curval;
   /* XXX to be implemented... this is like the constraint influence setting. */
@@ -634,6 +637,14 @@ typedef struct FCurve {
   float color[3];
 
   float prev_norm_factor, prev_offset;
+
+  /**
+   * Runtime, index in #bezt where the last evaluation found the evaluation time, used to skip
+   * the search for sequential evaluation. Only a hint, accessed atomically since the F-Curve
+   * can be evaluated from multiple threads.
+   */
+  int eval_keyframe_index;
+  char _pad1[4];
 } FCurve;
 
 /* user-editable flags/settings */
@@ -1107,6 +1118,8 @@ typedef struct AnimData {
 
   /** Runtime data, for depsgraph evaluation. */
   FCurve **driver_array;
+  /** Runtime data, resolved RNA paths of the action F-Curves. */
+  struct AnimPathCache *path_cache;
 
   /* settings for animation evaluation */
   /** User-defined settings. */
@@ -40,6 +40,7 @@ struct MEdge;
 struct MFace;
 struct MLoop;
 struct MLoopCol;
+struct MLoopSplitFans;
 struct MLoopTri;
 struct MLoopUV;
 struct MPoly;
@@ -103,6 +104,13 @@ typedef struct Mesh_Runtime {
   /** Non-manifold boundary data for Shrinkwrap Target Project. */
   struct ShrinkwrapBoundaryData *shrinkwrap_data;
 
+  /**
+   * Smooth fans of split normals, only stored on evaluated meshes, see
+   * #BKE_mesh_loop_split_fans_ensure. Deformed results of the modifier stack pass them on to the
+   * next evaluation, see #BKE_mesh_loop_split_fans_ref.
+   */
+  struct MLoopSplitFans *loop_split_fans;
+
   /** Set by modifier stack if only deformed from original. */
   char deformed_only;
   /**
@@ -122,7 +130,13 @@ typedef struct Mesh_Runtime {
    */
   char wrapper_type_finalize;
 
-  char _pad[4];
+  /**
+   * Set when the batch cache was taken over from the previous evaluated mesh of the object,
+   * so drawing only needs to update the data that depends on vertex positions.
+   */
+  char batch_cache_deform_update;
+
+  char _pad[3];
 
   /** Needed in case we need to lazily initialize the mesh. */
   CustomData_MeshMasks cd_mask_extra;
@@ -2251,6 +2251,12 @@ typedef struct NodesModifierData {
   ModifierData modifier;
   struct bNodeTree *node_group;
   struct NodesModifierSettings settings;
+  /**
+   * Memory used to keep node results between evaluations, in megabytes. Zero (the default)
+   * disables it.
+   */
+  int cache_memory_limit;
+  char _pad[4];
 } NodesModifierData;
 
 typedef struct MeshToVolumeModifierData {
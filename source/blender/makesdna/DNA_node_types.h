@@ -412,6 +412,10 @@ typedef struct bNodeLink {
 #define NTREE_CHUNKSIZE_512 512
 #define NTREE_CHUNKSIZE_1024 1024
 
+/* tree->execution_mode */
+#define NTREE_EXECUTION_MODE_TILED 0
+#define NTREE_EXECUTION_MODE_FULL_FRAME 1
+
 /* the basis for a Node tree, all links and nodes reside internal here */
 /* only re-usable node trees are in the library though,
  * materials and textures allocate own tree struct */
@@ -449,7 +453,9 @@ typedef struct bNodeTree {
   short is_updating;
   /** Generic temporary flag for recursion check (DFS/BFS). */
   short done;
-  char _pad2[4];
+  /** Execution mode to use for compositor engine. */
+  char execution_mode;
+  char _pad2[3];
 
   /** Specific node type this tree is used for. */
   int nodetype DNA_DEPRECATED;
@@ -23,18 +23,25 @@
 
 #include <cstring>
 #include <iostream>
+#include <list>
+#include <mutex>
+#include <optional>
 #include <string>
 
 #include "MEM_guardedalloc.h"
 
 #include "BLI_float3.hh"
+#include "BLI_hash_mm2a.h"
 #include "BLI_listbase.h"
 #include "BLI_set.hh"
+#include "BLI_stack.hh"
 #include "BLI_string.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "DNA_collection_types.h"
 #include "DNA_defaults.h"
+#include "DNA_material_types.h"
 #include "DNA_mesh_types.h"
 #include "DNA_meshdata_types.h"
 #include "DNA_modifier_types.h"
@@ -44,6 +51,7 @@
 #include "DNA_scene_types.h"
 #include "DNA_screen_types.h"
 
+#include "BKE_context.h"
 #include "BKE_customdata.h"
 #include "BKE_global.h"
 #include "BKE_idprop.h"
@@ -54,6 +62,8 @@
 #include "BKE_screen.h"
 #include "BKE_simulation.h"
 
+#include "BLT_translation.h"
+
 #include "BLO_read_write.h"
 
 #include "UI_interface.h"
@@ -80,12 +90,14 @@ using blender::IndexRange;
 using blender::Map;
 using blender::Set;
 using blender::Span;
+using blender::Stack;
 using blender::StringRef;
 using blender::Vector;
 using blender::bke::PersistentCollectionHandle;
 using blender::bke::PersistentDataHandleMap;
 using blender::bke::PersistentObjectHandle;
 using blender::fn::GMutablePointer;
+using blender::fn::GPointer;
 using blender::fn::GValueMap;
 using blender::nodes::GeoNodeExecParams;
 using namespace blender::nodes::derived_node_tree_types;
@@ -212,16 +224,664 @@ static bool isDisabled(const struct Scene *UNUSED(scene),
   return false;
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Node Result Cache
+ *
+ * Results of nodes are kept in the runtime data of the modifier, so that they can be reused when
+ * the modifier is evaluated again. The results are looked up by a hash of the node and of all the
+ * values that are passed into it. Geometry is not kept to compare it later, it is only identified
+ * by its hash and its number of elements. Geometry created by a cached node is identified by the
+ * key of that node, other geometry (like the geometry passed to the modifier) is hashed by its
+ * contents.
+ *
+ * Values that reference other data-blocks which can change without a change of the value itself,
+ * like objects and collections, can't be hashed. Nodes that get such values are always executed.
+ * Results that reference such data-blocks are not cached, because the data-blocks might be freed
+ * before the result is used again.
+ * \{ */
+
+/**
+ * Builds a 64 bit hash out of two 32 bit murmur hashes with different seeds.
+ */
+class NodeCacheHasher {
+ private:
+  BLI_HashMurmur2A mm2a_[2];
+  /* Optionally all hashed data is stored as well, so that it can be compared later. */
+  Vector<uint8_t> *r_data_;
+
+ public:
+  NodeCacheHasher(Vector<uint8_t> *r_data = nullptr) : r_data_(r_data)
+  {
+    BLI_hash_mm2a_init(&mm2a_[0], 0);
+    BLI_hash_mm2a_init(&mm2a_[1], 0x9e3779b9);
+  }
+
+  void add(const void *data, const size_t size)
+  {
+    BLI_hash_mm2a_add(&mm2a_[0], (const unsigned char *)data, size);
+    BLI_hash_mm2a_add(&mm2a_[1], (const unsigned char *)data, size);
+    if (r_data_ != nullptr) {
+      r_data_->extend(Span<uint8_t>((const uint8_t *)data, (int64_t)size));
+    }
+  }
+
+  template<typename T> void add(const T &value)
+  {
+    this->add(&value, sizeof(T));
+  }
+
+  void add_string(StringRef str)
+  {
+    this->add(str.size());
+    this->add(str.data(), (size_t)str.size());
+  }
+
+  uint64_t end()
+  {
+    return ((uint64_t)BLI_hash_mm2a_end(&mm2a_[0]) << 32) | BLI_hash_mm2a_end(&mm2a_[1]);
+  }
+};
+
+static bool customdata_layer_is_hashable(const CustomDataLayer &layer)
+{
+  /* These layers store pointers to data that is not hashed. */
+  return layer.data == nullptr ||
+         !ELEM(layer.type, CD_MDISPS, CD_GRID_PAINT_MASK, CD_BM_ELEM_PYPTR);
+}
+
+static bool hash_customdata(NodeCacheHasher &hasher, const CustomData &data, const int size)
+{
+  hasher.add(size);
+  for (const int i : IndexRange(data.totlayer)) {
+    const CustomDataLayer &layer = data.layers[i];
+    hasher.add(layer.type);
+    hasher.add_string(layer.name);
+    if (layer.data == nullptr) {
+      continue;
+    }
+    if (!customdata_layer_is_hashable(layer)) {
+      return false;
+    }
+    if (layer.type == CD_MDEFORMVERT) {
+      const MDeformVert *dverts = (const MDeformVert *)layer.data;
+      for (const int i_dvert : IndexRange(size)) {
+        const MDeformVert &dvert = dverts[i_dvert];
+        hasher.add(dvert.totweight);
+        hasher.add(dvert.dw, sizeof(MDeformWeight) * (size_t)dvert.totweight);
+      }
+      continue;
+    }
+    hasher.add(layer.data, (size_t)CustomData_sizeof(layer.type) * (size_t)size);
+  }
+  return true;
+}
+
+static void hash_materials(NodeCacheHasher &hasher, const Material *const *materials, const int len)
+{
+  hasher.add(len);
+  for (const int i : IndexRange(len)) {
+    const Material *material = materials[i];
+    hasher.add(material == nullptr ? 0 : material->id.session_uuid);
+  }
+}
+
+static bool hash_mesh_component(NodeCacheHasher &hasher, const MeshComponent &component)
+{
+  const Mesh *mesh = component.get_for_read();
+  hasher.add(mesh != nullptr);
+  if (mesh == nullptr) {
+    return true;
+  }
+  hasher.add(mesh->flag);
+  hasher.add(mesh->smoothresh);
+  hash_materials(hasher, mesh->mat, mesh->totcol);
+  if (!hash_customdata(hasher, mesh->vdata, mesh->totvert) ||
+      !hash_customdata(hasher, mesh->edata, mesh->totedge) ||
+      !hash_customdata(hasher, mesh->fdata, mesh->totface) ||
+      !hash_customdata(hasher, mesh->pdata, mesh->totpoly) ||
+      !hash_customdata(hasher, mesh->ldata, mesh->totloop)) {
+    return false;
+  }
+  /* Combine the vertex group names independent of their order in the map. */
+  uint64_t vertex_groups_hash = 0;
+  for (auto item : component.vertex_group_names().items()) {
+    NodeCacheHasher item_hasher;
+    item_hasher.add_string(item.key);
+    item_hasher.add(item.value);
+    vertex_groups_hash ^= item_hasher.end();
+  }
+  hasher.add(vertex_groups_hash);
+  return true;
+}
+
+static bool hash_pointcloud_component(NodeCacheHasher &hasher,
+                                      const PointCloudComponent &component)
+{
+  const PointCloud *pointcloud = component.get_for_read();
+  hasher.add(pointcloud != nullptr);
+  if (pointcloud == nullptr) {
+    return true;
+  }
+  hash_materials(hasher, pointcloud->mat, pointcloud->totcol);
+  return hash_customdata(hasher, pointcloud->pdata, pointcloud->totpoint);
+}
+
+/**
+ * Hash the contents of a geometry component. Returns false when the component can't be hashed.
+ * Only empty instances are hashed, because instances reference objects or collections.
+ */
+static bool hash_geometry_component(NodeCacheHasher &hasher, const GeometryComponent &component)
+{
+  hasher.add(component.type());
+  switch (component.type()) {
+    case GeometryComponentType::Mesh:
+      return hash_mesh_component(hasher, static_cast<const MeshComponent &>(component));
+    case GeometryComponentType::PointCloud:
+      return hash_pointcloud_component(hasher,
+                                       static_cast<const PointCloudComponent &>(component));
+    case GeometryComponentType::Instances:
+      return static_cast<const InstancesComponent &>(component).instances_amount() == 0;
+    case GeometryComponentType::Volume:
+      /* Volume grids are not hashed. */
+      return false;
+  }
+  return false;
+}
+
+/**
+ * Add the number of elements of a component, which is compared together with its hash to make a
+ * wrong match on a hash collision less likely.
+ */
+static void hash_geometry_component_size(NodeCacheHasher &hasher,
+                                         const GeometryComponent &component)
+{
+  hasher.add(component.type());
+  switch (component.type()) {
+    case GeometryComponentType::Mesh:
+      if (const Mesh *mesh = static_cast<const MeshComponent &>(component).get_for_read()) {
+        hasher.add(mesh->totvert);
+        hasher.add(mesh->totedge);
+        hasher.add(mesh->totpoly);
+        hasher.add(mesh->totloop);
+      }
+      break;
+    case GeometryComponentType::PointCloud:
+      if (const PointCloud *pointcloud =
+              static_cast<const PointCloudComponent &>(component).get_for_read()) {
+        hasher.add(pointcloud->totpoint);
+      }
+      break;
+    case GeometryComponentType::Instances:
+      hasher.add(static_cast<const InstancesComponent &>(component).instances_amount());
+      break;
+    case GeometryComponentType::Volume:
+      break;
+  }
+}
+
+static const GeometryComponentType geometry_component_types[] = {
+    GeometryComponentType::Mesh,
+    GeometryComponentType::PointCloud,
+    GeometryComponentType::Instances,
+    GeometryComponentType::Volume,
+};
+
+/**
+ * Results are only cached when they don't reference data that might be freed before the result
+ * is used again, like the mesh passed to the modifier or objects and collections.
+ */
+static bool geometry_set_is_cachable(const GeometrySet &geometry_set)
+{
+  for (const GeometryComponentType type : geometry_component_types) {
+    const GeometryComponent *component = geometry_set.get_component_for_read(type);
+    if (component == nullptr) {
+      continue;
+    }
+    if (!component->owns_direct_data()) {
+      return false;
+    }
+    if (type == GeometryComponentType::Instances &&
+        static_cast<const InstancesComponent *>(component)->instances_amount() > 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static int64_t customdata_memory_size(const CustomData &data, const int size)
+{
+  int64_t memory_size = 0;
+  for (const int i : IndexRange(data.totlayer)) {
+    memory_size += (int64_t)CustomData_sizeof(data.layers[i].type) * size;
+  }
+  return memory_size;
+}
+
+static int64_t geometry_set_memory_size(const GeometrySet &geometry_set)
+{
+  int64_t memory_size = 0;
+  if (const Mesh *mesh = geometry_set.get_mesh_for_read()) {
+    memory_size += customdata_memory_size(mesh->vdata, mesh->totvert);
+    memory_size += customdata_memory_size(mesh->edata, mesh->totedge);
+    memory_size += customdata_memory_size(mesh->pdata, mesh->totpoly);
+    memory_size += customdata_memory_size(mesh->ldata, mesh->totloop);
+  }
+  if (const PointCloud *pointcloud = geometry_set.get_pointcloud_for_read()) {
+    memory_size += customdata_memory_size(pointcloud->pdata, pointcloud->totpoint);
+  }
+  return memory_size;
+}
+
+/**
+ * An estimate of the memory that is used by a value, used to limit the size of the cache.
+ */
+static int64_t value_memory_size(const GPointer value)
+{
+  const CPPType &type = *value.type();
+  int64_t memory_size = type.size();
+  if (type.is<GeometrySet>()) {
+    memory_size += geometry_set_memory_size(*(const GeometrySet *)value.get());
+  }
+  return memory_size;
+}
+
+/**
+ * Identifies a cached result. Besides the hash, the key contains the data the hash has been
+ * computed from, which is compared before a result is reused. That is the identity and settings
+ * of the node and the input values, where geometry is only represented by the hashes and the
+ * number of elements of its components.
+ */
+struct NodeResultCacheKey {
+  uint64_t hash = 0;
+  Vector<uint8_t> data;
+
+  friend bool operator==(const NodeResultCacheKey &a, const NodeResultCacheKey &b)
+  {
+    return a.hash == b.hash && a.data.size() == b.data.size() &&
+           memcmp(a.data.data(), b.data.data(), (size_t)a.data.size()) == 0;
+  }
+};
+
+struct NodeResultCacheEntry {
+  NodeResultCacheKey key;
+  /* Copies of the available outputs of the node, in the order of the sockets. */
+  Vector<GMutablePointer> values;
+  int64_t memory_size = 0;
+};
+
+/**
+ * Hash of a geometry component that is referenced by the results of cache entries. Such
+ * components are not modified anymore, because they are shared, and they are not freed while
+ * they are referenced. The hash is derived from the key of the entry that created the component.
+ */
+struct CachedComponentHash {
+  /* Number of cache entries that reference the component. */
+  int users = 0;
+  uint64_t hash = 0;
+};
+
+using NodeResultCacheEntryIterator = std::list<NodeResultCacheEntry>::iterator;
+
+/**
+ * Runtime data of the modifier, which is kept when the evaluated modifier is updated.
+ */
+struct NodesModifierRuntime {
+  /* Nodes are executed on multiple threads, so access to the members is locked. */
+  std::mutex mutex;
+  /* Cached results, the most recently used one first. */
+  std::list<NodeResultCacheEntry> entries;
+  /* The cached results by the hash of their key. */
+  Map<uint64_t, Vector<NodeResultCacheEntryIterator>> entries_by_hash;
+  /* Avoids hashing the contents of geometry created by cached nodes when it is passed to another
+   * node. */
+  Map<const GeometryComponent *, CachedComponentHash> component_hashes;
+  int64_t memory_size = 0;
+  /* Statistics displayed in the user interface. */
+  int64_t hits = 0;
+  int64_t misses = 0;
+};
+
+template<typename Func>
+static void cache_entry_foreach_component(const NodeResultCacheEntry &entry, const Func &func)
+{
+  for (const int value_index : entry.values.index_range()) {
+    const GMutablePointer value = entry.values[value_index];
+    if (!value.type()->is<GeometrySet>()) {
+      continue;
+    }
+    const GeometrySet &geometry_set = *(const GeometrySet *)value.get();
+    for (const GeometryComponentType type : geometry_component_types) {
+      if (const GeometryComponent *component = geometry_set.get_component_for_read(type)) {
+        func(value_index, component);
+      }
+    }
+  }
+}
+
+static void cache_entry_free_values(NodeResultCacheEntry &entry)
+{
+  for (GMutablePointer value : entry.values) {
+    value.destruct();
+    MEM_freeN(value.get());
+  }
+  entry.values.clear();
+}
+
+static void cache_remove_entry(NodesModifierRuntime &runtime,
+                               const NodeResultCacheEntryIterator entry_it)
+{
+  NodeResultCacheEntry &entry = *entry_it;
+  Vector<NodeResultCacheEntryIterator> &same_hash_entries = runtime.entries_by_hash.lookup(
+      entry.key.hash);
+  same_hash_entries.remove_first_occurrence_and_reorder(entry_it);
+  if (same_hash_entries.is_empty()) {
+    runtime.entries_by_hash.remove(entry.key.hash);
+  }
+  cache_entry_foreach_component(
+      entry, [&](int UNUSED(value_index), const GeometryComponent *component) {
+        CachedComponentHash &component_hash = runtime.component_hashes.lookup(component);
+        if (--component_hash.users == 0) {
+          runtime.component_hashes.remove(component);
+        }
+      });
+  runtime.memory_size -= entry.memory_size;
+  cache_entry_free_values(entry);
+  runtime.entries.erase(entry_it);
+}
+
+static void cache_clear(NodesModifierRuntime &runtime)
+{
+  for (NodeResultCacheEntry &entry : runtime.entries) {
+    cache_entry_free_values(entry);
+  }
+  runtime.entries.clear();
+  runtime.entries_by_hash.clear();
+  runtime.component_hashes.clear();
+  runtime.memory_size = 0;
+}
+
+/**
+ * Remove the entries that have not been used for the longest time until the memory limit is met.
+ */
+static void cache_enforce_memory_limit(NodesModifierRuntime &runtime, const int64_t memory_limit)
+{
+  while (runtime.memory_size > memory_limit && !runtime.entries.empty()) {
+    cache_remove_entry(runtime, std::prev(runtime.entries.end()));
+  }
+}
+
+static NodesModifierRuntime *nodes_modifier_ensure_runtime(NodesModifierData *nmd)
+{
+  if (nmd->modifier.runtime == nullptr) {
+    nmd->modifier.runtime = OBJECT_GUARDED_NEW(NodesModifierRuntime);
+  }
+  return (NodesModifierRuntime *)nmd->modifier.runtime;
+}
+
+static void freeRuntimeData(void *runtime_data_v)
+{
+  if (runtime_data_v == nullptr) {
+    return;
+  }
+  NodesModifierRuntime *runtime = (NodesModifierRuntime *)runtime_data_v;
+  cache_clear(*runtime);
+  OBJECT_GUARDED_DELETE(runtime, NodesModifierRuntime);
+}
+
+/**
+ * The cache used by one evaluation of the node tree.
+ */
+class NodeResultCache {
+ private:
+  NodesModifierRuntime &runtime_;
+  int64_t memory_limit_;
+  eEvaluationMode evaluation_mode_;
+
+ public:
+  NodeResultCache(NodesModifierRuntime &runtime,
+                  const int64_t memory_limit,
+                  const eEvaluationMode evaluation_mode)
+      : runtime_(runtime), memory_limit_(memory_limit), evaluation_mode_(evaluation_mode)
+  {
+    std::lock_guard lock{runtime_.mutex};
+    cache_enforce_memory_limit(runtime_, memory_limit_);
+  }
+
+  /**
+   * Only nodes whose result depends on nothing but their settings and inputs can be cached.
+   * Nodes that support laziness are not cached, because they don't get all their inputs.
+   */
+  static bool node_is_cachable(const DNode &node)
+  {
+    const bNode &bnode = *node.bnode();
+    return bnode.typeinfo->geometry_node_execute != nullptr &&
+           !bnode.typeinfo->geometry_node_execute_supports_laziness && bnode.id == nullptr;
+  }
+
+  /**
+   * Add the identity and settings of the node to the key. The node is identified by its name and
+   * the names of the group nodes it is in, since the node tree is copied when it is evaluated
+   * again.
+   */
+  void add_node_to_key(NodeCacheHasher &hasher, const DNode &node) const
+  {
+    hasher.add(evaluation_mode_);
+    for (const DParentNode *parent = node.parent(); parent != nullptr;
+         parent = parent->parent()) {
+      hasher.add_string(parent->node_ref().bnode()->name);
+    }
+    const bNode &bnode = *node.bnode();
+    hasher.add_string(bnode.name);
+    hasher.add_string(bnode.idname);
+    hasher.add(bnode.custom1);
+    hasher.add(bnode.custom2);
+    hasher.add(bnode.custom3);
+    hasher.add(bnode.custom4);
+    if (bnode.storage != nullptr) {
+      hasher.add(bnode.storage, MEM_allocN_len(bnode.storage));
+    }
+  }
+
+  /**
+   * Add a value that is passed into the node to the key. Returns false when the value can't be
+   * hashed, the node using the value can't be cached then.
+   */
+  bool add_input_to_key(NodeCacheHasher &hasher, const GPointer value)
+  {
+    const CPPType &type = *value.type();
+    hasher.add_string(type.name());
+    if (type.is<GeometrySet>()) {
+      const GeometrySet &geometry_set = *(const GeometrySet *)value.get();
+      for (const GeometryComponentType component_type : geometry_component_types) {
+        const GeometryComponent *component = geometry_set.get_component_for_read(
+            component_type);
+        hasher.add(component != nullptr);
+        if (component == nullptr) {
+          continue;
+        }
+        uint64_t component_hash;
+        if (!this->hash_component(*component, component_hash)) {
+          return false;
+        }
+        hasher.add(component_hash);
+        hash_geometry_component_size(hasher, *component);
+      }
+      return true;
+    }
+    if (type.is<std::string>()) {
+      hasher.add_string(*(const std::string *)value.get());
+      return true;
+    }
+    if (type.is<float>() || type.is<int>() || type.is<bool>() || type.is<float3>() ||
+        type.is<blender::Color4f>()) {
+      hasher.add(value.get(), (size_t)type.size());
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * Copy the cached results into the allocator. Returns false when there is no cached result.
+   */
+  bool lookup(const NodeResultCacheKey &key,
+              blender::LinearAllocator<> &allocator,
+              Vector<GMutablePointer> &r_values)
+  {
+    std::lock_guard lock{runtime_.mutex};
+    const Vector<NodeResultCacheEntryIterator> *same_hash_entries =
+        runtime_.entries_by_hash.lookup_ptr(key.hash);
+    if (same_hash_entries != nullptr) {
+      for (const NodeResultCacheEntryIterator entry_it : *same_hash_entries) {
+        if (!(entry_it->key == key)) {
+          continue;
+        }
+        runtime_.hits++;
+        /* Move the entry to the front of the list of recently used entries. */
+        runtime_.entries.splice(runtime_.entries.begin(), runtime_.entries, entry_it);
+        for (GMutablePointer value : entry_it->values) {
+          const CPPType &type = *value.type();
+          void *buffer = allocator.allocate(type.size(), type.alignment());
+          type.copy_to_uninitialized(value.get(), buffer);
+          r_values.append({type, buffer});
+        }
+        return true;
+      }
+    }
+    runtime_.misses++;
+    return false;
+  }
+
+  void add(NodeResultCacheKey &&key, Span<GMutablePointer> values)
+  {
+    NodeResultCacheEntry entry;
+    for (GMutablePointer value : values) {
+      const CPPType &type = *value.type();
+      if (type.is<GeometrySet>() && !geometry_set_is_cachable(*(const GeometrySet *)value.get())) {
+        cache_entry_free_values(entry);
+        return;
+      }
+      void *buffer = MEM_mallocN_aligned(type.size(), type.alignment(), __func__);
+      type.copy_to_uninitialized(value.get(), buffer);
+      entry.values.append({type, buffer});
+      entry.memory_size += value_memory_size(value);
+    }
+    entry.key = std::move(key);
+    if (entry.memory_size > memory_limit_) {
+      cache_entry_free_values(entry);
+      return;
+    }
+
+    std::lock_guard lock{runtime_.mutex};
+    const Vector<NodeResultCacheEntryIterator> *same_hash_entries =
+        runtime_.entries_by_hash.lookup_ptr(entry.key.hash);
+    if (same_hash_entries != nullptr) {
+      for (const NodeResultCacheEntryIterator entry_it : *same_hash_entries) {
+        if (entry_it->key == entry.key) {
+          /* The same result has been computed by another node. */
+          cache_entry_free_values(entry);
+          return;
+        }
+      }
+    }
+    /* Geometry created by the node is identified by the key of the node and the output it belongs
+     * to, so it does not have to be hashed by its contents when it is passed to other nodes. A
+     * component that is passed through from an input keeps its hash. */
+    cache_entry_foreach_component(entry, [&](int value_index, const GeometryComponent *component) {
+      CachedComponentHash &component_hash = runtime_.component_hashes.lookup_or_add_default(
+          component);
+      if (component_hash.users++ == 0) {
+        NodeCacheHasher hasher;
+        hasher.add(entry.key.hash);
+        hasher.add(value_index);
+        hasher.add(component->type());
+        component_hash.hash = hasher.end();
+      }
+    });
+    runtime_.memory_size += entry.memory_size;
+    runtime_.entries.push_front(std::move(entry));
+    runtime_.entries_by_hash.lookup_or_add_default(runtime_.entries.front().key.hash)
+        .append(runtime_.entries.begin());
+    cache_enforce_memory_limit(runtime_, memory_limit_);
+  }
+
+ private:
+  /**
+   * Geometry that is referenced by the results of the cache has the hash derived from the key of
+   * the node that created it. Other geometry, like the geometry passed to the modifier or created
+   * by nodes that are not cached, is hashed by its contents.
+   */
+  bool hash_component(const GeometryComponent &component, uint64_t &r_hash)
+  {
+    {
+      std::lock_guard lock{runtime_.mutex};
+      const CachedComponentHash *cached_hash = runtime_.component_hashes.lookup_ptr(&component);
+      if (cached_hash != nullptr) {
+        r_hash = cached_hash->hash;
+        return true;
+      }
+    }
+    NodeCacheHasher hasher;
+    if (!hash_geometry_component(hasher, component)) {
+      return false;
+    }
+    r_hash = hasher.end();
+    return true;
+  }
+};
+
+/** \} */
+
+/**
+ * Evaluates the nodes that are required to compute the group outputs. Nodes are only executed
+ * when one of their outputs is requested, and a node requests the values of its inputs before it
+ * is executed. Every node is executed in a task that is scheduled as soon as all requested input
+ * values have been computed, so that independent branches of the node tree are evaluated in
+ * parallel.
+ *
+ * Nodes that support laziness only request the inputs they actually use while they are executed.
+ * Branches of the node tree that are not used are not evaluated at all then.
+ */
 class GeometryNodesEvaluator {
  private:
+  /**
+   * Runtime data of a node that might have to be executed to compute the group outputs.
+   */
+  struct NodeState {
+    /* Protects the members below, because values are forwarded from other threads. */
+    std::mutex mutex;
+    /* True when the node has been requested by another node. */
+    bool is_required = false;
+    /* Inputs whose values have been requested but are not passed to the node yet. */
+    Set<const DInputSocket *> required_inputs;
+    /* Values of links that have been computed already. */
+    Map<std::pair<const DInputSocket *, const DOutputSocket *>, GMutablePointer> link_values;
+    /* Number of links of required inputs whose value has not been computed yet. The node is
+     * scheduled for execution once this reaches zero. */
+    int links_pending = 0;
+
+    /* The members below are only accessed by the thread that is executing the node. */
+
+    /* Values created while executing the node are allocated here. They may outlive the execution,
+     * because they are forwarded to other nodes. Every node has its own allocator because
+     * #LinearAllocator is not thread-safe. */
+    blender::LinearAllocator<> allocator;
+    /* Input values that have been passed to the node. Nodes that support laziness can be executed
+     * more than once, the values they have not extracted yet are kept here in the meantime. */
+    GValueMap<StringRef> inputs{allocator};
+  };
+
   blender::LinearAllocator<> allocator_;
-  Map<std::pair<const DInputSocket *, const DOutputSocket *>, GMutablePointer> value_by_input_;
+  Map<const DNode *, std::unique_ptr<NodeState>> node_states_;
+  Set<const DOutputSocket *> group_input_sockets_;
   Vector<const DInputSocket *> group_outputs_;
+  const DNode *group_output_node_;
   blender::nodes::MultiFunctionByNode &mf_by_node_;
   const blender::nodes::DataTypeConversions &conversions_;
   const PersistentDataHandleMap &handle_map_;
   const Object *self_object_;
   Depsgraph *depsgraph_;
+  /* Optional cache for the results of nodes. */
+  NodeResultCache *cache_;
 
  public:
   GeometryNodesEvaluator(const Map<const DOutputSocket *, GMutablePointer> &group_input_data,
@@ -229,127 +889,341 @@ class GeometryNodesEvaluator {
                          blender::nodes::MultiFunctionByNode &mf_by_node,
                          const PersistentDataHandleMap &handle_map,
                          const Object *self_object,
-                         Depsgraph *depsgraph)
+                         Depsgraph *depsgraph,
+                         NodeResultCache *cache)
       : group_outputs_(std::move(group_outputs)),
+        group_output_node_(&group_outputs_[0]->node()),
         mf_by_node_(mf_by_node),
         conversions_(blender::nodes::get_implicit_type_conversions()),
         handle_map_(handle_map),
         self_object_(self_object),
-        depsgraph_(depsgraph)
+        depsgraph_(depsgraph),
+        cache_(cache)
   {
+    for (const DOutputSocket *socket : group_input_data.keys()) {
+      group_input_sockets_.add_new(socket);
+    }
+    this->initialize_node_states();
     for (auto item : group_input_data.items()) {
-      this->forward_to_inputs(*item.key, item.value);
+      this->forward_to_inputs(*item.key, item.value, allocator_, nullptr);
     }
   }
 
   Vector<GMutablePointer> execute()
   {
+    TaskPool *task_pool = (G.debug & G_DEBUG_DEPSGRAPH_NO_THREADS) ?
+                              BLI_task_pool_create_no_threads(this) :
+                              BLI_task_pool_create_suspended(this, TASK_PRIORITY_HIGH);
+    /* The group output node itself is never executed, it only requests the values. */
+    node_states_.lookup(group_output_node_)->is_required = true;
+    this->require_inputs(*group_output_node_, group_outputs_, task_pool);
+    BLI_task_pool_work_and_wait(task_pool);
+    BLI_task_pool_free(task_pool);
+
+    NodeState &output_state = *node_states_.lookup(group_output_node_);
     Vector<GMutablePointer> results;
     for (const DInputSocket *group_output : group_outputs_) {
-      Vector<GMutablePointer> result = this->get_input_values(*group_output);
+      Vector<GMutablePointer> result = this->get_input_values(
+          *group_output, output_state, allocator_);
       results.append(result[0]);
     }
-    for (GMutablePointer value : value_by_input_.values()) {
-      value.destruct();
+    for (std::unique_ptr<NodeState> &state : node_states_.values()) {
+      for (GMutablePointer value : state->link_values.values()) {
+        value.destruct();
+      }
     }
     return results;
   }
 
  private:
-  Vector<GMutablePointer> get_input_values(const DInputSocket &socket_to_compute)
+  /**
+   * Create a state for every node that might have to be executed to compute the group outputs.
+   */
+  void initialize_node_states()
   {
+    Set<const DOutputSocket *> unavailable_outputs;
+    Stack<const DInputSocket *> sockets_to_check;
+    node_states_.add_new(group_output_node_, std::make_unique<NodeState>());
+    sockets_to_check.push_multiple(group_outputs_.as_span());
+
+    while (!sockets_to_check.is_empty()) {
+      const DInputSocket &socket = *sockets_to_check.pop();
+      if (!this->is_computed_from_links(socket)) {
+        continue;
+      }
+      for (const DOutputSocket *from_socket : socket.linked_sockets()) {
+        if (group_input_sockets_.contains(from_socket)) {
+          continue;
+        }
+        if (!from_socket->is_available()) {
+          unavailable_outputs.add(from_socket);
+          continue;
+        }
+        const DNode &from_node = from_socket->node();
+        if (!node_states_.add(&from_node, std::make_unique<NodeState>())) {
+          continue;
+        }
+        for (const DInputSocket *input_socket : from_node.inputs()) {
+          if (input_socket->is_available()) {
+            sockets_to_check.push(input_socket);
+          }
+        }
+      }
+    }
 
-    Span<const DOutputSocket *> from_sockets = socket_to_compute.linked_sockets();
-    Span<const DGroupInput *> from_group_inputs = socket_to_compute.linked_group_inputs();
-    const int total_inputs = from_sockets.size() + from_group_inputs.size();
+    /* Outputs that are not available don't require their node to be executed, a default value is
+     * used instead. */
+    for (const DOutputSocket *socket : unavailable_outputs) {
+      const CPPType &type = *blender::nodes::socket_cpp_type_get(*socket->typeinfo());
+      void *buffer = allocator_.allocate(type.size(), type.alignment());
+      type.copy_to_uninitialized(type.default_value(), buffer);
+      this->forward_to_inputs(*socket, {type, buffer}, allocator_, nullptr);
+    }
+  }
 
-    if (total_inputs == 0) {
-      /* The input is not connected, use the value from the socket itself. */
-      return {get_unlinked_input_value(socket_to_compute)};
+  /**
+   * Returns false when the value of the input socket does not depend on the links to other
+   * nodes, and the value stored in the socket itself is used instead.
+   */
+  bool is_computed_from_links(const DInputSocket &socket) const
+  {
+    return socket.linked_sockets().size() > 0 && socket.linked_group_inputs().size() != 1;
+  }
+
+  bool node_supports_laziness(const DNode &node) const
+  {
+    return node.typeinfo()->geometry_node_execute_supports_laziness;
+  }
+
+  /**
+   * Request the outputs of a node. Nodes are only executed once, even when they are requested
+   * from multiple other nodes.
+   */
+  void require_node(const DNode &node, TaskPool *pool)
+  {
+    NodeState &state = *node_states_.lookup(&node);
+    {
+      std::lock_guard lock{state.mutex};
+      if (state.is_required) {
+        return;
+      }
+      state.is_required = true;
     }
 
-    if (from_group_inputs.size() == 1) {
-      return {get_unlinked_input_value(socket_to_compute)};
+    Vector<const DInputSocket *> inputs_to_require;
+    for (const DInputSocket *input_socket : node.inputs()) {
+      /* Nodes that support laziness only get the values that don't have to be computed up
+       * front. They request other inputs themselves. */
+      if (!this->node_supports_laziness(node) || !this->is_computed_from_links(*input_socket)) {
+        inputs_to_require.append(input_socket);
+      }
     }
+    this->require_inputs(node, inputs_to_require, pool);
+  }
 
-    /* Multi-input sockets contain a vector of inputs. */
-    if (socket_to_compute.is_multi_input_socket()) {
-      Vector<GMutablePointer> values;
-      for (const DOutputSocket *from_socket : from_sockets) {
-        const std::pair<const DInputSocket *, const DOutputSocket *> key = std::make_pair(
-            &socket_to_compute, from_socket);
-        std::optional<GMutablePointer> value = value_by_input_.pop_try(key);
-        if (value.has_value()) {
-          values.append(*value);
+  /**
+   * Request the values of the given input sockets. The node is scheduled for execution once all
+   * of them have been computed.
+   */
+  void require_inputs(const DNode &node, Span<const DInputSocket *> sockets, TaskPool *pool)
+  {
+    NodeState &state = *node_states_.lookup(&node);
+    Vector<const DNode *> nodes_to_require;
+    bool is_ready;
+    {
+      std::lock_guard lock{state.mutex};
+      for (const DInputSocket *socket : sockets) {
+        if (!socket->is_available() || !state.required_inputs.add(socket)) {
+          continue;
         }
-        else {
-          this->compute_output_and_forward(*from_socket);
-          GMutablePointer value = value_by_input_.pop(key);
-          values.append(value);
+        if (!this->is_computed_from_links(*socket)) {
+          continue;
+        }
+        for (const DOutputSocket *from_socket : socket->linked_sockets()) {
+          if (state.link_values.contains(std::make_pair(socket, from_socket))) {
+            continue;
+          }
+          state.links_pending++;
+          nodes_to_require.append(&from_socket->node());
         }
       }
-      return values;
+      is_ready = state.links_pending == 0;
     }
 
-    const DOutputSocket &from_socket = *from_sockets[0];
-    const std::pair<const DInputSocket *, const DOutputSocket *> key = std::make_pair(
-        &socket_to_compute, &from_socket);
-    std::optional<GMutablePointer> value = value_by_input_.pop_try(key);
-    if (value.has_value()) {
-      /* This input has been computed before, return it directly. */
-      return {*value};
+    if (is_ready) {
+      this->schedule_node(node, pool);
+    }
+    for (const DNode *node_to_require : nodes_to_require) {
+      this->require_node(*node_to_require, pool);
     }
+  }
 
-    /* Compute the socket now. */
-    this->compute_output_and_forward(from_socket);
-    return {value_by_input_.pop(key)};
+  void schedule_node(const DNode &node, TaskPool *pool)
+  {
+    if (&node == group_output_node_) {
+      return;
+    }
+    BLI_task_pool_push(pool, execute_node_task, (void *)&node, false, nullptr);
   }
 
-  void compute_output_and_forward(const DOutputSocket &socket_to_compute)
+  static void execute_node_task(TaskPool *__restrict pool, void *taskdata)
   {
-    const DNode &node = socket_to_compute.node();
-    const bNode &bnode = *node.bnode();
+    GeometryNodesEvaluator &evaluator = *(GeometryNodesEvaluator *)BLI_task_pool_user_data(pool);
+    const DNode &node = *(const DNode *)taskdata;
 
-    if (!socket_to_compute.is_available()) {
-      /* If the output is not available, use a default value. */
-      const CPPType &type = *blender::nodes::socket_cpp_type_get(*socket_to_compute.typeinfo());
-      void *buffer = allocator_.allocate(type.size(), type.alignment());
-      type.copy_to_uninitialized(type.default_value(), buffer);
-      this->forward_to_inputs(socket_to_compute, {type, buffer});
-      return;
+    evaluator.compute_node_and_forward(node, pool);
+  }
+
+  /**
+   * Get the values for an input socket. The values of linked sockets have to be computed already.
+   * Multi-input sockets contain a vector of inputs.
+   */
+  Vector<GMutablePointer> get_input_values(const DInputSocket &socket_to_compute,
+                                           NodeState &state,
+                                           blender::LinearAllocator<> &allocator)
+  {
+    if (!this->is_computed_from_links(socket_to_compute)) {
+      /* The input is not connected, use the value from the socket itself. */
+      return {get_unlinked_input_value(socket_to_compute, allocator)};
     }
 
-    /* Prepare inputs required to execute the node. */
-    GValueMap<StringRef> node_inputs_map{allocator_};
-    for (const DInputSocket *input_socket : node.inputs()) {
-      if (input_socket->is_available()) {
-        Vector<GMutablePointer> values = this->get_input_values(*input_socket);
+    Vector<GMutablePointer> values;
+    for (const DOutputSocket *from_socket : socket_to_compute.linked_sockets()) {
+      const std::pair<const DInputSocket *, const DOutputSocket *> key = std::make_pair(
+          &socket_to_compute, from_socket);
+      values.append(state.link_values.pop(key));
+    }
+    return values;
+  }
+
+  void compute_node_and_forward(const DNode &node, TaskPool *pool)
+  {
+    const bNode &bnode = *node.bnode();
+    NodeState &state = *node_states_.lookup(&node);
+
+    const bool use_cache = cache_ != nullptr && NodeResultCache::node_is_cachable(node);
+    NodeResultCacheKey cache_key;
+    NodeCacheHasher key_hasher{&cache_key.data};
+    bool inputs_are_hashable = use_cache;
+    if (use_cache) {
+      cache_->add_node_to_key(key_hasher, node);
+    }
+
+    /* Pass the requested input values to the node. The inputs are iterated in the order of the
+     * sockets, so that the hash of the values does not depend on the order of the set. */
+    {
+      std::lock_guard lock{state.mutex};
+      for (const DInputSocket *input_socket : node.inputs()) {
+        if (!state.required_inputs.contains(input_socket)) {
+          continue;
+        }
+        Vector<GMutablePointer> values = this->get_input_values(
+            *input_socket, state, state.allocator);
         for (int i = 0; i < values.size(); ++i) {
+          if (inputs_are_hashable) {
+            inputs_are_hashable = cache_->add_input_to_key(key_hasher, values[i]);
+          }
           /* Values from Multi Input Sockets are stored in input map with the format
            * <identifier>[<index>]. */
-          blender::StringRefNull key = allocator_.copy_string(
+          blender::StringRefNull key = state.allocator.copy_string(
               input_socket->identifier() + (i > 0 ? ("[" + std::to_string(i)) + "]" : ""));
-          node_inputs_map.add_new_direct(key, std::move(values[i]));
+          state.inputs.add_new_direct(key, std::move(values[i]));
         }
       }
+      state.required_inputs.clear();
+    }
+
+    if (inputs_are_hashable) {
+      cache_key.hash = key_hasher.end();
+      Vector<GMutablePointer> cached_values;
+      if (cache_->lookup(cache_key, state.allocator, cached_values)) {
+        this->destruct_node_inputs(node, state);
+        int value_index = 0;
+        for (const DOutputSocket *output_socket : node.outputs()) {
+          if (output_socket->is_available()) {
+            this->forward_to_inputs(
+                *output_socket, cached_values[value_index++], state.allocator, pool);
+          }
+        }
+        return;
+      }
     }
 
     /* Execute the node. */
-    GValueMap<StringRef> node_outputs_map{allocator_};
-    GeoNodeExecParams params{
-        bnode, node_inputs_map, node_outputs_map, handle_map_, self_object_, depsgraph_};
-    this->execute_node(node, params);
+    GValueMap<StringRef> node_outputs_map{state.allocator};
+    Vector<StringRef> lazy_required_inputs;
+    GeoNodeExecParams params{bnode,
+                             state.inputs,
+                             node_outputs_map,
+                             handle_map_,
+                             self_object_,
+                             depsgraph_,
+                             lazy_required_inputs};
+    this->execute_node(node, params, state.allocator);
+
+    if (!lazy_required_inputs.is_empty()) {
+      /* The node needs more inputs, it is executed again once they are computed. */
+      Vector<const DInputSocket *> inputs_to_require;
+      for (const DInputSocket *input_socket : node.inputs()) {
+        if (input_socket->is_available() &&
+            lazy_required_inputs.contains(input_socket->identifier())) {
+          inputs_to_require.append(input_socket);
+        }
+      }
+      if (!inputs_to_require.is_empty()) {
+        this->require_inputs(node, inputs_to_require, pool);
+        return;
+      }
+      /* Only inputs that can't be computed have been requested, output default values instead of
+       * executing the node again forever. */
+      BLI_assert(false);
+      this->execute_unknown_node(node, params);
+    }
 
-    /* Forward computed outputs to linked input sockets. */
+    Vector<std::pair<const DOutputSocket *, GMutablePointer>> output_values;
     for (const DOutputSocket *output_socket : node.outputs()) {
       if (output_socket->is_available()) {
-        GMutablePointer value = node_outputs_map.extract(output_socket->identifier());
-        this->forward_to_inputs(*output_socket, value);
+        output_values.append(
+            {output_socket, node_outputs_map.extract(output_socket->identifier())});
+      }
+    }
+
+    if (inputs_are_hashable) {
+      Vector<GMutablePointer> values_to_cache;
+      for (auto &item : output_values) {
+        values_to_cache.append(item.second);
+      }
+      cache_->add(std::move(cache_key), values_to_cache);
+    }
+
+    /* Forward computed outputs to linked input sockets. */
+    for (auto &item : output_values) {
+      this->forward_to_inputs(*item.first, item.second, state.allocator, pool);
+    }
+  }
+
+  /**
+   * Remove the inputs that have been passed to a node which is not executed.
+   */
+  void destruct_node_inputs(const DNode &node, NodeState &state)
+  {
+    for (const DInputSocket *input_socket : node.inputs()) {
+      if (!input_socket->is_available()) {
+        continue;
+      }
+      const std::string identifier = input_socket->identifier();
+      if (state.inputs.contains(identifier)) {
+        state.inputs.extract(identifier).destruct();
+      }
+      for (int i = 1; state.inputs.contains(identifier + "[" + std::to_string(i) + "]"); i++) {
+        state.inputs.extract(identifier + "[" + std::to_string(i) + "]").destruct();
       }
     }
   }
 
-  void execute_node(const DNode &node, GeoNodeExecParams params)
+  void execute_node(const DNode &node,
+                    GeoNodeExecParams params,
+                    blender::LinearAllocator<> &allocator)
   {
     const bNode &bnode = params.node();
 
@@ -362,7 +1236,7 @@ class GeometryNodesEvaluator {
     /* Use the multi-function implementation if it exists. */
     const MultiFunction *multi_function = mf_by_node_.lookup_default(&node, nullptr);
     if (multi_function != nullptr) {
-      this->execute_multi_function_node(node, params, *multi_function);
+      this->execute_multi_function_node(node, params, *multi_function, allocator);
       return;
     }
 
@@ -372,7 +1246,8 @@ class GeometryNodesEvaluator {
 
   void execute_multi_function_node(const DNode &node,
                                    GeoNodeExecParams params,
-                                   const MultiFunction &fn)
+                                   const MultiFunction &fn,
+                                   blender::LinearAllocator<> &allocator)
   {
     MFContextBuilder fn_context;
     MFParamsBuilder fn_params{fn, 1};
@@ -388,7 +1263,7 @@ class GeometryNodesEvaluator {
     for (const DOutputSocket *dsocket : node.outputs()) {
       if (dsocket->is_available()) {
         const CPPType &type = *blender::nodes::socket_cpp_type_get(*dsocket->typeinfo());
-        void *buffer = allocator_.allocate(type.size(), type.alignment());
+        void *buffer = allocator.allocate(type.size(), type.alignment());
         fn_params.add_uninitialized_single_output(GMutableSpan(type, buffer, 1));
         output_data.append(GMutablePointer(type, buffer));
       }
@@ -418,7 +1293,10 @@ class GeometryNodesEvaluator {
     }
   }
 
-  void forward_to_inputs(const DOutputSocket &from_socket, GMutablePointer value_to_forward)
+  void forward_to_inputs(const DOutputSocket &from_socket,
+                         GMutablePointer value_to_forward,
+                         blender::LinearAllocator<> &allocator,
+                         TaskPool *pool)
   {
     /* For all sockets that are linked with the from_socket push the value to their node. */
     Span<const DInputSocket *> to_sockets_all = from_socket.linked_sockets();
@@ -433,14 +1311,14 @@ class GeometryNodesEvaluator {
         to_sockets_same_type.append(to_socket);
       }
       else {
-        void *buffer = allocator_.allocate(to_type.size(), to_type.alignment());
+        void *buffer = allocator.allocate(to_type.size(), to_type.alignment());
         if (conversions_.is_convertible(from_type, to_type)) {
           conversions_.convert(from_type, to_type, value_to_forward.get(), buffer);
         }
         else {
           to_type.copy_to_uninitialized(to_type.default_value(), buffer);
         }
-        add_value_to_input_socket(key, GMutablePointer{to_type, buffer});
+        add_value_to_input_socket(key, GMutablePointer{to_type, buffer}, pool);
       }
     }
 
@@ -454,7 +1332,7 @@ class GeometryNodesEvaluator {
       const std::pair<const DInputSocket *, const DOutputSocket *> key = std::make_pair(
           to_socket, &from_socket);
 
-      add_value_to_input_socket(key, value_to_forward);
+      add_value_to_input_socket(key, value_to_forward, pool);
     }
     else {
       /* Multiple inputs use the value, make a copy for every input except for one. */
@@ -463,24 +1341,45 @@ class GeometryNodesEvaluator {
       const CPPType &type = *value_to_forward.type();
       const std::pair<const DInputSocket *, const DOutputSocket *> first_key = std::make_pair(
           first_to_socket, &from_socket);
-      add_value_to_input_socket(first_key, value_to_forward);
+      add_value_to_input_socket(first_key, value_to_forward, pool);
       for (const DInputSocket *to_socket : other_to_sockets) {
         const std::pair<const DInputSocket *, const DOutputSocket *> key = std::make_pair(
             to_socket, &from_socket);
-        void *buffer = allocator_.allocate(type.size(), type.alignment());
+        void *buffer = allocator.allocate(type.size(), type.alignment());
         type.copy_to_uninitialized(value_to_forward.get(), buffer);
-        add_value_to_input_socket(key, GMutablePointer{type, buffer});
+        add_value_to_input_socket(key, GMutablePointer{type, buffer}, pool);
       }
     }
   }
 
   void add_value_to_input_socket(const std::pair<const DInputSocket *, const DOutputSocket *> key,
-                                 GMutablePointer value)
+                                 GMutablePointer value,
+                                 TaskPool *pool)
   {
-    value_by_input_.add_new(key, value);
+    const DNode &node = key.first->node();
+    const std::unique_ptr<NodeState> *state_ptr = node_states_.lookup_ptr(&node);
+    if (state_ptr == nullptr) {
+      /* The node is never executed, so the value is not used. */
+      value.destruct();
+      return;
+    }
+    NodeState &state = **state_ptr;
+    bool is_ready = false;
+    {
+      std::lock_guard lock{state.mutex};
+      state.link_values.add_new(key, value);
+      if (state.required_inputs.contains(key.first)) {
+        state.links_pending--;
+        is_ready = state.links_pending == 0;
+      }
+    }
+    if (is_ready) {
+      this->schedule_node(node, pool);
+    }
   }
 
-  GMutablePointer get_unlinked_input_value(const DInputSocket &socket)
+  GMutablePointer get_unlinked_input_value(const DInputSocket &socket,
+                                           blender::LinearAllocator<> &allocator)
   {
     bNodeSocket *bsocket;
     if (socket.linked_group_inputs().size() == 0) {
@@ -490,7 +1389,7 @@ class GeometryNodesEvaluator {
       bsocket = socket.linked_group_inputs()[0]->bsocket();
     }
     const CPPType &type = *blender::nodes::socket_cpp_type_get(*socket.typeinfo());
-    void *buffer = allocator_.allocate(type.size(), type.alignment());
+    void *buffer = allocator.allocate(type.size(), type.alignment());
 
     if (bsocket->type == SOCK_OBJECT) {
       Object *object = ((bNodeSocketValueObject *)bsocket->default_value)->value;
@@ -926,8 +1825,6 @@ static void fill_data_handle_map(const NodesModifierSettings &settings,
 
 /**
  * Evaluate a node group to compute the output geometry.
- * Currently, this uses a fairly basic and inefficient algorithm that might compute things more
- * often than necessary. It's going to be replaced soon.
  */
 static GeometrySet compute_geometry(const DerivedNodeTree &tree,
                                     Span<const DOutputSocket *> group_input_sockets,
@@ -970,8 +1867,27 @@ static GeometrySet compute_geometry(const DerivedNodeTree &tree,
   Vector<const DInputSocket *> group_outputs;
   group_outputs.append(&socket_to_compute);
 
-  GeometryNodesEvaluator evaluator{
-      group_inputs, group_outputs, mf_by_node, handle_map, ctx->object, ctx->depsgraph};
+  /* A memory limit of zero disables the cache. */
+  std::optional<NodeResultCache> cache;
+  if (nmd->cache_memory_limit > 0) {
+    NodesModifierRuntime *runtime = nodes_modifier_ensure_runtime(nmd);
+    cache.emplace(*runtime,
+                  (int64_t)nmd->cache_memory_limit * 1024 * 1024,
+                  DEG_get_mode(ctx->depsgraph));
+  }
+  else if (nmd->modifier.runtime != nullptr) {
+    NodesModifierRuntime *runtime = (NodesModifierRuntime *)nmd->modifier.runtime;
+    std::lock_guard lock{runtime->mutex};
+    cache_clear(*runtime);
+  }
+
+  GeometryNodesEvaluator evaluator{group_inputs,
+                                   group_outputs,
+                                   mf_by_node,
+                                   handle_map,
+                                   ctx->object,
+                                   ctx->depsgraph,
+                                   cache.has_value() ? &*cache : nullptr};
   Vector<GMutablePointer> results = evaluator.execute();
   BLI_assert(results.size() == 1);
   GMutablePointer result = results[0];
@@ -1179,9 +2095,44 @@ static void panel_draw(const bContext *C, Panel *panel)
   modifier_panel_end(layout, ptr);
 }
 
+static void cache_panel_draw(const bContext *C, Panel *panel)
+{
+  uiLayout *layout = panel->layout;
+
+  PointerRNA ob_ptr;
+  PointerRNA *ptr = modifier_panel_get_property_pointers(panel, &ob_ptr);
+
+  uiLayoutSetPropSep(layout, true);
+
+  uiItemR(layout, ptr, "cache_memory_limit", 0, nullptr, ICON_NONE);
+
+  /* The cache is stored in the evaluated modifier. */
+  Depsgraph *depsgraph = CTX_data_depsgraph_pointer(C);
+  if (depsgraph == nullptr) {
+    return;
+  }
+  ModifierData *md_eval = BKE_modifier_get_evaluated(
+      depsgraph, (Object *)ob_ptr.data, (ModifierData *)ptr->data);
+  if (md_eval != nullptr && md_eval->runtime != nullptr) {
+    NodesModifierRuntime *runtime = (NodesModifierRuntime *)md_eval->runtime;
+    char str[128];
+    {
+      std::lock_guard lock{runtime->mutex};
+      BLI_snprintf(str,
+                   sizeof(str),
+                   TIP_("Hits: %lld, Misses: %lld, Memory: %.1f MB"),
+                   (long long)runtime->hits,
+                   (long long)runtime->misses,
+                   runtime->memory_size / (1024.0 * 1024.0));
+    }
+    uiItemL(layout, str, ICON_NONE);
+  }
+}
+
 static void panelRegister(ARegionType *region_type)
 {
-  modifier_panel_register(region_type, eModifierType_Nodes, panel_draw);
+  PanelType *panel_type = modifier_panel_register(region_type, eModifierType_Nodes, panel_draw);
+  modifier_subpanel_register(region_type, "cache", "Cache", nullptr, cache_panel_draw, panel_type);
 }
 
 static void blendWrite(BlendWriter *writer, const ModifierData *md)
@@ -1220,6 +2171,9 @@ static void freeData(ModifierData *md)
     IDP_FreeProperty_ex(nmd->settings.properties, false);
     nmd->settings.properties = nullptr;
   }
+
+  freeRuntimeData(md->runtime);
+  md->runtime = nullptr;
 }
 
 static void requiredDataMask(Object *UNUSED(ob),
@@ -1263,7 +2217,7 @@ ModifierTypeInfo modifierType_Nodes = {
     /* dependsOnNormals */ nullptr,
     /* foreachIDLink */ foreachIDLink,
     /* foreachTexLink */ nullptr,
-    /* freeRuntimeData */ nullptr,
+    /* freeRuntimeData */ freeRuntimeData,
     /* panelRegister */ panelRegister,
     /* blendWrite */ blendWrite,
     /* blendRead */ blendRead,
@@ -59,6 +59,7 @@ class GeoNodeExecParams {
   const PersistentDataHandleMap &handle_map_;
   const Object *self_object_;
   Depsgraph *depsgraph_;
+  Vector<StringRef> &lazy_required_inputs_;
 
  public:
   GeoNodeExecParams(const bNode &node,
@@ -66,16 +67,29 @@ class GeoNodeExecParams {
                     GValueMap<StringRef> &output_values,
                     const PersistentDataHandleMap &handle_map,
                     const Object *self_object,
-                    Depsgraph *depsgraph)
+                    Depsgraph *depsgraph,
+                    Vector<StringRef> &lazy_required_inputs)
       : node_(node),
         input_values_(input_values),
         output_values_(output_values),
         handle_map_(handle_map),
         self_object_(self_object),
-        depsgraph_(depsgraph)
+        depsgraph_(depsgraph),
+        lazy_required_inputs_(lazy_required_inputs)
   {
   }
 
+  /**
+   * Returns true when the value of the input with the given identifier has not been computed yet.
+   * The input is then requested and the node has to return without setting any outputs. It will
+   * be executed again once all requested inputs are available. Inputs that are never requested
+   * are not computed at all.
+   *
+   * This can only be used by nodes that set #bNodeType.geometry_node_execute_supports_laziness,
+   * other nodes always get all their inputs. It has to be called before the input is extracted.
+   */
+  bool lazy_require_input(StringRef identifier);
+
   /**
    * Get the input value for the input socket with the given identifier.
    *
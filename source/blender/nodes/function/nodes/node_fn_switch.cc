@@ -19,6 +19,8 @@
 #include "UI_interface.h"
 #include "UI_resources.h"
 
+#include "NOD_geometry_exec.hh"
+
 #include "node_function_util.hh"
 
 static void fn_node_switch_layout(uiLayout *layout, bContext *UNUSED(C), PointerRNA *ptr)
@@ -37,6 +39,8 @@ static bNodeSocketTemplate fn_node_switch_in[] = {
     {SOCK_RGBA, N_("If False"), 0.8f, 0.8f, 0.8f, 1.0f},
     {SOCK_OBJECT, N_("If False")},
     {SOCK_IMAGE, N_("If False")},
+    {SOCK_GEOMETRY, N_("If False")},
+    {SOCK_COLLECTION, N_("If False")},
 
     {SOCK_FLOAT, N_("If True"), 0.0f, 0.0f, 0.0f, 0.0f, -10000.0f, 10000.0f},
     {SOCK_INT, N_("If True"), 0, 0, 0, 0, -10000, 10000},
@@ -46,6 +50,8 @@ static bNodeSocketTemplate fn_node_switch_in[] = {
     {SOCK_RGBA, N_("If True"), 0.8f, 0.8f, 0.8f, 1.0f},
     {SOCK_OBJECT, N_("If True")},
     {SOCK_IMAGE, N_("If True")},
+    {SOCK_GEOMETRY, N_("If True")},
+    {SOCK_COLLECTION, N_("If True")},
 
     {-1, ""},
 };
@@ -59,6 +65,8 @@ static bNodeSocketTemplate fn_node_switch_out[] = {
     {SOCK_RGBA, N_("Result")},
     {SOCK_OBJECT, N_("Result")},
     {SOCK_IMAGE, N_("Result")},
+    {SOCK_GEOMETRY, N_("Result")},
+    {SOCK_COLLECTION, N_("Result")},
     {-1, ""},
 };
 
@@ -74,6 +82,39 @@ static void fn_node_switch_update(bNodeTree *UNUSED(ntree), bNode *node)
   }
 }
 
+static const bNodeSocket *find_available_socket(const ListBase &sockets, const char *name)
+{
+  LISTBASE_FOREACH (const bNodeSocket *, socket, &sockets) {
+    if ((socket->flag & SOCK_UNAVAIL) == 0 && STREQ(socket->name, name)) {
+      return socket;
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * Only the input that is passed through is requested, so the nodes that compute the other input
+ * are not executed at all.
+ */
+static void fn_node_switch_geometry_exec(blender::nodes::GeoNodeExecParams params)
+{
+  if (params.lazy_require_input("Switch")) {
+    return;
+  }
+  const bNode &node = params.node();
+  const bool use_true = params.get_input<bool>("Switch");
+  const bNodeSocket *input = find_available_socket(node.inputs, use_true ? "If True" : "If False");
+  const bNodeSocket *output = find_available_socket(node.outputs, "Result");
+  BLI_assert(input != nullptr && output != nullptr);
+
+  if (params.lazy_require_input(input->identifier)) {
+    return;
+  }
+  blender::fn::GMutablePointer value = params.extract_input(input->identifier);
+  params.set_output_by_move(output->identifier, value);
+  value.destruct();
+}
+
 void register_node_type_fn_switch()
 {
   static bNodeType ntype;
@@ -82,5 +123,7 @@ void register_node_type_fn_switch()
   node_type_socket_templates(&ntype, fn_node_switch_in, fn_node_switch_out);
   node_type_update(&ntype, fn_node_switch_update);
   ntype.draw_buttons = fn_node_switch_layout;
+  ntype.geometry_node_execute = fn_node_switch_geometry_exec;
+  ntype.geometry_node_execute_supports_laziness = true;
   nodeRegisterType(&ntype);
 }
@@ -113,8 +113,6 @@ static Mesh *mesh_boolean_calc(const Mesh *mesh_a, const Mesh *mesh_b, int boole
 namespace blender::nodes {
 static void geo_node_boolean_exec(GeoNodeExecParams params)
 {
-  GeometrySet geometry_set_in_a = params.extract_input<GeometrySet>("Geometry 1");
-  GeometrySet geometry_set_in_b = params.extract_input<GeometrySet>("Geometry 2");
   GeometrySet geometry_set_out;
 
   GeometryNodeBooleanOperation operation = (GeometryNodeBooleanOperation)params.node().custom1;
@@ -124,6 +122,24 @@ static void geo_node_boolean_exec(GeoNodeExecParams params)
     return;
   }
 
+  if (params.lazy_require_input("Geometry 1")) {
+    return;
+  }
+  if (operation != GEO_NODE_BOOLEAN_UNION) {
+    /* Intersecting with or subtracting from nothing gives the first geometry back, so the second
+     * geometry does not have to be computed in that case. */
+    if (params.get_input<GeometrySet>("Geometry 1").get_mesh_for_read() == nullptr) {
+      params.set_output("Geometry", params.extract_input<GeometrySet>("Geometry 1"));
+      return;
+    }
+  }
+  if (params.lazy_require_input("Geometry 2")) {
+    return;
+  }
+
+  GeometrySet geometry_set_in_a = params.extract_input<GeometrySet>("Geometry 1");
+  GeometrySet geometry_set_in_b = params.extract_input<GeometrySet>("Geometry 2");
+
   const Mesh *mesh_in_a = geometry_set_in_a.get_mesh_for_read();
   const Mesh *mesh_in_b = geometry_set_in_b.get_mesh_for_read();
 
@@ -157,5 +173,6 @@ void register_node_type_geo_boolean()
   node_type_socket_templates(&ntype, geo_node_boolean_in, geo_node_boolean_out);
   ntype.draw_buttons = geo_node_boolean_layout;
   ntype.geometry_node_execute = blender::nodes::geo_node_boolean_exec;
+  ntype.geometry_node_execute_supports_laziness = true;
   nodeRegisterType(&ntype);
 }
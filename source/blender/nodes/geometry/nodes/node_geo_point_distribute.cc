@@ -16,10 +16,10 @@
 
 #include "BLI_float3.hh"
 #include "BLI_hash.h"
-#include "BLI_kdtree.h"
 #include "BLI_math_vector.h"
 #include "BLI_rand.hh"
 #include "BLI_span.hh"
+#include "BLI_task.hh"
 #include "BLI_timeit.hh"
 
 #include "DNA_mesh_types.h"
@@ -88,6 +88,16 @@ static Span<MLoopTri> get_mesh_looptris(const Mesh &mesh)
   return {looptris, looptris_len};
 }
 
+/**
+ * Every looptri gets its own random number generator, seeded by its index. This makes the result
+ * independent of the order in which looptris are processed, so they can be sampled in parallel.
+ */
+static RandomNumberGenerator looptri_rng_create(const int looptri_index, const int seed)
+{
+  const int looptri_seed = BLI_hash_int(looptri_index + seed);
+  return RandomNumberGenerator(looptri_seed);
+}
+
 static void sample_mesh_surface(const Mesh &mesh,
                                 const float base_density,
                                 const FloatReadAttribute *density_factors,
@@ -98,52 +108,175 @@ static void sample_mesh_surface(const Mesh &mesh,
 {
   Span<MLoopTri> looptris = get_mesh_looptris(mesh);
 
+  /* Count the points on every looptri first, so that every looptri knows where its points are
+   * stored in the output arrays. */
+  Array<int> point_offsets(looptris.size() + 1);
+  parallel_for(looptris.index_range(), 1024, [&](IndexRange range) {
+    for (const int looptri_index : range) {
+      const MLoopTri &looptri = looptris[looptri_index];
+      const int v0_index = mesh.mloop[looptri.tri[0]].v;
+      const int v1_index = mesh.mloop[looptri.tri[1]].v;
+      const int v2_index = mesh.mloop[looptri.tri[2]].v;
+      const float3 v0_pos = mesh.mvert[v0_index].co;
+      const float3 v1_pos = mesh.mvert[v1_index].co;
+      const float3 v2_pos = mesh.mvert[v2_index].co;
+
+      float looptri_density_factor = 1.0f;
+      if (density_factors != nullptr) {
+        const float v0_density_factor = std::max(0.0f, (*density_factors)[v0_index]);
+        const float v1_density_factor = std::max(0.0f, (*density_factors)[v1_index]);
+        const float v2_density_factor = std::max(0.0f, (*density_factors)[v2_index]);
+        looptri_density_factor = (v0_density_factor + v1_density_factor + v2_density_factor) /
+                                 3.0f;
+      }
+      const float area = area_tri_v3(v0_pos, v1_pos, v2_pos);
+
+      RandomNumberGenerator looptri_rng = looptri_rng_create(looptri_index, seed);
+
+      const float points_amount_fl = area * base_density * looptri_density_factor;
+      const float add_point_probability = fractf(points_amount_fl);
+      const bool add_point = add_point_probability > looptri_rng.get_float();
+      point_offsets[looptri_index] = (int)points_amount_fl + (int)add_point;
+    }
+  });
+
+  int points_amount = 0;
   for (const int looptri_index : looptris.index_range()) {
-    const MLoopTri &looptri = looptris[looptri_index];
-    const int v0_index = mesh.mloop[looptri.tri[0]].v;
-    const int v1_index = mesh.mloop[looptri.tri[1]].v;
-    const int v2_index = mesh.mloop[looptri.tri[2]].v;
-    const float3 v0_pos = mesh.mvert[v0_index].co;
-    const float3 v1_pos = mesh.mvert[v1_index].co;
-    const float3 v2_pos = mesh.mvert[v2_index].co;
-
-    float looptri_density_factor = 1.0f;
-    if (density_factors != nullptr) {
-      const float v0_density_factor = std::max(0.0f, (*density_factors)[v0_index]);
-      const float v1_density_factor = std::max(0.0f, (*density_factors)[v1_index]);
-      const float v2_density_factor = std::max(0.0f, (*density_factors)[v2_index]);
-      looptri_density_factor = (v0_density_factor + v1_density_factor + v2_density_factor) / 3.0f;
+    const int looptri_points_amount = point_offsets[looptri_index];
+    point_offsets[looptri_index] = points_amount;
+    points_amount += looptri_points_amount;
+  }
+  point_offsets.last() = points_amount;
+
+  const int old_size = r_positions.size();
+  r_positions.resize(old_size + points_amount);
+  r_bary_coords.resize(old_size + points_amount);
+  r_looptri_indices.resize(old_size + points_amount);
+  MutableSpan<float3> positions = r_positions.as_mutable_span().drop_front(old_size);
+  MutableSpan<float3> bary_coords = r_bary_coords.as_mutable_span().drop_front(old_size);
+  MutableSpan<int> looptri_indices = r_looptri_indices.as_mutable_span().drop_front(old_size);
+
+  parallel_for(looptris.index_range(), 1024, [&](IndexRange range) {
+    for (const int looptri_index : range) {
+      const int point_offset = point_offsets[looptri_index];
+      const int point_amount = point_offsets[looptri_index + 1] - point_offset;
+      if (point_amount == 0) {
+        continue;
+      }
+
+      const MLoopTri &looptri = looptris[looptri_index];
+      const float3 v0_pos = mesh.mvert[mesh.mloop[looptri.tri[0]].v].co;
+      const float3 v1_pos = mesh.mvert[mesh.mloop[looptri.tri[1]].v].co;
+      const float3 v2_pos = mesh.mvert[mesh.mloop[looptri.tri[2]].v].co;
+
+      /* Continue the random sequence that was used to compute the amount of points. */
+      RandomNumberGenerator looptri_rng = looptri_rng_create(looptri_index, seed);
+      looptri_rng.get_float();
+
+      for (const int i : IndexRange(point_offset, point_amount)) {
+        const float3 bary_coord = looptri_rng.get_barycentric_coordinates();
+        interp_v3_v3v3v3(positions[i], v0_pos, v1_pos, v2_pos, bary_coord);
+        bary_coords[i] = bary_coord;
+        looptri_indices[i] = looptri_index;
+      }
+    }
+  });
+}
+
+/**
+ * A uniform grid with cells at least as large as the minimum distance, so that all points closer
+ * than the minimum distance to a point are in the 27 cells around it. The cells are stored in a
+ * hash table whose buckets contain the indices of the points in them.
+ */
+class PointHashGrid {
+ private:
+  struct CellCoord {
+    int x, y, z;
+  };
+
+  float cell_size_inv_;
+  uint64_t bucket_mask_;
+  /* The points of bucket `i` are `bucket_points_[bucket_offsets_[i]:bucket_offsets_[i + 1]]`. */
+  Array<int> bucket_offsets_;
+  Array<int> bucket_points_;
+
+ public:
+  PointHashGrid(Span<float3> positions, const float cell_size)
+      : cell_size_inv_(1.0f / cell_size), bucket_points_(positions.size())
+  {
+    /* Make the cells larger when the minimum distance is tiny compared to the positions, so that
+     * the cell coordinates (and their neighbors) fit into an int. */
+    float max_coord = 0.0f;
+    for (const float3 &position : positions) {
+      max_coord = std::max({max_coord, fabsf(position.x), fabsf(position.y), fabsf(position.z)});
     }
-    const float area = area_tri_v3(v0_pos, v1_pos, v2_pos);
-
-    const int looptri_seed = BLI_hash_int(looptri_index + seed);
-    RandomNumberGenerator looptri_rng(looptri_seed);
-
-    const float points_amount_fl = area * base_density * looptri_density_factor;
-    const float add_point_probability = fractf(points_amount_fl);
-    const bool add_point = add_point_probability > looptri_rng.get_float();
-    const int point_amount = (int)points_amount_fl + (int)add_point;
-
-    for (int i = 0; i < point_amount; i++) {
-      const float3 bary_coord = looptri_rng.get_barycentric_coordinates();
-      float3 point_pos;
-      interp_v3_v3v3v3(point_pos, v0_pos, v1_pos, v2_pos, bary_coord);
-      r_positions.append(point_pos);
-      r_bary_coords.append(bary_coord);
-      r_looptri_indices.append(looptri_index);
+    const float max_cell_coord = (float)(1 << 30);
+    if (!(max_coord * cell_size_inv_ <= max_cell_coord)) {
+      /* Also handles an infinite inverse of a denormal cell size. */
+      cell_size_inv_ = (max_coord > 0.0f) ? max_cell_coord / max_coord : 1.0f;
+    }
+
+    const int64_t buckets_amount = power_of_2_max_i(std::max<int>(positions.size(), 1));
+    bucket_mask_ = (uint64_t)buckets_amount - 1;
+    bucket_offsets_.reinitialize(buckets_amount + 1);
+    bucket_offsets_.fill(0);
+
+    Array<int> point_buckets(positions.size());
+    parallel_for(positions.index_range(), 4096, [&](IndexRange range) {
+      for (const int i : range) {
+        point_buckets[i] = this->bucket_index(this->cell_coord(positions[i]));
+      }
+    });
+
+    /* Counting sort of the points by bucket. */
+    for (const int bucket : point_buckets) {
+      bucket_offsets_[bucket + 1]++;
+    }
+    for (const int64_t i : IndexRange(buckets_amount)) {
+      bucket_offsets_[i + 1] += bucket_offsets_[i];
+    }
+    Array<int> bucket_fill(buckets_amount, 0);
+    for (const int i : positions.index_range()) {
+      const int bucket = point_buckets[i];
+      bucket_points_[bucket_offsets_[bucket] + bucket_fill[bucket]++] = i;
     }
   }
-}
 
-BLI_NOINLINE static KDTree_3d *build_kdtree(Span<float3> positions)
-{
-  KDTree_3d *kdtree = BLI_kdtree_3d_new(positions.size());
-  for (const int i : positions.index_range()) {
-    BLI_kdtree_3d_insert(kdtree, i, positions[i]);
+  /**
+   * Call the function for all points in the cells around the position. Points in other cells that
+   * share a bucket are passed as well, so the distance has to be checked by the caller.
+   */
+  template<typename Func> void foreach_point_in_neighborhood(const float3 position, Func func) const
+  {
+    const CellCoord center = this->cell_coord(position);
+    for (int z = -1; z <= 1; z++) {
+      for (int y = -1; y <= 1; y++) {
+        for (int x = -1; x <= 1; x++) {
+          const int bucket = this->bucket_index({center.x + x, center.y + y, center.z + z});
+          for (const int i : IndexRange(bucket_offsets_[bucket],
+                                        bucket_offsets_[bucket + 1] - bucket_offsets_[bucket])) {
+            func(bucket_points_[i]);
+          }
+        }
+      }
+    }
+  }
+
+ private:
+  CellCoord cell_coord(const float3 position) const
+  {
+    return {(int)floorf(position.x * cell_size_inv_),
+            (int)floorf(position.y * cell_size_inv_),
+            (int)floorf(position.z * cell_size_inv_)};
   }
-  BLI_kdtree_3d_balance(kdtree);
-  return kdtree;
-}
+
+  int bucket_index(const CellCoord cell) const
+  {
+    const uint64_t hash = (uint64_t)cell.x * 73856093 ^ (uint64_t)cell.y * 19349663 ^
+                          (uint64_t)cell.z * 83492791;
+    return (int)(hash & bucket_mask_);
+  }
+};
 
 BLI_NOINLINE static void update_elimination_mask_for_close_points(
     Span<float3> positions, const float minimum_distance, MutableSpan<bool> elimination_mask)
@@ -152,32 +285,23 @@ BLI_NOINLINE static void update_elimination_mask_for_close_points(
     return;
   }
 
-  KDTree_3d *kdtree = build_kdtree(positions);
+  const PointHashGrid grid(positions, minimum_distance);
+  const float minimum_distance_sq = minimum_distance * minimum_distance;
 
+  /* The result depends on the order in which the points are visited, so this loop stays serial to
+   * keep it deterministic. Every point eliminates the points too close to it, unless it has been
+   * eliminated itself already. */
   for (const int i : positions.index_range()) {
     if (elimination_mask[i]) {
       continue;
     }
-
-    struct CallbackData {
-      int index;
-      MutableSpan<bool> elimination_mask;
-    } callback_data = {i, elimination_mask};
-
-    BLI_kdtree_3d_range_search_cb(
-        kdtree,
-        positions[i],
-        minimum_distance,
-        [](void *user_data, int index, const float *UNUSED(co), float UNUSED(dist_sq)) {
-          CallbackData &callback_data = *static_cast<CallbackData *>(user_data);
-          if (index != callback_data.index) {
-            callback_data.elimination_mask[index] = true;
-          }
-          return true;
-        },
-        &callback_data);
+    const float3 position = positions[i];
+    grid.foreach_point_in_neighborhood(position, [&](const int index) {
+      if (index != i && len_squared_v3v3(position, positions[index]) <= minimum_distance_sq) {
+        elimination_mask[index] = true;
+      }
+    });
   }
-  BLI_kdtree_3d_free(kdtree);
 }
 
 BLI_NOINLINE static void update_elimination_mask_based_on_density_factors(
@@ -188,30 +312,33 @@ BLI_NOINLINE static void update_elimination_mask_based_on_density_factors(
     MutableSpan<bool> elimination_mask)
 {
   Span<MLoopTri> looptris = get_mesh_looptris(mesh);
-  for (const int i : bary_coords.index_range()) {
-    if (elimination_mask[i]) {
-      continue;
-    }
+  parallel_for(bary_coords.index_range(), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      if (elimination_mask[i]) {
+        continue;
+      }
 
-    const MLoopTri &looptri = looptris[looptri_indices[i]];
-    const float3 bary_coord = bary_coords[i];
+      const MLoopTri &looptri = looptris[looptri_indices[i]];
+      const float3 bary_coord = bary_coords[i];
 
-    const int v0_index = mesh.mloop[looptri.tri[0]].v;
-    const int v1_index = mesh.mloop[looptri.tri[1]].v;
-    const int v2_index = mesh.mloop[looptri.tri[2]].v;
+      const int v0_index = mesh.mloop[looptri.tri[0]].v;
+      const int v1_index = mesh.mloop[looptri.tri[1]].v;
+      const int v2_index = mesh.mloop[looptri.tri[2]].v;
 
-    const float v0_density_factor = std::max(0.0f, density_factors[v0_index]);
-    const float v1_density_factor = std::max(0.0f, density_factors[v1_index]);
-    const float v2_density_factor = std::max(0.0f, density_factors[v2_index]);
+      const float v0_density_factor = std::max(0.0f, density_factors[v0_index]);
+      const float v1_density_factor = std::max(0.0f, density_factors[v1_index]);
+      const float v2_density_factor = std::max(0.0f, density_factors[v2_index]);
 
-    const float probablity = v0_density_factor * bary_coord.x + v1_density_factor * bary_coord.y +
-                             v2_density_factor * bary_coord.z;
+      const float probablity = v0_density_factor * bary_coord.x +
+                               v1_density_factor * bary_coord.y +
+                               v2_density_factor * bary_coord.z;
 
-    const float hash = BLI_hash_int_01(bary_coord.hash());
-    if (hash > probablity) {
-      elimination_mask[i] = true;
+      const float hash = BLI_hash_int_01(bary_coord.hash());
+      if (hash > probablity) {
+        elimination_mask[i] = true;
+      }
     }
-  }
+  });
 }
 
 BLI_NOINLINE static void eliminate_points_based_on_mask(Span<bool> elimination_mask,
@@ -238,22 +365,24 @@ BLI_NOINLINE static void interpolate_attribute_point(const Mesh &mesh,
   BLI_assert(data_in.size() == mesh.totvert);
   Span<MLoopTri> looptris = get_mesh_looptris(mesh);
 
-  for (const int i : bary_coords.index_range()) {
-    const int looptri_index = looptri_indices[i];
-    const MLoopTri &looptri = looptris[looptri_index];
-    const float3 &bary_coord = bary_coords[i];
+  parallel_for(bary_coords.index_range(), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      const int looptri_index = looptri_indices[i];
+      const MLoopTri &looptri = looptris[looptri_index];
+      const float3 &bary_coord = bary_coords[i];
 
-    const int v0_index = mesh.mloop[looptri.tri[0]].v;
-    const int v1_index = mesh.mloop[looptri.tri[1]].v;
-    const int v2_index = mesh.mloop[looptri.tri[2]].v;
+      const int v0_index = mesh.mloop[looptri.tri[0]].v;
+      const int v1_index = mesh.mloop[looptri.tri[1]].v;
+      const int v2_index = mesh.mloop[looptri.tri[2]].v;
 
-    const T &v0 = data_in[v0_index];
-    const T &v1 = data_in[v1_index];
-    const T &v2 = data_in[v2_index];
+      const T &v0 = data_in[v0_index];
+      const T &v1 = data_in[v1_index];
+      const T &v2 = data_in[v2_index];
 
-    const T interpolated_value = attribute_math::mix3(bary_coord, v0, v1, v2);
-    data_out[i] = interpolated_value;
-  }
+      const T interpolated_value = attribute_math::mix3(bary_coord, v0, v1, v2);
+      data_out[i] = interpolated_value;
+    }
+  });
 }
 
 template<typename T>
@@ -266,22 +395,24 @@ BLI_NOINLINE static void interpolate_attribute_corner(const Mesh &mesh,
   BLI_assert(data_in.size() == mesh.totloop);
   Span<MLoopTri> looptris = get_mesh_looptris(mesh);
 
-  for (const int i : bary_coords.index_range()) {
-    const int looptri_index = looptri_indices[i];
-    const MLoopTri &looptri = looptris[looptri_index];
-    const float3 &bary_coord = bary_coords[i];
+  parallel_for(bary_coords.index_range(), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      const int looptri_index = looptri_indices[i];
+      const MLoopTri &looptri = looptris[looptri_index];
+      const float3 &bary_coord = bary_coords[i];
 
-    const int loop_index_0 = looptri.tri[0];
-    const int loop_index_1 = looptri.tri[1];
-    const int loop_index_2 = looptri.tri[2];
+      const int loop_index_0 = looptri.tri[0];
+      const int loop_index_1 = looptri.tri[1];
+      const int loop_index_2 = looptri.tri[2];
 
-    const T &v0 = data_in[loop_index_0];
-    const T &v1 = data_in[loop_index_1];
-    const T &v2 = data_in[loop_index_2];
+      const T &v0 = data_in[loop_index_0];
+      const T &v1 = data_in[loop_index_1];
+      const T &v2 = data_in[loop_index_2];
 
-    const T interpolated_value = attribute_math::mix3(bary_coord, v0, v1, v2);
-    data_out[i] = interpolated_value;
-  }
+      const T interpolated_value = attribute_math::mix3(bary_coord, v0, v1, v2);
+      data_out[i] = interpolated_value;
+    }
+  });
 }
 
 BLI_NOINLINE static void interpolate_attribute(const Mesh &mesh,
@@ -364,22 +495,24 @@ BLI_NOINLINE static void compute_special_attributes(const Mesh &mesh,
   MutableSpan<float3> rotations = rotation_attribute->get_span_for_write_only<float3>();
 
   Span<MLoopTri> looptris = get_mesh_looptris(mesh);
-  for (const int i : bary_coords.index_range()) {
-    const int looptri_index = looptri_indices[i];
-    const MLoopTri &looptri = looptris[looptri_index];
-    const float3 &bary_coord = bary_coords[i];
-
-    const int v0_index = mesh.mloop[looptri.tri[0]].v;
-    const int v1_index = mesh.mloop[looptri.tri[1]].v;
-    const int v2_index = mesh.mloop[looptri.tri[2]].v;
-    const float3 v0_pos = mesh.mvert[v0_index].co;
-    const float3 v1_pos = mesh.mvert[v1_index].co;
-    const float3 v2_pos = mesh.mvert[v2_index].co;
-
-    ids[i] = (int)(bary_coord.hash()) + looptri_index;
-    normal_tri_v3(normals[i], v0_pos, v1_pos, v2_pos);
-    rotations[i] = normal_to_euler_rotation(normals[i]);
-  }
+  parallel_for(bary_coords.index_range(), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      const int looptri_index = looptri_indices[i];
+      const MLoopTri &looptri = looptris[looptri_index];
+      const float3 &bary_coord = bary_coords[i];
+
+      const int v0_index = mesh.mloop[looptri.tri[0]].v;
+      const int v1_index = mesh.mloop[looptri.tri[1]].v;
+      const int v2_index = mesh.mloop[looptri.tri[2]].v;
+      const float3 v0_pos = mesh.mvert[v0_index].co;
+      const float3 v1_pos = mesh.mvert[v1_index].co;
+      const float3 v2_pos = mesh.mvert[v2_index].co;
+
+      ids[i] = (int)(bary_coord.hash()) + looptri_index;
+      normal_tri_v3(normals[i], v0_pos, v1_pos, v2_pos);
+      rotations[i] = normal_to_euler_rotation(normals[i]);
+    }
+  });
 
   id_attribute.apply_span_and_save();
   normal_attribute.apply_span_and_save();
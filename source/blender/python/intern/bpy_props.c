@@ -35,6 +35,7 @@
 #include "bpy_props.h"
 #include "bpy_rna.h"
 
+#include "BKE_animsys.h"
 #include "BKE_idprop.h"
 
 #include "RNA_access.h"
@@ -2002,6 +2003,17 @@ static void bpy_prop_callback_assign_enum(struct PropertyRNA *prop,
   } \
   (void)0
 
+/* Same as #RNA_def_property_free_identifier, animation data may have resolved paths to the
+ * freed property. */
+static int bpy_prop_free_identifier(StructRNA *srna, const char *id)
+{
+  const int ret = RNA_def_property_free_identifier(srna, id);
+  if (ret == 1) {
+    BKE_animsys_path_cache_invalidate();
+  }
+  return ret;
+}
+
 /* terse macros for error checks shared between all funcs cant use function
  * calls because of static strings passed to pyrna_set_to_enum_bitfield */
 #define BPY_PROPDEF_CHECK(_func, _property_flag_items, _property_flag_override_items) \
@@ -2012,7 +2024,7 @@ static void bpy_prop_callback_assign_enum(struct PropertyRNA *prop,
                  MAX_IDPROP_NAME - 1); \
     return NULL; \
   } \
-  if (UNLIKELY(RNA_def_property_free_identifier(srna, id) == -1)) { \
+  if (UNLIKELY(bpy_prop_free_identifier(srna, id) == -1)) { \
     PyErr_Format(PyExc_TypeError, #_func "(): '%s' is defined as a non-dynamic type", id); \
     return NULL; \
   } \
@@ -3570,7 +3582,7 @@ static PyObject *BPy_RemoveProperty(PyObject *self, PyObject *args, PyObject *kw
     return NULL;
   }
 
-  if (RNA_def_property_free_identifier(srna, id) != 1) {
+  if (bpy_prop_free_identifier(srna, id) != 1) {
     PyErr_Format(PyExc_TypeError, "RemoveProperty(): '%s' not a defined dynamic property", id);
     return NULL;
   }
@@ -60,6 +60,7 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BKE_animsys.h"
 #include "BKE_context.h"
 #include "BKE_global.h" /* evil G.* */
 #include "BKE_idprop.h"
@@ -4438,8 +4439,11 @@ static int pyrna_struct_meta_idprop_setattro(PyObject *cls, PyObject *attr, PyOb
        * but gets confusing from script writers POV if the assigned value can't be read back. */
     }
     else {
-      /* Remove existing property if it's set or we also end up with confusion. */
-      RNA_def_property_free_identifier(srna, attr_str); /* Ignore on failure. */
+      /* Remove existing property if it's set or we also end up with confusion,
+       * ignore on failure. */
+      if (RNA_def_property_free_identifier(srna, attr_str) == 1) {
+        BKE_animsys_path_cache_invalidate();
+      }
     }
   }
   else { /* __delattr__ */
@@ -4450,6 +4454,9 @@ static int pyrna_struct_meta_idprop_setattro(PyObject *cls, PyObject *attr, PyOb
           PyExc_TypeError, "struct_meta_idprop.detattr(): '%s' not a dynamic property", attr_str);
       return -1;
     }
+    if (ret == 1) {
+      BKE_animsys_path_cache_invalidate();
+    }
   }
 
   /* Fallback to standard py, delattr/setattr. */
@@ -9049,6 +9056,9 @@ static PyObject *pyrna_unregister_class(PyObject *UNUSED(self), PyObject *py_cla
   /* Call unregister. */
   unreg(CTX_data_main(C), srna); /* Calls bpy_class_free, this decref's py_class. */
 
+  /* Animation data may have resolved paths to properties of the freed type. */
+  BKE_animsys_path_cache_invalidate();
+
   PyDict_DelItem(((PyTypeObject *)py_class)->tp_dict, bpy_intern_str_bl_rna);
   if (PyErr_Occurred()) {
     PyErr_Clear();  // return NULL;
@@ -42,6 +42,7 @@
 #include "BLI_listbase.h"
 #include "BLI_mempool.h"
 #include "BLI_path_util.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 
 #include "BKE_global.h"
@@ -57,6 +58,10 @@
 #include "prefetch.h"
 #include "strip_time.h"
 
+#include <zlib.h>
+
+#include <zstd.h>
+
 /**
  * Sequencer Cache Design Notes
  * ============================
@@ -89,7 +94,11 @@
  * For each cached non-temp image, image data and supplementary info are written to HDD.
  * Multiple(DCACHE_IMAGES_PER_FILE) images share the same file.
  * Each of these files contains header DiskCacheHeader followed by image data.
- * Zlib compression with user definable level can be used to compress image data(per image)
+ * Image data is split into blocks of DCACHE_BLOCK_SIZE bytes, which are compressed and
+ * decompressed in parallel. Zstandard is used when available, zlib otherwise. Compression level is
+ * user definable. Bytes of float images are shuffled (all first bytes of each float, then all
+ * second bytes, etc.) before compression, which compresses much better.
+ * Image data of an entry starts with a table of compressed block sizes, followed by the blocks.
  * Images are written in order in which they are rendered.
  * Overwriting of individual entry is not possible.
  * Stored images are deleted by invalidation, or when size of all files exceeds maximum
@@ -97,16 +106,34 @@
  * To distinguish 2 blend files with same name, scene->ed->disk_cache_timestamp
  * is used as UID. Blend file can still be copied manually which may cause conflict.
  *
+ * When a final image is read from disk, following frames are read ahead from disk into RAM
+ * cache in a background task, so that playback of cached frames is not limited by disk reads.
+ *
  */
 
 /* <cache type>-<resolution X>x<resolution Y>-<rendersize>%(<view_id>)-<frame no>.dcf */
 #define DCACHE_FNAME_FORMAT "%d-%dx%d-%d%%(%d)-%d.dcf"
 #define DCACHE_IMAGES_PER_FILE 100
-#define DCACHE_CURRENT_VERSION 1
+#define DCACHE_CURRENT_VERSION 2
+#define DCACHE_BLOCK_SIZE (1024 * 1024)
 #define COLORSPACE_NAME_MAX 64 /* XXX: defined in imb intern */
 
+/* #DiskCacheHeaderEntry.codec */
+enum {
+  DCACHE_CODEC_NONE = 0,
+  DCACHE_CODEC_ZLIB = 1,
+  DCACHE_CODEC_ZSTD = 2,
+};
+
+/* #DiskCacheHeaderEntry.flag */
+enum {
+  DCACHE_FLAG_SHUFFLE = (1 << 0),
+};
+
 typedef struct DiskCacheHeaderEntry {
   unsigned char encoding;
+  unsigned char codec;
+  unsigned char flag;
   uint64_t frameno;
   uint64_t size_compressed;
   uint64_t size_raw;
@@ -124,6 +151,11 @@ typedef struct SeqDiskCache {
   ListBase files;
   ThreadMutex read_write_mutex;
   size_t size_total;
+  /* Background reading of following frames, protected by read_write_mutex. */
+  TaskPool *read_ahead_pool;
+  Sequence *read_ahead_seq;
+  int read_ahead_frame_start;
+  int read_ahead_frame_end;
 } SeqDiskCache;
 
 typedef struct DiskCacheFile {
@@ -488,29 +520,271 @@ static void seq_disk_cache_invalidate(Scene *scene,
   BLI_mutex_unlock(&disk_cache->read_write_mutex);
 }
 
-static size_t deflate_imbuf_to_file(ImBuf *ibuf,
-                                    FILE *file,
-                                    int level,
-                                    DiskCacheHeaderEntry *header_entry)
+static int seq_disk_cache_codec(int level)
 {
-  if (ibuf->rect) {
-    return BLI_gzip_mem_to_file_at_pos(
-        ibuf->rect, header_entry->size_raw, file, header_entry->offset, level);
+  if (level == 0) {
+    return DCACHE_CODEC_NONE;
   }
+  return DCACHE_CODEC_ZSTD;
+}
 
-  return BLI_gzip_mem_to_file_at_pos(
-      ibuf->rect_float, header_entry->size_raw, file, header_entry->offset, level);
+static size_t seq_disk_cache_block_compress_bound(int codec, size_t size)
+{
+  switch (codec) {
+    case DCACHE_CODEC_ZLIB:
+      return compressBound((uLong)size);
+    case DCACHE_CODEC_ZSTD:
+      return ZSTD_compressBound(size);
+  }
+  return size;
 }
 
-static size_t inflate_file_to_imbuf(ImBuf *ibuf, FILE *file, DiskCacheHeaderEntry *header_entry)
+/* Returns compressed size, 0 on failure. */
+static size_t seq_disk_cache_block_compress(
+    int codec, int level, const char *src, size_t src_size, char *dst, size_t dst_capacity)
 {
-  if (ibuf->rect) {
-    return BLI_ungzip_file_to_mem_at_pos(
-        ibuf->rect, header_entry->size_raw, file, header_entry->offset);
+  switch (codec) {
+    case DCACHE_CODEC_NONE:
+      memcpy(dst, src, src_size);
+      return src_size;
+    case DCACHE_CODEC_ZLIB: {
+      uLongf dst_size = (uLongf)dst_capacity;
+      if (compress2((Bytef *)dst, &dst_size, (const Bytef *)src, (uLong)src_size, level) != Z_OK) {
+        return 0;
+      }
+      return (size_t)dst_size;
+    }
+    case DCACHE_CODEC_ZSTD: {
+      const size_t dst_size = ZSTD_compress(dst, dst_capacity, src, src_size, level);
+      return ZSTD_isError(dst_size) ? 0 : dst_size;
+    }
+  }
+  return 0;
+}
+
+static bool seq_disk_cache_block_decompress(
+    int codec, const char *src, size_t src_size, char *dst, size_t dst_size)
+{
+  switch (codec) {
+    case DCACHE_CODEC_NONE:
+      if (src_size != dst_size) {
+        return false;
+      }
+      memcpy(dst, src, src_size);
+      return true;
+    case DCACHE_CODEC_ZLIB: {
+      uLongf size = (uLongf)dst_size;
+      return uncompress((Bytef *)dst, &size, (const Bytef *)src, (uLong)src_size) == Z_OK &&
+             size == dst_size;
+    }
+    case DCACHE_CODEC_ZSTD:
+      return ZSTD_decompress(dst, dst_size, src, src_size) == dst_size;
+  }
+  /* Files written with an unknown codec, consider the image missing. */
+  return false;
+}
+
+/* Group bytes of 4-byte elements by their significance, this makes float data compress well. */
+static void seq_disk_cache_shuffle(const char *src, char *dst, size_t size)
+{
+  const size_t elem_len = size / 4;
+  for (size_t i = 0; i < elem_len; i++) {
+    for (int b = 0; b < 4; b++) {
+      dst[b * elem_len + i] = src[i * 4 + b];
+    }
   }
+}
 
-  return BLI_ungzip_file_to_mem_at_pos(
-      ibuf->rect_float, header_entry->size_raw, file, header_entry->offset);
+static void seq_disk_cache_unshuffle(const char *src, char *dst, size_t size)
+{
+  const size_t elem_len = size / 4;
+  for (size_t i = 0; i < elem_len; i++) {
+    for (int b = 0; b < 4; b++) {
+      dst[i * 4 + b] = src[b * elem_len + i];
+    }
+  }
+}
+
+static int seq_disk_cache_blocks_len(uint64_t size_raw)
+{
+  return (int)((size_raw + DCACHE_BLOCK_SIZE - 1) / DCACHE_BLOCK_SIZE);
+}
+
+static size_t seq_disk_cache_block_size(uint64_t size_raw, int block)
+{
+  return (size_t)MIN2((uint64_t)DCACHE_BLOCK_SIZE, size_raw - (uint64_t)block * DCACHE_BLOCK_SIZE);
+}
+
+typedef struct DiskCacheCodecData {
+  const DiskCacheHeaderEntry *header_entry;
+  int level;
+  /* Raw image data. */
+  char *raw;
+  /* Compressed blocks, when encoding these are allocated per block. */
+  char **blocks;
+  uint64_t *blocks_size;
+  bool error;
+} DiskCacheCodecData;
+
+static void seq_disk_cache_encode_block_fn(void *__restrict userdata,
+                                           const int block,
+                                           const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  DiskCacheCodecData *data = userdata;
+  const DiskCacheHeaderEntry *header_entry = data->header_entry;
+  const size_t size = seq_disk_cache_block_size(header_entry->size_raw, block);
+  const char *src = data->raw + (size_t)block * DCACHE_BLOCK_SIZE;
+  char *shuffled = NULL;
+
+  if (header_entry->flag & DCACHE_FLAG_SHUFFLE) {
+    shuffled = MEM_mallocN(size, __func__);
+    seq_disk_cache_shuffle(src, shuffled, size);
+    src = shuffled;
+  }
+
+  const size_t capacity = seq_disk_cache_block_compress_bound(header_entry->codec, size);
+  data->blocks[block] = MEM_mallocN(capacity, __func__);
+  data->blocks_size[block] = seq_disk_cache_block_compress(
+      header_entry->codec, data->level, src, size, data->blocks[block], capacity);
+  if (data->blocks_size[block] == 0) {
+    data->error = true;
+  }
+
+  MEM_SAFE_FREE(shuffled);
+}
+
+static void seq_disk_cache_decode_block_fn(void *__restrict userdata,
+                                           const int block,
+                                           const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  DiskCacheCodecData *data = userdata;
+  const DiskCacheHeaderEntry *header_entry = data->header_entry;
+  const size_t size = seq_disk_cache_block_size(header_entry->size_raw, block);
+  char *dst = data->raw + (size_t)block * DCACHE_BLOCK_SIZE;
+
+  if (header_entry->flag & DCACHE_FLAG_SHUFFLE) {
+    char *shuffled = MEM_mallocN(size, __func__);
+    if (seq_disk_cache_block_decompress(header_entry->codec,
+                                        data->blocks[block],
+                                        (size_t)data->blocks_size[block],
+                                        shuffled,
+                                        size)) {
+      seq_disk_cache_unshuffle(shuffled, dst, size);
+    }
+    else {
+      data->error = true;
+    }
+    MEM_freeN(shuffled);
+  }
+  else if (!seq_disk_cache_block_decompress(header_entry->codec,
+                                            data->blocks[block],
+                                            (size_t)data->blocks_size[block],
+                                            dst,
+                                            size)) {
+    data->error = true;
+  }
+}
+
+static void seq_disk_cache_codec_parallel_range(DiskCacheCodecData *data,
+                                                TaskParallelRangeFunc func)
+{
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(
+      0, seq_disk_cache_blocks_len(data->header_entry->size_raw), data, func, &settings);
+}
+
+/**
+ * Compress image data described by \a header_entry. Returns a buffer containing the table of
+ * block sizes followed by the compressed blocks, or NULL on failure.
+ */
+static char *seq_disk_cache_encode_imbuf(ImBuf *ibuf,
+                                         const DiskCacheHeaderEntry *header_entry,
+                                         int level,
+                                         size_t *r_size)
+{
+  const int blocks_len = seq_disk_cache_blocks_len(header_entry->size_raw);
+  DiskCacheCodecData data = {
+      .header_entry = header_entry,
+      .level = level,
+      .raw = ibuf->rect ? (char *)ibuf->rect : (char *)ibuf->rect_float,
+      .blocks = MEM_calloc_arrayN(blocks_len, sizeof(char *), __func__),
+      .blocks_size = MEM_calloc_arrayN(blocks_len, sizeof(uint64_t), __func__),
+  };
+
+  seq_disk_cache_codec_parallel_range(&data, seq_disk_cache_encode_block_fn);
+
+  char *result = NULL;
+  if (!data.error) {
+    const size_t table_size = sizeof(uint64_t) * (size_t)blocks_len;
+    size_t size = table_size;
+    for (int i = 0; i < blocks_len; i++) {
+      size += (size_t)data.blocks_size[i];
+    }
+
+    result = MEM_mallocN(size, __func__);
+    memcpy(result, data.blocks_size, table_size);
+    char *dst = result + table_size;
+    for (int i = 0; i < blocks_len; i++) {
+      memcpy(dst, data.blocks[i], (size_t)data.blocks_size[i]);
+      dst += data.blocks_size[i];
+    }
+    *r_size = size;
+  }
+
+  for (int i = 0; i < blocks_len; i++) {
+    MEM_SAFE_FREE(data.blocks[i]);
+  }
+  MEM_freeN(data.blocks);
+  MEM_freeN(data.blocks_size);
+
+  return result;
+}
+
+/**
+ * Decompress image data read from disk cache into \a ibuf buffer.
+ */
+static bool seq_disk_cache_decode_imbuf(ImBuf *ibuf,
+                                        const DiskCacheHeaderEntry *header_entry,
+                                        char *encoded,
+                                        size_t encoded_size)
+{
+  const int blocks_len = seq_disk_cache_blocks_len(header_entry->size_raw);
+  const size_t table_size = sizeof(uint64_t) * (size_t)blocks_len;
+  if (encoded_size < table_size) {
+    return false;
+  }
+
+  DiskCacheCodecData data = {
+      .header_entry = header_entry,
+      .raw = ibuf->rect ? (char *)ibuf->rect : (char *)ibuf->rect_float,
+      .blocks = MEM_malloc_arrayN(blocks_len, sizeof(char *), __func__),
+      .blocks_size = MEM_malloc_arrayN(blocks_len, sizeof(uint64_t), __func__),
+  };
+
+  memcpy(data.blocks_size, encoded, table_size);
+  size_t offset = table_size;
+  for (int i = 0; i < blocks_len; i++) {
+    if ((ENDIAN_ORDER == B_ENDIAN) && header_entry->encoding == 0) {
+      BLI_endian_switch_uint64(&data.blocks_size[i]);
+    }
+    data.blocks[i] = encoded + offset;
+    if (data.blocks_size[i] > encoded_size - offset) {
+      data.error = true;
+      break;
+    }
+    offset += (size_t)data.blocks_size[i];
+  }
+
+  if (!data.error) {
+    seq_disk_cache_codec_parallel_range(&data, seq_disk_cache_decode_block_fn);
+  }
+
+  MEM_freeN(data.blocks);
+  MEM_freeN(data.blocks_size);
+
+  return !data.error;
 }
 
 static bool seq_disk_cache_read_header(FILE *file, DiskCacheHeader *header)
@@ -541,6 +815,14 @@ static size_t seq_disk_cache_write_header(FILE *file, DiskCacheHeader *header)
   return fwrite(header, sizeof(*header), 1, file);
 }
 
+static uint64_t seq_disk_cache_imbuf_size_raw(ImBuf *ibuf)
+{
+  if (ibuf->rect) {
+    return (uint64_t)ibuf->x * ibuf->y * ibuf->channels;
+  }
+  return (uint64_t)ibuf->x * ibuf->y * ibuf->channels * 4;
+}
+
 static int seq_disk_cache_add_header_entry(SeqCacheKey *key, ImBuf *ibuf, DiskCacheHeader *header)
 {
   int i;
@@ -578,12 +860,11 @@ static int seq_disk_cache_add_header_entry(SeqCacheKey *key, ImBuf *ibuf, DiskCa
 
   /* Store colorspace name of ibuf. */
   const char *colorspace_name;
+  header->entry[i].size_raw = seq_disk_cache_imbuf_size_raw(ibuf);
   if (ibuf->rect) {
-    header->entry[i].size_raw = ibuf->x * ibuf->y * ibuf->channels;
     colorspace_name = IMB_colormanagement_get_rect_colorspace(ibuf);
   }
   else {
-    header->entry[i].size_raw = ibuf->x * ibuf->y * ibuf->channels * 4;
     colorspace_name = IMB_colormanagement_get_float_colorspace(ibuf);
   }
   BLI_strncpy(
@@ -607,6 +888,24 @@ static bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key
 {
   char path[FILE_MAX];
 
+  /* Compress before locking, so that other threads can read from cache meanwhile. */
+  const int level = seq_disk_cache_compression_level();
+  DiskCacheHeaderEntry encode_entry = {
+      .codec = seq_disk_cache_codec(level),
+      .size_raw = seq_disk_cache_imbuf_size_raw(ibuf),
+  };
+  if (ibuf->rect_float && !ibuf->rect && encode_entry.codec != DCACHE_CODEC_NONE) {
+    encode_entry.flag |= DCACHE_FLAG_SHUFFLE;
+  }
+
+  size_t encoded_size;
+  char *encoded = seq_disk_cache_encode_imbuf(ibuf, &encode_entry, level, &encoded_size);
+  if (encoded == NULL) {
+    return false;
+  }
+
+  BLI_mutex_lock(&disk_cache->read_write_mutex);
+
   seq_disk_cache_get_file_path(disk_cache, key, path, sizeof(path));
   BLI_make_existing_file(path);
 
@@ -614,6 +913,8 @@ static bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key
   if (!file) {
     file = BLI_fopen(path, "wb+");
     if (!file) {
+      BLI_mutex_unlock(&disk_cache->read_write_mutex);
+      MEM_freeN(encoded);
       return false;
     }
     seq_disk_cache_add_file_to_list(disk_cache, path);
@@ -627,26 +928,34 @@ static bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key
   if (cache_file->fstat.st_size != 0 && !seq_disk_cache_read_header(file, &header)) {
     fclose(file);
     seq_disk_cache_delete_file(disk_cache, cache_file);
+    BLI_mutex_unlock(&disk_cache->read_write_mutex);
+    MEM_freeN(encoded);
     return false;
   }
   int entry_index = seq_disk_cache_add_header_entry(key, ibuf, &header);
+  DiskCacheHeaderEntry *header_entry = &header.entry[entry_index];
+  header_entry->codec = encode_entry.codec;
+  header_entry->flag = encode_entry.flag;
 
-  size_t bytes_written = deflate_imbuf_to_file(
-      ibuf, file, seq_disk_cache_compression_level(), &header.entry[entry_index]);
-
-  if (bytes_written != 0) {
+  bool success = false;
+  fseek(file, (long)header_entry->offset, 0);
+  if (fwrite(encoded, 1, encoded_size, file) == encoded_size) {
     /* Last step is writing header, as image data can be overwritten,
      * but missing data would cause problems.
      */
-    header.entry[entry_index].size_compressed = bytes_written;
+    header_entry->size_compressed = encoded_size;
     seq_disk_cache_write_header(file, &header);
+    success = true;
+  }
+  fclose(file);
+  if (success) {
     seq_disk_cache_update_file(disk_cache, path);
-    fclose(file);
-
-    return true;
   }
 
-  return false;
+  BLI_mutex_unlock(&disk_cache->read_write_mutex);
+  MEM_freeN(encoded);
+
+  return success;
 }
 
 static ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *key)
@@ -654,57 +963,74 @@ static ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *ke
   char path[FILE_MAX];
   DiskCacheHeader header;
 
+  BLI_mutex_lock(&disk_cache->read_write_mutex);
+
   seq_disk_cache_get_file_path(disk_cache, key, path, sizeof(path));
   BLI_make_existing_file(path);
 
   FILE *file = BLI_fopen(path, "rb");
   if (!file) {
+    BLI_mutex_unlock(&disk_cache->read_write_mutex);
     return NULL;
   }
 
-  if (!seq_disk_cache_read_header(file, &header)) {
-    fclose(file);
-    return NULL;
+  int entry_index = -1;
+  if (seq_disk_cache_read_header(file, &header)) {
+    entry_index = seq_disk_cache_get_header_entry(key, &header);
   }
-  int entry_index = seq_disk_cache_get_header_entry(key, &header);
 
   /* Item not found. */
   if (entry_index < 0) {
     fclose(file);
+    BLI_mutex_unlock(&disk_cache->read_write_mutex);
+    return NULL;
+  }
+
+  DiskCacheHeaderEntry *header_entry = &header.entry[entry_index];
+  const size_t encoded_size = (size_t)header_entry->size_compressed;
+  char *encoded = MEM_mallocN(encoded_size, __func__);
+  fseek(file, (long)header_entry->offset, 0);
+  const size_t bytes_read = fread(encoded, 1, encoded_size, file);
+  fclose(file);
+
+  if (bytes_read == encoded_size) {
+    BLI_file_touch(path);
+    seq_disk_cache_update_file(disk_cache, path);
+  }
+
+  /* Decompression happens without lock, other threads can read files meanwhile. */
+  BLI_mutex_unlock(&disk_cache->read_write_mutex);
+
+  if (bytes_read != encoded_size) {
+    MEM_freeN(encoded);
     return NULL;
   }
 
   ImBuf *ibuf;
   uint64_t size_char = (uint64_t)key->context.rectx * key->context.recty * 4;
   uint64_t size_float = (uint64_t)key->context.rectx * key->context.recty * 16;
-  size_t expected_size;
 
-  if (header.entry[entry_index].size_raw == size_char) {
-    expected_size = size_char;
+  if (header_entry->size_raw == size_char) {
     ibuf = IMB_allocImBuf(key->context.rectx, key->context.recty, 32, IB_rect);
-    IMB_colormanagement_assign_rect_colorspace(ibuf, header.entry[entry_index].colorspace_name);
+    IMB_colormanagement_assign_rect_colorspace(ibuf, header_entry->colorspace_name);
   }
-  else if (header.entry[entry_index].size_raw == size_float) {
-    expected_size = size_float;
+  else if (header_entry->size_raw == size_float) {
     ibuf = IMB_allocImBuf(key->context.rectx, key->context.recty, 32, IB_rectfloat);
-    IMB_colormanagement_assign_float_colorspace(ibuf, header.entry[entry_index].colorspace_name);
+    IMB_colormanagement_assign_float_colorspace(ibuf, header_entry->colorspace_name);
   }
   else {
-    fclose(file);
+    MEM_freeN(encoded);
     return NULL;
   }
 
-  size_t bytes_read = inflate_file_to_imbuf(ibuf, file, &header.entry[entry_index]);
+  const bool success = seq_disk_cache_decode_imbuf(ibuf, header_entry, encoded, encoded_size);
+  MEM_freeN(encoded);
 
   /* Sanity check. */
-  if (bytes_read != expected_size) {
-    fclose(file);
+  if (!success) {
     IMB_freeImBuf(ibuf);
     return NULL;
   }
-  BLI_file_touch(path);
-  seq_disk_cache_update_file(disk_cache, path);
-  fclose(file);
 
   return ibuf;
 }
@@ -713,6 +1039,7 @@ static ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *ke
 #undef DCACHE_IMAGES_PER_FILE
 #undef COLORSPACE_NAME_MAX
 #undef DCACHE_CURRENT_VERSION
+#undef DCACHE_BLOCK_SIZE
 
 static bool seq_cmp_render_data(const SeqRenderData *a, const SeqRenderData *b)
 {
@@ -1167,8 +1494,138 @@ static SeqCacheKey *seq_cache_allocate_key(SeqCache *cache,
   return key;
 }
 
+/* Store image read from disk cache in RAM cache, unless it got there meanwhile. */
+static void seq_cache_put_from_disk(const SeqRenderData *context,
+                                    Sequence *seq,
+                                    const float timeline_frame,
+                                    const int type,
+                                    ImBuf *ibuf)
+{
+  Scene *scene = context->scene;
+
+  /* Only recycle item for final type. */
+  if (type == SEQ_CACHE_STORE_FINAL_OUT && !seq_cache_recycle_item(scene)) {
+    return;
+  }
+
+  seq_cache_lock(scene);
+  SeqCache *cache = seq_cache_get_from_scene(scene);
+  SeqCacheKey key;
+  seq_cache_populate_key(&key, context, seq, timeline_frame, type);
+  if (!BLI_ghash_haskey(cache->hash, &key)) {
+    SeqCacheKey *new_key = seq_cache_allocate_key(cache, context, seq, timeline_frame, type);
+    seq_cache_put_ex(scene, new_key, ibuf);
+  }
+  seq_cache_unlock(scene);
+}
+
+typedef struct SeqCacheReadAheadTask {
+  SeqRenderData context;
+  Sequence *seq;
+  float timeline_frame;
+} SeqCacheReadAheadTask;
+
+static void seq_cache_read_ahead_task_run(TaskPool *__restrict pool, void *taskdata)
+{
+  SeqCacheReadAheadTask *task = taskdata;
+  if (BLI_task_pool_current_canceled(pool)) {
+    return;
+  }
+
+  Scene *scene = task->context.scene;
+  SeqCache *cache = seq_cache_get_from_scene(scene);
+  SeqCacheKey key;
+  seq_cache_populate_key(
+      &key, &task->context, task->seq, task->timeline_frame, SEQ_CACHE_STORE_FINAL_OUT);
+
+  seq_cache_lock(scene);
+  const bool is_cached = BLI_ghash_haskey(cache->hash, &key);
+  seq_cache_unlock(scene);
+
+  if (is_cached) {
+    return;
+  }
+
+  ImBuf *ibuf = seq_disk_cache_read_file(cache->disk_cache, &key);
+  if (ibuf != NULL) {
+    seq_cache_put_from_disk(
+        &task->context, task->seq, task->timeline_frame, SEQ_CACHE_STORE_FINAL_OUT, ibuf);
+    IMB_freeImBuf(ibuf);
+  }
+}
+
+#define DCACHE_READ_AHEAD_FRAMES 8
+
+/* Read final images of frames following timeline_frame from disk cache in background. */
+static void seq_cache_read_ahead(const SeqRenderData *context,
+                                 Sequence *seq,
+                                 const float timeline_frame)
+{
+  SeqDiskCache *disk_cache = seq_cache_get_from_scene(context->scene)->disk_cache;
+  const int frame = (int)timeline_frame;
+
+  BLI_mutex_lock(&disk_cache->read_write_mutex);
+
+  /* Continue reading where previous read-ahead ended when playing forward. */
+  int frame_start = frame + 1;
+  if (disk_cache->read_ahead_seq == seq && frame >= disk_cache->read_ahead_frame_start &&
+      frame < disk_cache->read_ahead_frame_end) {
+    frame_start = disk_cache->read_ahead_frame_end;
+  }
+  else {
+    disk_cache->read_ahead_frame_start = frame;
+  }
+  const int frame_end = min_ii(frame + 1 + DCACHE_READ_AHEAD_FRAMES, seq->enddisp);
+
+  if (frame_start < frame_end) {
+    if (disk_cache->read_ahead_pool == NULL) {
+      disk_cache->read_ahead_pool = BLI_task_pool_create_background_serial(NULL,
+                                                                           TASK_PRIORITY_LOW);
+    }
+    for (int i = frame_start; i < frame_end; i++) {
+      SeqCacheReadAheadTask *task = MEM_mallocN(sizeof(*task), __func__);
+      task->context = *context;
+      task->seq = seq;
+      task->timeline_frame = (float)i + (timeline_frame - (float)frame);
+      BLI_task_pool_push(
+          disk_cache->read_ahead_pool, seq_cache_read_ahead_task_run, task, true, NULL);
+    }
+    disk_cache->read_ahead_seq = seq;
+    disk_cache->read_ahead_frame_end = frame_end;
+  }
+
+  BLI_mutex_unlock(&disk_cache->read_write_mutex);
+}
+
+#undef DCACHE_READ_AHEAD_FRAMES
+
 /* ***************************** API ****************************** */
 
+/**
+ * Stop reading frames ahead from disk cache. Must be called before strips or the cache are
+ * freed.
+ */
+void seq_cache_read_ahead_stop(Scene *scene)
+{
+  SeqCache *cache = seq_cache_get_from_scene(scene);
+  if (cache == NULL || cache->disk_cache == NULL) {
+    return;
+  }
+
+  SeqDiskCache *disk_cache = cache->disk_cache;
+  BLI_mutex_lock(&disk_cache->read_write_mutex);
+  TaskPool *pool = disk_cache->read_ahead_pool;
+  disk_cache->read_ahead_pool = NULL;
+  disk_cache->read_ahead_seq = NULL;
+  BLI_mutex_unlock(&disk_cache->read_write_mutex);
+
+  /* Tasks lock the mutex, so cancel outside of it. */
+  if (pool != NULL) {
+    BLI_task_pool_cancel(pool);
+    BLI_task_pool_free(pool);
+  }
+}
+
 void seq_cache_free_temp_cache(Scene *scene, short id, int timeline_frame)
 {
   SeqCache *cache = seq_cache_get_from_scene(scene);
@@ -1204,6 +1661,8 @@ void seq_cache_destruct(Scene *scene)
     return;
   }
 
+  seq_cache_read_ahead_stop(scene);
+
   BLI_ghash_free(cache->hash, seq_cache_keyfree, seq_cache_valfree);
   BLI_mempool_destroy(cache->keys_pool);
   BLI_mempool_destroy(cache->items_pool);
@@ -1259,6 +1718,8 @@ void seq_cache_cleanup_sequence(Scene *scene,
     return;
   }
 
+  seq_cache_read_ahead_stop(scene);
+
   if (seq_disk_cache_is_enabled(cache->bmain) && cache->disk_cache != NULL) {
     seq_disk_cache_invalidate(scene, seq, seq_changed, invalidate_types);
   }
@@ -1312,10 +1773,13 @@ void seq_cache_cleanup_sequence(Scene *scene,
   seq_cache_unlock(scene);
 }
 
-struct ImBuf *seq_cache_get(const SeqRenderData *context,
-                            Sequence *seq,
-                            float timeline_frame,
-                            int type)
+/* Reading ahead is only allowed from the UI or render thread. Prefetching renders ahead by
+ * itself and adding an image must not start reading other images. */
+static struct ImBuf *seq_cache_get_ex2(const SeqRenderData *context,
+                                       Sequence *seq,
+                                       float timeline_frame,
+                                       int type,
+                                       const bool allow_read_ahead)
 {
 
   if (context->skip_cache || context->is_proxy_render || !seq) {
@@ -1323,6 +1787,9 @@ struct ImBuf *seq_cache_get(const SeqRenderData *context,
   }
 
   Scene *scene = context->scene;
+  const bool use_read_ahead = allow_read_ahead && !context->is_prefetch_render &&
+                              type == SEQ_CACHE_STORE_FINAL_OUT &&
+                              seq_disk_cache_is_enabled(context->bmain);
 
   if (context->is_prefetch_render) {
     context = seq_prefetch_get_original_context(context);
@@ -1351,6 +1818,9 @@ struct ImBuf *seq_cache_get(const SeqRenderData *context,
   seq_cache_unlock(scene);
 
   if (ibuf) {
+    if (use_read_ahead && cache->disk_cache != NULL) {
+      seq_cache_read_ahead(context, seq, timeline_frame);
+    }
     return ibuf;
   }
 
@@ -1360,24 +1830,31 @@ struct ImBuf *seq_cache_get(const SeqRenderData *context,
       seq_disk_cache_create(context->bmain, context->scene);
     }
 
-    BLI_mutex_lock(&cache->disk_cache->read_write_mutex);
     ibuf = seq_disk_cache_read_file(cache->disk_cache, &key);
-    BLI_mutex_unlock(&cache->disk_cache->read_write_mutex);
 
     if (ibuf == NULL) {
       return NULL;
     }
 
-    /* Store read image in RAM. Only recycle item for final type. */
-    if (key.type != SEQ_CACHE_STORE_FINAL_OUT || seq_cache_recycle_item(scene)) {
-      SeqCacheKey *new_key = seq_cache_allocate_key(cache, context, seq, timeline_frame, type);
-      seq_cache_put_ex(scene, new_key, ibuf);
+    /* Store read image in RAM. */
+    seq_cache_put_from_disk(context, seq, timeline_frame, type, ibuf);
+
+    if (use_read_ahead) {
+      seq_cache_read_ahead(context, seq, timeline_frame);
     }
   }
 
   return ibuf;
 }
 
+struct ImBuf *seq_cache_get(const SeqRenderData *context,
+                            Sequence *seq,
+                            float timeline_frame,
+                            int type)
+{
+  return seq_cache_get_ex2(context, seq, timeline_frame, type, true);
+}
+
 bool seq_cache_put_if_possible(
     const SeqRenderData *context, Sequence *seq, float timeline_frame, int type, ImBuf *ibuf)
 {
@@ -1419,8 +1896,9 @@ void seq_cache_put(
     BLI_assert(seq != NULL);
   }
 
-  /* Prevent reinserting, it breaks cache key linking. */
-  ImBuf *test = seq_cache_get(context, seq, timeline_frame, type);
+  /* Prevent reinserting, it breaks cache key linking. The context is not the prefetch context
+   * anymore, so reading ahead is disabled explicitly. */
+  ImBuf *test = seq_cache_get_ex2(context, seq, timeline_frame, type, false);
   if (test) {
     IMB_freeImBuf(test);
     return;
@@ -1442,9 +1920,7 @@ void seq_cache_put(
         seq_disk_cache_create(context->bmain, context->scene);
       }
 
-      BLI_mutex_lock(&cache->disk_cache->read_write_mutex);
       seq_disk_cache_write_file(cache->disk_cache, key, i);
-      BLI_mutex_unlock(&cache->disk_cache->read_write_mutex);
       seq_disk_cache_enforce_limits(cache->disk_cache);
     }
   }
@@ -52,6 +52,7 @@ bool seq_cache_put_if_possible(const struct SeqRenderData *context,
                                int type,
                                struct ImBuf *nval);
 bool seq_cache_recycle_item(struct Scene *scene);
+void seq_cache_read_ahead_stop(struct Scene *scene);
 void seq_cache_free_temp_cache(struct Scene *scene, short id, int timeline_frame);
 void seq_cache_destruct(struct Scene *scene);
 void seq_cache_cleanup_all(struct Main *bmain);
@@ -271,6 +271,8 @@ void SEQ_prefetch_stop_all(void)
  */
 void SEQ_prefetch_stop(Scene *scene)
 {
+  seq_cache_read_ahead_stop(scene);
+
   PrefetchJob *pfjob;
   pfjob = seq_prefetch_job_get(scene);
 
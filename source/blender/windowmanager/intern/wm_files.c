@@ -443,8 +443,6 @@ static void wm_init_userdef(Main *bmain)
 static int wm_read_exotic(const char *name)
 {
   int len;
-  gzFile gzfile;
-  char header[7];
   int retval;
 
   /* make sure we're not trying to read a directory.... */
@@ -454,14 +452,12 @@ static int wm_read_exotic(const char *name)
     retval = BKE_READ_EXOTIC_FAIL_PATH;
   }
   else {
-    gzfile = BLI_gzopen(name, "rb");
-    if (gzfile == NULL) {
+    if (BLI_access(name, R_OK) != 0) {
       retval = BKE_READ_EXOTIC_FAIL_OPEN;
     }
     else {
-      len = gzread(gzfile, header, sizeof(header));
-      gzclose(gzfile);
-      if (len == sizeof(header) && STREQLEN(header, "BLENDER", 7)) {
+      /* Also handles compressed files, in all formats supported by the file reader. */
+      if (BLO_file_header_is_blend(name)) {
         retval = BKE_READ_EXOTIC_OK_BLEND;
       }
       else {